@@ -1,3 +1,14 @@
 C:/Develop/Tools/VulkanSDK/1.3.290.0/Bin/glslc.exe ./resources/shaders/00/triangle.vert -o ./resources/shaders/00/triangle.vert.spv
+C:/Develop/Tools/VulkanSDK/1.3.290.0/Bin/glslc.exe ./resources/shaders/00/triangle_quantized.vert -o ./resources/shaders/00/triangle_quantized.vert.spv
 C:/Develop/Tools/VulkanSDK/1.3.290.0/Bin/glslc.exe ./resources/shaders/00//triangle.frag -o ./resources/shaders/00/triangle.frag.spv
+C:/Develop/Tools/VulkanSDK/1.3.290.0/Bin/glslc.exe ./resources/shaders/virtual_texture/vt_feedback.frag -o ./resources/shaders/virtual_texture/vt_feedback.frag.spv
+C:/Develop/Tools/VulkanSDK/1.3.290.0/Bin/glslc.exe ./resources/shaders/meshlet/meshlet_cull.comp -o ./resources/shaders/meshlet/meshlet_cull.comp.spv
+C:/Develop/Tools/VulkanSDK/1.3.290.0/Bin/glslc.exe --target-env=vulkan1.2 ./resources/shaders/meshlet/meshlet.task -o ./resources/shaders/meshlet/meshlet.task.spv
+C:/Develop/Tools/VulkanSDK/1.3.290.0/Bin/glslc.exe --target-env=vulkan1.2 ./resources/shaders/meshlet/meshlet.mesh -o ./resources/shaders/meshlet/meshlet.mesh.spv
+C:/Develop/Tools/VulkanSDK/1.3.290.0/Bin/glslc.exe ./resources/shaders/meshlet/meshlet.vert -o ./resources/shaders/meshlet/meshlet.vert.spv
+C:/Develop/Tools/VulkanSDK/1.3.290.0/Bin/glslc.exe ./resources/shaders/scene/scene_cull.comp -o ./resources/shaders/scene/scene_cull.comp.spv
+C:/Develop/Tools/VulkanSDK/1.3.290.0/Bin/glslc.exe -DOCCLUSION_CULLING ./resources/shaders/scene/scene_cull.comp -o ./resources/shaders/scene/scene_cull_occlusion.comp.spv
+C:/Develop/Tools/VulkanSDK/1.3.290.0/Bin/glslc.exe ./resources/shaders/scene/depth_pyramid.comp -o ./resources/shaders/scene/depth_pyramid.comp.spv
+C:/Develop/Tools/VulkanSDK/1.3.290.0/Bin/glslc.exe ./resources/shaders/scene/scene.vert -o ./resources/shaders/scene/scene.vert.spv
+C:/Develop/Tools/VulkanSDK/1.3.290.0/Bin/glslc.exe ./resources/shaders/scene/instanced.vert -o ./resources/shaders/scene/instanced.vert.spv
 pause
\ No newline at end of file
@@ -1,20 +1,20 @@
 #version 450
 
-layout(location = 0) out vec3 fragColor;
+// 与 VertexLayoutOf<Vertex> 的属性对应
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inUV;
 
-vec2 positions[3] = vec2[](
-    vec2(0.0, -0.5),
-    vec2(0.5, 0.5),
-    vec2(-0.5, 0.5)
-);
+layout(location = 0) out vec3 fragColor;
 
-vec3 colors[3] = vec3[](
-    vec3(1.0, 0.0, 0.0),
-    vec3(0.0, 1.0, 0.0),
-    vec3(0.0, 0.0, 1.0)
-);
+// 与 common/per_draw.glsl 中的推送常量块一致
+layout(push_constant) uniform PerDrawPush
+{
+    mat4 model;
+    uint materialIndex;
+} uPush;
 
 void main() {
-    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
-    fragColor = colors[gl_VertexIndex];
+    gl_Position = uPush.model * vec4(inPosition, 1.0);
+    fragColor = inNormal * 0.5 + 0.5;
 }
\ No newline at end of file
@@ -0,0 +1,23 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "../common/vertex_quantization.glsl"
+
+// 与 VertexLayoutOf<QuantizedVertex> 对应
+layout(location = 0) in vec4 inPosition; // [0, 1]，w 为填充
+layout(location = 1) in vec2 inNormal;   // 八面体编码
+layout(location = 2) in vec2 inUV;
+
+layout(location = 0) out vec3 fragColor;
+
+// 与 common/per_draw.glsl 中的推送常量块一致，model 已包含位置反量化
+layout(push_constant) uniform PerDrawPush
+{
+    mat4 model;
+    uint materialIndex;
+} uPush;
+
+void main() {
+    gl_Position = uPush.model * vec4(inPosition.xyz, 1.0);
+    fragColor = decodeOctahedral(inNormal) * 0.5 + 0.5;
+}
@@ -0,0 +1,19 @@
+// 无绑定资源表，与 BindlessDescriptors 的 set 0 布局对应
+// 使用前需要 #extension GL_EXT_nonuniform_qualifier : require
+layout(set = 0, binding = 0) uniform sampler2D uBindlessTextures[];
+
+layout(set = 0, binding = 1) readonly buffer BindlessBuffer
+{
+    uint words[];
+} uBindlessBuffers[];
+
+// 句柄在一次绘制内可能不一致时（例如来自逐实例数据）必须加 nonuniformEXT
+vec4 bindlessSample(uint handle, vec2 uv)
+{
+    return texture(uBindlessTextures[nonuniformEXT(handle)], uv);
+}
+
+uint bindlessLoadWord(uint handle, uint index)
+{
+    return uBindlessBuffers[nonuniformEXT(handle)].words[index];
+}
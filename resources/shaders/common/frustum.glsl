@@ -0,0 +1,20 @@
+// 视锥平面提取，与 Scene/Frustum.hpp 对应
+
+// 由裁剪矩阵提取视锥平面（深度范围 [0, 1]），与 Scene/Frustum.hpp 的 extractFrustumPlanes 一致；
+// 传入 clipFromObject 时得到对象空间的平面
+void extractFrustumPlanes(mat4 m, out vec4 planes[6])
+{
+    vec4 row0 = vec4(m[0][0], m[1][0], m[2][0], m[3][0]);
+    vec4 row1 = vec4(m[0][1], m[1][1], m[2][1], m[3][1]);
+    vec4 row2 = vec4(m[0][2], m[1][2], m[2][2], m[3][2]);
+    vec4 row3 = vec4(m[0][3], m[1][3], m[2][3], m[3][3]);
+    planes[0] = row3 + row0;
+    planes[1] = row3 - row0;
+    planes[2] = row3 + row1;
+    planes[3] = row3 - row1;
+    planes[4] = row2;
+    planes[5] = row3 - row2;
+    for (int i = 0; i < 6; i++) {
+        planes[i] /= length(planes[i].xyz);
+    }
+}
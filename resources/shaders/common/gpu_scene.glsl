@@ -0,0 +1,33 @@
+// GPU 驱动渲染的场景数据，与 Scene/GpuScene.hpp 对应
+
+#define GPU_SCENE_MAX_LODS 8
+
+// 与 GpuLod 对应
+struct Lod
+{
+    uint firstIndex;
+    uint indexCount;
+    float error;
+    uint padding;
+};
+
+// 与 GpuMeshInfo 对应
+struct MeshInfo
+{
+    vec4 sphere; // xyz 球心，w 半径（对象空间）
+    int vertexOffset;
+    uint lodCount;
+    uint padding0;
+    uint padding1;
+    Lod lods[GPU_SCENE_MAX_LODS];
+};
+
+// 与 GpuObject 对应
+struct Object
+{
+    mat4 model;
+    uint meshIndex;
+    float maxScale;
+    uint padding0;
+    uint padding1;
+};
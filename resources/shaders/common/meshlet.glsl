@@ -0,0 +1,31 @@
+// 网格簇数据与剔除测试，与 MeshletMesh.hpp / MeshletCuller.hpp 对应
+
+#include "frustum.glsl"
+
+// 与 GpuMeshlet 对应
+struct Meshlet
+{
+    vec4 sphere; // xyz 球心，w 半径（对象空间）
+    vec4 cone;   // xyz 锥轴，w coneCutoff
+    uint firstIndex;
+    uint indexCount;
+    uint vertexOffset;
+    uint vertexCount;
+};
+
+// 视锥测试 + 法线锥背面测试，eye 为对象空间的视点
+bool isMeshletVisible(Meshlet meshlet, vec4 planes[6], vec3 eye)
+{
+    vec3 center = meshlet.sphere.xyz;
+    float radius = meshlet.sphere.w;
+
+    for (int i = 0; i < 6; i++) {
+        if (dot(planes[i].xyz, center) + planes[i].w < -radius) {
+            return false;
+        }
+    }
+
+    // 整个簇背向相机
+    vec3 view = center - eye;
+    return dot(view, meshlet.cone.xyz) < meshlet.cone.w * length(view) + radius;
+}
@@ -0,0 +1,21 @@
+// 每次绘制的数据，与 PerDrawData.hpp 对应
+// 包含前可定义 PER_DRAW_SET 指定动态 UBO 所在的描述符集（默认 1，与 PerDrawUniformRing::DESCRIPTOR_SET 一致；
+// set 0 为无绑定资源表，不支持无绑定时由空布局占位）
+#ifndef PER_DRAW_SET
+#define PER_DRAW_SET 1
+#endif
+
+// 推送常量路径：最多 128 字节，所有管线共用同一范围
+layout(push_constant) uniform PerDrawPush
+{
+    mat4 model;
+    uint materialIndex;
+} uPush;
+
+// 动态 UBO 路径：PerDrawUniformRing::Bind 传入的动态偏移指向本次绘制的数据
+layout(set = PER_DRAW_SET, binding = 0) uniform PerDrawUniform
+{
+    mat4 model;
+    mat4 normalMatrix;
+    vec4 params[8];
+} uPerDraw;
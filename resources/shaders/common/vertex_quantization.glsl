@@ -0,0 +1,12 @@
+// 压缩顶点的解码，与 VertexQuantization.hpp 对应
+// 位置（R16G16B16A16_UNORM）与 UV（R16G16_SFLOAT）由顶点输入阶段自动转换为 float，
+// 位置的反量化已折进模型矩阵（model * VertexDequantization::Matrix()），这里只需解码法线
+
+// 八面体映射（R16G16_SNORM）还原为单位向量
+vec3 decodeOctahedral(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
@@ -0,0 +1,21 @@
+#version 450
+
+// 网格着色器不可用时的回退路径：由 MeshletCuller 剔除后间接绘制
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inUV;
+
+layout(location = 0) out vec3 fragColor;
+
+// 与 MeshletDrawParams 对应
+layout(push_constant) uniform MeshletPush
+{
+    mat4 clipFromObject;
+    vec3 cameraPosition;
+    uint meshletCount;
+} uDraw;
+
+void main() {
+    gl_Position = uDraw.clipFromObject * vec4(inPosition, 1.0);
+    fragColor = inNormal * 0.5 + 0.5;
+}
@@ -0,0 +1,25 @@
+#version 450
+
+// 实例化绘制的顶点着色器：DrawBatcher 把同一批次的实例数据连续写入实例缓冲，
+// 实例频率的输入从 firstInstance 开始逐实例读取，与 InstanceData 对应
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inUV;
+layout(location = 3) in mat4 inModel; // 占用 location 3~6
+layout(location = 7) in uint inMaterialIndex;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragUV;
+layout(location = 2) flat out uint fragMaterialIndex;
+
+layout(push_constant) uniform ScenePush
+{
+    mat4 viewProjection;
+} uScene;
+
+void main() {
+    gl_Position = uScene.viewProjection * inModel * vec4(inPosition, 1.0);
+    fragColor = normalize(mat3(inModel) * inNormal) * 0.5 + 0.5;
+    fragUV = inUV;
+    fragMaterialIndex = inMaterialIndex;
+}
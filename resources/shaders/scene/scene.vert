@@ -0,0 +1,27 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "../common/gpu_scene.glsl"
+
+// GPU 驱动路径的顶点着色器：gl_InstanceIndex 即剔除时写入的 firstInstance（对象编号）
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inUV;
+
+layout(location = 0) out vec3 fragColor;
+
+layout(std430, set = 0, binding = 0) readonly buffer Objects
+{
+    Object objects[];
+};
+
+layout(push_constant) uniform ScenePush
+{
+    mat4 viewProjection;
+} uScene;
+
+void main() {
+    mat4 model = objects[gl_InstanceIndex].model;
+    gl_Position = uScene.viewProjection * model * vec4(inPosition, 1.0);
+    fragColor = normalize(mat3(model) * inNormal) * 0.5 + 0.5;
+}
@@ -0,0 +1,44 @@
+// 虚拟纹理公共函数，特化常量与 VirtualTextureShaderConstants 一一对应
+layout(constant_id = 0) const uint VT_PAGE_SIZE = 128;
+layout(constant_id = 1) const uint VT_PAGE_BORDER = 4;
+layout(constant_id = 2) const uint VT_CACHE_PAGES = 16;
+layout(constant_id = 3) const uint VT_VIRTUAL_PAGES = 256;
+layout(constant_id = 4) const uint VT_MAX_MIP = 8;
+layout(constant_id = 5) const float VT_FEEDBACK_SCALE = 0.125;
+
+// 按虚拟空间纹素的屏幕导数估算 mip 级别，derivScale 用于补偿低分辨率反馈
+uint vtMipLevel(vec2 uv, float derivScale)
+{
+    vec2 texels = uv * float(VT_VIRTUAL_PAGES * VT_PAGE_SIZE);
+    vec2 dx = dFdx(texels) * derivScale;
+    vec2 dy = dFdy(texels) * derivScale;
+    float lod = 0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1.0));
+    return min(uint(lod), VT_MAX_MIP);
+}
+
+// 与 VirtualTexture 的页面键编码一致：level << 24 | y << 12 | x
+uint vtPageKey(vec2 uv, uint mip)
+{
+    uint pages = VT_VIRTUAL_PAGES >> mip;
+    uvec2 page = min(uvec2(clamp(uv, 0.0, 1.0) * float(pages)), uvec2(pages - 1));
+    return (mip << 24) | (page.y << 12) | page.x;
+}
+
+// 通过页表间接采样物理页缓存，缺失的页面已在 CPU 端回退到最近的常驻父页面
+vec4 vtSample(usampler2D pageTable, sampler2D cache, vec2 uv)
+{
+    uint mip = vtMipLevel(uv, 1.0);
+    uint pages = VT_VIRTUAL_PAGES >> mip;
+    ivec2 page = ivec2(min(uvec2(clamp(uv, 0.0, 1.0) * float(pages)), uvec2(pages - 1)));
+    uvec4 entry = texelFetch(pageTable, page, int(mip));
+    if (entry.a == 0u)
+    {
+        return vec4(0.0);
+    }
+
+    // entry.b 是实际映射页面所在的级别，在该级别内求页内坐标
+    vec2 local = fract(uv * float(VT_VIRTUAL_PAGES >> entry.b));
+    float padded = float(VT_PAGE_SIZE + 2u * VT_PAGE_BORDER);
+    vec2 texel = vec2(entry.rg) * padded + float(VT_PAGE_BORDER) + local * float(VT_PAGE_SIZE);
+    return texture(cache, texel / (float(VT_CACHE_PAGES) * padded));
+}
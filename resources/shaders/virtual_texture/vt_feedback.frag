@@ -0,0 +1,13 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "vt_common.glsl"
+
+layout(location = 0) in vec2 inVirtualUV;
+
+layout(location = 0) out uint outPage;
+
+void main()
+{
+    outPage = vtPageKey(inVirtualUV, vtMipLevel(inVirtualUV, VT_FEEDBACK_SCALE));
+}
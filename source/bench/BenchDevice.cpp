@@ -0,0 +1,167 @@
+#include "BenchDevice.hpp"
+
+#include "Vulkan/DeviceFeatures.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+BenchDevice::BenchDevice(const std::vector<const char *> &optionalExtensions) {
+  // 1. 实例：加载器支持时使用 1.2
+  uint32_t instanceVersion = VK_API_VERSION_1_1;
+  vkEnumerateInstanceVersion(&instanceVersion);
+  m_context.apiVersion = instanceVersion >= VK_API_VERSION_1_2
+                             ? VK_API_VERSION_1_2
+                             : VK_API_VERSION_1_1;
+
+  VkApplicationInfo appInfo = {
+      .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+      .pApplicationName = "LearnVulkan Benchmark",
+      .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
+      .pEngineName = "No Engine",
+      .engineVersion = VK_MAKE_VERSION(1, 0, 0),
+      .apiVersion = m_context.apiVersion,
+  };
+  VkInstanceCreateInfo instanceInfo = {
+      .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+      .pApplicationInfo = &appInfo,
+  };
+  if (vkCreateInstance(&instanceInfo, nullptr, &m_context.instance) !=
+      VK_SUCCESS) {
+    LOG_ERROR("failed to create instance!");
+    throw std::runtime_error("failed to create instance!");
+  }
+
+  // 2. 物理设备
+  uint32_t deviceCount = 0;
+  vkEnumeratePhysicalDevices(m_context.instance, &deviceCount, nullptr);
+  if (deviceCount == 0) {
+    LOG_ERROR("failed to find GPUs with Vulkan support!");
+    throw std::runtime_error("failed to find GPUs with Vulkan support!");
+  }
+  std::vector<VkPhysicalDevice> devices(deviceCount);
+  vkEnumeratePhysicalDevices(m_context.instance, &deviceCount, devices.data());
+
+  m_context.physicalDevice = devices.front();
+  for (VkPhysicalDevice device : devices) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device, &properties);
+    if (properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
+      m_context.physicalDevice = device;
+      break;
+    }
+  }
+
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(m_context.physicalDevice, &properties);
+  m_context.apiVersion = std::min(m_context.apiVersion, properties.apiVersion);
+  m_context.limits = properties.limits;
+  LOG_INFO("benchmark device: {}", properties.deviceName);
+
+  // 3. 图形队列族
+  uint32_t queueFamilyCount = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(m_context.physicalDevice,
+                                           &queueFamilyCount, nullptr);
+  std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+  vkGetPhysicalDeviceQueueFamilyProperties(
+      m_context.physicalDevice, &queueFamilyCount, queueFamilies.data());
+  auto graphicsFamily = std::find_if(
+      queueFamilies.begin(), queueFamilies.end(),
+      [](const VkQueueFamilyProperties &family) {
+        return family.queueFlags & VK_QUEUE_GRAPHICS_BIT;
+      });
+  if (graphicsFamily == queueFamilies.end()) {
+    LOG_ERROR("failed to find a graphics queue family!");
+    throw std::runtime_error("failed to find a graphics queue family!");
+  }
+  m_context.graphicsQueueFamily =
+      static_cast<uint32_t>(graphicsFamily - queueFamilies.begin());
+
+  // 4. 逻辑设备：启用可用的可选扩展与对应特性
+  uint32_t extensionCount = 0;
+  vkEnumerateDeviceExtensionProperties(m_context.physicalDevice, nullptr,
+                                       &extensionCount, nullptr);
+  std::vector<VkExtensionProperties> available(extensionCount);
+  vkEnumerateDeviceExtensionProperties(m_context.physicalDevice, nullptr,
+                                       &extensionCount, available.data());
+
+  std::vector<const char *> extensions;
+  for (const char *extension : optionalExtensions) {
+    bool found = std::any_of(available.begin(), available.end(),
+                             [extension](const VkExtensionProperties &p) {
+                               return std::strcmp(p.extensionName, extension) ==
+                                      0;
+                             });
+    if (found) {
+      extensions.push_back(extension);
+    } else {
+      LOG_INFO("optional device extension not available: {}", extension);
+    }
+  }
+
+  DeviceFeatureChain features;
+  selectDeviceFeatures(m_context.physicalDevice, m_context.apiVersion,
+                       extensions, features);
+
+  float queuePriority = 1.0f;
+  VkDeviceQueueCreateInfo queueInfo = {
+      .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+      .queueFamilyIndex = m_context.graphicsQueueFamily,
+      .queueCount = 1,
+      .pQueuePriorities = &queuePriority,
+  };
+  VkDeviceCreateInfo deviceInfo = {
+      .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+      .pNext = features.Link(m_context.apiVersion, extensions),
+      .queueCreateInfoCount = 1,
+      .pQueueCreateInfos = &queueInfo,
+      .enabledExtensionCount = static_cast<uint32_t>(extensions.size()),
+      .ppEnabledExtensionNames = extensions.data(),
+      .pEnabledFeatures = &features.features,
+  };
+  if (vkCreateDevice(m_context.physicalDevice, &deviceInfo, nullptr,
+                     &m_context.device) != VK_SUCCESS) {
+    LOG_ERROR("failed to create logical device!");
+    throw std::runtime_error("failed to create logical device!");
+  }
+
+  vkGetDeviceQueue(m_context.device, m_context.graphicsQueueFamily, 0,
+                   &m_context.graphicsQueue);
+  m_context.enabledExtensions =
+      std::set<std::string>(extensions.begin(), extensions.end());
+  m_context.features = features.features;
+  m_context.features12 = features.features12;
+  m_context.features12.pNext = nullptr;
+
+  // 5. 命令池
+  VkCommandPoolCreateInfo poolInfo = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+      .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+      .queueFamilyIndex = m_context.graphicsQueueFamily,
+  };
+  if (vkCreateCommandPool(m_context.device, &poolInfo, nullptr,
+                          &m_commandPool) != VK_SUCCESS) {
+    LOG_ERROR("failed to create command pool!");
+    throw std::runtime_error("failed to create command pool!");
+  }
+}
+
+BenchDevice::~BenchDevice() {
+  vkDeviceWaitIdle(m_context.device);
+  vkDestroyCommandPool(m_context.device, m_commandPool, nullptr);
+  vkDestroyDevice(m_context.device, nullptr);
+  vkDestroyInstance(m_context.instance, nullptr);
+}
+
+VkCommandBuffer BenchDevice::AllocateCommandBuffer() const {
+  VkCommandBufferAllocateInfo allocInfo = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+      .commandPool = m_commandPool,
+      .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+      .commandBufferCount = 1,
+  };
+  VkCommandBuffer commandBuffer;
+  vkAllocateCommandBuffers(m_context.device, &allocInfo, &commandBuffer);
+  return commandBuffer;
+}
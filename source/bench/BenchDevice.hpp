@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Vulkan/VkContext.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// 基准测试用的无窗口 Vulkan 设备：选择第一个独立显卡（没有时取第一个设备），
+// 启用与主程序相同的特性选择逻辑，可选扩展在设备支持时启用
+class BenchDevice {
+public:
+  explicit BenchDevice(const std::vector<const char *> &optionalExtensions = {});
+  ~BenchDevice();
+
+  BenchDevice(const BenchDevice &) = delete;
+  BenchDevice &operator=(const BenchDevice &) = delete;
+
+  const VkContext &GetContext() const { return m_context; }
+  VkCommandPool GetCommandPool() const { return m_commandPool; }
+
+  // 分配一个主命令缓冲（随命令池一起销毁）
+  VkCommandBuffer AllocateCommandBuffer() const;
+
+private:
+  VkContext m_context;
+  VkCommandPool m_commandPool = VK_NULL_HANDLE;
+};
+
+// 执行 function 并返回耗时（毫秒）
+template <typename Function> double measureMilliseconds(Function &&function) {
+  auto begin = std::chrono::steady_clock::now();
+  function();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// 先执行 warmupFrames 次预热，返回之后 measuredFrames 次的平均耗时（毫秒）；
+// prepare 在每次 function 之前执行，不计入耗时
+template <typename Function, typename Prepare>
+double averageMilliseconds(uint32_t warmupFrames, uint32_t measuredFrames,
+                           Function &&function, Prepare &&prepare) {
+  double total = 0.0;
+  for (uint32_t frame = 0; frame < warmupFrames + measuredFrames; frame++) {
+    prepare();
+    double ms = measureMilliseconds(function);
+    if (frame >= warmupFrames) {
+      total += ms;
+    }
+  }
+  return total / measuredFrames;
+}
+
+template <typename Function>
+double averageMilliseconds(uint32_t warmupFrames, uint32_t measuredFrames,
+                           Function &&function) {
+  return averageMilliseconds(warmupFrames, measuredFrames,
+                             std::forward<Function>(function), [] {});
+}
@@ -0,0 +1,310 @@
+// CPU 剔除的吞吐，只用 CPU，不创建 Vulkan 设备：
+// - 视锥剔除：随机分布的包围体，分别用标量、SSE2、AVX2 内核在共享线程池上剔除，
+//   再用最高级别的内核测量 100 万个对象随线程数的扩展
+// - 掩码遮挡剔除：一排“建筑”盒子作为遮挡体，光栅化后过滤视锥剔除的结果
+// - 场景 BVH：构建、对象移动后的 Refit，以及视锥、射线与球查询
+// - 空间哈希网格：所有对象每帧移动后的批量更新，以及视锥与球查询
+#include "BenchDevice.hpp"
+
+#include "Scene/FrustumCuller.hpp"
+#include "Scene/MaskedOcclusionCuller.hpp"
+#include "Scene/SceneBvh.hpp"
+#include "Scene/SpatialHashGrid.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr uint32_t MEASURED_FRAMES = 50;
+constexpr uint32_t WARMUP_FRAMES = 5;
+constexpr uint32_t OBJECT_COUNTS[] = {10000, 100000, 1000000};
+constexpr float WORLD_HALF_SIZE = 500.0f;
+constexpr uint32_t OCCLUDER_COUNTS[] = {16, 256, 4096};
+constexpr uint32_t BVH_QUERY_COUNT = 1000;
+
+// 相机位于原点朝 -z，60 度垂直视角，深度范围 [0, 1]
+glm::mat4 benchViewProjection() {
+  float focal = 1.0f / std::tan(glm::radians(60.0f) * 0.5f);
+  float aspect = 16.0f / 9.0f, zNear = 0.1f, zFar = 1000.0f;
+  glm::mat4 projection(0.0f);
+  projection[0][0] = focal / aspect;
+  projection[1][1] = -focal;
+  projection[2][2] = zFar / (zNear - zFar);
+  projection[2][3] = -1.0f;
+  projection[3][2] = -(zFar * zNear) / (zFar - zNear);
+  return projection;
+}
+
+void fillBounds(CullingBounds &bounds, uint32_t count) {
+  std::mt19937 random(42);
+  std::uniform_real_distribution<float> position(-WORLD_HALF_SIZE,
+                                                 WORLD_HALF_SIZE);
+  std::uniform_real_distribution<float> size(0.5f, 3.0f);
+  bounds.Clear();
+  bounds.Reserve(count);
+  for (uint32_t i = 0; i < count; i++) {
+    glm::vec3 extent(size(random), size(random), size(random));
+    bounds.Add(glm::vec3(position(random), position(random), position(random)),
+               glm::length(extent), extent);
+  }
+}
+
+// 轴对齐盒子的 8 个角点与 12 个三角形
+void appendBox(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices,
+               const glm::vec3 &center, const glm::vec3 &extent) {
+  static constexpr uint32_t BOX_INDICES[] = {
+      0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5, 0, 4, 5, 0, 5, 1,
+      2, 3, 7, 2, 7, 6, 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3};
+  uint32_t base = static_cast<uint32_t>(vertices.size());
+  for (int i = 0; i < 8; i++) {
+    glm::vec3 corner(i & 4 ? extent.x : -extent.x, i & 2 ? extent.y : -extent.y,
+                     i & 1 ? extent.z : -extent.z);
+    vertices.push_back({center + corner, glm::vec3(0.0f), glm::vec2(0.0f)});
+  }
+  for (uint32_t index : BOX_INDICES) {
+    indices.push_back(base + index);
+  }
+}
+
+void runOcclusionBenchmark(const CullingBounds &bounds,
+                           const glm::mat4 &viewProjection) {
+  std::vector<uint32_t> frustumVisible;
+  FrustumCuller frustumCuller;
+  frustumCuller.Cull(bounds, viewProjection, frustumVisible);
+
+  LOG_INFO("{:>9} | {:>8} {:>8} | {:>10} {:>10} {:>10}", "occluders",
+           "tested", "visible", "scalar ms", "sse2 ms", "avx2 ms");
+  std::mt19937 random(7);
+  std::uniform_real_distribution<float> lateral(-150.0f, 150.0f);
+  std::uniform_real_distribution<float> depth(-400.0f, -60.0f);
+  std::uniform_real_distribution<float> size(2.0f, 20.0f);
+  for (uint32_t occluderCount : OCCLUDER_COUNTS) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < occluderCount; i++) {
+      appendBox(vertices, indices,
+                glm::vec3(lateral(random), lateral(random) * 0.2f,
+                          depth(random)),
+                glm::vec3(size(random), size(random), size(random)));
+    }
+    OccluderMesh occluder = {vertices, indices, glm::mat4(1.0f)};
+
+    double milliseconds[3] = {};
+    std::vector<uint32_t> visible;
+    for (SimdLevel level :
+         {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2}) {
+      if (level > detectSimdLevel()) {
+        continue;
+      }
+      MaskedOcclusionCuller culler({}, ThreadPool::Get(), level);
+      milliseconds[static_cast<int>(level)] = averageMilliseconds(
+          WARMUP_FRAMES, MEASURED_FRAMES,
+          [&] {
+            culler.BeginFrame(viewProjection);
+            culler.RenderOccluders({&occluder, 1});
+            culler.FilterVisible(bounds, visible);
+          },
+          [&] { visible = frustumVisible; });
+    }
+    LOG_INFO("{:>9} | {:>8} {:>8} | {:>10.3f} {:>10.3f} {:>10.3f}",
+             occluderCount, frustumVisible.size(), visible.size(),
+             milliseconds[0], milliseconds[1], milliseconds[2]);
+  }
+}
+
+// 与 fillBounds 相同分布的轴对齐包围盒
+void fillAabbs(std::vector<Aabb> &aabbs, uint32_t count) {
+  std::mt19937 random(42);
+  std::uniform_real_distribution<float> position(-WORLD_HALF_SIZE,
+                                                 WORLD_HALF_SIZE);
+  std::uniform_real_distribution<float> size(0.5f, 3.0f);
+  aabbs.resize(count);
+  for (Aabb &aabb : aabbs) {
+    glm::vec3 center(position(random), position(random), position(random));
+    glm::vec3 extent(size(random), size(random), size(random));
+    aabb = {center - extent, center + extent};
+  }
+}
+
+void runBvhBenchmark(const glm::mat4 &viewProjection) {
+  LOG_INFO("{:>8} | {:>8} {:>6} | {:>9} {:>9} {:>9} {:>9} {:>9}", "objects",
+           "nodes", "cost", "build ms", "refit ms", "frustum", "1k rays",
+           "1k sphere");
+  std::mt19937 random(11);
+  std::uniform_real_distribution<float> position(-WORLD_HALF_SIZE,
+                                                 WORLD_HALF_SIZE);
+  std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+  std::vector<Aabb> aabbs;
+  std::vector<uint32_t> objects;
+  for (uint32_t objectCount : OBJECT_COUNTS) {
+    fillAabbs(aabbs, objectCount);
+    SceneBvh bvh;
+    double buildMs = averageMilliseconds(
+        WARMUP_FRAMES, MEASURED_FRAMES, [&] { bvh.Build(aabbs); });
+
+    // 每帧所有对象小幅移动后 Refit，代价劣化超过阈值时 Update 会重建
+    std::vector<Aabb> moved = aabbs;
+    double refitMs = averageMilliseconds(
+        WARMUP_FRAMES, MEASURED_FRAMES, [&] { bvh.Refit(moved); });
+    for (Aabb &aabb : moved) {
+      glm::vec3 delta(offset(random), offset(random), offset(random));
+      aabb.min += delta;
+      aabb.max += delta;
+    }
+    bvh.Update(moved);
+
+    double frustumMs = averageMilliseconds(
+        WARMUP_FRAMES, MEASURED_FRAMES,
+        [&] { bvh.QueryFrustum(viewProjection, objects); });
+
+    std::vector<glm::vec3> points(BVH_QUERY_COUNT * 2);
+    for (glm::vec3 &point : points) {
+      point = glm::vec3(position(random), position(random), position(random));
+    }
+    double rayMs = averageMilliseconds(WARMUP_FRAMES, MEASURED_FRAMES, [&] {
+      RayHit hit;
+      for (uint32_t i = 0; i < BVH_QUERY_COUNT; i++) {
+        bvh.Raycast(points[2 * i], points[2 * i + 1] - points[2 * i], 1.0f,
+                    hit);
+      }
+    });
+    double sphereMs = averageMilliseconds(WARMUP_FRAMES, MEASURED_FRAMES, [&] {
+      for (uint32_t i = 0; i < BVH_QUERY_COUNT; i++) {
+        bvh.QuerySphere(points[i], 20.0f, objects);
+      }
+    });
+    LOG_INFO("{:>8} | {:>8} {:>6.1f} | {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} "
+             "{:>9.3f}",
+             objectCount, bvh.GetNodeCount(), bvh.GetCost(), buildMs, refitMs,
+             frustumMs, rayMs, sphereMs);
+  }
+}
+
+void runGridBenchmark(const glm::mat4 &viewProjection) {
+  LOG_INFO("{:>8} | {:>9} | {:>9} {:>9} {:>9}", "objects", "oversized",
+           "update ms", "frustum", "1k sphere");
+  std::mt19937 random(13);
+  std::uniform_real_distribution<float> position(-WORLD_HALF_SIZE,
+                                                 WORLD_HALF_SIZE);
+  std::uniform_real_distribution<float> velocity(-1.0f, 1.0f);
+  std::vector<Aabb> aabbs;
+  std::vector<uint32_t> objects;
+  for (uint32_t objectCount : OBJECT_COUNTS) {
+    fillAabbs(aabbs, objectCount);
+    std::vector<uint32_t> ids(objectCount);
+    std::iota(ids.begin(), ids.end(), 0u);
+    SpatialHashGrid grid;
+    grid.InsertBatch(ids, aabbs);
+
+    // 每个对象以固定速度移动，每帧约有几分之一的对象跨过格子
+    std::vector<glm::vec3> velocities(objectCount);
+    for (glm::vec3 &v : velocities) {
+      v = glm::vec3(velocity(random), velocity(random), velocity(random));
+    }
+    double updateMs = averageMilliseconds(WARMUP_FRAMES, MEASURED_FRAMES, [&] {
+      for (uint32_t i = 0; i < objectCount; i++) {
+        aabbs[i].min += velocities[i];
+        aabbs[i].max += velocities[i];
+      }
+      grid.UpdateBatch(ids, aabbs);
+    });
+
+    double frustumMs = averageMilliseconds(
+        WARMUP_FRAMES, MEASURED_FRAMES,
+        [&] { grid.QueryFrustum(viewProjection, objects); });
+    std::vector<glm::vec3> centers(BVH_QUERY_COUNT);
+    for (glm::vec3 &center : centers) {
+      center = glm::vec3(position(random), position(random), position(random));
+    }
+    double sphereMs = averageMilliseconds(WARMUP_FRAMES, MEASURED_FRAMES, [&] {
+      for (const glm::vec3 &center : centers) {
+        grid.QuerySphere(center, 20.0f, objects);
+      }
+    });
+    LOG_INFO("{:>8} | {:>9} | {:>9.3f} {:>9.3f} {:>9.3f}", objectCount,
+             grid.GetOversizedCount(), updateMs, frustumMs, sphereMs);
+  }
+}
+
+// 线程数从 1 开始翻倍直到硬件线程数，调用线程也参与执行
+void runThreadScaling(const CullingBounds &bounds,
+                      const glm::mat4 &viewProjection) {
+  LOG_INFO("{:>8} | {:>8} | {:>10} {:>12}", "threads", "visible", "ms",
+           "objects/ns");
+  uint32_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  std::vector<uint32_t> visible;
+  for (uint32_t threads = 1;; threads = std::min(threads * 2, hardwareThreads)) {
+    // 单线程时线程池没有工作线程，剔除完全在调用线程上串行执行
+    ThreadPool threadPool(threads - 1);
+    FrustumCuller culler(threadPool);
+    double ms = averageMilliseconds(
+        WARMUP_FRAMES, MEASURED_FRAMES,
+        [&] { culler.Cull(bounds, viewProjection, visible); });
+    LOG_INFO("{:>8} | {:>8} | {:>10.3f} {:>12.2f}", threads, visible.size(),
+             ms, bounds.GetCount() / (ms * 1e6));
+    if (threads == hardwareThreads) {
+      break;
+    }
+  }
+}
+
+void runBenchmark() {
+  glm::mat4 viewProjection = benchViewProjection();
+  SimdLevel best = detectSimdLevel();
+  LOG_INFO("{} threads, best SIMD level {}", ThreadPool::Get().GetThreadCount(),
+           simdLevelName(best));
+  LOG_INFO("{:>8} | {:>8} | {:>10} {:>10} {:>10}", "objects", "visible",
+           "scalar ms", "sse2 ms", "avx2 ms");
+
+  CullingBounds bounds;
+  std::vector<uint32_t> visible;
+  for (uint32_t objectCount : OBJECT_COUNTS) {
+    fillBounds(bounds, objectCount);
+    double milliseconds[3] = {};
+    for (SimdLevel level :
+         {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2}) {
+      if (level > best) {
+        continue;
+      }
+      FrustumCuller culler(ThreadPool::Get(), level);
+      milliseconds[static_cast<int>(level)] =
+          averageMilliseconds(WARMUP_FRAMES, MEASURED_FRAMES, [&] {
+            culler.Cull(bounds, viewProjection, visible);
+          });
+    }
+    LOG_INFO("{:>8} | {:>8} | {:>10.3f} {:>10.3f} {:>10.3f}", objectCount,
+             visible.size(), milliseconds[0], milliseconds[1], milliseconds[2]);
+  }
+
+  // bounds 此时为最后一组，即 100 万个对象
+  runThreadScaling(bounds, viewProjection);
+
+  // 遮挡剔除接在 100000 个对象的视锥剔除之后
+  fillBounds(bounds, OBJECT_COUNTS[1]);
+  runOcclusionBenchmark(bounds, viewProjection);
+
+  runBvhBenchmark(viewProjection);
+  runGridBenchmark(viewProjection);
+}
+} // namespace
+
+int main() {
+  Log::Init();
+
+  try {
+    runBenchmark();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
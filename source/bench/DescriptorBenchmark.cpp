@@ -0,0 +1,248 @@
+// 描述符池路径与 VK_EXT_descriptor_buffer 路径的 CPU 开销对比：
+// 每帧为 N 次绘制各准备一个描述符集（1 个 UBO + 2 个组合图像采样器），
+// 分别统计“分配 + 写入”与“录制绑定命令”的耗时。
+#include "BenchDevice.hpp"
+
+#include "Vulkan/DescriptorAllocator.hpp"
+#include "Vulkan/DescriptorBuffer.hpp"
+#include "Vulkan/VkUtils.hpp"
+#include "utils/log.hpp"
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+
+namespace {
+constexpr uint32_t FRAMES_IN_FLIGHT = 2;
+constexpr uint32_t MEASURED_FRAMES = 20;
+constexpr uint32_t WARMUP_FRAMES = 3;
+constexpr uint32_t DRAW_COUNTS[] = {1000, 10000, 100000};
+
+struct BenchResources {
+  VkBuffer uniformBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory uniformMemory = VK_NULL_HANDLE;
+  VkImage image = VK_NULL_HANDLE;
+  VkDeviceMemory imageMemory = VK_NULL_HANDLE;
+  VkImageView imageView = VK_NULL_HANDLE;
+  VkSampler sampler = VK_NULL_HANDLE;
+
+  DescriptorWrite writes[3];
+};
+
+struct FrameTiming {
+  double updateMs = 0.0; // 分配 + 写入描述符
+  double recordMs = 0.0; // 录制每次绘制的绑定命令
+};
+
+const std::vector<DescriptorBinding> BENCH_BINDINGS = {
+    {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT},
+    {1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2,
+     VK_SHADER_STAGE_FRAGMENT_BIT},
+};
+
+VkPipelineLayout createPipelineLayout(const VkContext &context,
+                                      VkDescriptorSetLayout setLayout) {
+  VkPipelineLayoutCreateInfo layoutInfo = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+      .setLayoutCount = 1,
+      .pSetLayouts = &setLayout,
+  };
+  VkPipelineLayout layout;
+  if (vkCreatePipelineLayout(context.device, &layoutInfo, nullptr, &layout) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("failed to create pipeline layout!");
+  }
+  return layout;
+}
+
+void createResources(const VkContext &context, BenchResources &resources) {
+  VkBufferUsageFlags usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+  if (context.features12.bufferDeviceAddress) {
+    usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+  }
+  createBuffer(context, 256, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+               resources.uniformBuffer, resources.uniformMemory);
+
+  createImage(context, 1, 1, 1, 1, VK_FORMAT_R8G8B8A8_UNORM,
+              VK_IMAGE_USAGE_SAMPLED_BIT, resources.image,
+              resources.imageMemory);
+  resources.imageView =
+      createImageView(context, resources.image, VK_FORMAT_R8G8B8A8_UNORM,
+                      VK_IMAGE_VIEW_TYPE_2D, 1, 1);
+
+  VkSamplerCreateInfo samplerInfo = {
+      .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+      .magFilter = VK_FILTER_LINEAR,
+      .minFilter = VK_FILTER_LINEAR,
+  };
+  vkCreateSampler(context.device, &samplerInfo, nullptr, &resources.sampler);
+
+  resources.writes[0].buffer = {resources.uniformBuffer, 0, 256};
+  for (uint32_t i = 1; i < 3; i++) {
+    resources.writes[i].image = {resources.sampler, resources.imageView,
+                                 VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+  }
+}
+
+void destroyResources(const VkContext &context, BenchResources &resources) {
+  vkDestroySampler(context.device, resources.sampler, nullptr);
+  vkDestroyImageView(context.device, resources.imageView, nullptr);
+  vkDestroyImage(context.device, resources.image, nullptr);
+  vkFreeMemory(context.device, resources.imageMemory, nullptr);
+  vkDestroyBuffer(context.device, resources.uniformBuffer, nullptr);
+  vkFreeMemory(context.device, resources.uniformMemory, nullptr);
+}
+
+void beginRecording(VkCommandBuffer commandBuffer) {
+  vkResetCommandBuffer(commandBuffer, 0);
+  VkCommandBufferBeginInfo beginInfo = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+  };
+  vkBeginCommandBuffer(commandBuffer, &beginInfo);
+}
+
+// 描述符池路径：每帧重置池，逐次分配 + 模板写入 + vkCmdBindDescriptorSets
+FrameTiming runPoolFrame(uint64_t frame, uint32_t drawCount,
+                         FrameDescriptorAllocator &allocator,
+                         const DescriptorLayout &layout,
+                         VkPipelineLayout pipelineLayout,
+                         const BenchResources &resources,
+                         VkCommandBuffer commandBuffer,
+                         std::vector<VkDescriptorSet> &sets) {
+  FrameTiming timing;
+  timing.updateMs = measureMilliseconds([&] {
+    allocator.BeginFrame(frame);
+    for (uint32_t i = 0; i < drawCount; i++) {
+      sets[i] = allocator.Allocate(layout);
+      layout.Write(sets[i], resources.writes);
+    }
+  });
+
+  beginRecording(commandBuffer);
+  timing.recordMs = measureMilliseconds([&] {
+    for (uint32_t i = 0; i < drawCount; i++) {
+      vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                              pipelineLayout, 0, 1, &sets[i], 0, nullptr);
+    }
+  });
+  vkEndCommandBuffer(commandBuffer);
+  return timing;
+}
+
+// 描述符缓冲路径：线性分配 + vkGetDescriptorEXT 写入 + 按偏移绑定
+FrameTiming runBufferFrame(uint64_t frame, uint32_t drawCount,
+                           DescriptorBuffer &descriptorBuffer,
+                           const DescriptorLayout &layout,
+                           VkPipelineLayout pipelineLayout,
+                           const BenchResources &resources,
+                           VkCommandBuffer commandBuffer,
+                           std::vector<DescriptorBufferSet> &sets) {
+  FrameTiming timing;
+  timing.updateMs = measureMilliseconds([&] {
+    descriptorBuffer.BeginFrame(frame);
+    for (uint32_t i = 0; i < drawCount; i++) {
+      sets[i] = descriptorBuffer.Allocate(layout);
+      descriptorBuffer.Write(sets[i], layout, resources.writes);
+    }
+  });
+
+  beginRecording(commandBuffer);
+  timing.recordMs = measureMilliseconds([&] {
+    descriptorBuffer.BindBuffer(commandBuffer);
+    for (uint32_t i = 0; i < drawCount; i++) {
+      descriptorBuffer.BindSet(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                               pipelineLayout, 0, sets[i]);
+    }
+  });
+  vkEndCommandBuffer(commandBuffer);
+  return timing;
+}
+
+template <typename RunFrame>
+FrameTiming measureAverage(RunFrame &&runFrame) {
+  FrameTiming total;
+  for (uint32_t frame = 0; frame < WARMUP_FRAMES + MEASURED_FRAMES; frame++) {
+    FrameTiming timing = runFrame(frame);
+    if (frame >= WARMUP_FRAMES) {
+      total.updateMs += timing.updateMs;
+      total.recordMs += timing.recordMs;
+    }
+  }
+  total.updateMs /= MEASURED_FRAMES;
+  total.recordMs /= MEASURED_FRAMES;
+  return total;
+}
+
+void runBenchmark() {
+  BenchDevice device({VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME,
+                      VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME});
+  const VkContext &context = device.GetContext();
+  VkCommandBuffer commandBuffer = device.AllocateCommandBuffer();
+
+  BenchResources resources;
+  createResources(context, resources);
+
+  DescriptorLayout poolLayout(context, BENCH_BINDINGS);
+  VkPipelineLayout poolPipelineLayout =
+      createPipelineLayout(context, poolLayout.Get());
+  FrameDescriptorAllocator allocator(context, FRAMES_IN_FLIGHT);
+
+  bool bufferSupported = DescriptorBuffer::IsSupported(context);
+  if (!bufferSupported) {
+    LOG_WARN("VK_EXT_descriptor_buffer not available, only the pool path is "
+             "measured");
+  }
+
+  LOG_INFO("{:>8} | {:>12} {:>12} | {:>12} {:>12}", "draws", "pool upd ms",
+           "pool rec ms", "dbuf upd ms", "dbuf rec ms");
+
+  for (uint32_t drawCount : DRAW_COUNTS) {
+    std::vector<VkDescriptorSet> poolSets(drawCount);
+    FrameTiming pool = measureAverage([&](uint64_t frame) {
+      return runPoolFrame(frame, drawCount, allocator, poolLayout,
+                          poolPipelineLayout, resources, commandBuffer,
+                          poolSets);
+    });
+
+    FrameTiming buffer;
+    if (bufferSupported) {
+      DescriptorLayout bufferLayout(
+          context, BENCH_BINDINGS,
+          VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT);
+      VkPipelineLayout bufferPipelineLayout =
+          createPipelineLayout(context, bufferLayout.Get());
+      DescriptorBuffer descriptorBuffer(context, FRAMES_IN_FLIGHT,
+                                        VkDeviceSize(drawCount) * 512);
+      descriptorBuffer.RegisterBuffer(resources.uniformBuffer);
+      std::vector<DescriptorBufferSet> bufferSets(drawCount);
+
+      buffer = measureAverage([&](uint64_t frame) {
+        return runBufferFrame(frame, drawCount, descriptorBuffer, bufferLayout,
+                              bufferPipelineLayout, resources, commandBuffer,
+                              bufferSets);
+      });
+      vkDestroyPipelineLayout(context.device, bufferPipelineLayout, nullptr);
+    }
+
+    LOG_INFO("{:>8} | {:>12.3f} {:>12.3f} | {:>12.3f} {:>12.3f}", drawCount,
+             pool.updateMs, pool.recordMs, buffer.updateMs, buffer.recordMs);
+  }
+
+  vkDestroyPipelineLayout(context.device, poolPipelineLayout, nullptr);
+  destroyResources(context, resources);
+}
+} // namespace
+
+int main() {
+  Log::Init();
+
+  try {
+    runBenchmark();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
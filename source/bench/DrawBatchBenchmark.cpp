@@ -0,0 +1,161 @@
+// 绘制提交的 CPU 开销，只用 CPU，不创建 Vulkan 设备：
+// - 合批：可见对象按 (管线, 材质, 网格, LOD) 合并成实例化绘制，统计分组与写入实例数据的耗时，
+//   以及合批后的绘制次数。对象的渲染状态分别按场景顺序（相同状态的对象相邻）与随机顺序排列
+// - 排序：绘制包按 64 位排序键做并行基数排序并生成命令流，与 std::sort 对比，
+//   并统计排序前后的绑定次数
+#include "BenchDevice.hpp"
+
+#include "Scene/DrawBatcher.hpp"
+#include "Scene/DrawQueue.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr uint32_t MEASURED_FRAMES = 50;
+constexpr uint32_t WARMUP_FRAMES = 5;
+constexpr uint32_t VISIBLE_COUNTS[] = {10000, 100000};
+constexpr uint32_t STATE_COUNTS[] = {16, 256, 4096};
+constexpr uint32_t PIPELINE_COUNT = 4;
+constexpr uint32_t MATERIALS_PER_PIPELINE = 8;
+constexpr uint32_t PACKET_COUNTS[] = {10000, 100000, 1000000};
+constexpr uint32_t PACKET_MATERIALS = 256;
+constexpr uint32_t PACKET_MESHES = 1024;
+constexpr uint32_t OPAQUE_PASS = 0;
+constexpr uint32_t TRANSPARENT_PASS = 1;
+
+// stateCount 种渲染状态，对象 i 的状态为 states[i]
+std::vector<DrawObject> makeObjects(uint32_t objectCount, uint32_t stateCount,
+                                    bool shuffled) {
+  std::vector<uint32_t> states(objectCount);
+  for (uint32_t i = 0; i < objectCount; i++) {
+    states[i] = uint32_t(uint64_t(i) * stateCount / objectCount);
+  }
+  if (shuffled) {
+    std::shuffle(states.begin(), states.end(), std::mt19937(42));
+  }
+  std::vector<DrawObject> objects(objectCount);
+  for (uint32_t i = 0; i < objectCount; i++) {
+    uint32_t state = states[i];
+    objects[i] = {
+        .pipeline = state % PIPELINE_COUNT,
+        .material = state / PIPELINE_COUNT % MATERIALS_PER_PIPELINE,
+        .mesh = state / (PIPELINE_COUNT * MATERIALS_PER_PIPELINE),
+        .lod = 0,
+        .materialIndex = i % 1024,
+    };
+  }
+  return objects;
+}
+
+// 按提交顺序逐个绑定时，状态与上一个绘制不同就需要重新绑定
+uint32_t countUnsortedBinds(std::span<const DrawPacket> packets) {
+  uint32_t binds = 0;
+  for (size_t i = 0; i < packets.size(); i++) {
+    bool pipelineChanged =
+        i == 0 || packets[i].pipeline != packets[i - 1].pipeline;
+    binds += pipelineChanged;
+    binds += pipelineChanged || packets[i].material != packets[i - 1].material;
+    binds += i == 0 || packets[i].mesh != packets[i - 1].mesh;
+  }
+  return binds;
+}
+
+// 随机状态与深度的绘制包，约八分之一为半透明
+void runSortBenchmark() {
+  LOG_INFO("{:>8} | {:>8} {:>8} | {:>10} {:>10}", "packets", "binds",
+           "sorted", "radix ms", "std ms");
+
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> depthDistribution(0.1f, 1000.0f);
+  DrawQueue queue;
+  for (uint32_t packetCount : PACKET_COUNTS) {
+    queue.Clear();
+    std::span<DrawPacket> packets = queue.Append(packetCount);
+    for (uint32_t i = 0; i < packetCount; i++) {
+      DrawPacket &packet = packets[i];
+      packet = {
+          .sortKey = 0,
+          .pipeline = uint32_t(rng() % PIPELINE_COUNT),
+          .material = uint32_t(rng() % PACKET_MATERIALS),
+          .mesh = uint32_t(rng() % PACKET_MESHES),
+          .lod = 0,
+          .firstInstance = i,
+          .instanceCount = 1,
+      };
+      bool transparent = rng() % 8 == 0;
+      packet.sortKey = DrawQueue::MakeSortKey(
+          transparent ? TRANSPARENT_PASS : OPAQUE_PASS,
+          transparent ? DepthOrder::BackToFront : DepthOrder::FrontToBack,
+          packet, depthDistribution(rng));
+    }
+
+    double radixMs = averageMilliseconds(
+        WARMUP_FRAMES, MEASURED_FRAMES, [&] { queue.Sort(); });
+    // 对照：同样排序 (键, 下标)，键相同时按下标保持提交顺序
+    std::vector<std::pair<uint64_t, uint32_t>> items(packetCount);
+    double stdMs = averageMilliseconds(WARMUP_FRAMES, MEASURED_FRAMES, [&] {
+      for (uint32_t i = 0; i < packetCount; i++) {
+        items[i] = {packets[i].sortKey, i};
+      }
+      std::sort(items.begin(), items.end());
+    });
+
+    const DrawStreamStats &stats = queue.GetStats();
+    LOG_INFO("{:>8} | {:>8} {:>8} | {:>10.3f} {:>10.3f}", packetCount,
+             countUnsortedBinds(packets),
+             stats.pipelineBinds + stats.materialBinds + stats.meshBinds,
+             radixMs, stdMs);
+  }
+}
+
+void runBatchBenchmark() {
+  LOG_INFO("{} threads", ThreadPool::Get().GetThreadCount());
+  LOG_INFO("{:>8} {:>6} {:>8} | {:>8} | {:>10}", "visible", "states", "order",
+           "batches", "build ms");
+
+  DrawBatcher batcher;
+  for (uint32_t visibleCount : VISIBLE_COUNTS) {
+    // 只有一半对象可见，模拟剔除后的稀疏编号
+    uint32_t objectCount = visibleCount * 2;
+    std::vector<glm::mat4> transforms(objectCount, glm::mat4(1.0f));
+    std::vector<uint32_t> visible(visibleCount);
+    for (uint32_t i = 0; i < visibleCount; i++) {
+      visible[i] = i * 2;
+    }
+    std::vector<InstanceData> instances(visibleCount);
+
+    for (uint32_t stateCount : STATE_COUNTS) {
+      for (bool shuffled : {false, true}) {
+        std::vector<DrawObject> objects =
+            makeObjects(objectCount, stateCount, shuffled);
+        double ms = averageMilliseconds(
+            WARMUP_FRAMES, MEASURED_FRAMES,
+            [&] { batcher.Build(objects, transforms, visible, instances); });
+        LOG_INFO("{:>8} {:>6} {:>8} | {:>8} | {:>10.3f}", visibleCount,
+                 stateCount, shuffled ? "random" : "scene",
+                 batcher.GetBatches().size(), ms);
+      }
+    }
+  }
+}
+} // namespace
+
+int main() {
+  Log::Init();
+
+  try {
+    runBatchBenchmark();
+    runSortBenchmark();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+// 每次绘制数据两条路径的 CPU 开销对比：推送常量与动态偏移 UBO 环形缓冲。
+// 每帧为 N 次绘制各准备一份 payload，统计“写入数据 + 录制命令”的耗时，
+// 用于为不同大小的材质数据选择更快的路径。
+#include "BenchDevice.hpp"
+
+#include "Vulkan/PerDrawData.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <vector>
+
+namespace {
+constexpr uint32_t FRAMES_IN_FLIGHT = 2;
+constexpr uint32_t MEASURED_FRAMES = 20;
+constexpr uint32_t WARMUP_FRAMES = 3;
+constexpr uint32_t DRAW_COUNTS[] = {10000, 100000};
+constexpr uint32_t PAYLOAD_SIZES[] = {16, 64, 128, 256};
+
+VkPipelineLayout createPipelineLayout(const VkContext &context,
+                                      VkDescriptorSetLayout setLayout) {
+  VkPushConstantRange pushConstantRange = perDrawPushConstantRange();
+  VkPipelineLayoutCreateInfo layoutInfo = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+      .setLayoutCount = 1,
+      .pSetLayouts = &setLayout,
+      .pushConstantRangeCount = 1,
+      .pPushConstantRanges = &pushConstantRange,
+  };
+  VkPipelineLayout layout;
+  if (vkCreatePipelineLayout(context.device, &layoutInfo, nullptr, &layout) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("failed to create pipeline layout!");
+  }
+  return layout;
+}
+
+void beginRecording(VkCommandBuffer commandBuffer) {
+  vkResetCommandBuffer(commandBuffer, 0);
+  VkCommandBufferBeginInfo beginInfo = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+  };
+  vkBeginCommandBuffer(commandBuffer, &beginInfo);
+}
+
+// 模拟每次绘制的数据来源：应用侧按绘制顺序排列好的 payload
+std::vector<uint8_t> makePayloads(uint32_t drawCount, uint32_t size) {
+  std::vector<uint8_t> payloads(size_t(drawCount) * size);
+  for (size_t i = 0; i < payloads.size(); i++) {
+    payloads[i] = static_cast<uint8_t>(i);
+  }
+  return payloads;
+}
+
+// 推送常量路径：payload 直接写进命令缓冲
+double runPushFrame(uint32_t drawCount, uint32_t size,
+                    const std::vector<uint8_t> &payloads,
+                    VkPipelineLayout pipelineLayout,
+                    VkCommandBuffer commandBuffer) {
+  beginRecording(commandBuffer);
+  double ms = measureMilliseconds([&] {
+    for (uint32_t i = 0; i < drawCount; i++) {
+      cmdPushPerDraw(commandBuffer, pipelineLayout,
+                     payloads.data() + size_t(i) * size, size);
+    }
+  });
+  vkEndCommandBuffer(commandBuffer);
+  return ms;
+}
+
+// 动态 UBO 路径：子分配 + 拷贝到映射内存 + 以动态偏移重新绑定同一个描述符集
+double runUniformFrame(uint64_t frame, uint32_t drawCount, uint32_t size,
+                       const std::vector<uint8_t> &payloads,
+                       PerDrawUniformRing &ring,
+                       VkPipelineLayout pipelineLayout,
+                       VkCommandBuffer commandBuffer) {
+  beginRecording(commandBuffer);
+  double ms = measureMilliseconds([&] {
+    ring.BeginFrame(frame);
+    for (uint32_t i = 0; i < drawCount; i++) {
+      PerDrawAllocation allocation = ring.Allocate(size);
+      std::memcpy(allocation.mapped, payloads.data() + size_t(i) * size, size);
+      ring.Bind(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout,
+                0, allocation.dynamicOffset);
+    }
+  });
+  vkEndCommandBuffer(commandBuffer);
+  return ms;
+}
+
+template <typename RunFrame> double measureAverage(RunFrame &&runFrame) {
+  double total = 0.0;
+  for (uint32_t frame = 0; frame < WARMUP_FRAMES + MEASURED_FRAMES; frame++) {
+    double ms = runFrame(frame);
+    if (frame >= WARMUP_FRAMES) {
+      total += ms;
+    }
+  }
+  return total / MEASURED_FRAMES;
+}
+
+void runBenchmark() {
+  BenchDevice device;
+  const VkContext &context = device.GetContext();
+  VkCommandBuffer commandBuffer = device.AllocateCommandBuffer();
+
+  LOG_INFO("{:>8} {:>8} | {:>12} {:>12} | {:>8}", "draws", "bytes", "push ms",
+           "dyn ubo ms", "faster");
+
+  for (uint32_t drawCount : DRAW_COUNTS) {
+    // 每帧区域按最大 payload 与最坏对齐留足空间
+    VkDeviceSize alignment = std::max<VkDeviceSize>(
+        context.limits.minUniformBufferOffsetAlignment, 256);
+    PerDrawUniformRing ring(context,
+                            {
+                                .framesInFlight = FRAMES_IN_FLIGHT,
+                                .maxDrawSize = 256,
+                                .bytesPerFrame = drawCount * alignment,
+                            });
+    VkPipelineLayout pipelineLayout =
+        createPipelineLayout(context, ring.GetSetLayout());
+
+    for (uint32_t size : PAYLOAD_SIZES) {
+      std::vector<uint8_t> payloads = makePayloads(drawCount, size);
+
+      bool pushFits = size <= PER_DRAW_PUSH_CONSTANT_SIZE &&
+                      size <= context.limits.maxPushConstantsSize;
+      double pushMs = 0.0;
+      if (pushFits) {
+        pushMs = measureAverage([&](uint64_t) {
+          return runPushFrame(drawCount, size, payloads, pipelineLayout,
+                              commandBuffer);
+        });
+      }
+      double uniformMs = measureAverage([&](uint64_t frame) {
+        return runUniformFrame(frame, drawCount, size, payloads, ring,
+                               pipelineLayout, commandBuffer);
+      });
+
+      const char *faster =
+          !pushFits || uniformMs < pushMs ? "dyn ubo" : "push";
+      if (pushFits) {
+        LOG_INFO("{:>8} {:>8} | {:>12.3f} {:>12.3f} | {:>8}", drawCount, size,
+                 pushMs, uniformMs, faster);
+      } else {
+        LOG_INFO("{:>8} {:>8} | {:>12} {:>12.3f} | {:>8}", drawCount, size,
+                 "-", uniformMs, faster);
+      }
+    }
+
+    vkDestroyPipelineLayout(context.device, pipelineLayout, nullptr);
+  }
+}
+} // namespace
+
+int main() {
+  Log::Init();
+
+  try {
+    runBenchmark();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
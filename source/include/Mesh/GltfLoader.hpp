@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Mesh/Mesh.hpp"
+#include "utils/MappedFile.hpp"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// glTF 访问器在已映射缓冲上的零拷贝视图
+struct GltfAccessor {
+  const uint8_t *data = nullptr; // 第一个元素
+  uint32_t count = 0;
+  uint32_t stride = 0;         // 相邻元素间的字节数
+  uint32_t componentType = 0;  // 5120 BYTE ~ 5126 FLOAT
+  uint32_t componentCount = 0; // SCALAR = 1 ... MAT4 = 16
+  bool normalized = false;
+
+  bool IsValid() const { return data != nullptr; }
+};
+
+// 一个三角形图元，normals / uvs / indices 可能无效
+struct GltfPrimitive {
+  GltfAccessor positions;
+  GltfAccessor normals;
+  GltfAccessor uvs;
+  GltfAccessor indices;
+  int32_t material = -1;
+};
+
+struct GltfMesh {
+  std::string name;
+  std::vector<GltfPrimitive> primitives;
+};
+
+// 默认场景中引用网格的节点，变换已沿节点层级累乘
+struct GltfMeshInstance {
+  uint32_t mesh;
+  glm::mat4 transform;
+};
+
+// glTF 2.0 模型（.gltf + 外部 .bin，或 .glb）：
+// JSON 由 JsonReader 流式解析，二进制缓冲保持内存映射，
+// 访问器直接指向映射内存，上传时逐元素写入暂存缓冲，只拷贝一次。
+// 访问器在 GltfModel 销毁前有效。
+//
+// 不支持：稀疏访问器、data URI 内嵌缓冲、非三角形列表图元（加载时跳过）。
+class GltfModel {
+public:
+  explicit GltfModel(const std::string &filename);
+
+  GltfModel(const GltfModel &) = delete;
+  GltfModel &operator=(const GltfModel &) = delete;
+
+  const std::vector<GltfMesh> &GetMeshes() const { return m_meshes; }
+  const std::vector<GltfMeshInstance> &GetInstances() const {
+    return m_instances;
+  }
+
+  // 上传一个图元；顶点按 Vertex 布局从映射缓冲直接写入暂存内存
+  std::unique_ptr<Mesh> CreateMesh(const VkContext &context,
+                                   VkCommandPool commandPool,
+                                   const GltfPrimitive &primitive) const;
+
+  static uint32_t GetIndexCount(const GltfPrimitive &primitive);
+  static void WritePrimitive(const GltfPrimitive &primitive, Vertex *vertices,
+                             void *indices, VkIndexType indexType);
+
+private:
+  struct BufferData {
+    const uint8_t *data;
+    size_t size;
+  };
+
+  void loadGlb(const std::string &filename);
+  void loadGltf(const std::string &filename);
+  void parse(std::string_view json, const std::string &directory,
+             BufferData glbBinary);
+
+private:
+  std::vector<std::unique_ptr<MappedFile>> m_files; // 保持映射，访问器指向其中
+  std::vector<GltfMesh> m_meshes;
+  std::vector<GltfMeshInstance> m_instances;
+};
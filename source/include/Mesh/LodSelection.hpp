@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Mesh/Mesh.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+
+// 按屏幕空间误差选择 LOD：把每级记录的对象空间误差投影到屏幕上，
+// 选择投影误差不超过 pixelError 像素的最粗一级。
+struct LodSelectionParams {
+  float projectionScale; // 见 lodProjectionScale，距离 1 处一单位长度对应的像素数
+  float pixelError = 1.0f;
+};
+
+// 透视投影下距离为 1 时单位长度覆盖的像素数
+float lodProjectionScale(float viewportHeight, float fovY);
+
+// 对象空间误差 error 在 distance 处的屏幕像素数
+inline float projectedLodError(float error, float distance,
+                               float projectionScale) {
+  return error * projectionScale / distance;
+}
+
+// bounds 为对象空间包围球，model 的最大轴缩放同时作用于半径与误差；
+// 相机位于包围球内时始终返回 LOD 0
+uint32_t selectLod(std::span<const MeshLod> lods, const MeshBounds &bounds,
+                   const glm::mat4 &model, const glm::vec3 &cameraPosition,
+                   const LodSelectionParams &params);
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Mesh/Vertex.hpp"
+#include "Mesh/VertexQuantization.hpp"
+#include "Vulkan/VkContext.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// 轴对齐包围盒与包围球
+struct MeshBounds {
+  glm::vec3 min;
+  glm::vec3 max;
+  glm::vec3 center;
+  float radius;
+};
+
+// 一级 LOD 在索引数组中的区间，error 为相对原始网格的几何误差（对象空间）
+struct MeshLod {
+  uint32_t firstIndex;
+  uint32_t indexCount;
+  float error;
+};
+
+// CPU 端网格数据，索引统一以 32 位保存，上传时再决定 GPU 端位宽
+struct MeshData {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  std::vector<MeshLod> lods; // 为空时整个索引数组是唯一的一级 LOD
+};
+
+MeshBounds computeMeshBounds(const std::vector<Vertex> &vertices);
+
+// 顶点数不超过 UINT16_MAX 时使用 16 位索引（保留 0xFFFF 作为图元重启值）
+VkIndexType selectIndexType(size_t vertexCount);
+
+// 把顶点与索引直接写入映射好的暂存内存，indices 的元素类型由 indexType 决定
+using MeshWriter = std::function<void(Vertex *vertices, void *indices,
+                                      VkIndexType indexType)>;
+using QuantizedMeshWriter = std::function<void(
+    QuantizedVertex *vertices, void *indices, VkIndexType indexType)>;
+
+// 上传时的顶点格式：Quantized 的顶点缓冲为 Vertex 的一半，
+// 需配合 VertexLayoutOf<QuantizedVertex> 的管线和 GetDequantization() 使用
+enum class VertexCompression {
+  None,
+  Quantized,
+};
+
+// 设备本地的顶点缓冲与索引缓冲，构造时经同一个暂存缓冲一次性上传
+class Mesh {
+public:
+  Mesh(const VkContext &context, VkCommandPool commandPool,
+       const MeshData &data,
+       VertexCompression compression = VertexCompression::None);
+  // 由 write 直接填充暂存内存，加载器无需先构造 MeshData 等中间数组
+  Mesh(const VkContext &context, VkCommandPool commandPool,
+       uint32_t vertexCount, uint32_t indexCount, const MeshWriter &write);
+  Mesh(const VkContext &context, VkCommandPool commandPool,
+       uint32_t vertexCount, uint32_t indexCount,
+       const VertexDequantization &dequantization,
+       const QuantizedMeshWriter &write);
+  ~Mesh();
+
+  Mesh(const Mesh &) = delete;
+  Mesh &operator=(const Mesh &) = delete;
+
+  void Bind(VkCommandBuffer commandBuffer) const;
+  // 绘制最精细的一级（LOD 0）
+  void Draw(VkCommandBuffer commandBuffer, uint32_t instanceCount = 1,
+            uint32_t firstInstance = 0) const;
+  // 绘制指定 LOD，超出范围时取最粗的一级
+  void DrawLod(VkCommandBuffer commandBuffer, uint32_t lod,
+               uint32_t instanceCount = 1, uint32_t firstInstance = 0) const;
+
+  // 索引缓冲中各级 LOD 的区间，为空时整个索引缓冲是唯一的一级
+  void SetLods(std::vector<MeshLod> lods) { m_lods = std::move(lods); }
+  const std::vector<MeshLod> &GetLods() const { return m_lods; }
+  uint32_t GetLodCount() const {
+    return m_lods.empty() ? 1 : static_cast<uint32_t>(m_lods.size());
+  }
+
+  uint32_t GetVertexCount() const { return m_vertexCount; }
+  uint32_t GetIndexCount() const { return m_indexCount; }
+  VkIndexType GetIndexType() const { return m_indexType; }
+  uint32_t GetVertexStride() const { return m_vertexStride; }
+  bool IsQuantized() const { return m_vertexStride == sizeof(QuantizedVertex); }
+  // 未量化时为单位变换
+  const VertexDequantization &GetDequantization() const {
+    return m_dequantization;
+  }
+
+private:
+  using RawWriter =
+      std::function<void(void *vertices, void *indices, VkIndexType)>;
+
+  Mesh(const VkContext &context, uint32_t vertexStride, uint32_t vertexCount,
+       uint32_t indexCount, const VertexDequantization &dequantization);
+  void upload(VkCommandPool commandPool, const RawWriter &write);
+
+private:
+  const VkContext &m_context;
+
+  VkBuffer m_vertexBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_vertexMemory = VK_NULL_HANDLE;
+  VkBuffer m_indexBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_indexMemory = VK_NULL_HANDLE;
+
+  uint32_t m_vertexStride = sizeof(Vertex);
+  uint32_t m_vertexCount = 0;
+  uint32_t m_indexCount = 0;
+  VkIndexType m_indexType = VK_INDEX_TYPE_UINT32;
+  VertexDequantization m_dequantization;
+  std::vector<MeshLod> m_lods;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Mesh/Mesh.hpp"
+#include "utils/MappedFile.hpp"
+
+#include <memory>
+#include <span>
+#include <string>
+
+// 二进制网格缓存：数据按运行时布局原样存放（顶点即 Vertex 数组，索引已按位宽收窄），
+// 加载时只需映射文件并拷贝进暂存缓冲，不做任何解析。
+//
+// 文件布局（小端，各段 16 字节对齐）：
+//   MeshCacheHeader | MeshLod[lodCount] | Vertex[vertexCount] | 索引
+// 版本号、顶点布局哈希或源文件时间戳不一致时缓存视为失效。
+constexpr uint32_t MESH_CACHE_MAGIC = 0x434D564C; // "LVMC"
+constexpr uint32_t MESH_CACHE_VERSION = 3;
+
+struct MeshCacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t layoutHash;  // VertexLayoutOf<Vertex>::LAYOUT_HASH
+  uint64_t sourceStamp; // 源文件大小与修改时间
+  uint32_t vertexCount;
+  uint32_t indexCount;
+  uint32_t indexType; // VkIndexType
+  uint32_t lodCount;
+  MeshBounds bounds;
+  uint64_t lodOffset;
+  uint64_t vertexOffset;
+  uint64_t indexOffset;
+};
+
+// 源文件的时间戳，文件不存在时返回 0
+uint64_t meshSourceStamp(const std::string &sourcePath);
+
+// 按扩展名导入 .obj / .gltf / .glb，生成 LOD 链后执行 optimizeMesh；
+// glTF 的所有图元合并为一个网格（忽略节点变换）
+MeshData importMesh(const std::string &sourcePath);
+
+// 写入缓存文件（先写临时文件再重命名，避免留下半个文件）
+void writeMeshCache(const std::string &cachePath, const MeshData &mesh,
+                    uint64_t sourceStamp);
+
+class MeshCache {
+public:
+  // 文件不存在或已失效时返回空
+  static std::unique_ptr<MeshCache> Open(const std::string &cachePath,
+                                         uint64_t sourceStamp);
+
+  const MeshCacheHeader &GetHeader() const { return m_header; }
+  const MeshBounds &GetBounds() const { return m_header.bounds; }
+  std::span<const MeshLod> GetLods() const {
+    return {m_lods, m_header.lodCount};
+  }
+
+  // 从映射内存直接拷入暂存缓冲并上传；量化时按缓存中的包围盒逐顶点压缩写入
+  std::unique_ptr<Mesh>
+  CreateMesh(const VkContext &context, VkCommandPool commandPool,
+             VertexCompression compression = VertexCompression::None) const;
+
+private:
+  explicit MeshCache(std::unique_ptr<MappedFile> file)
+      : m_file(std::move(file)) {}
+
+private:
+  std::unique_ptr<MappedFile> m_file;
+  MeshCacheHeader m_header{};
+  const MeshLod *m_lods = nullptr;
+  const uint8_t *m_vertices = nullptr;
+  const uint8_t *m_indices = nullptr;
+};
+
+// 导入入口：缓存有效时直接打开，否则导入源文件、写缓存后再打开。
+// 缓存文件为 sourcePath + ".meshcache"
+std::unique_ptr<MeshCache> loadMeshCached(const std::string &sourcePath);
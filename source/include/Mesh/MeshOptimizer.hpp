@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Mesh/Mesh.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// 导入阶段的网格优化，均只重排数据，不改变渲染结果：
+// 1. 顶点缓存：Tipsify 重排三角形，减少顶点着色器的重复调用
+// 2. 过度绘制：在不明显破坏缓存命中的前提下切分三角形簇，
+//    按簇朝外程度排序，使外侧的面先绘制，提前深度测试剔除更多片元
+// 3. 顶点读取：按首次引用顺序重排顶点并重映射索引，去掉未引用的顶点
+
+// 典型的后变换缓存大小（FIFO 近似）
+constexpr uint32_t VERTEX_CACHE_SIZE = 16;
+
+struct VertexCacheStats {
+  float acmr;      // 平均每个三角形的缓存缺失数，下限 0.5 左右，最坏 3
+  float atvr;      // 变换次数 / 被引用顶点数，理想为 1
+  float overfetch; // 读取的缓存行字节 / 被引用顶点字节，理想为 1
+};
+
+VertexCacheStats analyzeVertexCache(const uint32_t *indices,
+                                    size_t indexCount, size_t vertexCount,
+                                    uint32_t cacheSize = VERTEX_CACHE_SIZE);
+
+void optimizeVertexCache(uint32_t *indices, size_t indexCount,
+                         size_t vertexCount,
+                         uint32_t cacheSize = VERTEX_CACHE_SIZE);
+
+// 需在 optimizeVertexCache 之后调用；threshold 为簇内 ACMR 允许变差的比例
+void optimizeOverdraw(uint32_t *indices, size_t indexCount,
+                      const std::vector<Vertex> &vertices,
+                      float threshold = 1.05f,
+                      uint32_t cacheSize = VERTEX_CACHE_SIZE);
+
+// 顶点数组按首次引用顺序重排，返回后 vertices 只剩被引用的顶点
+void optimizeVertexFetch(std::vector<Vertex> &vertices,
+                         std::vector<uint32_t> &indices);
+
+// 依次执行以上三步，每一步前后打印 ACMR / ATVR；有多级 LOD 时逐级优化三角形顺序
+void optimizeMesh(MeshData &mesh);
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Mesh/Mesh.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// 基于二次误差度量（QEM）的网格简化：
+// 每次把一个顶点折叠到相邻顶点上（半边折叠），新位置取自已有顶点，
+// 因此所有 LOD 共用同一个顶点数组，只需在索引缓冲中追加各级三角形。
+// 边界顶点保持不动；属性接缝（同一位置多个顶点）上的顶点只沿接缝折叠，
+// 同一位置的所有顶点一起移动，避免出现裂缝。
+
+struct SimplifyResult {
+  std::vector<uint32_t> indices;
+  // 对象空间的距离上限：简化后的顶点到其合并区域内输入三角形所在平面的最大距离
+  float error;
+};
+
+// 简化到不多于 targetIndexCount 个索引为止，只执行误差上限不超过 maxError 的折叠
+SimplifyResult simplifyMesh(const std::vector<Vertex> &vertices,
+                            const uint32_t *indices, size_t indexCount,
+                            size_t targetIndexCount, float maxError);
+
+struct LodConfig {
+  uint32_t maxLodCount = 6;        // 包含原始网格在内的级数上限
+  float reduction = 0.5f;          // 每级目标三角形比例
+  uint32_t minTriangleCount = 64;  // 低于此三角形数不再继续
+  float maxRelativeError = 0.05f;  // 误差上限，相对包围球半径
+};
+
+// 各级都从原始网格简化，把各级索引追加到 mesh.indices 之后，填充 mesh.lods（误差递增）。
+// 需在 optimizeMesh 之前调用，以便逐级优化三角形顺序
+void generateLods(MeshData &mesh, const LodConfig &config = {});
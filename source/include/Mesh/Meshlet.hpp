@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Mesh/Mesh.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// 网格簇（meshlet）：把网格切成顶点数、三角形数都有上限的小块，
+// 每块带包围球和法线锥，可以在 GPU 上逐块做视锥与背面剔除。
+// 上限取 NVIDIA 推荐的 64 / 124，同样适用于网格着色器的输出限制。
+constexpr uint32_t MESHLET_MAX_VERTICES = 64;
+constexpr uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+struct Meshlet {
+  uint32_t vertexOffset;   // MeshletData::vertices 中的起点
+  uint32_t triangleOffset; // MeshletData::triangles 中的起点（字节，3 的倍数）
+  uint32_t vertexCount;
+  uint32_t triangleCount;
+};
+
+// 对象空间的包围球与法线锥。
+// 锥轴为簇内三角形法线的平均方向，coneCutoff = sin(最大偏角)，
+// 从视点看去满足 dot(center - eye, axis) >= coneCutoff * |center - eye| + radius
+// 时整块背向相机；法线分布超过半球时 coneCutoff = 1，永不剔除
+struct MeshletBounds {
+  glm::vec3 center;
+  float radius;
+  glm::vec3 coneAxis;
+  float coneCutoff;
+};
+
+struct MeshletData {
+  std::vector<Meshlet> meshlets;
+  std::vector<MeshletBounds> bounds;
+  std::vector<uint32_t> vertices; // 簇内局部顶点到网格顶点的映射
+  std::vector<uint8_t> triangles; // 每个三角形 3 个局部顶点索引
+};
+
+// 按索引顺序贪心切分（索引应已经过 optimizeVertexCache，相邻三角形共享顶点多），
+// 只处理最精细一级 LOD
+MeshletData buildMeshlets(const MeshData &mesh);
+
+MeshletBounds computeMeshletBounds(const MeshletData &meshlets,
+                                   const Meshlet &meshlet,
+                                   const std::vector<Vertex> &vertices);
+
+// 展开成使用网格顶点索引的三角形列表，第 i 个簇的索引从 triangleOffset 开始
+std::vector<uint32_t> meshletIndices(const MeshletData &meshlets);
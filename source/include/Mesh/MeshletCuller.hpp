@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Mesh/MeshletMesh.hpp"
+#include "Scene/Frustum.hpp"
+#include "Vulkan/DescriptorAllocator.hpp"
+
+#include <glm/glm.hpp>
+
+// 剔除参数，作为推送常量传给 meshlet_cull.comp（116 字节）。
+// 平面与视点都在对象空间，着色器不需要模型矩阵
+struct MeshletCullParams {
+  glm::vec4 frustumPlanes[6]; // xyz 法线朝内，已归一化
+  glm::vec3 cameraPosition;
+  uint32_t meshletCount;
+  uint32_t compact; // 1：存活的簇紧凑写入并计数；0：原位写入，剔除的簇实例数为 0
+};
+static_assert(sizeof(MeshletCullParams) == 116);
+
+// 逐簇的视锥与法线锥剔除：每个线程处理一个簇，结果写入 MeshletMesh 的绘制命令缓冲。
+// Cull 自带所需的屏障，之后可直接调用 MeshletMesh::DrawIndirect
+class MeshletCuller {
+public:
+  static constexpr uint32_t WORKGROUP_SIZE = 64;
+
+  explicit MeshletCuller(const VkContext &context);
+  ~MeshletCuller();
+
+  MeshletCuller(const MeshletCuller &) = delete;
+  MeshletCuller &operator=(const MeshletCuller &) = delete;
+
+  // 每个网格一个描述符集，由调用方与网格一起保存
+  VkDescriptorSet AllocateSet(const MeshletMesh &mesh);
+
+  void Cull(VkCommandBuffer commandBuffer, VkDescriptorSet set,
+            const MeshletMesh &mesh, const glm::mat4 &viewProjection,
+            const glm::mat4 &model, const glm::vec3 &cameraPosition) const;
+
+private:
+  const VkContext &m_context;
+  DescriptorLayout m_layout;
+  DescriptorAllocator m_descriptorAllocator;
+  VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+  VkPipeline m_pipeline = VK_NULL_HANDLE;
+};
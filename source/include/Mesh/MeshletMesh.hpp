@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Mesh/Meshlet.hpp"
+
+// GPU 端的簇信息，std430 布局，对应 common/meshlet.glsl 中的 Meshlet
+struct GpuMeshlet {
+  glm::vec4 sphere;    // xyz 球心，w 半径
+  glm::vec4 cone;      // xyz 锥轴，w coneCutoff
+  uint32_t firstIndex; // 同时是三角形字节流中的起点
+  uint32_t indexCount;
+  uint32_t vertexOffset; // 网格着色器路径：簇内顶点表的起点
+  uint32_t vertexCount;
+};
+static_assert(sizeof(GpuMeshlet) == 48);
+
+// 按簇切分后的网格：索引按簇连续排列，每个簇对应一条 VkDrawIndexedIndirectCommand。
+// 剔除计算着色器写入绘制命令缓冲和数量缓冲，DrawIndirect 读取它们完成绘制。
+// 网格着色器路径不用索引缓冲，直接读取顶点、簇内顶点表和打包的三角形字节流。
+class MeshletMesh {
+public:
+  MeshletMesh(const VkContext &context, VkCommandPool commandPool,
+              const MeshData &mesh, const MeshletData &meshlets);
+  ~MeshletMesh();
+
+  MeshletMesh(const MeshletMesh &) = delete;
+  MeshletMesh &operator=(const MeshletMesh &) = delete;
+
+  // 剔除之后调用。支持 drawIndirectCount 时只绘制存活的簇，
+  // 否则遍历全部命令，被剔除的簇 instanceCount 为 0
+  void DrawIndirect(VkCommandBuffer commandBuffer) const;
+
+  uint32_t GetMeshletCount() const { return m_meshletCount; }
+  VkBuffer GetMeshletBuffer() const { return m_meshletBuffer; }
+  VkBuffer GetDrawBuffer() const { return m_drawBuffer; }
+  VkBuffer GetDrawCountBuffer() const { return m_drawCountBuffer; }
+  VkBuffer GetVertexBuffer() const { return m_vertexBuffer; }
+  VkBuffer GetMeshletVertexBuffer() const { return m_meshletVertexBuffer; }
+  VkBuffer GetMeshletTriangleBuffer() const { return m_meshletTriangleBuffer; }
+
+private:
+  const VkContext &m_context;
+  uint32_t m_meshletCount = 0;
+  VkIndexType m_indexType = VK_INDEX_TYPE_UINT32;
+
+  VkBuffer m_vertexBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_vertexMemory = VK_NULL_HANDLE;
+  VkBuffer m_indexBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_indexMemory = VK_NULL_HANDLE;
+  VkBuffer m_meshletBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_meshletMemory = VK_NULL_HANDLE;
+  VkBuffer m_meshletVertexBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_meshletVertexMemory = VK_NULL_HANDLE;
+  VkBuffer m_meshletTriangleBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_meshletTriangleMemory = VK_NULL_HANDLE;
+  VkBuffer m_drawBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_drawMemory = VK_NULL_HANDLE;
+  VkBuffer m_drawCountBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_drawCountMemory = VK_NULL_HANDLE;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Mesh/MeshletCuller.hpp"
+
+#include <memory>
+
+// 推送常量，对应 meshlet.task / meshlet.mesh / meshlet.vert 中的 MeshletPush
+struct MeshletDrawParams {
+  glm::mat4 clipFromObject;
+  glm::vec3 cameraPosition; // 对象空间
+  uint32_t meshletCount;
+};
+static_assert(sizeof(MeshletDrawParams) == 80);
+
+// 网格簇的两条几何路径：
+// - VK_EXT_mesh_shader 可用时：任务阶段逐簇剔除，网格阶段直接从存储缓冲展开顶点与三角形，
+//   不需要索引缓冲，也没有计算剔除 + 间接绘制之间的往返
+// - 否则回退到顶点管线：MeshletCuller 在渲染通道外剔除，再由 MeshletMesh::DrawIndirect 绘制
+// 两条路径共用片段着色器 00/triangle.frag。
+class MeshletRenderer {
+public:
+  static bool IsMeshShaderSupported(const VkContext &context);
+
+  MeshletRenderer(const VkContext &context, VkRenderPass renderPass,
+                  uint32_t subpass = 0);
+  ~MeshletRenderer();
+
+  MeshletRenderer(const MeshletRenderer &) = delete;
+  MeshletRenderer &operator=(const MeshletRenderer &) = delete;
+
+  bool UsesMeshShaders() const { return m_useMeshShaders; }
+
+  // 每个网格一个描述符集，由调用方与网格一起保存
+  VkDescriptorSet AllocateSet(const MeshletMesh &mesh);
+
+  // 渲染通道开始前调用；网格着色器路径下什么也不做
+  void Cull(VkCommandBuffer commandBuffer, VkDescriptorSet set,
+            const MeshletMesh &mesh, const glm::mat4 &viewProjection,
+            const glm::mat4 &model, const glm::vec3 &cameraPosition) const;
+
+  // 渲染通道内调用，视口与裁剪矩形为动态状态，由调用方设置
+  void Draw(VkCommandBuffer commandBuffer, VkDescriptorSet set,
+            const MeshletMesh &mesh, const glm::mat4 &viewProjection,
+            const glm::mat4 &model, const glm::vec3 &cameraPosition) const;
+
+private:
+  void createMeshShaderPipeline(VkRenderPass renderPass, uint32_t subpass);
+  void createVertexPipeline(VkRenderPass renderPass, uint32_t subpass);
+  void createPipelineLayout(VkDescriptorSetLayout setLayout,
+                            VkShaderStageFlags pushStages);
+
+private:
+  const VkContext &m_context;
+  bool m_useMeshShaders;
+
+  // 网格着色器路径
+  std::unique_ptr<DescriptorLayout> m_layout;
+  std::unique_ptr<DescriptorAllocator> m_descriptorAllocator;
+  PFN_vkCmdDrawMeshTasksEXT m_vkCmdDrawMeshTasksEXT = nullptr;
+
+  // 顶点管线回退路径
+  std::unique_ptr<MeshletCuller> m_culler;
+
+  VkShaderStageFlags m_pushStages = 0;
+  VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+  VkPipeline m_pipeline = VK_NULL_HANDLE;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Mesh/Mesh.hpp"
+
+#include <string>
+
+// Wavefront OBJ 加载器：
+// 1. 内存映射整个文件，按换行对齐切分为若干块
+// 2. 各块在线程池中用 std::from_chars 并行解析 v / vt / vn / f
+// 3. 按块的前缀和合并，解析出全局索引（包括负数的相对索引）
+// 4. 以 (位置, 纹理坐标, 法线) 索引三元组为键在 FlatHashMap 中去重，输出索引网格
+//
+// 多边形按扇形三角化；材质、分组、平滑组等语句被忽略。
+// 缺少法线或纹理坐标的顶点对应分量为 0。
+MeshData loadObj(const std::string &filename);
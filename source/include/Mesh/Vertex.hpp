@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Mesh/VertexLayout.hpp"
+
+#include <glm/glm.hpp>
+
+// 交错排列的网格顶点，对应 triangle.vert 中 location 0~2 的输入
+struct Vertex {
+  glm::vec3 position;
+  glm::vec3 normal;
+  glm::vec2 uv;
+
+  bool operator==(const Vertex &other) const {
+    return position == other.position && normal == other.normal &&
+           uv == other.uv;
+  }
+};
+
+template <>
+struct VertexLayoutOf<Vertex>
+    : VertexLayout<Vertex, VERTEX_ATTRIBUTE(Vertex, position),
+                   VERTEX_ATTRIBUTE(Vertex, normal),
+                   VERTEX_ATTRIBUTE(Vertex, uv)> {};
+
+static_assert(VertexLayoutOf<Vertex>::STRIDE == 32,
+              "Vertex must stay tightly packed");
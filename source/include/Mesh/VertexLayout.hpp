@@ -0,0 +1,238 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// 编译期顶点布局反射：由带注解的顶点结构体推导出绑定步长、属性偏移与格式，
+// 生成的描述数组是 constexpr 静态数据，运行时没有任何开销。
+//
+// 用法：
+//   struct MyVertex { glm::vec3 position; glm::vec2 uv; };
+//   template <> struct VertexLayoutOf<MyVertex>
+//       : VertexLayout<MyVertex, VERTEX_ATTRIBUTE(MyVertex, position),
+//                      VERTEX_ATTRIBUTE(MyVertex, uv)> {};
+//   auto inputInfo = VertexInputState<VertexLayoutOf<MyVertex>>::CreateInfo();
+//
+// 着色器 location 按属性声明顺序依次分配，多个绑定时顺延编号。
+// 属性越界、相互重叠、成员类型没有对应的 VkFormat 等都会在编译期报错。
+
+// C++ 成员类型到顶点格式的映射，新增类型时特化此模板
+// locationCount > 1 的类型（矩阵）按列占用多个连续 location
+template <typename T> struct VertexFormat {
+  static_assert(sizeof(T) == 0, "no VkFormat mapping for this vertex member");
+};
+
+template <VkFormat Format, uint32_t LocationCount = 1,
+          uint32_t LocationStride = 0>
+struct VertexFormatTraits {
+  static constexpr VkFormat FORMAT = Format;
+  static constexpr uint32_t LOCATION_COUNT = LocationCount;
+  static constexpr uint32_t LOCATION_STRIDE = LocationStride;
+};
+
+template <>
+struct VertexFormat<float> : VertexFormatTraits<VK_FORMAT_R32_SFLOAT> {};
+template <>
+struct VertexFormat<glm::vec2> : VertexFormatTraits<VK_FORMAT_R32G32_SFLOAT> {
+};
+template <>
+struct VertexFormat<glm::vec3>
+    : VertexFormatTraits<VK_FORMAT_R32G32B32_SFLOAT> {};
+template <>
+struct VertexFormat<glm::vec4>
+    : VertexFormatTraits<VK_FORMAT_R32G32B32A32_SFLOAT> {};
+template <>
+struct VertexFormat<int32_t> : VertexFormatTraits<VK_FORMAT_R32_SINT> {};
+template <>
+struct VertexFormat<glm::ivec2> : VertexFormatTraits<VK_FORMAT_R32G32_SINT> {
+};
+template <>
+struct VertexFormat<glm::ivec3>
+    : VertexFormatTraits<VK_FORMAT_R32G32B32_SINT> {};
+template <>
+struct VertexFormat<glm::ivec4>
+    : VertexFormatTraits<VK_FORMAT_R32G32B32A32_SINT> {};
+template <>
+struct VertexFormat<uint32_t> : VertexFormatTraits<VK_FORMAT_R32_UINT> {};
+template <>
+struct VertexFormat<glm::uvec2> : VertexFormatTraits<VK_FORMAT_R32G32_UINT> {
+};
+template <>
+struct VertexFormat<glm::uvec3>
+    : VertexFormatTraits<VK_FORMAT_R32G32B32_UINT> {};
+template <>
+struct VertexFormat<glm::uvec4>
+    : VertexFormatTraits<VK_FORMAT_R32G32B32A32_UINT> {};
+template <>
+struct VertexFormat<glm::mat4>
+    : VertexFormatTraits<VK_FORMAT_R32G32B32A32_SFLOAT, 4, sizeof(glm::vec4)> {
+};
+
+// 单个属性：成员类型与其在结构体中的偏移
+template <typename T, uint32_t Offset> struct VertexAttribute {
+  using Type = T;
+  static constexpr uint32_t OFFSET = Offset;
+  static constexpr uint32_t SIZE = sizeof(T);
+  static constexpr VkFormat FORMAT = VertexFormat<T>::FORMAT;
+  static constexpr uint32_t LOCATION_COUNT = VertexFormat<T>::LOCATION_COUNT;
+  static constexpr uint32_t LOCATION_STRIDE = VertexFormat<T>::LOCATION_STRIDE;
+};
+
+#define VERTEX_ATTRIBUTE(Struct, member)                                       \
+  VertexAttribute<decltype(Struct::member), offsetof(Struct, member)>
+
+namespace vertex_layout_detail {
+struct Range {
+  uint32_t offset;
+  uint32_t size;
+};
+
+template <size_t N>
+constexpr bool rangesDisjoint(const std::array<Range, N> &ranges) {
+  for (size_t i = 0; i < N; i++) {
+    for (size_t j = i + 1; j < N; j++) {
+      if (ranges[i].offset < ranges[j].offset + ranges[j].size &&
+          ranges[j].offset < ranges[i].offset + ranges[i].size) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+struct AttributeKey {
+  VkFormat format;
+  uint32_t offset;
+  uint32_t locationCount;
+};
+
+// FNV-1a，覆盖步长、输入频率和每个属性的格式与偏移
+template <size_t N>
+constexpr uint64_t hashLayout(uint32_t stride, VkVertexInputRate inputRate,
+                              const std::array<AttributeKey, N> &attributes) {
+  uint64_t hash = 0xCBF29CE484222325ull;
+  auto mix = [&hash](uint64_t value) {
+    hash = (hash ^ value) * 0x100000001B3ull;
+  };
+  mix(stride);
+  mix(static_cast<uint64_t>(inputRate));
+  for (const AttributeKey &attribute : attributes) {
+    mix(static_cast<uint64_t>(attribute.format));
+    mix(attribute.offset);
+    mix(attribute.locationCount);
+  }
+  return hash;
+}
+} // namespace vertex_layout_detail
+
+// 一个顶点缓冲绑定的布局，Attributes 为 VERTEX_ATTRIBUTE(...) 列表
+template <typename V, VkVertexInputRate InputRate, typename... Attributes>
+struct VertexBufferLayout {
+  static_assert(std::is_standard_layout_v<V>,
+                "vertex struct must be standard-layout for offsetof");
+  static_assert(sizeof...(Attributes) > 0, "vertex layout has no attributes");
+
+  using VertexType = V;
+  static constexpr uint32_t STRIDE = sizeof(V);
+  static constexpr VkVertexInputRate INPUT_RATE = InputRate;
+  static constexpr uint32_t LOCATION_COUNT =
+      (Attributes::LOCATION_COUNT + ...);
+
+  // Vulkan 保证的最小限制：maxVertexInputBindingStride 与 maxVertexInputAttributes
+  static_assert(STRIDE <= 2048, "vertex stride exceeds the guaranteed limit");
+  static_assert(LOCATION_COUNT <= 16,
+                "vertex layout uses more than 16 attribute locations");
+  static_assert(((Attributes::OFFSET + Attributes::SIZE <= STRIDE) && ...),
+                "vertex attribute lies outside the vertex struct");
+  static_assert(vertex_layout_detail::rangesDisjoint<sizeof...(Attributes)>(
+                    {{{Attributes::OFFSET, Attributes::SIZE}...}}),
+                "vertex attributes overlap");
+
+  // 布局指纹，二进制网格缓存用它判断文件与当前顶点结构是否一致
+  static constexpr uint64_t LAYOUT_HASH =
+      vertex_layout_detail::hashLayout<sizeof...(Attributes)>(
+          STRIDE, INPUT_RATE,
+          {{{Attributes::FORMAT, Attributes::OFFSET,
+             Attributes::LOCATION_COUNT}...}});
+
+  static constexpr VkVertexInputBindingDescription
+  BindingDescription(uint32_t binding = 0) {
+    return {binding, STRIDE, INPUT_RATE};
+  }
+
+  // 从 firstLocation 开始按声明顺序生成属性描述
+  static constexpr std::array<VkVertexInputAttributeDescription, LOCATION_COUNT>
+  AttributeDescriptions(uint32_t binding = 0, uint32_t firstLocation = 0) {
+    std::array<VkVertexInputAttributeDescription, LOCATION_COUNT> result{};
+    uint32_t index = 0;
+    auto append = [&](VkFormat format, uint32_t offset, uint32_t count,
+                      uint32_t stride) {
+      for (uint32_t i = 0; i < count; i++, index++) {
+        result[index] = {firstLocation + index, binding, format,
+                         offset + i * stride};
+      }
+    };
+    (append(Attributes::FORMAT, Attributes::OFFSET, Attributes::LOCATION_COUNT,
+            Attributes::LOCATION_STRIDE),
+     ...);
+    return result;
+  }
+};
+
+template <typename V, typename... Attributes>
+using VertexLayout =
+    VertexBufferLayout<V, VK_VERTEX_INPUT_RATE_VERTEX, Attributes...>;
+template <typename V, typename... Attributes>
+using InstanceLayout =
+    VertexBufferLayout<V, VK_VERTEX_INPUT_RATE_INSTANCE, Attributes...>;
+
+// 为顶点结构体特化，继承对应的 VertexLayout / InstanceLayout
+template <typename V> struct VertexLayoutOf;
+
+// 完整的顶点输入状态：Layouts 依次占用绑定 0, 1, ...，location 顺延编号
+template <typename... Layouts> struct VertexInputState {
+  static constexpr uint32_t BINDING_COUNT = sizeof...(Layouts);
+  static constexpr uint32_t ATTRIBUTE_COUNT = (Layouts::LOCATION_COUNT + ...);
+  static_assert(ATTRIBUTE_COUNT <= 16,
+                "vertex input uses more than 16 attribute locations");
+
+  static constexpr std::array<VkVertexInputBindingDescription, BINDING_COUNT>
+      BINDINGS = [] {
+        std::array<VkVertexInputBindingDescription, BINDING_COUNT> result{};
+        uint32_t binding = 0;
+        ((result[binding] = Layouts::BindingDescription(binding), binding++), ...);
+        return result;
+      }();
+
+  static constexpr std::array<VkVertexInputAttributeDescription,
+                              ATTRIBUTE_COUNT>
+      ATTRIBUTES = [] {
+        std::array<VkVertexInputAttributeDescription, ATTRIBUTE_COUNT>
+            result{};
+        uint32_t binding = 0;
+        uint32_t location = 0;
+        auto append = [&](const auto &attributes) {
+          for (const auto &attribute : attributes) {
+            result[location++] = attribute;
+          }
+          binding++;
+        };
+        (append(Layouts::AttributeDescriptions(binding, location)), ...);
+        return result;
+      }();
+
+  static VkPipelineVertexInputStateCreateInfo CreateInfo() {
+    return {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+        .vertexBindingDescriptionCount = BINDING_COUNT,
+        .pVertexBindingDescriptions = BINDINGS.data(),
+        .vertexAttributeDescriptionCount = ATTRIBUTE_COUNT,
+        .pVertexAttributeDescriptions = ATTRIBUTES.data(),
+    };
+  }
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Mesh/Vertex.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+// 压缩顶点格式：顶点输入阶段由固定功能硬件完成 UNORM / SNORM / 半精度到 float 的转换，
+// 着色器只需做八面体法线解码，位置的反量化折进模型矩阵。
+// 对应 GLSL 见 resources/shaders/common/vertex_quantization.glsl。
+
+// 相对网格包围盒的 16 位归一化坐标，w 仅用于对齐（三分量 16 位格式支持很差）
+struct Unorm16x4 {
+  uint16_t x, y, z, w;
+};
+
+// 八面体映射的单位向量
+struct Snorm16x2 {
+  int16_t x, y;
+};
+
+struct Half2 {
+  uint16_t x, y;
+};
+
+template <>
+struct VertexFormat<Unorm16x4>
+    : VertexFormatTraits<VK_FORMAT_R16G16B16A16_UNORM> {};
+template <>
+struct VertexFormat<Snorm16x2> : VertexFormatTraits<VK_FORMAT_R16G16_SNORM> {};
+template <>
+struct VertexFormat<Half2> : VertexFormatTraits<VK_FORMAT_R16G16_SFLOAT> {};
+
+// Vertex 的压缩版本，对应 triangle_quantized.vert 中 location 0~2 的输入
+struct QuantizedVertex {
+  Unorm16x4 position;
+  Snorm16x2 normal;
+  Half2 uv;
+};
+
+template <>
+struct VertexLayoutOf<QuantizedVertex>
+    : VertexLayout<QuantizedVertex, VERTEX_ATTRIBUTE(QuantizedVertex, position),
+                   VERTEX_ATTRIBUTE(QuantizedVertex, normal),
+                   VERTEX_ATTRIBUTE(QuantizedVertex, uv)> {};
+
+static_assert(VertexLayoutOf<QuantizedVertex>::STRIDE == 16,
+              "QuantizedVertex must stay tightly packed");
+
+// 位置反量化：position = offset + unorm * scale
+struct VertexDequantization {
+  glm::vec3 offset = glm::vec3(0.0f);
+  glm::vec3 scale = glm::vec3(1.0f);
+
+  // 由包围盒得到量化范围，退化的轴保持 scale = 1 以免除零
+  static VertexDequantization FromBounds(const glm::vec3 &min,
+                                         const glm::vec3 &max);
+
+  // 右乘到模型矩阵上：model * Matrix()。法线不经过这个矩阵，法线矩阵仍由原模型矩阵计算
+  glm::mat4 Matrix() const;
+};
+
+Snorm16x2 encodeOctahedral(const glm::vec3 &normal);
+glm::vec3 decodeOctahedral(Snorm16x2 encoded);
+
+QuantizedVertex quantizeVertex(const Vertex &vertex,
+                               const VertexDequantization &dequantization);
+
+// 逐顶点量化，dst 可以直接是映射的暂存内存
+void quantizeVertices(const Vertex *src, size_t count,
+                      const VertexDequantization &dequantization,
+                      QuantizedVertex *dst);
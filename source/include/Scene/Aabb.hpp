@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Mesh/Mesh.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <limits>
+
+// 轴对齐包围盒，默认构造为空盒子（min > max），Expand 后才有效
+struct Aabb {
+  glm::vec3 min{std::numeric_limits<float>::max()};
+  glm::vec3 max{-std::numeric_limits<float>::max()};
+
+  void Expand(const glm::vec3 &point) {
+    min = glm::min(min, point);
+    max = glm::max(max, point);
+  }
+  void Expand(const Aabb &other) {
+    min = glm::min(min, other.min);
+    max = glm::max(max, other.max);
+  }
+
+  bool IsEmpty() const {
+    return min.x > max.x || min.y > max.y || min.z > max.z;
+  }
+  glm::vec3 Center() const { return (min + max) * 0.5f; }
+  glm::vec3 Extent() const { return (max - min) * 0.5f; }
+  // 点到盒子的距离平方，点在盒内为 0
+  float SquaredDistance(const glm::vec3 &point) const {
+    glm::vec3 offset = point - glm::max(min, glm::min(point, max));
+    return glm::dot(offset, offset);
+  }
+
+  // 空盒子为 0，SAH 中作为代价的权重
+  float SurfaceArea() const {
+    if (IsEmpty()) {
+      return 0.0f;
+    }
+    glm::vec3 size = max - min;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+  }
+};
+
+// Arvo：变换后盒子的半长为 |M| * extent
+inline glm::vec3 transformExtent(const glm::mat4 &model,
+                                 const glm::vec3 &extent) {
+  glm::mat3 absolute = glm::mat3(model);
+  for (int column = 0; column < 3; column++) {
+    absolute[column] = glm::abs(absolute[column]);
+  }
+  return absolute * extent;
+}
+
+// 对象空间包围盒变换到世界空间
+inline Aabb transformAabb(const MeshBounds &bounds, const glm::mat4 &model) {
+  glm::vec3 center =
+      glm::vec3(model * glm::vec4((bounds.min + bounds.max) * 0.5f, 1.0f));
+  glm::vec3 extent = transformExtent(model, (bounds.max - bounds.min) * 0.5f);
+  return {center - extent, center + extent};
+}
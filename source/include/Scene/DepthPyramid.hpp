@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Vulkan/DescriptorAllocator.hpp"
+#include "Vulkan/VkContext.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// 层级深度缓冲（Hi-Z）：R32_SFLOAT 的 mip 链，每个 texel 保存其覆盖区域内最远的深度。
+// 本仓库使用常规深度（近 0 远 1，LESS 比较），因此各级取最大值；
+// 包围体最近的深度仍大于该值时，说明它完全被已绘制的几何遮挡。
+//
+// 整个 mip 链由一次计算派发生成（depth_pyramid.comp）：
+// 每个工作组把 32x32 的 0 级区域在共享内存中逐级归约到第 5 级，
+// 最后一个完成的工作组（原子计数判断）再把第 5 级继续归约到 1x1。
+//
+// 0 级为深度缓冲尺寸向下取整到 2 的幂，保证每级恰好是上一级的一半。
+// 交换链尺寸变化时随深度缓冲一起重建。
+class DepthPyramid {
+public:
+  static constexpr uint32_t MAX_LEVELS = 16;
+  static constexpr uint32_t TILE_SIZE = 32;  // 每个工作组负责的 0 级区域
+  static constexpr uint32_t TILE_LEVELS = 6; // 工作组内完成的级数（32 -> 1）
+
+  // depthView 为深度附件的采样视图（只含深度方面），深度图像需带 SAMPLED 用途
+  DepthPyramid(const VkContext &context, VkImageView depthView,
+               uint32_t depthWidth, uint32_t depthHeight);
+  ~DepthPyramid();
+
+  DepthPyramid(const DepthPyramid &) = delete;
+  DepthPyramid &operator=(const DepthPyramid &) = delete;
+
+  // 在第一阶段的渲染通道结束后调用，深度图像需处于
+  // DEPTH_STENCIL_READ_ONLY_OPTIMAL（渲染通道的 finalLayout）。
+  // 结束时金字塔对计算着色器的采样读取可见
+  void Build(VkCommandBuffer commandBuffer);
+
+  uint32_t GetWidth() const { return m_width; }
+  uint32_t GetHeight() const { return m_height; }
+  uint32_t GetLevelCount() const { return m_levelCount; }
+  VkImageView GetView() const { return m_view; }     // 全部 mip
+  VkSampler GetSampler() const { return m_sampler; } // 最近点、边缘钳制
+
+private:
+  void createPipeline();
+
+private:
+  const VkContext &m_context;
+  uint32_t m_depthWidth;
+  uint32_t m_depthHeight;
+  uint32_t m_width;
+  uint32_t m_height;
+  uint32_t m_levelCount;
+  bool m_initialized = false; // 首次 Build 时从 UNDEFINED 转到 GENERAL
+
+  VkImage m_image = VK_NULL_HANDLE;
+  VkDeviceMemory m_memory = VK_NULL_HANDLE;
+  VkImageView m_view = VK_NULL_HANDLE;
+  std::vector<VkImageView> m_levelViews;
+  VkSampler m_sampler = VK_NULL_HANDLE;
+
+  VkBuffer m_counterBuffer = VK_NULL_HANDLE; // 已完成的工作组数
+  VkDeviceMemory m_counterMemory = VK_NULL_HANDLE;
+
+  DescriptorLayout m_layout;
+  DescriptorAllocator m_descriptorAllocator;
+  VkDescriptorSet m_set = VK_NULL_HANDLE;
+  VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+  VkPipeline m_pipeline = VK_NULL_HANDLE;
+};
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Mesh/Mesh.hpp"
+#include "Mesh/VertexLayout.hpp"
+#include "Vulkan/VkContext.hpp"
+#include "utils/FlatHashMap.hpp"
+#include "utils/ThreadPool.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+// 每个实例的数据，作为实例频率的顶点输入（绑定 1，location 紧接在网格顶点之后），
+// 对应 resources/shaders/scene/instanced.vert
+struct InstanceData {
+  glm::mat4 model;
+  uint32_t materialIndex; // 无绑定材质表中的编号
+  uint32_t padding[3];
+};
+static_assert(sizeof(InstanceData) == 80);
+
+template <>
+struct VertexLayoutOf<InstanceData>
+    : InstanceLayout<InstanceData, VERTEX_ATTRIBUTE(InstanceData, model),
+                     VERTEX_ATTRIBUTE(InstanceData, materialIndex)> {};
+
+// 场景中一个可绘制对象的渲染状态，编号都由调用方分配：
+// - pipeline / material：切换时需要重新绑定的管线与材质描述符集。
+//   使用无绑定材质时，参数不同的材质可以共用同一个 material，只靠 materialIndex 区分
+// - mesh / lod：绘制的网格与其 LOD（见 Mesh::DrawLod）
+struct DrawObject {
+  uint32_t pipeline;
+  uint32_t material;
+  uint32_t mesh;
+  uint32_t lod;
+  uint32_t materialIndex;
+};
+
+// 一次实例化绘制：实例数据位于本帧实例缓冲的 [firstInstance, firstInstance + instanceCount)
+struct DrawBatch {
+  uint32_t pipeline;
+  uint32_t material;
+  uint32_t mesh;
+  uint32_t lod;
+  uint32_t firstInstance;
+  uint32_t instanceCount;
+};
+
+// 录制时由调用方完成的绑定，编号与 DrawObject 中的一致
+struct DrawBindings {
+  std::function<void(VkCommandBuffer, uint32_t pipeline)> bindPipeline;
+  std::function<void(VkCommandBuffer, uint32_t material)> bindMaterial;
+  std::span<const Mesh *const> meshes;
+
+  // 编号超出 meshes 或对应网格为空时抛出异常
+  const Mesh &GetMesh(uint32_t mesh) const;
+};
+
+// 把可见对象按 (pipeline, material, mesh, lod) 合并成实例化绘制：
+// 1. 对象按 CHUNK_SIZE 分块并行，每块用局部哈希表给对象分配块内批次
+// 2. 串行合并各块的批次，按键排序后得到每个批次的实例区间，以及每块在各批次中的起点
+// 3. 各块并行把对象编号散布到批次顺序中，批次内保持可见列表中的顺序
+// 4. 按批次顺序并行、连续地写入变换与材质编号，映射内存上不做随机写
+// 批次按管线、材质、网格的顺序排列，录制时相邻批次共用的绑定不会重复。
+class DrawBatcher {
+public:
+  static constexpr uint32_t CHUNK_SIZE = 4096;
+
+  // 批次键的位宽，超出时 Build 抛出异常。
+  // 管线、材质、网格的位宽与 DrawQueue 的排序键相同，同一套编号两者都能使用
+  static constexpr uint32_t PIPELINE_BITS = 12;
+  static constexpr uint32_t MATERIAL_BITS = 16;
+  static constexpr uint32_t MESH_BITS = 16;
+  static constexpr uint32_t LOD_BITS = 4;
+
+  explicit DrawBatcher(ThreadPool &threadPool = ThreadPool::Get());
+
+  // objects / transforms 以对象编号索引，visible 为本帧可见的对象编号
+  // （例如 FrustumCuller::Cull 的输出）。instances 至少要有 visible.size() 项，
+  // 通常直接是 InstanceRing::GetFrameInstances() 的映射内存
+  void Build(std::span<const DrawObject> objects,
+             std::span<const glm::mat4> transforms,
+             std::span<const uint32_t> visible,
+             std::span<InstanceData> instances);
+
+  // 录制所有批次，调用前需已绑定本帧的实例缓冲（InstanceRing::Bind）
+  void Record(VkCommandBuffer commandBuffer,
+              const DrawBindings &bindings) const;
+
+  const std::vector<DrawBatch> &GetBatches() const { return m_batches; }
+
+private:
+  struct Chunk {
+    FlatHashMap<uint64_t, uint32_t> lookup; // 批次键 -> 块内批次
+    std::vector<uint64_t> keys;             // 块内批次的键
+    std::vector<uint32_t> counts;           // 块内批次的对象数
+    std::vector<uint32_t> batches;          // 块内批次对应的全局批次
+    std::vector<uint32_t> cursors;          // 块内批次在实例数据中的写入位置
+  };
+
+  static uint64_t makeKey(const DrawObject &object);
+
+private:
+  ThreadPool &m_threadPool;
+  std::vector<Chunk> m_chunks;
+  std::vector<uint32_t> m_localBatches; // 每个可见对象的块内批次
+  std::vector<uint32_t> m_order;        // 按批次排列的对象编号
+  std::vector<uint64_t> m_batchKeys;
+  FlatHashMap<uint64_t, uint32_t> m_batchLookup; // 批次键 -> 全局批次
+  std::vector<DrawBatch> m_batches;
+};
+
+struct InstanceRingConfig {
+  uint32_t framesInFlight = 2;
+  uint32_t maxInstances = 65536; // 每帧的实例上限
+};
+
+// 每帧环形的实例缓冲：常驻映射的顶点缓冲，每帧一个分区，
+// 帧开始时由 DrawBatcher::Build 直接写入，绘制时绑定到实例频率的绑定点
+class InstanceRing {
+public:
+  // 绑定 0 为网格顶点
+  static constexpr uint32_t INSTANCE_BINDING = 1;
+
+  InstanceRing(const VkContext &context, const InstanceRingConfig &config = {});
+  ~InstanceRing();
+
+  InstanceRing(const InstanceRing &) = delete;
+  InstanceRing &operator=(const InstanceRing &) = delete;
+
+  // 帧开始时调用，调用方需已等待该帧槽上一次提交的栅栏
+  void BeginFrame(uint64_t frameIndex);
+
+  // 本帧分区的映射内存，共 maxInstances 项
+  std::span<InstanceData> GetFrameInstances() const;
+
+  void Bind(VkCommandBuffer commandBuffer) const;
+
+  uint32_t GetMaxInstances() const { return m_config.maxInstances; }
+
+private:
+  const VkContext &m_context;
+  InstanceRingConfig m_config;
+
+  VkBuffer m_buffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_memory = VK_NULL_HANDLE;
+  InstanceData *m_mapped = nullptr;
+  uint32_t m_frameSlot = 0;
+};
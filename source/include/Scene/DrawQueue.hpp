@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Scene/DrawBatcher.hpp"
+#include "utils/ThreadPool.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// 一次绘制：sortKey 由 DrawQueue::MakeSortKey 生成，其余字段的含义与 DrawBatch 相同。
+// 逐对象绘制时 instanceCount 为 1，firstInstance 指向对象在本帧实例缓冲中的数据
+struct DrawPacket {
+  uint64_t sortKey;
+  uint32_t pipeline;
+  uint32_t material;
+  uint32_t mesh;
+  uint32_t lod;
+  uint32_t firstInstance;
+  uint32_t instanceCount;
+};
+static_assert(sizeof(DrawPacket) == 32);
+
+// 同一 pass 内按深度排列的方向
+enum class DepthOrder {
+  FrontToBack, // 不透明物体：先画近处的，尽早通过深度测试剔除被遮挡的像素
+  BackToFront, // 半透明物体：混合结果依赖绘制顺序
+};
+
+enum class DrawCommandType : uint32_t { BindPipeline, BindMaterial, BindMesh, Draw };
+
+// 命令流中的一项，id 为管线 / 材质 / 网格编号，Draw 时为绘制包的下标
+struct DrawCommand {
+  DrawCommandType type;
+  uint32_t id;
+};
+
+struct DrawStreamStats {
+  uint32_t draws = 0;
+  uint32_t pipelineBinds = 0;
+  uint32_t materialBinds = 0;
+  uint32_t meshBinds = 0;
+};
+
+// 每帧的绘制队列：收集绘制包，按 64 位排序键做并行 LSD 基数排序，再生成去掉冗余绑定的命令流。
+// 排序键从高位到低位：
+// - 不透明：pass(4) | pipeline(12) | material(16) | mesh(16) | depth(16)
+//   同一 pass 内先按状态分组，状态相同的绘制再从近到远
+// - 半透明：pass(4) | ~depth(16) | pipeline(12) | material(16) | mesh(16)
+//   深度优先保证从远到近的正确混合，深度相同时再按状态分组
+// 深度取正浮点数位模式的高 16 位（8 位指数 + 8 位尾数），单调且相对精度约 1/256，不需要远近平面。
+// 基数排序是稳定的，键相同的绘制保持提交顺序。
+class DrawQueue {
+public:
+  static constexpr uint32_t PASS_BITS = 4;
+  static constexpr uint32_t PIPELINE_BITS = DrawBatcher::PIPELINE_BITS;
+  static constexpr uint32_t MATERIAL_BITS = DrawBatcher::MATERIAL_BITS;
+  static constexpr uint32_t MESH_BITS = DrawBatcher::MESH_BITS;
+  static constexpr uint32_t DEPTH_BITS = 16;
+  static constexpr uint32_t MAX_PASSES = 1u << PASS_BITS;
+  static_assert(PASS_BITS + PIPELINE_BITS + MATERIAL_BITS + MESH_BITS +
+                    DEPTH_BITS ==
+                64);
+
+  // 基数排序每次处理 8 位，每个任务至少处理 RADIX_BLOCK_SIZE 个绘制包
+  static constexpr uint32_t RADIX_BITS = 8;
+  static constexpr uint32_t RADIX_SIZE = 1u << RADIX_BITS;
+  static constexpr uint32_t RADIX_PASSES = 64 / RADIX_BITS;
+  static constexpr uint32_t RADIX_BLOCK_SIZE = 16384;
+
+  explicit DrawQueue(ThreadPool &threadPool = ThreadPool::Get());
+
+  // viewDepth 为到相机平面的距离，非正数按 0 处理；编号超出位宽时抛出异常
+  static uint64_t MakeSortKey(uint32_t pass, DepthOrder order,
+                              const DrawPacket &packet, float viewDepth);
+
+  void Clear();
+
+  // 在队尾追加 count 个绘制包，返回的区间可以在多个线程中分别填充，
+  // 下一次 Append 或 Clear 前有效
+  std::span<DrawPacket> Append(size_t count);
+
+  // 排序所有绘制包并生成命令流
+  void Sort();
+
+  // 重放某个 pass 的命令流，调用前需已开始渲染流程并绑定本帧的实例缓冲
+  void Record(VkCommandBuffer commandBuffer, uint32_t pass,
+              const DrawBindings &bindings) const;
+
+  std::span<const DrawPacket> GetPackets() const { return m_packets; }
+  std::span<const DrawCommand> GetCommands(uint32_t pass) const;
+  const DrawStreamStats &GetStats() const { return m_stats; }
+
+private:
+  struct SortItem {
+    uint64_t key;
+    uint32_t packet;
+  };
+
+  // 命令流中一个 pass 的区间
+  struct PassRange {
+    uint32_t first = 0;
+    uint32_t count = 0;
+  };
+
+  void radixSort();
+  void buildCommands();
+
+  static uint64_t digitOf(uint64_t key, uint32_t digit) {
+    return (key >> (digit * RADIX_BITS)) & (RADIX_SIZE - 1);
+  }
+
+private:
+  ThreadPool &m_threadPool;
+  std::vector<DrawPacket> m_packets;
+
+  std::vector<SortItem> m_items, m_scratch;
+  std::vector<uint32_t> m_histograms; // [块][位][桶]，排序时原地转换为写入位置
+
+  std::vector<DrawCommand> m_commands;
+  std::array<PassRange, MAX_PASSES> m_passRanges{};
+  DrawStreamStats m_stats;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// 由 projection * view * model 提取对象空间的视锥平面（Vulkan 深度范围 [0, 1]），
+// 只传 projection * view 时得到世界空间的平面。
+// 顺序为左、右、下、上、近、远，xyz 法线朝内且已归一化
+void extractFrustumPlanes(const glm::mat4 &clipFromObject,
+                          glm::vec4 (&planes)[6]);
+
+enum class FrustumTest { Outside, Intersecting, Inside };
+
+// 轴对齐包围盒与视锥平面的保守测试：盒子在平面法线上的投影半径为 |n| · extent
+FrustumTest testFrustumAabb(const glm::vec4 (&planes)[6], const glm::vec3 &min,
+                            const glm::vec3 &max);
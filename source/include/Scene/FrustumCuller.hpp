@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Mesh/Mesh.hpp"
+#include "utils/ThreadPool.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// CPU 端视锥剔除：一次 SIMD 迭代测试 8 个（AVX2）或 4 个（SSE2）对象，
+// 按块分给线程池并行处理，输出紧凑、升序的可见对象编号。
+// 剔除只读取量化后的包围体（见 CullingBounds）：包围球测试每个对象读 10 字节，
+// 只有存活对象的球心在某个平面外侧时才再读 6 字节做包围盒测试，
+// 每个对象的读取量从 float 数组的 28 字节降到约 10 字节。
+// 指令集在运行时检测，不依赖编译选项。
+// 性能：AVX2 内核单核约 2 ns/对象（计算受限），100 万对象单线程约 4-6 ms；
+// 100 万对象低于 1 ms 的目标依赖至少 8 个物理核心（线程池 8 个以上线程），
+// 核心更少时耗时约按线程数线性增加，见 CullingBenchmark 的线程扩展表。
+
+enum class SimdLevel {
+  Scalar,
+  Sse2,
+  Avx2,
+};
+
+// 当前 CPU 支持的最高级别
+SimdLevel detectSimdLevel();
+const char *simdLevelName(SimdLevel level);
+
+// 每 8 个对象一组的量化参数：组内坐标 = origin + step * q
+struct QuantizedGroup {
+  float originX, originY, originZ;
+  float step;
+};
+
+// 一组的球心与半径（16 位），正好一条缓存行
+struct alignas(64) QuantizedSpheres {
+  uint16_t x[8], y[8], z[8], radius[8];
+};
+
+// 一组的包围盒半尺寸（16 位），只在包围球测试有存活时读取
+struct QuantizedExtents {
+  uint16_t x[8], y[8], z[8];
+};
+
+// 包围球与包围盒共用球心：球半径 radius，盒子为 center ± extent。
+// 数组长度补齐到 8 的倍数，补齐部分的半径为负，永远不可见。
+// 另外按组保存一份量化数据供剔除使用：半径与半尺寸向上取整并计入球心的量化误差，
+// 剔除结果只会比 float 数据更保守。修改对象时若超出组的量化范围，整组重新量化
+class CullingBounds {
+public:
+  static constexpr uint32_t LANE_PADDING = 8;
+
+  void Reserve(size_t count);
+  void Clear();
+
+  uint32_t Add(const glm::vec3 &center, float radius, const glm::vec3 &extent);
+  // 由对象空间包围体与模型矩阵求世界空间包围体（盒子按 Arvo 方法变换）
+  uint32_t Add(const MeshBounds &bounds, const glm::mat4 &model);
+  void Set(uint32_t index, const glm::vec3 &center, float radius,
+           const glm::vec3 &extent);
+  void Set(uint32_t index, const MeshBounds &bounds, const glm::mat4 &model);
+
+  uint32_t GetCount() const { return m_count; }
+
+  const float *GetCenterX() const { return m_centerX.data(); }
+  const float *GetCenterY() const { return m_centerY.data(); }
+  const float *GetCenterZ() const { return m_centerZ.data(); }
+  const float *GetRadius() const { return m_radius.data(); }
+  const float *GetExtentX() const { return m_extentX.data(); }
+  const float *GetExtentY() const { return m_extentY.data(); }
+  const float *GetExtentZ() const { return m_extentZ.data(); }
+
+  const QuantizedGroup *GetGroups() const { return m_groups.data(); }
+  const QuantizedSpheres *GetSpheres() const { return m_spheres.data(); }
+  const QuantizedExtents *GetExtents() const { return m_extents.data(); }
+
+private:
+  void resizePadded(size_t count);
+  // 用所在组现有的量化参数量化一个对象，超出范围时返回 false
+  bool quantize(uint32_t index);
+  // 按组内所有对象重新选择量化参数并量化
+  void quantizeGroup(uint32_t group);
+
+private:
+  uint32_t m_count = 0;
+  std::vector<float> m_centerX, m_centerY, m_centerZ, m_radius;
+  std::vector<float> m_extentX, m_extentY, m_extentZ;
+
+  std::vector<QuantizedGroup> m_groups;
+  std::vector<QuantizedSpheres> m_spheres;
+  std::vector<QuantizedExtents> m_extents;
+};
+
+class FrustumCuller {
+public:
+  // 每个线程任务处理的对象数，也是输出压缩的粒度
+  static constexpr uint32_t CHUNK_SIZE = 16384;
+
+  explicit FrustumCuller(ThreadPool &threadPool = ThreadPool::Get(),
+                         SimdLevel level = detectSimdLevel());
+
+  // viewProjection 为 projection * view，bounds 为世界空间。
+  // 先测包围球，通过的对象再测包围盒；visible 被覆盖为可见对象的编号
+  void Cull(const CullingBounds &bounds, const glm::mat4 &viewProjection,
+            std::vector<uint32_t> &visible);
+
+  SimdLevel GetSimdLevel() const { return m_level; }
+
+private:
+  ThreadPool &m_threadPool;
+  SimdLevel m_level;
+  std::vector<uint32_t> m_scratch;     // 各块按块起点写入的可见编号
+  std::vector<uint32_t> m_chunkCounts; // 各块的可见数量，之后就地变为输出偏移
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Mesh/LodSelection.hpp"
+#include "Scene/DepthPyramid.hpp"
+#include "Scene/GpuScene.hpp"
+#include "Vulkan/DescriptorAllocator.hpp"
+
+#include <glm/glm.hpp>
+
+// 剔除阶段，见 GpuDrivenRenderer 的说明
+enum class CullPhase : uint32_t {
+  All,   // 只做视锥剔除与 LOD 选择
+  Early, // 绘制上一帧可见的对象
+  Late,  // 用本帧的层级深度测试所有对象，补绘新变为可见的对象
+};
+
+// 剔除参数，作为推送常量传给 scene_cull.comp（96 字节）；
+// 视锥平面在着色器中由 viewProjection 提取，遮挡测试也用它投影包围盒
+struct SceneCullParams {
+  glm::mat4 viewProjection;
+  glm::vec3 cameraPosition;
+  uint32_t objectCount;
+  float projectionScale; // 见 lodProjectionScale
+  float pixelError;
+  uint32_t compact; // 1：存活的对象紧凑写入并计数；0：原位写入，剔除的实例数为 0
+  CullPhase phase;
+};
+static_assert(sizeof(SceneCullParams) == 96);
+
+// GPU 驱动的场景渲染：
+// 1. Cull（渲染通道外）：每个线程一个对象，视锥剔除并按屏幕空间误差选择 LOD，
+//    追加一条 VkDrawIndexedIndirectCommand，firstInstance 为对象编号
+// 2. Draw（渲染通道内）：绑定一次合并的几何，一次 vkCmdDrawIndexedIndirectCount
+//    绘制所有存活对象，顶点着色器用 gl_InstanceIndex 读取对象的变换
+// 两步录制的命令数与对象数量无关。需要 drawIndirectFirstInstance。
+//
+// 构造时传入 DepthPyramid 则启用两阶段遮挡剔除（场景需开启 occlusionCulling），
+// 每帧的顺序为：
+//   Cull(Early) -> 渲染通道 1: Draw -> DepthPyramid::Build
+//   -> Cull(Late) -> 渲染通道 2（loadOp = LOAD）: Draw
+// Early 只绘制上一帧可见且在视锥内的对象，由它们的深度生成层级深度；
+// Late 用层级深度测试所有对象并更新可见性，只补绘 Early 没有绘制的对象。
+// 上一帧的可见集合通常与本帧几乎相同，因此大部分被遮挡的对象在 Late 中被剔除，
+// 而新出现的对象最多晚一个阶段、不会晚一帧出现。
+// 层级深度随交换链重建时需要一起重建本对象。
+class GpuDrivenRenderer {
+public:
+  static constexpr uint32_t WORKGROUP_SIZE = 64;
+
+  static bool IsSupported(const VkContext &context);
+
+  GpuDrivenRenderer(const VkContext &context, const GpuScene &scene,
+                    VkRenderPass renderPass, uint32_t subpass = 0,
+                    const DepthPyramid *depthPyramid = nullptr);
+  ~GpuDrivenRenderer();
+
+  GpuDrivenRenderer(const GpuDrivenRenderer &) = delete;
+  GpuDrivenRenderer &operator=(const GpuDrivenRenderer &) = delete;
+
+  // 在 GpuScene::BeginFrame 之后、渲染通道开始前调用，自带所需的屏障。
+  // Early / Late 需要在构造时传入 DepthPyramid
+  void Cull(VkCommandBuffer commandBuffer, const glm::mat4 &viewProjection,
+            const glm::vec3 &cameraPosition,
+            const LodSelectionParams &lodParams,
+            CullPhase phase = CullPhase::All) const;
+
+  // 渲染通道内调用，视口与裁剪矩形为动态状态，由调用方设置
+  void Draw(VkCommandBuffer commandBuffer,
+            const glm::mat4 &viewProjection) const;
+
+private:
+  void createCullPipeline();
+  void createDrawPipeline(VkRenderPass renderPass, uint32_t subpass);
+
+private:
+  const VkContext &m_context;
+  const GpuScene &m_scene;
+  const DepthPyramid *m_depthPyramid;
+
+  DescriptorLayout m_cullLayout;
+  DescriptorLayout m_drawLayout;
+  DescriptorAllocator m_descriptorAllocator;
+  VkDescriptorSet m_cullSet = VK_NULL_HANDLE;
+  VkDescriptorSet m_drawSet = VK_NULL_HANDLE;
+
+  VkPipelineLayout m_cullPipelineLayout = VK_NULL_HANDLE;
+  VkPipeline m_cullPipeline = VK_NULL_HANDLE;
+  VkPipelineLayout m_drawPipelineLayout = VK_NULL_HANDLE;
+  VkPipeline m_drawPipeline = VK_NULL_HANDLE;
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Mesh/Mesh.hpp"
+#include "Vulkan/VkContext.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// GPU 驱动渲染的场景数据，std430 布局与 common/gpu_scene.glsl 一一对应。
+// 所有网格合并进同一对顶点/索引缓冲，每个对象只是对象缓冲中的一项，
+// 剔除与 LOD 选择都在计算着色器里完成，CPU 每帧只录制固定数量的命令。
+
+constexpr uint32_t GPU_SCENE_MAX_LODS = 8;
+
+struct GpuLod {
+  uint32_t firstIndex;
+  uint32_t indexCount;
+  float error;
+  uint32_t padding;
+};
+static_assert(sizeof(GpuLod) == 16);
+
+struct GpuMeshInfo {
+  glm::vec4 sphere;     // xyz 球心，w 半径（对象空间）
+  int32_t vertexOffset; // 合并顶点缓冲中的起点
+  uint32_t lodCount;
+  uint32_t padding[2];
+  GpuLod lods[GPU_SCENE_MAX_LODS];
+};
+static_assert(sizeof(GpuMeshInfo) == 160);
+
+struct GpuObject {
+  glm::mat4 model;
+  uint32_t meshIndex;
+  float maxScale; // 模型矩阵的最大轴缩放，用于包围球半径与 LOD 误差
+  uint32_t padding[2];
+};
+static_assert(sizeof(GpuObject) == 80);
+
+struct GpuSceneConfig {
+  uint32_t maxObjects = 16384;
+  uint32_t framesInFlight = 2; // 对象缓冲按帧分区，CPU 写入不会与 GPU 读取冲突
+  // 为两阶段遮挡剔除分配可见性缓冲（每个对象 4 字节），
+  // GpuDrivenRenderer 传入 DepthPyramid 时必须开启
+  bool occlusionCulling = false;
+};
+
+class GpuScene {
+public:
+  GpuScene(const VkContext &context, VkCommandPool commandPool,
+           std::span<const MeshData> meshes, const GpuSceneConfig &config = {});
+  ~GpuScene();
+
+  GpuScene(const GpuScene &) = delete;
+  GpuScene &operator=(const GpuScene &) = delete;
+
+  // 返回对象编号，超过 maxObjects 时抛出异常
+  uint32_t AddObject(uint32_t meshIndex, const glm::mat4 &model);
+  void SetTransform(uint32_t object, const glm::mat4 &model);
+
+  // 帧开始时调用，调用方需已等待该帧槽上一次提交的栅栏；
+  // 只有对象变化过的帧槽才重新写入
+  void BeginFrame(uint64_t frameIndex);
+
+  uint32_t GetObjectCount() const {
+    return static_cast<uint32_t>(m_objects.size());
+  }
+  uint32_t GetMaxObjects() const { return m_config.maxObjects; }
+  uint32_t GetMeshCount() const { return m_meshCount; }
+
+  VkBuffer GetVertexBuffer() const { return m_vertexBuffer; }
+  VkBuffer GetIndexBuffer() const { return m_indexBuffer; }
+  VkIndexType GetIndexType() const { return m_indexType; }
+  VkBuffer GetMeshBuffer() const { return m_meshBuffer; }
+  VkBuffer GetDrawBuffer() const { return m_drawBuffer; }
+  VkBuffer GetDrawCountBuffer() const { return m_drawCountBuffer; }
+  // 每个对象一个 uint，上一帧遮挡剔除后是否可见；未开启 occlusionCulling 时为空
+  VkBuffer GetVisibilityBuffer() const { return m_visibilityBuffer; }
+
+  // 对象缓冲以 STORAGE_BUFFER_DYNAMIC 绑定，range 为 GetObjectRange，
+  // 本帧数据位于 GetObjectOffset 处
+  VkBuffer GetObjectBuffer() const { return m_objectBuffer; }
+  VkDeviceSize GetObjectRange() const {
+    return VkDeviceSize(m_config.maxObjects) * sizeof(GpuObject);
+  }
+  uint32_t GetObjectOffset() const { return m_objectOffset; }
+
+private:
+  const VkContext &m_context;
+  GpuSceneConfig m_config;
+  uint32_t m_meshCount = 0;
+
+  std::vector<GpuObject> m_objects;
+  uint64_t m_objectVersion = 0;
+  std::vector<uint64_t> m_frameVersions; // 各帧槽已写入的对象版本
+
+  VkBuffer m_vertexBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_vertexMemory = VK_NULL_HANDLE;
+  VkBuffer m_indexBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_indexMemory = VK_NULL_HANDLE;
+  VkIndexType m_indexType = VK_INDEX_TYPE_UINT32;
+  VkBuffer m_meshBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_meshMemory = VK_NULL_HANDLE;
+
+  VkBuffer m_objectBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_objectMemory = VK_NULL_HANDLE;
+  uint8_t *m_objectMapped = nullptr;
+  VkDeviceSize m_objectStride = 0; // 每帧分区的大小，按存储缓冲偏移对齐
+  uint32_t m_objectOffset = 0;
+
+  VkBuffer m_drawBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_drawMemory = VK_NULL_HANDLE;
+  VkBuffer m_drawCountBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_drawCountMemory = VK_NULL_HANDLE;
+  VkBuffer m_visibilityBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_visibilityMemory = VK_NULL_HANDLE;
+};
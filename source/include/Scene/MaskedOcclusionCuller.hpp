@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Mesh/Mesh.hpp"
+#include "Scene/FrustumCuller.hpp"
+#include "utils/ThreadPool.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// 遮挡体：一段三角形列表（通常是网格较粗的一级 LOD）与其模型矩阵。
+// 遮挡体只应覆盖真实几何的内部，简化后外扩的轮廓会造成少量误剔除
+struct OccluderMesh {
+  std::span<const Vertex> vertices;
+  std::span<const uint32_t> indices;
+  glm::mat4 model;
+};
+
+struct MaskedOcclusionConfig {
+  uint32_t width = 256; // 向上取整到 TILE_WIDTH 的倍数
+  uint32_t height = 128; // 向上取整到 TILE_HEIGHT 的倍数
+};
+
+// CPU 端的掩码软件遮挡剔除，完全不依赖 GPU：
+// 把遮挡体光栅化到低分辨率缓冲，再用对象的包围盒查询是否被完全挡住。
+//
+// 缓冲按 32x8 的块组织，每块不保存逐像素深度，而是两层保守深度：
+// - zMax0：整块所有像素的深度都不超过它
+// - 工作层：覆盖掩码（每行 32 位）以及掩码内像素的最大深度 zMax1
+// 三角形只需求出块内的覆盖掩码（逐行的跨度，SIMD 一次算 4 / 8 行）和块内最大深度，
+// 合并进工作层；工作层覆盖满整块时成为新的 zMax0。
+// 本仓库使用常规深度（近 0 远 1），包围盒最近的深度不小于覆盖像素的上界即被遮挡。
+//
+// 光栅化分两步并行：先按三角形分批变换、裁剪、建立边方程并分箱，
+// 再按屏幕分箱（BIN_COLUMNS x BIN_ROWS 个矩形区域）各自光栅化，箱之间没有写冲突。
+//
+// 每帧用法：BeginFrame -> RenderOccluders（可多次）-> FilterVisible / IsVisible
+class MaskedOcclusionCuller {
+public:
+  static constexpr uint32_t TILE_WIDTH = 32;
+  static constexpr uint32_t TILE_HEIGHT = 8;
+  static constexpr uint32_t BIN_COLUMNS = 4;
+  static constexpr uint32_t BIN_ROWS = 4;
+  // 三角形准备阶段每个任务处理的三角形数
+  static constexpr uint32_t JOB_TRIANGLES = 1024;
+  // 查询阶段每个任务处理的对象数
+  static constexpr uint32_t TEST_CHUNK_SIZE = 1024;
+
+  explicit MaskedOcclusionCuller(const MaskedOcclusionConfig &config = {},
+                                 ThreadPool &threadPool = ThreadPool::Get(),
+                                 SimdLevel level = detectSimdLevel());
+
+  // 清空缓冲并设置本帧的 projection * view
+  void BeginFrame(const glm::mat4 &viewProjection);
+
+  // 光栅化遮挡体，可在一帧内多次调用，结果累积
+  void RenderOccluders(std::span<const OccluderMesh> occluders);
+
+  // center ± extent 为世界空间包围盒；跨过近平面的包围盒总是可见
+  bool IsVisible(const glm::vec3 &center, const glm::vec3 &extent) const;
+
+  // 就地移除 visible 中被遮挡的编号，保持原有顺序；
+  // 通常接在 FrustumCuller::Cull 之后，只测试视锥内的对象
+  void FilterVisible(const CullingBounds &bounds,
+                     std::vector<uint32_t> &visible);
+
+  // 逐像素展开的保守深度（行优先，width * height），用于调试显示
+  void ResolveDepth(std::vector<float> &depth) const;
+
+  uint32_t GetWidth() const { return m_width; }
+  uint32_t GetHeight() const { return m_height; }
+  SimdLevel GetSimdLevel() const { return m_level; }
+
+  // 上一次 RenderOccluders 送入光栅化的三角形数（裁剪与视锥外剔除之后）
+  uint32_t GetRasterizedTriangleCount() const { return m_triangleCount; }
+
+  // 三角形准备后的结果：逐行左右边界的直线方程与深度平面，坐标单位为像素
+  struct Triangle {
+    float leftOffset[2], leftSlope[2];   // x = offset + slope * y，取最大值
+    float rightOffset[2], rightSlope[2]; // 取最小值
+    float minY, maxY;                    // 覆盖的扫描线范围
+    float minX, maxX;
+    float zA, zB, zC; // z = zA * x + zB * y + zC
+    float zMax;       // 三个顶点的最大深度
+    uint16_t tileX0, tileX1, tileY0, tileY1; // 覆盖的块范围（含）
+  };
+
+private:
+  struct TriangleJob {
+    uint32_t occluder;
+    uint32_t firstTriangle;
+    uint32_t triangleCount;
+    std::vector<Triangle> triangles;
+    std::vector<uint32_t> binned[BIN_COLUMNS * BIN_ROWS];
+  };
+
+  void transformVertices(std::span<const OccluderMesh> occluders);
+  void setupTriangles(const OccluderMesh &occluder, TriangleJob &job) const;
+  void emitTriangle(const glm::vec4 clip[3], TriangleJob &job) const;
+  void rasterizeBin(uint32_t bin);
+  void updateTile(uint32_t tile, const uint32_t rowMasks[TILE_HEIGHT],
+                  float depth);
+
+private:
+  ThreadPool &m_threadPool;
+  SimdLevel m_level;
+  uint32_t m_width;
+  uint32_t m_height;
+  uint32_t m_tilesX;
+  uint32_t m_tilesY;
+  glm::mat4 m_viewProjection{1.0f};
+
+  // 每块的两层深度与工作层掩码（每块 TILE_HEIGHT 个 32 位行）
+  std::vector<float> m_zMax0;
+  std::vector<float> m_zMax1;
+  std::vector<uint32_t> m_masks;
+
+  std::vector<glm::vec4> m_clipVertices; // 所有遮挡体的裁剪空间顶点
+  std::vector<uint32_t> m_vertexOffsets; // 各遮挡体在 m_clipVertices 中的起点
+  std::vector<TriangleJob> m_jobs;
+  uint32_t m_jobCount = 0;
+  uint32_t m_triangleCount = 0;
+
+  std::vector<uint32_t> m_chunkCounts; // FilterVisible 各块保留的数量
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Scene/Aabb.hpp"
+#include "utils/ThreadPool.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+struct RayHit {
+  uint32_t object;
+  float distance;
+};
+
+// 射线与对象的精确求交：返回 [0, maxDistance) 内的距离，未命中返回负数。
+// 不提供时以对象包围盒的进入距离作为命中
+using RayIntersector =
+    std::function<float(uint32_t object, float maxDistance)>;
+
+// 场景对象的 4 叉 BVH，用于视锥剔除、射线拾取与邻近查询：
+// - Build：分箱 SAH 自顶向下构建。大区间的分箱在线程池上并行统计，
+//   区间缩小到 SUBTREE_SIZE 以下后整棵子树作为一个任务并行构建
+// - Refit：对象移动后自底向上更新节点包围盒，拓扑不变，各子树并行
+// - Update：Refit 后若 SAH 代价相对构建时劣化超过阈值则重新 Build
+//
+// 节点按 4 个子节点的包围盒分量连续存放（SoA），一次遍历步骤读取两条缓存行即可
+// 测试全部 4 个子节点；父节点编号总是小于子节点，逆序遍历即可自底向上 Refit。
+// 对象包围盒按叶子顺序另存一份，叶子内的测试同样是连续访问。
+class SceneBvh {
+public:
+  static constexpr uint32_t WIDTH = 4;
+  static constexpr uint32_t BIN_COUNT = 16;
+  static constexpr uint32_t MAX_LEAF_SIZE = 4;
+  static constexpr uint32_t SUBTREE_SIZE = 4096;
+
+  // 子节点槽：count 为 0 时 index 是内部节点编号，否则是叶子在对象编号数组中的起点
+  static constexpr uint32_t EMPTY_CHILD = UINT32_MAX;
+
+  struct alignas(64) Node {
+    float minX[WIDTH], minY[WIDTH], minZ[WIDTH];
+    float maxX[WIDTH], maxY[WIDTH], maxZ[WIDTH];
+    uint32_t index[WIDTH];
+    uint32_t count[WIDTH];
+  };
+  static_assert(sizeof(Node) == 128);
+
+  explicit SceneBvh(ThreadPool &threadPool = ThreadPool::Get());
+
+  // bounds[i] 为对象 i 的世界空间包围盒
+  void Build(std::span<const Aabb> bounds);
+  // 对象数量必须与 Build 时相同
+  void Refit(std::span<const Aabb> bounds);
+  // 返回是否重建；rebuildThreshold 为允许的 SAH 代价倍数
+  bool Update(std::span<const Aabb> bounds, float rebuildThreshold = 1.5f);
+
+  // 包围盒与视锥相交的对象，顺序不定；完全在视锥内的子树不再逐个测试
+  void QueryFrustum(const glm::mat4 &viewProjection,
+                    std::vector<uint32_t> &objects) const;
+  // 包围盒与球相交的对象
+  void QuerySphere(const glm::vec3 &center, float radius,
+                   std::vector<uint32_t> &objects) const;
+  // 最近命中，direction 不需要归一化（距离以 direction 的长度为单位）
+  bool Raycast(const glm::vec3 &origin, const glm::vec3 &direction,
+               float maxDistance, RayHit &hit,
+               const RayIntersector &intersector = nullptr) const;
+
+  uint32_t GetObjectCount() const {
+    return static_cast<uint32_t>(m_objectIndices.size());
+  }
+  uint32_t GetNodeCount() const { return static_cast<uint32_t>(m_nodes.size()); }
+  const Aabb &GetBounds() const { return m_rootBounds; }
+  // 相对根包围盒表面积归一化的 SAH 代价
+  float GetCost() const { return m_cost; }
+  float GetBuildCost() const { return m_buildCost; }
+
+private:
+  // 对象编号数组 [begin, end) 及其包围盒、质心包围盒
+  struct Range {
+    uint32_t begin;
+    uint32_t end;
+    Aabb bounds;
+    Aabb centroidBounds;
+  };
+
+  // 尚未展开的子节点槽：父节点编号与槽位
+  struct PendingChild {
+    uint32_t parent;
+    uint32_t slot;
+    Range range;
+  };
+
+  // 构建时按区间原地划分的对象包围盒，划分移动的是数据本身，分箱时顺序访问
+  struct BuildPrimitive {
+    Aabb bounds;
+    uint32_t object;
+  };
+
+  struct Subtree {
+    uint32_t firstNode;
+    uint32_t nodeCount;
+    std::vector<Node> nodes; // 构建时的局部节点，合并后清空
+  };
+
+  Range makeRange(uint32_t begin, uint32_t end, bool parallel) const;
+  bool splitRange(const Range &range, Range &left, Range &right,
+                  bool parallel);
+  uint32_t gatherChildren(const Range &range, Range children[WIDTH],
+                          bool parallel);
+  void buildSubtree(const Range &range, uint32_t baseNode,
+                    std::vector<Node> &nodes);
+  void setChild(Node &node, uint32_t slot, const Range &range) const;
+  float refitNodes(uint32_t firstNode, uint32_t nodeCount);
+
+  template <typename Visit>
+  void forEachLeafObject(uint32_t nodeIndex, Visit &&visit) const;
+
+private:
+  ThreadPool &m_threadPool;
+  std::vector<BuildPrimitive> m_primitives; // 只在 Build 期间使用
+  std::vector<uint32_t> m_objectIndices;
+  std::vector<Aabb> m_leafBounds; // m_leafBounds[i] 是对象 m_objectIndices[i] 的包围盒
+  std::vector<Node> m_nodes;
+  std::vector<Subtree> m_subtrees;
+  uint32_t m_topNodeCount = 0; // 串行展开的顶层节点数，其后依次是各子树
+  Aabb m_rootBounds;
+  float m_cost = 0.0f;
+  float m_buildCost = 0.0f;
+};
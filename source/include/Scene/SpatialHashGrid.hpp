@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Scene/Aabb.hpp"
+#include "utils/ThreadPool.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct SpatialHashGridConfig {
+  float cellSize = 8.0f;
+  uint32_t bucketCount = 16384; // 向上取整到 2 的幂
+};
+
+// 松散网格 + 空间哈希，适合每帧都在移动的大量对象：
+// - 对象只按包围盒中心放进一个格子，格子的松散边界向外扩半个格子，
+//   半长不超过 cellSize / 2 的对象一定落在所在格子的松散边界内；更大的对象单独存放
+// - 格子坐标哈希到固定数量的桶，世界大小不受限制；
+//   不同格子可能共用一个桶，桶内每项带着格子坐标，查询时先按格子过滤，
+//   被剔除的格子不会访问对象的包围盒
+// - 桶内用交换删除，对象记录自己在桶内的位置，单个插入、删除与更新都是 O(1)
+//
+// 批量操作分三步：先并行计算每个对象的目标桶（多数移动的对象仍在原来的桶内，直接跳过），
+// 再把需要换桶的对象按桶所属的分片分组，最后按分片并行地先删除、后插入，分片之间不会写同一个桶。
+// 对象编号由调用方分配，通常是场景中的对象下标；同一批次内编号不能重复。
+class SpatialHashGrid {
+public:
+  static constexpr uint32_t SHARD_COUNT = 64;
+  static constexpr uint32_t INVALID_BUCKET = UINT32_MAX;
+  // 查询视锥时每个任务处理的桶数
+  static constexpr uint32_t QUERY_CHUNK_SIZE = 1024;
+
+  explicit SpatialHashGrid(const SpatialHashGridConfig &config = {},
+                           ThreadPool &threadPool = ThreadPool::Get());
+
+  void Insert(uint32_t object, const Aabb &bounds);
+  void Update(uint32_t object, const Aabb &bounds);
+  void Remove(uint32_t object);
+
+  void InsertBatch(std::span<const uint32_t> objects,
+                   std::span<const Aabb> bounds);
+  void UpdateBatch(std::span<const uint32_t> objects,
+                   std::span<const Aabb> bounds);
+  void RemoveBatch(std::span<const uint32_t> objects);
+
+  void Clear();
+
+  bool Contains(uint32_t object) const {
+    return object < m_entries.size() &&
+           m_entries[object].bucket != INVALID_BUCKET;
+  }
+
+  // 包围盒与球相交的对象
+  void QuerySphere(const glm::vec3 &center, float radius,
+                   std::vector<uint32_t> &objects) const;
+  // 包围盒与视锥相交的对象，按桶并行遍历，结果顺序固定
+  void QueryFrustum(const glm::mat4 &viewProjection,
+                    std::vector<uint32_t> &objects);
+
+  uint32_t GetObjectCount() const { return m_objectCount; }
+  uint32_t GetOversizedCount() const {
+    return static_cast<uint32_t>(m_buckets[m_bucketCount].size());
+  }
+  float GetCellSize() const { return m_cellSize; }
+
+private:
+  struct Entry {
+    Aabb bounds;
+    uint32_t bucket = INVALID_BUCKET;
+    uint32_t slot = 0; // 在桶内的位置
+  };
+
+  struct BucketItem {
+    glm::ivec3 cell;
+    uint32_t object;
+  };
+
+  // 批量操作中对象的新位置，from / to 为 INVALID_BUCKET 表示插入 / 删除；
+  // from == to 时只需更新桶内的格子坐标
+  struct Move {
+    uint32_t object;
+    uint32_t from;
+    uint32_t to;
+    glm::ivec3 cell;
+  };
+
+  enum class BatchMode { Insert, Update, Remove };
+
+  glm::ivec3 cellOf(const glm::vec3 &point) const;
+  uint32_t bucketOf(const glm::ivec3 &cell) const;
+  // 过大的对象放在最后一个桶（编号 m_bucketCount）
+  uint32_t placeEntry(Entry &entry, const Aabb &bounds,
+                      glm::ivec3 &cell) const;
+
+  void addToBucket(uint32_t object, uint32_t bucket, const glm::ivec3 &cell);
+  void removeFromBucket(uint32_t object);
+  void applyBatch(std::span<const uint32_t> objects,
+                  std::span<const Aabb> bounds, BatchMode mode);
+  void groupByShard(bool byDestination, std::vector<uint32_t> &offsets,
+                    std::vector<uint32_t> &order) const;
+
+  static uint32_t shardOf(uint32_t bucket) {
+    return bucket & (SHARD_COUNT - 1);
+  }
+
+private:
+  ThreadPool &m_threadPool;
+  float m_cellSize;
+  float m_inverseCellSize;
+  uint32_t m_bucketCount;
+  uint32_t m_objectCount = 0;
+
+  std::vector<Entry> m_entries;                   // 按对象编号
+  std::vector<std::vector<BucketItem>> m_buckets; // m_bucketCount + 1 个
+
+  // 批量操作的临时数据，保留容量
+  std::vector<Move> m_moves;
+  std::vector<uint32_t> m_removeOffsets, m_removeOrder;
+  std::vector<uint32_t> m_insertOffsets, m_insertOrder;
+
+  std::vector<std::vector<uint32_t>> m_chunkResults; // QueryFrustum 各任务的结果
+};
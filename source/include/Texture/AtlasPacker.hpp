@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct AtlasRect {
+  uint32_t x = 0;
+  uint32_t y = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+};
+
+enum class AtlasPackMethod {
+  Skyline,    // 自底向左的天际线，适合高度相近的精灵
+  Guillotine, // 空闲矩形最佳面积匹配 + 短边切分，适合尺寸差异大的贴花
+};
+
+// 在固定尺寸的图集页内放置矩形，不做旋转
+class AtlasPacker {
+public:
+  AtlasPacker(uint32_t width, uint32_t height,
+              AtlasPackMethod method = AtlasPackMethod::Skyline);
+
+  // 放置成功返回 true 并写入 rect，空间不足返回 false
+  bool Insert(uint32_t width, uint32_t height, AtlasRect &rect);
+
+  void Reset();
+
+  // 已使用面积占整页的比例
+  float GetOccupancy() const;
+
+private:
+  struct SkylineNode {
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+  };
+
+  bool insertSkyline(uint32_t width, uint32_t height, AtlasRect &rect);
+  bool insertGuillotine(uint32_t width, uint32_t height, AtlasRect &rect);
+
+  // 以节点 index 为左端放置宽度为 width 的矩形时所需的最低 y，放不下返回 false
+  bool skylineFit(size_t index, uint32_t width, uint32_t height,
+                  uint32_t &y) const;
+
+private:
+  uint32_t m_width;
+  uint32_t m_height;
+  AtlasPackMethod m_method;
+  uint64_t m_usedArea = 0;
+
+  std::vector<SkylineNode> m_skyline;
+  std::vector<AtlasRect> m_freeRects;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// CPU 端的 RGBA8 图像，由 stb_image 解码得到
+struct ImageData {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  std::vector<uint8_t> pixels; // 按行紧密排列，每像素 4 字节
+
+  size_t ByteSize() const { return pixels.size(); }
+};
+
+// 使用 stb_image 解码图像文件并强制转换为 RGBA8，失败时抛出 std::runtime_error
+ImageData loadImageRGBA8(const std::string &filename);
+
+// 完整 mip 链的层数：floor(log2(max(w, h))) + 1
+uint32_t mipLevelCount(uint32_t width, uint32_t height);
+
+// 2x2 盒式滤波生成下一级 mip，奇数边长时重复最后一行/列
+ImageData downsampleImage(const ImageData &source);
+
+// 生成完整的 mip 链，返回值第 0 级即为源图像
+std::vector<ImageData> generateMipChain(ImageData base);
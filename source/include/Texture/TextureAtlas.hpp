@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Texture/AtlasPacker.hpp"
+#include "Texture/ImageData.hpp"
+#include "Vulkan/VkContext.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 材质中的纹理坐标变换：uv' = uv * scale + offset，layer 为数组图像的层
+struct UVTransform {
+  float offset[2] = {0.0f, 0.0f};
+  float scale[2] = {1.0f, 1.0f};
+  uint32_t layer = 0;
+};
+
+using PackedTextureHandle = uint32_t;
+
+struct PackedTexture {
+  uint32_t imageIndex = 0; // GetImages() 中的下标
+  UVTransform uvTransform;
+};
+
+// 打包生成的 2D 数组图像：图集的每页是一层，同尺寸纹理数组每张图一层
+struct PackedImage {
+  VkImage image = VK_NULL_HANDLE;
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  VkImageView view = VK_NULL_HANDLE; // VK_IMAGE_VIEW_TYPE_2D_ARRAY
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t layers = 0;
+  uint32_t mipLevels = 0;
+  bool isAtlas = false;
+};
+
+struct TextureAtlasConfig {
+  uint32_t atlasExtent = 2048; // 图集页边长
+  uint32_t padding = 4;        // 每个子图四周外扩的边缘像素，同时限制图集 mip 数
+  uint32_t maxSpriteExtent = 512; // 超过该边长的图像不进图集
+  uint32_t minArrayLayers = 4; // 同尺寸图像达到该数量时改用纹理数组
+  AtlasPackMethod method = AtlasPackMethod::Skyline;
+};
+
+// 加载期把大量小纹理合并为少数几张数组图像，减少描述符切换：
+// 同尺寸且数量足够的图像组成纹理数组（保留完整 mip 链），其余小图打包进图集页。
+// 材质保存 Get() 返回的 UVTransform，着色器以
+// texture(sampler2DArray, vec3(uv * scale + offset, layer)) 采样。
+//
+// 图集子图按 2^(mips-1) 对齐并外扩 padding，mip 数限制在 floor(log2(padding)) + 1，
+// 保证各级 mip 的双线性过滤都不会采到相邻子图。
+class TextureAtlasBuilder {
+public:
+  TextureAtlasBuilder(const VkContext &context,
+                      const TextureAtlasConfig &config = {});
+  ~TextureAtlasBuilder();
+
+  TextureAtlasBuilder(const TextureAtlasBuilder &) = delete;
+  TextureAtlasBuilder &operator=(const TextureAtlasBuilder &) = delete;
+
+  // 用 stb_image 解码并登记图像，Build() 之前调用
+  PackedTextureHandle Add(const std::string &filename);
+  PackedTextureHandle Add(ImageData image);
+
+  // 打包并上传所有登记的图像，完成后释放 CPU 端像素
+  void Build();
+
+  const PackedTexture &Get(PackedTextureHandle handle) const {
+    return m_entries[handle].packed;
+  }
+  const std::vector<PackedImage> &GetImages() const { return m_images; }
+  VkSampler GetSampler() const { return m_sampler; }
+
+private:
+  struct Entry {
+    ImageData image;
+    PackedTexture packed;
+  };
+
+  void buildArrays(const std::vector<PackedTextureHandle> &handles);
+  void buildAtlas(std::vector<PackedTextureHandle> handles);
+  void uploadImage(PackedImage &target,
+                   const std::vector<std::vector<ImageData>> &layerMips);
+
+private:
+  const VkContext &m_context;
+  TextureAtlasConfig m_config;
+
+  VkCommandPool m_commandPool = VK_NULL_HANDLE;
+  VkSampler m_sampler = VK_NULL_HANDLE;
+
+  std::vector<Entry> m_entries;
+  std::vector<PackedImage> m_images;
+};
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "Texture/ImageData.hpp"
+#include "Vulkan/VkContext.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 流送纹理句柄
+using StreamedTextureHandle = uint32_t;
+constexpr StreamedTextureHandle INVALID_TEXTURE_HANDLE = UINT32_MAX;
+
+struct TextureStreamerConfig {
+  VkDeviceSize budgetBytes = 256ull << 20; // 纹理显存预算上限
+  float budgetUsageRatio = 0.9f; // 使用 VK_EXT_memory_budget 报告预算的比例
+  uint32_t tailMaxExtent = 64;  // 注册后立即常驻的尾部 mip 最大边长
+  uint32_t maxUploadsPerFrame = 4; // 每帧最多发起的 mip 重建次数
+  uint32_t framesInFlight = 2;     // 旧图像延迟销毁的帧数
+};
+
+// 按 mip 级别流送纹理：先常驻低精度尾部 mip，再按屏幕空间需求在后台提升精度，
+// 超出显存预算时按最近最少使用（LRU）顺序降级。
+//
+// 不依赖稀疏绑定：每次改变常驻级别都会重建一张只含常驻 mip 的图像，
+// 图像视图的第 0 级即为当前最高常驻 mip，因此采样永远不会触及未常驻的 mip。
+// 调用方在 GetImageView() 返回值变化后需要更新描述符。
+//
+// CPU 端不常驻像素数据：重建图像时已常驻的级别从旧图像复制，
+// 只有新提升的级别需要像素，由后台线程重新解码源文件得到，上传后立即释放。
+class TextureStreamer {
+public:
+  TextureStreamer(const VkContext &context,
+                  const TextureStreamerConfig &config = {});
+  ~TextureStreamer();
+
+  TextureStreamer(const TextureStreamer &) = delete;
+  TextureStreamer &operator=(const TextureStreamer &) = delete;
+
+  // 注册纹理文件，解码与 mip 生成在后台线程完成
+  StreamedTextureHandle Load(const std::string &filename);
+
+  // 上报本帧需要的最精细 mip 级别（越小越精细），同一帧内取最小值
+  void RequestMip(StreamedTextureHandle handle, uint32_t mipLevel);
+
+  // 每帧调用一次：回收完成的上传、按预算淘汰并发起新的流送
+  void Update(uint64_t frameIndex);
+
+  // 当前可采样的图像视图，尚未常驻时返回 VK_NULL_HANDLE
+  VkImageView GetImageView(StreamedTextureHandle handle) const;
+
+  // 当前常驻的最精细 mip 级别（相对完整 mip 链）
+  uint32_t GetResidentMip(StreamedTextureHandle handle) const;
+
+  VkDeviceSize GetResidentBytes() const { return m_residentBytes; }
+  VkDeviceSize GetRetiredBytes() const { return m_retiredBytes; }
+  VkDeviceSize GetBudgetBytes() const { return m_budgetBytes; }
+
+  // 根据纹理尺寸和它在屏幕上覆盖的像素边长估算需要的 mip 级别
+  static uint32_t ComputeDesiredMip(uint32_t width, uint32_t height,
+                                    float screenExtentPixels);
+
+private:
+  // 一次 mip 范围重建：新图像上传完成前旧图像继续被采样
+  struct PendingUpload {
+    uint32_t targetMip = 0;
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+    VkDeviceSize bytes = 0;
+    VkBuffer stagingBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;
+  };
+
+  struct StreamedTexture {
+    std::string filename;
+    // 每级 mip 的尺寸，解码完成前为空；像素只在等待上传时暂存
+    std::vector<ImageData> mips;
+    uint32_t mipCount = 0;
+    uint32_t tailMip = 0;      // 始终常驻的最粗 mip 起点
+    uint32_t residentMip = 0;  // 当前常驻的最精细 mip，mipCount 表示未常驻
+    uint32_t requestedMip = 0; // 本帧请求的最精细 mip
+    uint64_t lastUsedFrame = 0;
+    bool requested = false; // 自上次 Update 以来是否被请求过
+    bool decoding = false;     // 后台正在重新解码精细级别
+    bool decodeFailed = false; // 重新解码失败，不再提升精度
+
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+    VkDeviceSize bytes = 0;
+
+    bool uploading = false;
+    PendingUpload upload;
+  };
+
+  // 后台解码请求：只保留 [firstMip, lastMip) 的像素，首次解码保留全部
+  struct DecodeRequest {
+    StreamedTextureHandle handle;
+    std::string filename;
+    uint32_t firstMip;
+    uint32_t lastMip;
+  };
+
+  // 解码完成、等待主线程接收的结果
+  struct DecodeResult {
+    StreamedTextureHandle handle;
+    std::vector<ImageData> mips;
+  };
+
+  // 等待 framesInFlight 帧后销毁的旧图像
+  struct RetiredImage {
+    uint64_t retireFrame;
+    VkImage image;
+    VkDeviceMemory memory;
+    VkImageView view;
+    VkDeviceSize bytes;
+  };
+
+  void workerLoop();
+  void queryBudget();
+  void collectDecodedTextures();
+  // 上传尚无图像的纹理的尾部 mip，失败时保留像素，下一帧重试
+  void uploadTails();
+  void pollUploads();
+  void destroyRetiredImages(bool force);
+  void evictToBudget();
+  void streamIn();
+  void requestDecode(StreamedTextureHandle handle, uint32_t firstMip,
+                     uint32_t lastMip);
+  bool beginUpload(StreamedTextureHandle handle, uint32_t targetMip);
+  VkDeviceSize estimateBytes(const StreamedTexture &texture,
+                             uint32_t firstMip) const;
+
+  static bool hasPixels(const StreamedTexture &texture, uint32_t firstMip,
+                        uint32_t lastMip);
+  static void releasePixels(StreamedTexture &texture, uint32_t firstMip);
+
+private:
+  const VkContext &m_context;
+  TextureStreamerConfig m_config;
+
+  VkCommandPool m_commandPool = VK_NULL_HANDLE;
+
+  std::vector<StreamedTexture> m_textures;
+  std::deque<RetiredImage> m_retiredImages;
+
+  uint64_t m_frameIndex = 0;
+  uint32_t m_uploadsThisFrame = 0;
+  VkDeviceSize m_residentBytes = 0; // 已常驻与正在上传的图像总字节数
+  VkDeviceSize m_retiredBytes = 0;  // 已替换、等待在途帧结束后释放的图像字节数
+  VkDeviceSize m_budgetBytes = 0;   // 本帧生效的预算
+
+  // 后台解码线程
+  std::thread m_worker;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::deque<DecodeRequest> m_decodeQueue;
+  std::vector<DecodeResult> m_decodedResults;
+  bool m_stopWorker = false;
+};
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "Texture/ImageData.hpp"
+#include "Vulkan/VkContext.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+struct VirtualTextureConfig {
+  uint32_t pageSize = 128;             // 页面有效像素边长
+  uint32_t pageBorder = 4;             // 双线性过滤所需的页面边框
+  uint32_t cachePagesPerSide = 16;     // 物理页缓存每边的页数
+  uint32_t virtualPagesPerSide = 256;  // 虚拟空间每边的页数（2 的幂）
+  uint32_t feedbackDivisor = 8;        // 反馈缓冲相对屏幕的缩小倍数
+  uint32_t maxUploadsPerFrame = 16;    // 每帧最多写入物理缓存的页数
+  uint32_t maxPendingRequests = 256;   // 后台加载队列上限
+  uint32_t framesInFlight = 2;         // 反馈回读与暂存缓冲的分帧数
+};
+
+// 纹理在虚拟空间中的位置，材质用它把网格 UV 变换到虚拟 UV
+struct VirtualTextureRegion {
+  float uvOffset[2];
+  float uvScale[2];
+};
+
+// 与 resources/shaders/virtual_texture/vt_common.glsl 中特化常量一一对应
+struct VirtualTextureShaderConstants {
+  uint32_t pageSize;
+  uint32_t pageBorder;
+  uint32_t cachePagesPerSide;
+  uint32_t virtualPagesPerSide;
+  uint32_t maxMipLevel;
+  float feedbackScale; // 反馈分辨率缩小导致的导数补偿
+};
+
+// 软件虚拟纹理：固定大小的物理页缓存 + 带 mip 的页表（间接纹理），
+// 低分辨率反馈 pass 记录每个像素需要的页面，后台线程从源图像切出页面填充缓存。
+//
+// 不依赖稀疏绑定，可运行在 lavapipe 等软件 ICD 上；显存占用只由配置决定，
+// 与场景引用的纹理总量无关。
+//
+// 每帧调用顺序：Update(cmd) 上传新页与页表 -> 场景 pass 采样 ->
+// BeginFeedbackPass/EndFeedbackPass 之间用反馈管线绘制场景。
+// 调用方需保证 frameIndex 对应的帧栏栅已等待，反馈回读缓冲才可安全读取。
+class VirtualTexture {
+public:
+  VirtualTexture(const VkContext &context, VkExtent2D screenExtent,
+                 const VirtualTextureConfig &config = {});
+  ~VirtualTexture();
+
+  VirtualTexture(const VirtualTexture &) = delete;
+  VirtualTexture &operator=(const VirtualTexture &) = delete;
+
+  // 把一张图像放入虚拟空间（只读取尺寸，像素在需要时由后台线程解码）
+  VirtualTextureRegion AddTexture(const std::string &filename);
+
+  // 处理反馈、回收加载好的页面，并把缓存与页表更新录制到 commandBuffer
+  void Update(VkCommandBuffer commandBuffer, uint64_t frameIndex);
+
+  // 反馈 pass：清空为“无请求”，结束时把结果复制到本帧的回读缓冲
+  void BeginFeedbackPass(VkCommandBuffer commandBuffer, uint64_t frameIndex);
+  void EndFeedbackPass(VkCommandBuffer commandBuffer, uint64_t frameIndex);
+
+  VkRenderPass GetFeedbackRenderPass() const { return m_feedbackRenderPass; }
+  VkExtent2D GetFeedbackExtent() const { return m_feedbackExtent; }
+
+  VkImageView GetCacheView() const { return m_cacheView; }
+  VkImageView GetPageTableView() const { return m_pageTableView; }
+  VkSampler GetCacheSampler() const { return m_cacheSampler; }
+  VkSampler GetPageTableSampler() const { return m_pageTableSampler; }
+
+  VirtualTextureShaderConstants GetShaderConstants() const;
+
+  // 供管线创建使用的特化常量描述，constants 需在创建管线时保持有效
+  static void
+  FillSpecializationInfo(const VirtualTextureShaderConstants &constants,
+                         VkSpecializationMapEntry (&entries)[6],
+                         VkSpecializationInfo &info);
+
+  uint32_t GetResidentPageCount() const {
+    return static_cast<uint32_t>(m_residentPages.size());
+  }
+
+private:
+  // 页面键：level << 24 | y << 12 | x，与反馈着色器输出的编码一致
+  static constexpr uint32_t INVALID_PAGE = UINT32_MAX;
+  static uint32_t makePageKey(uint32_t level, uint32_t x, uint32_t y) {
+    return (level << 24) | (y << 12) | x;
+  }
+  static uint32_t pageLevel(uint32_t key) { return key >> 24; }
+  static uint32_t pageX(uint32_t key) { return key & 0xFFF; }
+  static uint32_t pageY(uint32_t key) { return (key >> 12) & 0xFFF; }
+
+  struct VirtualSource {
+    std::string filename;
+    uint32_t width, height;    // 源图像像素尺寸
+    uint32_t pageX, pageY;     // 在第 0 级虚拟页网格中的起点
+    uint32_t pagesW, pagesH;   // 占用的页数
+  };
+
+  struct CacheSlot {
+    uint32_t pageKey = INVALID_PAGE;
+    uint64_t lastUsedFrame = 0;
+    bool pinned = false; // 最粗一级页面常驻，保证总有可回退的数据
+  };
+
+  struct LoadedPage {
+    uint32_t pageKey;
+    std::vector<uint8_t> pixels; // paddedPageSize^2 个 RGBA8 像素
+  };
+
+  void createResources(VkExtent2D screenExtent);
+  void createFeedbackResources();
+  void workerLoop();
+  void buildPage(uint32_t pageKey, std::vector<uint8_t> &pixels,
+                 std::unordered_map<uint32_t, std::vector<ImageData>> &cache,
+                 std::deque<uint32_t> &cacheOrder);
+  void processFeedback(uint64_t frameIndex);
+  void requestPage(uint32_t pageKey, uint64_t frameIndex,
+                   std::vector<uint32_t> &requests);
+  uint32_t allocateSlot(uint64_t frameIndex);
+  void rebuildPageTable();
+
+  uint32_t paddedPageSize() const {
+    return m_config.pageSize + 2 * m_config.pageBorder;
+  }
+  uint32_t levelPages(uint32_t level) const {
+    return m_config.virtualPagesPerSide >> level;
+  }
+
+private:
+  const VkContext &m_context;
+  VirtualTextureConfig m_config;
+  uint32_t m_levelCount = 0; // 虚拟空间 mip 级数，最粗一级只有一页
+
+  // 物理页缓存与页表
+  VkImage m_cacheImage = VK_NULL_HANDLE;
+  VkDeviceMemory m_cacheMemory = VK_NULL_HANDLE;
+  VkImageView m_cacheView = VK_NULL_HANDLE;
+  VkSampler m_cacheSampler = VK_NULL_HANDLE;
+  VkImage m_pageTableImage = VK_NULL_HANDLE;
+  VkDeviceMemory m_pageTableMemory = VK_NULL_HANDLE;
+  VkImageView m_pageTableView = VK_NULL_HANDLE;
+  VkSampler m_pageTableSampler = VK_NULL_HANDLE;
+  bool m_imagesInitialized = false;
+
+  // 按帧划分的暂存缓冲（常驻映射）
+  VkBuffer m_stagingBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_stagingMemory = VK_NULL_HANDLE;
+  uint8_t *m_stagingMapped = nullptr;
+  VkDeviceSize m_stagingFrameSize = 0;
+
+  // 反馈 pass
+  VkExtent2D m_feedbackExtent{};
+  VkImage m_feedbackImage = VK_NULL_HANDLE;
+  VkDeviceMemory m_feedbackMemory = VK_NULL_HANDLE;
+  VkImageView m_feedbackView = VK_NULL_HANDLE;
+  VkImage m_feedbackDepthImage = VK_NULL_HANDLE;
+  VkDeviceMemory m_feedbackDepthMemory = VK_NULL_HANDLE;
+  VkImageView m_feedbackDepthView = VK_NULL_HANDLE;
+  VkRenderPass m_feedbackRenderPass = VK_NULL_HANDLE;
+  VkFramebuffer m_feedbackFramebuffer = VK_NULL_HANDLE;
+  std::vector<VkBuffer> m_readbackBuffers;
+  std::vector<VkDeviceMemory> m_readbackMemories;
+  std::vector<const uint32_t *> m_readbackMapped;
+  std::vector<bool> m_readbackValid;
+
+  // CPU 端页表：每级记录自身映射，以及解析回退后的上传数据
+  std::vector<std::vector<uint32_t>> m_pageEntries;
+  std::vector<std::vector<uint32_t>> m_resolvedEntries;
+  bool m_pageTableDirty = true;
+
+  std::vector<CacheSlot> m_slots;
+  std::vector<uint32_t> m_freeSlots;
+  std::unordered_map<uint32_t, uint32_t> m_residentPages; // 页面键 -> 槽位
+  std::unordered_set<uint32_t> m_pendingPages; // 已交给后台线程的页面
+
+  // 虚拟空间分配（以页为单位的货架算法）
+  uint32_t m_shelfX = 0;
+  uint32_t m_shelfY = 0;
+  uint32_t m_shelfHeight = 0;
+
+  // 后台加载线程，m_sources 也受 m_mutex 保护
+  std::vector<VirtualSource> m_sources;
+  std::thread m_worker;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::deque<uint32_t> m_loadQueue;
+  std::vector<LoadedPage> m_loadedPages;
+  bool m_stopWorker = false;
+};
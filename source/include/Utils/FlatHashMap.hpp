@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// 开放寻址、线性探测的哈希表，键值连续存放在一个数组里，查找时缓存友好。
+// 只支持插入与查找，不支持删除，适合一次性构建的大表（顶点去重、批次合并等）。
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename Equal = std::equal_to<Key>>
+class FlatHashMap {
+public:
+  explicit FlatHashMap(size_t expectedSize = 0) { Reserve(expectedSize); }
+
+  // 保证插入 size 个元素前不会扩容
+  void Reserve(size_t size) {
+    size_t capacity = 16;
+    while (capacity * MAX_LOAD_NUMERATOR < size * MAX_LOAD_DENOMINATOR) {
+      capacity *= 2;
+    }
+    if (capacity > m_slots.size()) {
+      rehash(capacity);
+    }
+  }
+
+  // 键不存在时插入 value；返回表中值的指针以及是否新插入。
+  // 指针在下一次插入前有效
+  std::pair<Value *, bool> TryEmplace(const Key &key, const Value &value) {
+    if ((m_size + 1) * MAX_LOAD_DENOMINATOR >
+        m_slots.size() * MAX_LOAD_NUMERATOR) {
+      rehash(m_slots.size() * 2);
+    }
+
+    size_t index = slotIndex(key);
+    while (m_occupied[index]) {
+      if (Equal{}(m_slots[index].key, key)) {
+        return {&m_slots[index].value, false};
+      }
+      index = (index + 1) & m_mask;
+    }
+
+    m_occupied[index] = 1;
+    m_slots[index] = {key, value};
+    m_size++;
+    return {&m_slots[index].value, true};
+  }
+
+  Value *Find(const Key &key) {
+    if (m_size == 0) {
+      return nullptr;
+    }
+    size_t index = slotIndex(key);
+    while (m_occupied[index]) {
+      if (Equal{}(m_slots[index].key, key)) {
+        return &m_slots[index].value;
+      }
+      index = (index + 1) & m_mask;
+    }
+    return nullptr;
+  }
+
+  // 按槽位顺序遍历所有键值对
+  template <typename Function> void ForEach(Function &&function) const {
+    for (size_t i = 0; i < m_slots.size(); i++) {
+      if (m_occupied[i]) {
+        function(m_slots[i].key, m_slots[i].value);
+      }
+    }
+  }
+
+  void Clear() {
+    std::fill(m_occupied.begin(), m_occupied.end(), 0);
+    m_size = 0;
+  }
+
+  size_t GetSize() const { return m_size; }
+
+private:
+  // 最大负载因子 7/8 以下才能保证线性探测的平均探测长度
+  static constexpr size_t MAX_LOAD_NUMERATOR = 7;
+  static constexpr size_t MAX_LOAD_DENOMINATOR = 8;
+
+  struct Slot {
+    Key key;
+    Value value;
+  };
+
+  size_t slotIndex(const Key &key) const {
+    // std::hash 对整数是恒等映射，乘以黄金分割常数后折叠高位，让低位也充分混合
+    uint64_t hash = static_cast<uint64_t>(Hash{}(key));
+    hash *= 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(hash ^ (hash >> 32)) & m_mask;
+  }
+
+  void rehash(size_t capacity) {
+    std::vector<Slot> oldSlots = std::move(m_slots);
+    std::vector<uint8_t> oldOccupied = std::move(m_occupied);
+
+    m_slots.assign(capacity, Slot{});
+    m_occupied.assign(capacity, 0);
+    m_mask = capacity - 1;
+    m_size = 0;
+
+    for (size_t i = 0; i < oldSlots.size(); i++) {
+      if (oldOccupied[i]) {
+        size_t index = slotIndex(oldSlots[i].key);
+        while (m_occupied[index]) {
+          index = (index + 1) & m_mask;
+        }
+        m_occupied[index] = 1;
+        m_slots[index] = std::move(oldSlots[i]);
+        m_size++;
+      }
+    }
+  }
+
+private:
+  std::vector<Slot> m_slots;
+  std::vector<uint8_t> m_occupied;
+  size_t m_mask = 0;
+  size_t m_size = 0;
+};
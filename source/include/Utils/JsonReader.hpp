@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+enum class JsonType {
+  Null,
+  Bool,
+  Number,
+  String,
+  Array,
+  Object,
+};
+
+// 流式（拉取式）JSON 读取器：不构建 DOM，调用方按结构逐个读取所需字段，
+// 不关心的值用 Skip() 跳过。字符串以指向源文本的 string_view 返回，不分配内存。
+//
+//   reader.BeginObject();
+//   std::string_view key;
+//   while (reader.NextKey(key)) {
+//     if (key == "count") count = reader.ReadUint();
+//     else reader.Skip();
+//   }
+//
+// 语法错误时记录日志并抛出 std::runtime_error。
+class JsonReader {
+public:
+  explicit JsonReader(std::string_view text) : m_text(text) {}
+
+  // 下一个值的类型（不消耗输入）
+  JsonType Peek();
+
+  void BeginObject();
+  // 读取下一个键，遇到对象结尾时消耗 '}' 并返回 false
+  bool NextKey(std::string_view &key);
+
+  void BeginArray();
+  // 还有下一个元素时返回 true，遇到数组结尾时消耗 ']' 并返回 false
+  bool NextElement();
+
+  double ReadNumber();
+  uint32_t ReadUint();
+  bool ReadBool();
+  // 字符串的原始内容（转义序列未解码）
+  std::string_view ReadRawString();
+  // 解码转义序列后的字符串
+  std::string ReadString();
+
+  // 跳过下一个完整的值（包括嵌套的对象与数组）
+  void Skip();
+
+private:
+  void skipWhitespace();
+  char peekChar();
+  void expect(char c);
+  void skipCommaBefore(char closing);
+  [[noreturn]] void fail(const char *message) const;
+
+private:
+  std::string_view m_text;
+  size_t m_pos = 0;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// 只读内存映射文件，页面按需从页缓存载入，不需要把整个文件读进堆内存
+class MappedFile {
+public:
+  // 打开或映射失败时抛出异常；空文件得到 GetSize() == 0
+  explicit MappedFile(const std::string &filename);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const uint8_t *GetData() const { return m_data; }
+  size_t GetSize() const { return m_size; }
+  std::string_view GetView() const {
+    return {reinterpret_cast<const char *>(m_data), m_size};
+  }
+
+private:
+  const uint8_t *m_data = nullptr;
+  size_t m_size = 0;
+#ifdef _WIN32
+  void *m_file = nullptr;
+  void *m_mapping = nullptr;
+#else
+  int m_file = -1;
+#endif
+};
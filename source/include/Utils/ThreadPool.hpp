@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 固定数量工作线程的线程池，只提供阻塞式的 ParallelFor：
+// 调用线程也参与执行，返回时所有批次都已完成，任务抛出的第一个异常会在调用线程重新抛出。
+// 在任务内部嵌套调用 ParallelFor 时退化为串行执行，避免死锁。
+class ThreadPool {
+public:
+  // 默认使用 hardware_concurrency() - 1 个工作线程
+  static constexpr uint32_t DEFAULT_WORKER_COUNT = UINT32_MAX;
+
+  // workerCount 为 0 时没有工作线程，ParallelFor 全部在调用线程串行执行
+  explicit ThreadPool(uint32_t workerCount = DEFAULT_WORKER_COUNT);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  // 进程内共享的线程池，首次调用时创建
+  static ThreadPool &Get();
+
+  // 参与执行的线程数（工作线程 + 调用线程）
+  uint32_t GetThreadCount() const {
+    return static_cast<uint32_t>(m_workers.size()) + 1;
+  }
+
+  // 将 [0, count) 划分为不小于 minBatchSize 的批次，并行调用 function(begin, end)
+  template <typename Function>
+  void ParallelFor(size_t count, size_t minBatchSize, Function &&function) {
+    if (count == 0) {
+      return;
+    }
+    // 每个线程约 4 个批次，在负载不均时仍能互相补位
+    size_t targetBatches = size_t(GetThreadCount()) * 4;
+    size_t batchSize = std::max<size_t>(
+        std::max<size_t>(minBatchSize, 1),
+        (count + targetBatches - 1) / targetBatches);
+    size_t batchCount = (count + batchSize - 1) / batchSize;
+    if (batchCount == 1 || m_workers.empty() || s_insideTask) {
+      function(size_t(0), count);
+      return;
+    }
+
+    std::function<void(size_t)> task = [&](size_t batch) {
+      size_t begin = batch * batchSize;
+      function(begin, std::min(begin + batchSize, count));
+    };
+    run(batchCount, task);
+  }
+
+private:
+  void run(size_t batchCount, const std::function<void(size_t)> &task);
+  void drainBatches();
+  void workerLoop();
+
+private:
+  std::vector<std::thread> m_workers;
+
+  std::mutex m_runMutex; // 串行化来自不同线程的 ParallelFor
+  std::mutex m_mutex;
+  std::condition_variable m_wakeCondition;
+  std::condition_variable m_doneCondition;
+
+  const std::function<void(size_t)> *m_task = nullptr;
+  size_t m_batchCount = 0;
+  std::atomic<size_t> m_nextBatch{0};
+  size_t m_pendingWorkers = 0; // 本轮尚未完成的工作线程数
+  uint64_t m_generation = 0;   // 每轮任务加一，唤醒工作线程
+  bool m_stop = false;
+  std::exception_ptr m_exception;
+
+  static thread_local bool s_insideTask;
+};
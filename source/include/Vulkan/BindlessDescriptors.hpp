@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Vulkan/VkContext.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// 无绑定资源句柄，即描述符数组中的下标，着色器直接用它索引
+using BindlessHandle = uint32_t;
+constexpr BindlessHandle INVALID_BINDLESS_HANDLE = UINT32_MAX;
+
+// 描述符数组槽位的空闲链表分配器
+class DescriptorSlotAllocator {
+public:
+  explicit DescriptorSlotAllocator(uint32_t capacity = 0)
+      : m_capacity(capacity) {}
+
+  // 槽位耗尽时返回 INVALID_BINDLESS_HANDLE
+  BindlessHandle Allocate();
+  void Free(BindlessHandle slot);
+
+  uint32_t GetCapacity() const { return m_capacity; }
+  uint32_t GetUsedCount() const {
+    return m_next - static_cast<uint32_t>(m_freeList.size());
+  }
+
+private:
+  uint32_t m_capacity;
+  uint32_t m_next = 0; // 从未分配过的最小槽位
+  std::vector<BindlessHandle> m_freeList;
+};
+
+struct BindlessConfig {
+  uint32_t maxTextures = 16384;      // 采样图像数组容量（受设备限制裁剪）
+  uint32_t maxStorageBuffers = 4096; // 存储缓冲数组容量（受设备限制裁剪）
+  uint32_t framesInFlight = 2;       // 释放的槽位延迟复用的帧数
+};
+
+// 基于描述符索引（Vulkan 1.2 核心）的无绑定资源表：
+// 一个描述符集包含部分绑定、绑定后可更新的采样图像数组（binding 0）
+// 和存储缓冲数组（binding 1），整帧只需绑定一次，着色器按整数句柄索引。
+// 对应 GLSL 声明见 resources/shaders/common/bindless.glsl。
+class BindlessDescriptors {
+public:
+  static constexpr uint32_t TEXTURE_BINDING = 0;
+  static constexpr uint32_t STORAGE_BUFFER_BINDING = 1;
+
+  // 设备创建时是否启用了所需的描述符索引特性
+  static bool IsSupported(const VkContext &context);
+
+  BindlessDescriptors(const VkContext &context,
+                      const BindlessConfig &config = {});
+  ~BindlessDescriptors();
+
+  BindlessDescriptors(const BindlessDescriptors &) = delete;
+  BindlessDescriptors &operator=(const BindlessDescriptors &) = delete;
+
+  // 注册资源并立即写入描述符，返回可在着色器中使用的句柄
+  BindlessHandle RegisterTexture(VkImageView view, VkSampler sampler);
+  BindlessHandle RegisterStorageBuffer(VkBuffer buffer, VkDeviceSize offset = 0,
+                                       VkDeviceSize range = VK_WHOLE_SIZE);
+
+  // 替换资源（例如纹理流送重建了图像视图）：在新槽位写入并返回新句柄，
+  // 旧槽位可能仍被在途帧读取，按 Release* 的方式在 frameIndex 退休
+  BindlessHandle UpdateTexture(BindlessHandle handle, VkImageView view,
+                               VkSampler sampler, uint64_t frameIndex);
+  BindlessHandle UpdateStorageBuffer(BindlessHandle handle, VkBuffer buffer,
+                                     uint64_t frameIndex,
+                                     VkDeviceSize offset = 0,
+                                     VkDeviceSize range = VK_WHOLE_SIZE);
+
+  // 槽位在 framesInFlight 帧后才回到空闲链表，避免在途帧读到新资源
+  void ReleaseTexture(BindlessHandle handle, uint64_t frameIndex);
+  void ReleaseStorageBuffer(BindlessHandle handle, uint64_t frameIndex);
+
+  // 每帧调用一次，回收已过期的槽位
+  void Update(uint64_t frameIndex);
+
+  // 整帧绑定一次描述符集
+  void Bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint,
+            VkPipelineLayout layout, uint32_t setIndex = 0) const;
+
+  VkDescriptorSetLayout GetSetLayout() const { return m_setLayout; }
+  VkDescriptorSet GetDescriptorSet() const { return m_descriptorSet; }
+  uint32_t GetTextureCapacity() const { return m_textureSlots.GetCapacity(); }
+  uint32_t GetStorageBufferCapacity() const {
+    return m_bufferSlots.GetCapacity();
+  }
+
+private:
+  struct RetiredSlot {
+    uint64_t releaseFrame;
+    uint32_t binding;
+    BindlessHandle slot;
+  };
+
+  void writeTexture(BindlessHandle handle, VkImageView view, VkSampler sampler);
+  void writeStorageBuffer(BindlessHandle handle, VkBuffer buffer,
+                          VkDeviceSize offset, VkDeviceSize range);
+
+private:
+  const VkContext &m_context;
+  BindlessConfig m_config;
+
+  VkDescriptorSetLayout m_setLayout = VK_NULL_HANDLE;
+  VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
+  VkDescriptorSet m_descriptorSet = VK_NULL_HANDLE;
+
+  DescriptorSlotAllocator m_textureSlots;
+  DescriptorSlotAllocator m_bufferSlots;
+  std::deque<RetiredSlot> m_retiredSlots;
+};
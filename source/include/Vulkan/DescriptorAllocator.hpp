@@ -0,0 +1,139 @@
+#pragma once
+
+#include "Vulkan/VkContext.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 核心描述符类型（VK_DESCRIPTOR_TYPE_SAMPLER ~ INPUT_ATTACHMENT）的数量
+constexpr uint32_t CORE_DESCRIPTOR_TYPE_COUNT = 11;
+using DescriptorTypeCounts = std::array<uint32_t, CORE_DESCRIPTOR_TYPE_COUNT>;
+
+struct DescriptorBinding {
+  uint32_t binding;
+  VkDescriptorType type;
+  uint32_t count;
+  VkShaderStageFlags stages;
+};
+
+// 更新模板读取的单个描述符数据，按 binding 声明顺序紧密排列
+union DescriptorWrite {
+  VkDescriptorImageInfo image;
+  VkDescriptorBufferInfo buffer;
+  VkBufferView texelBuffer;
+};
+
+// 描述符集布局及与之对应的更新模板：
+// Write() 传入的数组依次包含每个 binding 的 count 个 DescriptorWrite，
+// 一次 vkUpdateDescriptorSetWithTemplate 写完整个集合。
+// 带 VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT 的布局不创建更新模板，
+// 由 DescriptorBuffer::Write() 以相同的数据格式写入。
+class DescriptorLayout {
+public:
+  DescriptorLayout(const VkContext &context,
+                   const std::vector<DescriptorBinding> &bindings,
+                   VkDescriptorSetLayoutCreateFlags flags = 0);
+  ~DescriptorLayout();
+
+  DescriptorLayout(const DescriptorLayout &) = delete;
+  DescriptorLayout &operator=(const DescriptorLayout &) = delete;
+
+  void Write(VkDescriptorSet set, const DescriptorWrite *writes) const;
+
+  VkDescriptorSetLayout Get() const { return m_layout; }
+  VkDescriptorSetLayoutCreateFlags GetFlags() const { return m_flags; }
+  const std::vector<DescriptorBinding> &GetBindings() const {
+    return m_bindings;
+  }
+  uint32_t GetWriteCount() const { return m_writeCount; }
+  const DescriptorTypeCounts &GetTypeCounts() const { return m_typeCounts; }
+
+private:
+  const VkContext &m_context;
+  VkDescriptorSetLayout m_layout = VK_NULL_HANDLE;
+  VkDescriptorUpdateTemplate m_updateTemplate = VK_NULL_HANDLE;
+  VkDescriptorSetLayoutCreateFlags m_flags;
+  std::vector<DescriptorBinding> m_bindings;
+  uint32_t m_writeCount = 0;
+  DescriptorTypeCounts m_typeCounts{};
+};
+
+struct DescriptorAllocatorConfig {
+  uint32_t initialSetsPerPool = 64;
+  uint32_t maxSetsPerPool = 4096;
+  float growthFactor = 2.0f;
+};
+
+// 可增长的描述符池链：当前池耗尽时切换到备用池或新建更大的池，
+// 新池的大小和各类型比例取自上一轮 Reset 之前实际分配的数量。
+// 每个池记录剩余的集合数与各类型描述符数，分配前先判断是否放得下，
+// 放不下时直接换池，正常情况下不会让驱动返回 OUT_OF_POOL_MEMORY。
+// 不支持单独释放描述符集，只能由 Reset() 整体回收。
+class DescriptorAllocator {
+public:
+  DescriptorAllocator(const VkContext &context,
+                      const DescriptorAllocatorConfig &config = {});
+  ~DescriptorAllocator();
+
+  DescriptorAllocator(const DescriptorAllocator &) = delete;
+  DescriptorAllocator &operator=(const DescriptorAllocator &) = delete;
+
+  // 不会因池空间不足而失败
+  VkDescriptorSet Allocate(const DescriptorLayout &layout);
+
+  // 对所有池调用 vkResetDescriptorPool，调用方需保证其中的集合已不再被 GPU 使用
+  void Reset();
+
+  uint32_t GetPoolCount() const {
+    return static_cast<uint32_t>(m_usedPools.size() + m_readyPools.size());
+  }
+
+private:
+  struct Pool {
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    uint32_t maxSets = 0;
+    DescriptorTypeCounts capacity{}; // 各类型描述符的容量
+  };
+
+  // 换到能容纳 layout 的备用池，没有时新建；forceNew 时总是新建
+  void acquirePool(const DescriptorLayout &layout, bool forceNew);
+  Pool createPool(uint32_t maxSets, const DescriptorTypeCounts &minCounts);
+
+  static bool fits(uint32_t sets, const DescriptorTypeCounts &available,
+                   const DescriptorTypeCounts &required);
+
+private:
+  const VkContext &m_context;
+  DescriptorAllocatorConfig m_config;
+
+  VkDescriptorPool m_currentPool = VK_NULL_HANDLE;
+  uint32_t m_remainingSets = 0;            // 当前池剩余的集合数
+  DescriptorTypeCounts m_remainingTypes{}; // 当前池剩余的各类型描述符数
+  std::vector<Pool> m_usedPools;           // 本轮已分配过的池
+  std::vector<Pool> m_readyPools;          // 已重置、可直接使用的池
+
+  uint32_t m_setsPerPool;
+  uint32_t m_allocatedSets = 0;            // 本轮分配的集合数
+  DescriptorTypeCounts m_allocatedTypes{}; // 本轮分配的各类型描述符数
+  DescriptorTypeCounts m_typeRatio{};      // 每 64 个集合的各类型描述符数
+};
+
+// 每个在途帧一个 DescriptorAllocator，帧槽复用时整体重置
+class FrameDescriptorAllocator {
+public:
+  FrameDescriptorAllocator(const VkContext &context, uint32_t framesInFlight,
+                           const DescriptorAllocatorConfig &config = {});
+
+  // 帧开始时调用，调用方需已等待该帧槽上一次提交的栅栏
+  void BeginFrame(uint64_t frameIndex);
+
+  VkDescriptorSet Allocate(const DescriptorLayout &layout) {
+    return m_allocators[m_current]->Allocate(layout);
+  }
+
+private:
+  std::vector<std::unique_ptr<DescriptorAllocator>> m_allocators;
+  uint32_t m_current = 0;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Vulkan/DescriptorAllocator.hpp"
+#include "Vulkan/VkContext.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// 描述符缓冲中的一个“描述符集”：相对缓冲起点的偏移及其映射地址
+struct DescriptorBufferSet {
+  VkDeviceSize offset = 0;
+  uint8_t *mapped = nullptr;
+};
+
+// VK_EXT_descriptor_buffer 后端：描述符由 vkGetDescriptorEXT 直接写入常驻映射的缓冲，
+// 绘制时只设置偏移，没有描述符池与描述符集对象。
+//
+// 与 FrameDescriptorAllocator 的用法一一对应：BeginFrame -> Allocate -> Write，
+// Write 接受与 DescriptorLayout::Write 相同的 DescriptorWrite 数组。
+// 使用要求：
+// - 布局需带 VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT，且不含动态缓冲
+// - 管线需带 VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT
+// - 缓冲描述符引用的缓冲需带 SHADER_DEVICE_ADDRESS 用途，range 不能为 VK_WHOLE_SIZE，
+//   且需先 RegisterBuffer（设备地址只查询一次），销毁缓冲前 UnregisterBuffer
+class DescriptorBuffer {
+public:
+  // 设备创建时是否启用了 VK_EXT_descriptor_buffer 及其依赖特性
+  static bool IsSupported(const VkContext &context);
+
+  DescriptorBuffer(const VkContext &context, uint32_t framesInFlight,
+                   VkDeviceSize bytesPerFrame = 4ull << 20);
+  ~DescriptorBuffer();
+
+  DescriptorBuffer(const DescriptorBuffer &) = delete;
+  DescriptorBuffer &operator=(const DescriptorBuffer &) = delete;
+
+  // 帧开始时调用，调用方需已等待该帧槽上一次提交的栅栏
+  void BeginFrame(uint64_t frameIndex);
+
+  // 在本帧区域内线性分配，超出 bytesPerFrame 时抛出异常
+  DescriptorBufferSet Allocate(const DescriptorLayout &layout);
+
+  // 缓存缓冲的设备地址，Write 中不再调用 vkGetBufferDeviceAddress
+  void RegisterBuffer(VkBuffer buffer);
+  void UnregisterBuffer(VkBuffer buffer);
+
+  // 缓冲类描述符引用未注册的缓冲时抛出异常
+  void Write(const DescriptorBufferSet &set, const DescriptorLayout &layout,
+             const DescriptorWrite *writes);
+
+  // 每个命令缓冲绑定一次描述符缓冲，之后每次绘制只需 BindSet
+  void BindBuffer(VkCommandBuffer commandBuffer) const;
+  void BindSet(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint,
+               VkPipelineLayout pipelineLayout, uint32_t setIndex,
+               const DescriptorBufferSet &set) const;
+
+private:
+  struct LayoutInfo {
+    VkDeviceSize size;
+    std::vector<VkDeviceSize> bindingOffsets; // 与 DescriptorLayout 的 binding 顺序一致
+  };
+
+  const LayoutInfo &getLayoutInfo(const DescriptorLayout &layout);
+  size_t descriptorSize(VkDescriptorType type) const;
+
+private:
+  const VkContext &m_context;
+  VkPhysicalDeviceDescriptorBufferPropertiesEXT m_properties{};
+
+  VkBuffer m_buffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_memory = VK_NULL_HANDLE;
+  uint8_t *m_mapped = nullptr;
+  VkDeviceAddress m_address = 0;
+
+  uint32_t m_framesInFlight;
+  VkDeviceSize m_bytesPerFrame;
+  VkDeviceSize m_frameBegin = 0; // 本帧区域起点
+  VkDeviceSize m_head = 0;       // 本帧区域内的分配位置
+
+  std::unordered_map<VkDescriptorSetLayout, LayoutInfo> m_layoutInfos;
+  std::unordered_map<VkBuffer, VkDeviceAddress> m_bufferAddresses;
+
+  // 扩展函数
+  PFN_vkGetDescriptorSetLayoutSizeEXT m_vkGetDescriptorSetLayoutSizeEXT =
+      nullptr;
+  PFN_vkGetDescriptorSetLayoutBindingOffsetEXT
+      m_vkGetDescriptorSetLayoutBindingOffsetEXT = nullptr;
+  PFN_vkGetDescriptorEXT m_vkGetDescriptorEXT = nullptr;
+  PFN_vkCmdBindDescriptorBuffersEXT m_vkCmdBindDescriptorBuffersEXT = nullptr;
+  PFN_vkCmdSetDescriptorBufferOffsetsEXT m_vkCmdSetDescriptorBufferOffsetsEXT =
+      nullptr;
+};
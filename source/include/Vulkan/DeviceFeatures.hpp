@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+// 创建逻辑设备时启用的特性链，各模块需要的可选特性都在这里声明
+struct DeviceFeatureChain {
+  VkPhysicalDeviceFeatures features{};
+  VkPhysicalDeviceVulkan12Features features12{};
+  VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptorBuffer{};
+  VkPhysicalDeviceMeshShaderFeaturesEXT meshShader{};
+  // VK_EXT_descriptor_buffer 依赖 VK_KHR_synchronization2（1.3 才进入核心）
+  VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2{};
+
+  // 按 apiVersion 与已启用的扩展串好 pNext 链，返回 VkDeviceCreateInfo::pNext
+  const void *Link(uint32_t apiVersion,
+                   const std::vector<const char *> &extensions);
+};
+
+// 查询设备支持的特性并选出要启用的部分；
+// 缺少特性支撑的可选扩展会从 extensions 中移除，避免启用了扩展却无法使用
+void selectDeviceFeatures(VkPhysicalDevice physicalDevice, uint32_t apiVersion,
+                          std::vector<const char *> &extensions,
+                          DeviceFeatureChain &chain);
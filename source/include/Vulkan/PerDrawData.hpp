@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Vulkan/DescriptorAllocator.hpp"
+#include "Vulkan/VkContext.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// 每次绘制的数据（变换、材质参数等）有两条传递路径：
+// - 推送常量：直接写进命令缓冲，适合不超过 PER_DRAW_PUSH_CONSTANT_SIZE 的小数据
+// - 动态 UBO：从每帧环形缓冲中子分配，绑定时只改变动态偏移，适合较大的数据
+// 对应 GLSL 声明见 resources/shaders/common/per_draw.glsl。
+
+// Vulkan 保证所有设备至少支持 128 字节的推送常量
+constexpr uint32_t PER_DRAW_PUSH_CONSTANT_SIZE = 128;
+constexpr VkShaderStageFlags PER_DRAW_STAGES =
+    VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+enum class PerDrawPath {
+  PushConstants,
+  DynamicUniform,
+};
+
+// 按每次绘制的数据大小选择路径：放得进推送常量时优先推送常量
+inline PerDrawPath selectPerDrawPath(uint32_t size) {
+  return size <= PER_DRAW_PUSH_CONSTANT_SIZE ? PerDrawPath::PushConstants
+                                             : PerDrawPath::DynamicUniform;
+}
+
+// 管线布局中使用的推送常量范围，所有管线共用以保证布局兼容
+inline VkPushConstantRange perDrawPushConstantRange() {
+  return {
+      .stageFlags = PER_DRAW_STAGES,
+      .offset = 0,
+      .size = PER_DRAW_PUSH_CONSTANT_SIZE,
+  };
+}
+
+inline void cmdPushPerDraw(VkCommandBuffer commandBuffer,
+                           VkPipelineLayout pipelineLayout, const void *data,
+                           uint32_t size) {
+  vkCmdPushConstants(commandBuffer, pipelineLayout, PER_DRAW_STAGES, 0, size,
+                     data);
+}
+
+struct PerDrawConfig {
+  uint32_t framesInFlight = 2;          // 环形缓冲的分帧数
+  uint32_t maxDrawSize = 256;           // 单次绘制数据的上限，即描述符的 range
+  VkDeviceSize bytesPerFrame = 4 << 20; // 每帧可子分配的字节数
+};
+
+// 一次子分配：绑定时传入的动态偏移，以及可直接写入的映射地址
+struct PerDrawAllocation {
+  uint32_t dynamicOffset;
+  void *mapped;
+};
+
+// 每帧环形的动态 UBO：一个常驻映射的缓冲和一个 UNIFORM_BUFFER_DYNAMIC 描述符集，
+// 所有绘制共用同一个描述符集，只通过动态偏移区分各自的数据。
+class PerDrawUniformRing {
+public:
+  static constexpr uint32_t UNIFORM_BINDING = 0;
+  // 管线布局中的描述符集编号，与 per_draw.glsl 中 PER_DRAW_SET 的默认值一致
+  static constexpr uint32_t DESCRIPTOR_SET = 1;
+
+  PerDrawUniformRing(const VkContext &context,
+                     const PerDrawConfig &config = {});
+  ~PerDrawUniformRing();
+
+  PerDrawUniformRing(const PerDrawUniformRing &) = delete;
+  PerDrawUniformRing &operator=(const PerDrawUniformRing &) = delete;
+
+  // 帧开始时调用，调用方需已等待该帧槽上一次提交的栅栏
+  void BeginFrame(uint64_t frameIndex);
+
+  // 按 minUniformBufferOffsetAlignment 对齐分配，本帧区域耗尽时抛出异常
+  PerDrawAllocation Allocate(uint32_t size);
+
+  // 分配并写入一份数据，返回其动态偏移
+  template <typename T> uint32_t Push(const T &data) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    PerDrawAllocation allocation = Allocate(sizeof(T));
+    std::memcpy(allocation.mapped, &data, sizeof(T));
+    return allocation.dynamicOffset;
+  }
+
+  void Bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint,
+            VkPipelineLayout pipelineLayout, uint32_t setIndex,
+            uint32_t dynamicOffset) const;
+
+  VkDescriptorSetLayout GetSetLayout() const { return m_layout.Get(); }
+  uint32_t GetMaxDrawSize() const { return m_config.maxDrawSize; }
+
+private:
+  const VkContext &m_context;
+  PerDrawConfig m_config;
+
+  DescriptorLayout m_layout;
+  DescriptorAllocator m_descriptorAllocator;
+  VkDescriptorSet m_set = VK_NULL_HANDLE;
+
+  VkBuffer m_buffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_memory = VK_NULL_HANDLE;
+  uint8_t *m_mapped = nullptr;
+
+  VkDeviceSize m_alignment = 0;
+  VkDeviceSize m_frameBegin = 0; // 本帧区域起点
+  VkDeviceSize m_head = 0;       // 本帧区域内的分配位置
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <set>
+#include <string>
+
+// 各模块共享的 Vulkan 设备上下文，由 HelloTriangleApplication 在创建逻辑设备后填充
+struct VkContext {
+  VkInstance instance = VK_NULL_HANDLE;             // Vulkan 实例
+  VkPhysicalDevice physicalDevice = VK_NULL_HANDLE; // 物理设备
+  VkDevice device = VK_NULL_HANDLE;                 // 逻辑设备
+  VkQueue graphicsQueue = VK_NULL_HANDLE;           // 图形队列
+  uint32_t graphicsQueueFamily = 0;                 // 图形队列族索引
+  uint32_t apiVersion = VK_API_VERSION_1_1;         // 实例与设备共同支持的 API 版本
+  VkPhysicalDeviceLimits limits{};                  // 物理设备限制
+
+  VkPhysicalDeviceFeatures features{}; // 已启用的 Vulkan 1.0 特性
+
+  // 已启用的 Vulkan 1.2 特性，设备低于 1.2 时全部为 VK_FALSE（pNext 恒为空）
+  VkPhysicalDeviceVulkan12Features features12{};
+
+  std::set<std::string> enabledExtensions; // 已启用的设备扩展
+
+  // 检查某个设备扩展是否已启用
+  bool HasExtension(const char *name) const {
+    return enabledExtensions.count(name) != 0;
+  }
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Vulkan/VkContext.hpp"
+
+#include <vector>
+
+// Vulkan 资源创建的辅助函数，出错时记录日志并抛出 std::runtime_error
+
+// 查找满足类型过滤和属性要求的内存类型
+uint32_t findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter,
+                        VkMemoryPropertyFlags properties);
+
+// 创建缓冲并分配、绑定独立的设备内存
+void createBuffer(const VkContext &context, VkDeviceSize size,
+                  VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                  VkBuffer &buffer, VkDeviceMemory &memory);
+
+// 创建 2D 图像并分配、绑定独立的设备内存，返回实际分配的字节数
+VkDeviceSize createImage(const VkContext &context, uint32_t width,
+                         uint32_t height, uint32_t mipLevels,
+                         uint32_t arrayLayers, VkFormat format,
+                         VkImageUsageFlags usage, VkImage &image,
+                         VkDeviceMemory &memory);
+
+// 创建覆盖图像全部 mip 与数组层的图像视图
+VkImageView
+createImageView(const VkContext &context, VkImage image, VkFormat format,
+                VkImageViewType viewType, uint32_t mipLevels,
+                uint32_t arrayLayers,
+                VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT);
+
+// 由 SPIR-V 字节码创建着色器模块
+VkShaderModule createShaderModule(const VkContext &context,
+                                  const std::vector<char> &code);
+
+// 录制一次性命令，提交后阻塞等待完成（仅用于加载期）
+VkCommandBuffer beginSingleTimeCommands(const VkContext &context,
+                                        VkCommandPool commandPool);
+void endSingleTimeCommands(const VkContext &context, VkCommandPool commandPool,
+                           VkCommandBuffer commandBuffer);
+
+// 创建设备本地缓冲，经暂存缓冲上传 data 后阻塞等待完成（仅用于加载期）
+void uploadDeviceLocalBuffer(const VkContext &context,
+                             VkCommandPool commandPool, const void *data,
+                             VkDeviceSize size, VkBufferUsageFlags usage,
+                             VkBuffer &buffer, VkDeviceMemory &memory);
+
+// 在命令缓冲中记录图像布局转换屏障
+void cmdTransitionImageLayout(VkCommandBuffer commandBuffer, VkImage image,
+                              VkImageLayout oldLayout, VkImageLayout newLayout,
+                              uint32_t baseMipLevel, uint32_t levelCount,
+                              uint32_t layerCount = 1);
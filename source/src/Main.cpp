@@ -11,10 +11,17 @@
 // #include <stdexcept>
 #include <cstdlib>
 
+#include "Mesh/Mesh.hpp"
+#include "Texture/TextureStreamer.hpp"
+#include "Vulkan/BindlessDescriptors.hpp"
+#include "Vulkan/DeviceFeatures.hpp"
+#include "Vulkan/PerDrawData.hpp"
+#include "Vulkan/VkContext.hpp"
 #include "utils/fileUtils.hpp"
 #include "utils/log.hpp"
 #include <algorithm>
 #include <map>
+#include <memory>
 #include <optional>
 #include <set>
 
@@ -92,23 +99,60 @@ private:
     // 8. 创建渲染通道
     createRenderPass();
 
-    // 9. 创建图形渲染管线
+    // 9. 创建无绑定描述符表（设备支持描述符索引时）
+    if (BindlessDescriptors::IsSupported(m_context)) {
+      m_bindless = std::make_unique<BindlessDescriptors>(m_context);
+    } else {
+      LOG_INFO("descriptor indexing not supported, bindless mode disabled");
+    }
+
+    // 10. 创建每次绘制数据的动态 UBO 环形缓冲
+    m_perDrawRing = std::make_unique<PerDrawUniformRing>(m_context);
+
+    // 11. 创建图形渲染管线
     createGraphicsPipeline();
+
+    // 12. 创建纹理流送器
+    m_textureStreamer = std::make_unique<TextureStreamer>(m_context);
+
+    // 13. 创建命令池并上传网格
+    createCommandPool();
+    createMesh();
   }
 
   void mainLoop() {
     while (!glfwWindowShouldClose(m_window)) {
       glfwPollEvents();
+
+      m_perDrawRing->BeginFrame(m_frameIndex);
+      m_textureStreamer->Update(m_frameIndex);
+      if (m_bindless) {
+        m_bindless->Update(m_frameIndex);
+      }
+      m_frameIndex++;
     }
+
+    vkDeviceWaitIdle(m_device);
   }
 
   void cleanup() {
+    // 销毁网格与命令池
+    m_mesh.reset();
+    vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+
+    // 销毁纹理流送器
+    m_textureStreamer.reset();
 
     // 销毁图形管线
     vkDestroyPipeline(m_device, m_graphicsPipeline, nullptr);
 
-    // 清理图形管线布局
+    // 清理图形管线布局与占位的空描述符集布局
     vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(m_device, m_emptySetLayout, nullptr);
+
+    // 销毁每次绘制数据的环形缓冲与无绑定描述符表
+    m_perDrawRing.reset();
+    m_bindless.reset();
     
     // 清理渲染通道
     vkDestroyRenderPass(m_device, m_renderPass, nullptr);
@@ -177,6 +221,13 @@ private:
           "validation layers requested, but not available!");
     }
 
+    // 加载器支持时使用 Vulkan 1.2，无绑定描述符等特性依赖 1.2 核心功能
+    uint32_t instanceVersion = VK_API_VERSION_1_1;
+    vkEnumerateInstanceVersion(&instanceVersion);
+    m_context.apiVersion = instanceVersion >= VK_API_VERSION_1_2
+                               ? VK_API_VERSION_1_2
+                               : VK_API_VERSION_1_1;
+
     // VkApplicationInfo
     // 结构体---------------------------------------------------------------------------
     // 提供应用程序基本信息，一般用于驱动程序优化和调试
@@ -189,7 +240,7 @@ private:
         .applicationVersion = VK_MAKE_VERSION(1, 0, 0), // 应用程序版本号
         .pEngineName = "No Engine", // 引擎名称字符串的指针
         .engineVersion = VK_MAKE_VERSION(1, 0, 0), // 引擎版本号
-        .apiVersion = VK_API_VERSION_1_1,          // 使用的Vulkan API版本
+        .apiVersion = m_context.apiVersion,        // 使用的Vulkan API版本
     };
 
     //---------------------------------------------------------------------------------------------------
@@ -360,17 +411,38 @@ private:
       queueCreateInfos.push_back(queueCreateInfo);
     }
 
-    VkPhysicalDeviceFeatures deviceFeatures = {};
+    // 设备也支持 1.2 时才启用 1.2 特性
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+    m_context.apiVersion = std::min(m_context.apiVersion, properties.apiVersion);
+
+    // 必需扩展之外，启用设备支持的可选扩展
+    std::vector<const char *> enabledExtensions = m_deviceExtensions;
+    std::set<std::string> availableExtensions =
+        getAvailableDeviceExtensions(m_physicalDevice);
+    for (const char *extension : m_optionalDeviceExtensions) {
+      if (availableExtensions.count(extension)) {
+        enabledExtensions.push_back(extension);
+      } else {
+        LOG_INFO("optional device extension not available: {}", extension);
+      }
+    }
+
+    // 选择各模块需要的设备特性
+    DeviceFeatureChain features;
+    selectDeviceFeatures(m_physicalDevice, m_context.apiVersion,
+                         enabledExtensions, features);
 
     VkDeviceCreateInfo createInfo = {
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+        .pNext = features.Link(m_context.apiVersion, enabledExtensions),
         .queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size()),
         .pQueueCreateInfos = queueCreateInfos.data(),
         .enabledLayerCount = 0,
         .enabledExtensionCount =
-            static_cast<uint32_t>(m_deviceExtensions.size()),
-        .ppEnabledExtensionNames = m_deviceExtensions.data(),
-        .pEnabledFeatures = &deviceFeatures,
+            static_cast<uint32_t>(enabledExtensions.size()),
+        .ppEnabledExtensionNames = enabledExtensions.data(),
+        .pEnabledFeatures = &features.features,
     };
 
     if (enableValidationLayers) {
@@ -394,6 +466,20 @@ private:
     // 获取呈现队列句柄
     vkGetDeviceQueue(m_device, indices.presentFamily.value(), 0,
                      &m_presentQueue);
+
+    // 填充供各模块共享的设备上下文
+    m_context.instance = m_instance;
+    m_context.physicalDevice = m_physicalDevice;
+    m_context.device = m_device;
+    m_context.graphicsQueue = m_graphicsQueue;
+    m_context.graphicsQueueFamily = indices.graphicsFamily.value();
+    m_context.enabledExtensions = std::set<std::string>(
+        enabledExtensions.begin(), enabledExtensions.end());
+
+    m_context.limits = properties.limits;
+    m_context.features = features.features;
+    m_context.features12 = features.features12;
+    m_context.features12.pNext = nullptr;
   }
 
   // 创建交换链
@@ -591,14 +677,8 @@ private:
     };
 
     // 2.2 顶点输入
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo = {
-        .sType =
-            VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO, // 结构体类型
-        .vertexBindingDescriptionCount = 0,      // 顶点绑定描述数量
-        .pVertexBindingDescriptions = nullptr,   // 顶点绑定描述
-        .vertexAttributeDescriptionCount = 0,    // 顶点属性描述数量
-        .pVertexAttributeDescriptions = nullptr, // 顶点属性描述
-    };
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo =
+        VertexInputState<VertexLayoutOf<Vertex>>::CreateInfo(); // 编译期生成的顶点布局
 
     // 2.3 输入组装
     VkPipelineInputAssemblyStateCreateInfo inputAssembly = {
@@ -696,13 +776,34 @@ private:
         .blendConstants = {0.0f, 0.0f, 0.0f, 0.0f}, // 混合常数
     };
 
-    // 2.9 管道布局
+    // 2.9 管道布局：set 0 为全局资源表，set 1 为每次绘制的动态 UBO
+    // （PerDrawUniformRing::DESCRIPTOR_SET，即 per_draw.glsl 的
+    // PER_DRAW_SET）；不支持无绑定时 set 0 用空布局占位，保证两边的编号一致。
+    // 推送常量范围所有管线共用
+    std::vector<VkDescriptorSetLayout> setLayouts;
+    if (m_bindless) {
+      setLayouts.push_back(m_bindless->GetSetLayout());
+    } else {
+      VkDescriptorSetLayoutCreateInfo emptyLayoutInfo = {
+          .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+          .bindingCount = 0,
+          .pBindings = nullptr,
+      };
+      if (vkCreateDescriptorSetLayout(m_device, &emptyLayoutInfo, nullptr,
+                                      &m_emptySetLayout) != VK_SUCCESS) {
+        LOG_ERROR("failed to create empty descriptor set layout!");
+        throw std::runtime_error("failed to create empty descriptor set layout!");
+      }
+      setLayouts.push_back(m_emptySetLayout);
+    }
+    setLayouts.push_back(m_perDrawRing->GetSetLayout());
+    VkPushConstantRange pushConstantRange = perDrawPushConstantRange();
     VkPipelineLayoutCreateInfo pipelineLayoutInfo = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO, // 结构体类型
-        .setLayoutCount = 0,            // 设置布局数量
-        .pSetLayouts = nullptr,         // 设置布局
-        .pushConstantRangeCount = 0,    // 推送常量范围数量
-        .pPushConstantRanges = nullptr, // 推送常量范围
+        .setLayoutCount = static_cast<uint32_t>(setLayouts.size()), // 设置布局数量
+        .pSetLayouts = setLayouts.data(),          // 设置布局
+        .pushConstantRangeCount = 1,               // 推送常量范围数量
+        .pPushConstantRanges = &pushConstantRange, // 推送常量范围
     };
 
     if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr,
@@ -780,6 +881,23 @@ private:
     return indices.isComplete() && extensionsSupported && swapChainAdequate;
   }
 
+  // 枚举物理设备支持的全部扩展名
+  std::set<std::string> getAvailableDeviceExtensions(VkPhysicalDevice device) {
+    uint32_t extensionCount;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount,
+                                         nullptr);
+
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount,
+                                         availableExtensions.data());
+
+    std::set<std::string> names;
+    for (const auto &extension : availableExtensions) {
+      names.insert(extension.extensionName);
+    }
+    return names;
+  }
+
   // 枚举扩展并检查其中是否包含所有必需的扩展
   bool checkDeviceExtensionSupport(VkPhysicalDevice device) {
     uint32_t extensionCount;
@@ -1009,6 +1127,37 @@ private:
     return VK_FALSE;
   }
 
+  // 创建命令池
+  void createCommandPool() {
+    VkCommandPoolCreateInfo poolInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO, // 结构体类型
+        .flags =
+            VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, // 允许单独重置命令缓冲
+        .queueFamilyIndex = m_context.graphicsQueueFamily, // 图形队列族
+    };
+
+    if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPool) !=
+        VK_SUCCESS) {
+      LOG_ERROR("failed to create command pool!");
+      throw std::runtime_error("failed to create command pool!");
+    }
+  }
+
+  // 上传一个带索引的四边形网格
+  void createMesh() {
+    MeshData quad = {
+        .vertices =
+            {
+                {{-0.5f, -0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}},
+                {{0.5f, -0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f}},
+                {{0.5f, 0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 1.0f}},
+                {{-0.5f, 0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f}},
+            },
+        .indices = {0, 1, 2, 2, 3, 0},
+    };
+    m_mesh = std::make_unique<Mesh>(m_context, m_commandPool, quad);
+  }
+
   void setupDebugMessenger() {
     if (!enableValidationLayers)
       return;
@@ -1062,10 +1211,27 @@ private:
 
   VkPipelineLayout m_pipelineLayout; // 管线布局
 
+  // 不支持无绑定时占住 set 0 的空布局
+  VkDescriptorSetLayout m_emptySetLayout = VK_NULL_HANDLE;
+
   VkPipeline m_graphicsPipeline; // 图形管线
 
   VkDebugUtilsMessengerEXT m_debugMessenger; // Vulkan调试报告
 
+  VkContext m_context; // 共享给各模块的设备上下文
+
+  std::unique_ptr<TextureStreamer> m_textureStreamer; // 纹理流送器
+
+  std::unique_ptr<BindlessDescriptors> m_bindless; // 无绑定描述符表，可能为空
+
+  std::unique_ptr<PerDrawUniformRing> m_perDrawRing; // 每次绘制数据的动态 UBO
+
+  VkCommandPool m_commandPool = VK_NULL_HANDLE; // 图形队列的命令池
+
+  std::unique_ptr<Mesh> m_mesh; // 示例网格
+
+  uint64_t m_frameIndex = 0; // 已提交的帧数
+
   std::vector<VkExtensionProperties> m_extensions; // Vulkan支持的扩展列表
 
   // 指定的验证层列表
@@ -1076,6 +1242,14 @@ private:
   // 指定的设备扩展列表
   const std::vector<const char *> m_deviceExtensions = {
       VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+
+  // 可选的设备扩展列表，设备支持时才启用
+  const std::vector<const char *> m_optionalDeviceExtensions = {
+      VK_EXT_MEMORY_BUDGET_EXTENSION_NAME, // 纹理流送的显存预算
+      VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME, // 描述符缓冲扩展的依赖
+      VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME, // 描述符缓冲后端
+      VK_EXT_MESH_SHADER_EXTENSION_NAME,       // 网格簇的任务/网格着色器路径
+  };
 };
 
 int main() {
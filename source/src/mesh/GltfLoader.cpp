@@ -0,0 +1,686 @@
+#include "Mesh/GltfLoader.hpp"
+
+#include "utils/JsonReader.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+constexpr uint32_t GLB_MAGIC = 0x46546C67;      // "glTF"
+constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A; // "JSON"
+constexpr uint32_t GLB_CHUNK_BIN = 0x004E4942;  // "BIN\0"
+
+constexpr uint32_t COMPONENT_BYTE = 5120;
+constexpr uint32_t COMPONENT_UNSIGNED_BYTE = 5121;
+constexpr uint32_t COMPONENT_SHORT = 5122;
+constexpr uint32_t COMPONENT_UNSIGNED_SHORT = 5123;
+constexpr uint32_t COMPONENT_UNSIGNED_INT = 5125;
+constexpr uint32_t COMPONENT_FLOAT = 5126;
+
+constexpr uint32_t MODE_TRIANGLES = 4;
+
+[[noreturn]] void fail(const std::string &message) {
+  LOG_ERROR("glTF: {}", message);
+  throw std::runtime_error("glTF: " + message);
+}
+
+uint32_t componentSize(uint32_t componentType) {
+  switch (componentType) {
+  case COMPONENT_BYTE:
+  case COMPONENT_UNSIGNED_BYTE:
+    return 1;
+  case COMPONENT_SHORT:
+  case COMPONENT_UNSIGNED_SHORT:
+    return 2;
+  case COMPONENT_UNSIGNED_INT:
+  case COMPONENT_FLOAT:
+    return 4;
+  default:
+    fail("unknown component type " + std::to_string(componentType));
+  }
+}
+
+uint32_t componentCount(std::string_view type) {
+  if (type == "SCALAR") {
+    return 1;
+  }
+  if (type == "VEC2") {
+    return 2;
+  }
+  if (type == "VEC3") {
+    return 3;
+  }
+  if (type == "VEC4" || type == "MAT2") {
+    return 4;
+  }
+  if (type == "MAT3") {
+    return 9;
+  }
+  if (type == "MAT4") {
+    return 16;
+  }
+  fail("unknown accessor type " + std::string(type));
+}
+
+// JSON 中先按原样记录各对象，全部读完后再解析相互引用
+struct RawBuffer {
+  std::string uri;
+  uint64_t byteLength = 0;
+};
+
+struct RawBufferView {
+  uint32_t buffer = 0;
+  uint64_t byteOffset = 0;
+  uint64_t byteLength = 0;
+  uint32_t byteStride = 0;
+};
+
+struct RawAccessor {
+  int32_t bufferView = -1;
+  uint64_t byteOffset = 0;
+  uint32_t componentType = 0;
+  uint32_t count = 0;
+  uint32_t componentCount = 0;
+  bool normalized = false;
+  bool sparse = false;
+};
+
+struct RawPrimitive {
+  int32_t position = -1;
+  int32_t normal = -1;
+  int32_t uv = -1;
+  int32_t indices = -1;
+  int32_t material = -1;
+  uint32_t mode = MODE_TRIANGLES;
+};
+
+struct RawMesh {
+  std::string name;
+  std::vector<RawPrimitive> primitives;
+};
+
+struct RawNode {
+  int32_t mesh = -1;
+  std::vector<uint32_t> children;
+  glm::mat4 local = glm::mat4(1.0f);
+};
+
+struct RawDocument {
+  std::vector<RawBuffer> buffers;
+  std::vector<RawBufferView> bufferViews;
+  std::vector<RawAccessor> accessors;
+  std::vector<RawMesh> meshes;
+  std::vector<RawNode> nodes;
+  std::vector<std::vector<uint32_t>> scenes;
+  uint32_t scene = 0;
+};
+
+// 读取 JSON 数组，每个元素交给 readElement
+template <typename Function>
+void readArray(JsonReader &reader, Function &&readElement) {
+  reader.BeginArray();
+  while (reader.NextElement()) {
+    readElement();
+  }
+}
+
+// 读取 JSON 对象，每个键交给 readField，返回 false 的键被跳过
+template <typename Function>
+void readObject(JsonReader &reader, Function &&readField) {
+  reader.BeginObject();
+  std::string_view key;
+  while (reader.NextKey(key)) {
+    if (!readField(key)) {
+      reader.Skip();
+    }
+  }
+}
+
+template <size_t N> void readFloats(JsonReader &reader, float (&values)[N]) {
+  size_t i = 0;
+  readArray(reader, [&] {
+    float value = static_cast<float>(reader.ReadNumber());
+    if (i < N) {
+      values[i++] = value;
+    }
+  });
+}
+
+// T * R * S，旋转为单位四元数 (x, y, z, w)
+glm::mat4 composeTransform(const float (&t)[3], const float (&r)[4],
+                           const float (&s)[3]) {
+  float x = r[0], y = r[1], z = r[2], w = r[3];
+  glm::mat4 m(1.0f);
+  m[0] = glm::vec4(1 - 2 * (y * y + z * z), 2 * (x * y + z * w),
+                   2 * (x * z - y * w), 0) *
+         s[0];
+  m[1] = glm::vec4(2 * (x * y - z * w), 1 - 2 * (x * x + z * z),
+                   2 * (y * z + x * w), 0) *
+         s[1];
+  m[2] = glm::vec4(2 * (x * z + y * w), 2 * (y * z - x * w),
+                   1 - 2 * (x * x + y * y), 0) *
+         s[2];
+  m[3] = glm::vec4(t[0], t[1], t[2], 1);
+  return m;
+}
+
+RawNode readNode(JsonReader &reader) {
+  RawNode node;
+  float matrix[16];
+  float translation[3] = {0, 0, 0};
+  float rotation[4] = {0, 0, 0, 1};
+  float scale[3] = {1, 1, 1};
+  bool hasMatrix = false;
+  readObject(reader, [&](std::string_view key) {
+    if (key == "mesh") {
+      node.mesh = static_cast<int32_t>(reader.ReadUint());
+    } else if (key == "children") {
+      readArray(reader, [&] { node.children.push_back(reader.ReadUint()); });
+    } else if (key == "matrix") {
+      readFloats(reader, matrix);
+      hasMatrix = true;
+    } else if (key == "translation") {
+      readFloats(reader, translation);
+    } else if (key == "rotation") {
+      readFloats(reader, rotation);
+    } else if (key == "scale") {
+      readFloats(reader, scale);
+    } else {
+      return false;
+    }
+    return true;
+  });
+
+  if (hasMatrix) {
+    for (int c = 0; c < 4; c++) {
+      node.local[c] = glm::vec4(matrix[c * 4], matrix[c * 4 + 1],
+                                matrix[c * 4 + 2], matrix[c * 4 + 3]);
+    }
+  } else {
+    node.local = composeTransform(translation, rotation, scale);
+  }
+  return node;
+}
+
+RawPrimitive readPrimitive(JsonReader &reader) {
+  RawPrimitive primitive;
+  readObject(reader, [&](std::string_view key) {
+    if (key == "attributes") {
+      readObject(reader, [&](std::string_view attribute) {
+        if (attribute == "POSITION") {
+          primitive.position = static_cast<int32_t>(reader.ReadUint());
+        } else if (attribute == "NORMAL") {
+          primitive.normal = static_cast<int32_t>(reader.ReadUint());
+        } else if (attribute == "TEXCOORD_0") {
+          primitive.uv = static_cast<int32_t>(reader.ReadUint());
+        } else {
+          return false;
+        }
+        return true;
+      });
+    } else if (key == "indices") {
+      primitive.indices = static_cast<int32_t>(reader.ReadUint());
+    } else if (key == "material") {
+      primitive.material = static_cast<int32_t>(reader.ReadUint());
+    } else if (key == "mode") {
+      primitive.mode = reader.ReadUint();
+    } else {
+      return false;
+    }
+    return true;
+  });
+  return primitive;
+}
+
+RawDocument readDocument(std::string_view json) {
+  RawDocument document;
+  JsonReader reader(json);
+  readObject(reader, [&](std::string_view key) {
+    if (key == "buffers") {
+      readArray(reader, [&] {
+        RawBuffer &buffer = document.buffers.emplace_back();
+        readObject(reader, [&](std::string_view field) {
+          if (field == "uri") {
+            buffer.uri = reader.ReadString();
+          } else if (field == "byteLength") {
+            buffer.byteLength = static_cast<uint64_t>(reader.ReadNumber());
+          } else {
+            return false;
+          }
+          return true;
+        });
+      });
+    } else if (key == "bufferViews") {
+      readArray(reader, [&] {
+        RawBufferView &view = document.bufferViews.emplace_back();
+        readObject(reader, [&](std::string_view field) {
+          if (field == "buffer") {
+            view.buffer = reader.ReadUint();
+          } else if (field == "byteOffset") {
+            view.byteOffset = static_cast<uint64_t>(reader.ReadNumber());
+          } else if (field == "byteLength") {
+            view.byteLength = static_cast<uint64_t>(reader.ReadNumber());
+          } else if (field == "byteStride") {
+            view.byteStride = reader.ReadUint();
+          } else {
+            return false;
+          }
+          return true;
+        });
+      });
+    } else if (key == "accessors") {
+      readArray(reader, [&] {
+        RawAccessor &accessor = document.accessors.emplace_back();
+        readObject(reader, [&](std::string_view field) {
+          if (field == "bufferView") {
+            accessor.bufferView = static_cast<int32_t>(reader.ReadUint());
+          } else if (field == "byteOffset") {
+            accessor.byteOffset = static_cast<uint64_t>(reader.ReadNumber());
+          } else if (field == "componentType") {
+            accessor.componentType = reader.ReadUint();
+          } else if (field == "count") {
+            accessor.count = reader.ReadUint();
+          } else if (field == "type") {
+            accessor.componentCount = componentCount(reader.ReadRawString());
+          } else if (field == "normalized") {
+            accessor.normalized = reader.ReadBool();
+          } else if (field == "sparse") {
+            accessor.sparse = true;
+            return false;
+          } else {
+            return false;
+          }
+          return true;
+        });
+      });
+    } else if (key == "meshes") {
+      readArray(reader, [&] {
+        RawMesh &mesh = document.meshes.emplace_back();
+        readObject(reader, [&](std::string_view field) {
+          if (field == "name") {
+            mesh.name = reader.ReadString();
+          } else if (field == "primitives") {
+            readArray(reader, [&] {
+              mesh.primitives.push_back(readPrimitive(reader));
+            });
+          } else {
+            return false;
+          }
+          return true;
+        });
+      });
+    } else if (key == "nodes") {
+      readArray(reader, [&] { document.nodes.push_back(readNode(reader)); });
+    } else if (key == "scenes") {
+      readArray(reader, [&] {
+        std::vector<uint32_t> &roots = document.scenes.emplace_back();
+        readObject(reader, [&](std::string_view field) {
+          if (field != "nodes") {
+            return false;
+          }
+          readArray(reader, [&] { roots.push_back(reader.ReadUint()); });
+          return true;
+        });
+      });
+    } else if (key == "scene") {
+      document.scene = reader.ReadUint();
+    } else {
+      return false;
+    }
+    return true;
+  });
+  return document;
+}
+
+float readComponent(const uint8_t *p, uint32_t componentType,
+                    bool normalized) {
+  switch (componentType) {
+  case COMPONENT_FLOAT: {
+    float value;
+    std::memcpy(&value, p, sizeof(float));
+    return value;
+  }
+  case COMPONENT_UNSIGNED_BYTE:
+    return normalized ? *p / 255.0f : float(*p);
+  case COMPONENT_BYTE: {
+    float value = float(int8_t(*p));
+    return normalized ? std::max(value / 127.0f, -1.0f) : value;
+  }
+  case COMPONENT_UNSIGNED_SHORT: {
+    uint16_t value;
+    std::memcpy(&value, p, sizeof(uint16_t));
+    return normalized ? value / 65535.0f : float(value);
+  }
+  case COMPONENT_SHORT: {
+    int16_t value;
+    std::memcpy(&value, p, sizeof(int16_t));
+    return normalized ? std::max(value / 32767.0f, -1.0f) : float(value);
+  }
+  default: {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(uint32_t));
+    return float(value);
+  }
+  }
+}
+
+// 把访问器的第 index 个元素读入 N 个分量的 out，浮点数据直接按字节拷贝
+template <int N>
+void readElement(const GltfAccessor &accessor, uint32_t index, float *out) {
+  const uint8_t *element = accessor.data + size_t(index) * accessor.stride;
+  if (accessor.componentType == COMPONENT_FLOAT) {
+    std::memcpy(out, element, N * sizeof(float));
+    return;
+  }
+  uint32_t size = componentSize(accessor.componentType);
+  for (int i = 0; i < N; i++) {
+    out[i] = readComponent(element + i * size, accessor.componentType,
+                           accessor.normalized);
+  }
+}
+
+// glTF 只允许无符号整数索引，其余类型的元素宽度与 readIndex 的读取宽度不符
+bool isIndexComponentType(uint32_t componentType) {
+  return componentType == COMPONENT_UNSIGNED_BYTE ||
+         componentType == COMPONENT_UNSIGNED_SHORT ||
+         componentType == COMPONENT_UNSIGNED_INT;
+}
+
+uint32_t readIndex(const GltfAccessor &accessor, uint32_t index) {
+  const uint8_t *element = accessor.data + size_t(index) * accessor.stride;
+  switch (accessor.componentType) {
+  case COMPONENT_UNSIGNED_BYTE:
+    return *element;
+  case COMPONENT_UNSIGNED_SHORT: {
+    uint16_t value;
+    std::memcpy(&value, element, sizeof(uint16_t));
+    return value;
+  }
+  case COMPONENT_UNSIGNED_INT: {
+    uint32_t value;
+    std::memcpy(&value, element, sizeof(uint32_t));
+    return value;
+  }
+  default:
+    // 加载时已校验，只会是上面三种无符号整数类型
+    fail("invalid index component type " +
+         std::to_string(accessor.componentType));
+  }
+}
+
+std::string directoryOf(const std::string &filename) {
+  size_t slash = filename.find_last_of("/\\");
+  return slash == std::string::npos ? std::string()
+                                    : filename.substr(0, slash + 1);
+}
+} // namespace
+
+GltfModel::GltfModel(const std::string &filename) {
+  auto startTime = std::chrono::steady_clock::now();
+
+  if (filename.ends_with(".glb")) {
+    loadGlb(filename);
+  } else {
+    loadGltf(filename);
+  }
+
+  size_t primitiveCount = 0;
+  for (const GltfMesh &mesh : m_meshes) {
+    primitiveCount += mesh.primitives.size();
+  }
+  double elapsedMs = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - startTime)
+                         .count();
+  LOG_INFO("loaded {} in {:.1f} ms: {} meshes, {} primitives, {} instances",
+           filename, elapsedMs, m_meshes.size(), primitiveCount,
+           m_instances.size());
+}
+
+void GltfModel::loadGlb(const std::string &filename) {
+  const MappedFile &file =
+      *m_files.emplace_back(std::make_unique<MappedFile>(filename));
+  const uint8_t *data = file.GetData();
+  size_t size = file.GetSize();
+
+  // 12 字节文件头：magic, version, length
+  uint32_t header[3];
+  if (size < sizeof(header)) {
+    fail(filename + " is too small to be a GLB file");
+  }
+  std::memcpy(header, data, sizeof(header));
+  if (header[0] != GLB_MAGIC || header[1] != 2 || header[2] > size) {
+    fail(filename + " is not a glTF 2.0 binary file");
+  }
+
+  // 之后依次为 JSON 块与可选的 BIN 块，每块 8 字节头：length, type
+  std::string_view json;
+  BufferData binary = {nullptr, 0};
+  size_t offset = sizeof(header);
+  while (offset + 8 <= header[2]) {
+    uint32_t chunk[2];
+    std::memcpy(chunk, data + offset, sizeof(chunk));
+    offset += sizeof(chunk);
+    if (offset + chunk[0] > header[2]) {
+      fail(filename + " has a truncated chunk");
+    }
+    if (chunk[1] == GLB_CHUNK_JSON && json.empty()) {
+      json = {reinterpret_cast<const char *>(data + offset), chunk[0]};
+    } else if (chunk[1] == GLB_CHUNK_BIN && !binary.data) {
+      binary = {data + offset, chunk[0]};
+    }
+    offset += chunk[0];
+  }
+  if (json.empty()) {
+    fail(filename + " has no JSON chunk");
+  }
+
+  parse(json, directoryOf(filename), binary);
+}
+
+void GltfModel::loadGltf(const std::string &filename) {
+  const MappedFile &file =
+      *m_files.emplace_back(std::make_unique<MappedFile>(filename));
+  parse(file.GetView(), directoryOf(filename), {nullptr, 0});
+}
+
+void GltfModel::parse(std::string_view json, const std::string &directory,
+                      BufferData glbBinary) {
+  RawDocument document = readDocument(json);
+
+  // 1. 缓冲：GLB 的第一个无 uri 缓冲是 BIN 块，其余映射外部文件
+  std::vector<BufferData> buffers;
+  for (size_t i = 0; i < document.buffers.size(); i++) {
+    const RawBuffer &buffer = document.buffers[i];
+    BufferData data;
+    if (buffer.uri.empty()) {
+      if (i != 0 || !glbBinary.data) {
+        fail("buffer " + std::to_string(i) + " has no uri");
+      }
+      data = glbBinary;
+    } else if (buffer.uri.starts_with("data:")) {
+      fail("embedded data URIs are not supported");
+    } else {
+      const MappedFile &file = *m_files.emplace_back(
+          std::make_unique<MappedFile>(directory + buffer.uri));
+      data = {file.GetData(), file.GetSize()};
+    }
+    if (data.size < buffer.byteLength) {
+      fail("buffer " + std::to_string(i) + " is shorter than its byteLength");
+    }
+    buffers.push_back(data);
+  }
+
+  // 2. 访问器 -> 缓冲视图 -> 缓冲，检查越界后得到零拷贝视图
+  auto resolveAccessor = [&](int32_t index) {
+    GltfAccessor result;
+    if (index < 0) {
+      return result;
+    }
+    if (size_t(index) >= document.accessors.size()) {
+      fail("accessor index out of range");
+    }
+    const RawAccessor &accessor = document.accessors[index];
+    if (accessor.sparse || accessor.bufferView < 0) {
+      fail("sparse accessors and accessors without a bufferView are not "
+           "supported");
+    }
+    if (size_t(accessor.bufferView) >= document.bufferViews.size()) {
+      fail("bufferView index out of range");
+    }
+    const RawBufferView &view = document.bufferViews[accessor.bufferView];
+    if (view.buffer >= buffers.size() ||
+        view.byteOffset + view.byteLength > buffers[view.buffer].size) {
+      fail("bufferView exceeds its buffer");
+    }
+
+    uint32_t elementSize =
+        componentSize(accessor.componentType) * accessor.componentCount;
+    if (view.byteStride != 0 && view.byteStride < elementSize) {
+      fail("bufferView byteStride is smaller than its accessor elements");
+    }
+    uint32_t stride = view.byteStride ? view.byteStride : elementSize;
+    if (accessor.count > 0 &&
+        accessor.byteOffset + uint64_t(accessor.count - 1) * stride +
+                elementSize >
+            view.byteLength) {
+      fail("accessor exceeds its bufferView");
+    }
+
+    result.data =
+        buffers[view.buffer].data + view.byteOffset + accessor.byteOffset;
+    result.count = accessor.count;
+    result.stride = stride;
+    result.componentType = accessor.componentType;
+    result.componentCount = accessor.componentCount;
+    result.normalized = accessor.normalized;
+    return result;
+  };
+
+  // 3. 网格与图元
+  m_meshes.reserve(document.meshes.size());
+  for (const RawMesh &rawMesh : document.meshes) {
+    GltfMesh &mesh = m_meshes.emplace_back();
+    mesh.name = rawMesh.name;
+    for (const RawPrimitive &rawPrimitive : rawMesh.primitives) {
+      if (rawPrimitive.mode != MODE_TRIANGLES || rawPrimitive.position < 0) {
+        LOG_WARN("glTF: skipping non-triangle primitive in mesh '{}'",
+                 rawMesh.name);
+        continue;
+      }
+      GltfPrimitive primitive = {
+          .positions = resolveAccessor(rawPrimitive.position),
+          .normals = resolveAccessor(rawPrimitive.normal),
+          .uvs = resolveAccessor(rawPrimitive.uv),
+          .indices = resolveAccessor(rawPrimitive.indices),
+          .material = rawPrimitive.material,
+      };
+      uint32_t vertexCount = primitive.positions.count;
+      if (primitive.positions.componentCount != 3 ||
+          (primitive.normals.IsValid() &&
+           (primitive.normals.count != vertexCount ||
+            primitive.normals.componentCount != 3)) ||
+          (primitive.uvs.IsValid() && (primitive.uvs.count != vertexCount ||
+                                       primitive.uvs.componentCount != 2)) ||
+          (primitive.indices.IsValid() &&
+           (primitive.indices.componentCount != 1 ||
+            !isIndexComponentType(primitive.indices.componentType)))) {
+        fail("mesh '" + rawMesh.name + "' has mismatched vertex attributes");
+      }
+      // TRIANGLES 模式下索引数（无索引时为顶点数）必须是 3 的倍数
+      uint32_t cornerCount = primitive.indices.IsValid()
+                                 ? primitive.indices.count
+                                 : vertexCount;
+      if (cornerCount % 3 != 0) {
+        fail("mesh '" + rawMesh.name + "' has an incomplete triangle list");
+      }
+      mesh.primitives.push_back(primitive);
+    }
+  }
+
+  // 4. 遍历默认场景的节点层级，累乘变换得到网格实例
+  if (document.scene < document.scenes.size()) {
+    struct StackEntry {
+      uint32_t node;
+      glm::mat4 parent;
+      uint32_t depth;
+    };
+    std::vector<StackEntry> stack;
+    for (uint32_t root : document.scenes[document.scene]) {
+      stack.push_back({root, glm::mat4(1.0f), 0});
+    }
+    while (!stack.empty()) {
+      StackEntry entry = stack.back();
+      stack.pop_back();
+      // 合法的 glTF 节点层级是森林，深度超过节点数说明存在环
+      if (entry.node >= document.nodes.size() ||
+          entry.depth > document.nodes.size()) {
+        fail("invalid node hierarchy");
+      }
+      const RawNode &node = document.nodes[entry.node];
+      glm::mat4 world = entry.parent * node.local;
+      if (node.mesh >= 0) {
+        if (size_t(node.mesh) >= m_meshes.size()) {
+          fail("node mesh index out of range");
+        }
+        m_instances.push_back({static_cast<uint32_t>(node.mesh), world});
+      }
+      for (uint32_t child : node.children) {
+        stack.push_back({child, world, entry.depth + 1});
+      }
+    }
+  }
+}
+
+uint32_t GltfModel::GetIndexCount(const GltfPrimitive &primitive) {
+  return primitive.indices.IsValid() ? primitive.indices.count
+                                     : primitive.positions.count;
+}
+
+void GltfModel::WritePrimitive(const GltfPrimitive &primitive,
+                               Vertex *vertices, void *indices,
+                               VkIndexType indexType) {
+  uint32_t vertexCount = primitive.positions.count;
+  for (uint32_t i = 0; i < vertexCount; i++) {
+    Vertex &vertex = vertices[i];
+    readElement<3>(primitive.positions, i, &vertex.position.x);
+    if (primitive.normals.IsValid()) {
+      readElement<3>(primitive.normals, i, &vertex.normal.x);
+    } else {
+      vertex.normal = glm::vec3(0.0f);
+    }
+    if (primitive.uvs.IsValid()) {
+      readElement<2>(primitive.uvs, i, &vertex.uv.x);
+    } else {
+      vertex.uv = glm::vec2(0.0f);
+    }
+  }
+
+  // 索引按目标位宽写入；没有索引的图元生成顺序索引
+  uint32_t indexCount = GetIndexCount(primitive);
+  for (uint32_t i = 0; i < indexCount; i++) {
+    uint32_t index =
+        primitive.indices.IsValid() ? readIndex(primitive.indices, i) : i;
+    if (index >= vertexCount) {
+      fail("index out of range");
+    }
+    if (indexType == VK_INDEX_TYPE_UINT16) {
+      static_cast<uint16_t *>(indices)[i] = static_cast<uint16_t>(index);
+    } else {
+      static_cast<uint32_t *>(indices)[i] = index;
+    }
+  }
+}
+
+std::unique_ptr<Mesh>
+GltfModel::CreateMesh(const VkContext &context, VkCommandPool commandPool,
+                      const GltfPrimitive &primitive) const {
+  return std::make_unique<Mesh>(
+      context, commandPool, primitive.positions.count,
+      GetIndexCount(primitive),
+      [&primitive](Vertex *vertices, void *indices, VkIndexType indexType) {
+        WritePrimitive(primitive, vertices, indices, indexType);
+      });
+}
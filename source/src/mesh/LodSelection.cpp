@@ -0,0 +1,39 @@
+#include "Mesh/LodSelection.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+float lodProjectionScale(float viewportHeight, float fovY) {
+  return viewportHeight * 0.5f / std::tan(fovY * 0.5f);
+}
+
+uint32_t selectLod(std::span<const MeshLod> lods, const MeshBounds &bounds,
+                   const glm::mat4 &model, const glm::vec3 &cameraPosition,
+                   const LodSelectionParams &params) {
+  if (lods.size() <= 1) {
+    return 0;
+  }
+
+  float scale = std::sqrt(std::max({glm::dot(model[0], model[0]),
+                                    glm::dot(model[1], model[1]),
+                                    glm::dot(model[2], model[2])}));
+  glm::vec3 center = glm::vec3(model * glm::vec4(bounds.center, 1.0f));
+  // 取包围球上离相机最近的点，误差估计偏保守
+  float distance =
+      glm::length(center - cameraPosition) - bounds.radius * scale;
+  if (distance <= 0.0f) {
+    return 0;
+  }
+
+  // 误差随 LOD 单调递增，找到第一个超出阈值的级别即可停止
+  uint32_t selected = 0;
+  for (uint32_t i = 1; i < lods.size(); i++) {
+    float error = projectedLodError(lods[i].error * scale, distance,
+                                    params.projectionScale);
+    if (error > params.pixelError) {
+      break;
+    }
+    selected = i;
+  }
+  return selected;
+}
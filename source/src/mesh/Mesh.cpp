@@ -0,0 +1,206 @@
+#include "Mesh/Mesh.hpp"
+
+#include "Vulkan/VkUtils.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+VkIndexType selectIndexType(size_t vertexCount) {
+  return vertexCount <= UINT16_MAX ? VK_INDEX_TYPE_UINT16
+                                   : VK_INDEX_TYPE_UINT32;
+}
+
+MeshBounds computeMeshBounds(const std::vector<Vertex> &vertices) {
+  MeshBounds bounds = {glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(0.0f),
+                       0.0f};
+  if (vertices.empty()) {
+    return bounds;
+  }
+
+  bounds.min = bounds.max = vertices[0].position;
+  for (const Vertex &vertex : vertices) {
+    bounds.min = glm::min(bounds.min, vertex.position);
+    bounds.max = glm::max(bounds.max, vertex.position);
+  }
+  // 以包围盒中心为球心，比 Ritter 算法宽松但足够用于剔除
+  bounds.center = (bounds.min + bounds.max) * 0.5f;
+  for (const Vertex &vertex : vertices) {
+    bounds.radius =
+        std::max(bounds.radius, glm::distance(bounds.center, vertex.position));
+  }
+  return bounds;
+}
+
+namespace {
+// 16 位索引在写入暂存内存时收窄，显存与索引带宽减半
+void writeIndices(const std::vector<uint32_t> &src, void *dst,
+                  VkIndexType indexType) {
+  if (indexType == VK_INDEX_TYPE_UINT16) {
+    std::copy(src.begin(), src.end(), static_cast<uint16_t *>(dst));
+  } else {
+    std::memcpy(dst, src.data(), src.size() * sizeof(uint32_t));
+  }
+}
+
+VertexDequantization dequantizationOf(const MeshData &data,
+                                      VertexCompression compression) {
+  if (compression == VertexCompression::None) {
+    return {};
+  }
+  MeshBounds bounds = computeMeshBounds(data.vertices);
+  return VertexDequantization::FromBounds(bounds.min, bounds.max);
+}
+} // namespace
+
+Mesh::Mesh(const VkContext &context, VkCommandPool commandPool,
+           const MeshData &data, VertexCompression compression)
+    : Mesh(context,
+           compression == VertexCompression::Quantized
+               ? sizeof(QuantizedVertex)
+               : sizeof(Vertex),
+           static_cast<uint32_t>(data.vertices.size()),
+           static_cast<uint32_t>(data.indices.size()),
+           dequantizationOf(data, compression)) {
+  m_lods = data.lods;
+  upload(commandPool, [&](void *vertices, void *indices,
+                          VkIndexType indexType) {
+    if (compression == VertexCompression::Quantized) {
+      quantizeVertices(data.vertices.data(), data.vertices.size(),
+                       m_dequantization,
+                       static_cast<QuantizedVertex *>(vertices));
+    } else {
+      std::memcpy(vertices, data.vertices.data(),
+                  data.vertices.size() * sizeof(Vertex));
+    }
+    writeIndices(data.indices, indices, indexType);
+  });
+}
+
+Mesh::Mesh(const VkContext &context, VkCommandPool commandPool,
+           uint32_t vertexCount, uint32_t indexCount, const MeshWriter &write)
+    : Mesh(context, sizeof(Vertex), vertexCount, indexCount, {}) {
+  upload(commandPool,
+         [&write](void *vertices, void *indices, VkIndexType indexType) {
+           write(static_cast<Vertex *>(vertices), indices, indexType);
+         });
+}
+
+Mesh::Mesh(const VkContext &context, VkCommandPool commandPool,
+           uint32_t vertexCount, uint32_t indexCount,
+           const VertexDequantization &dequantization,
+           const QuantizedMeshWriter &write)
+    : Mesh(context, sizeof(QuantizedVertex), vertexCount, indexCount,
+           dequantization) {
+  upload(commandPool,
+         [&write](void *vertices, void *indices, VkIndexType indexType) {
+           write(static_cast<QuantizedVertex *>(vertices), indices, indexType);
+         });
+}
+
+Mesh::Mesh(const VkContext &context, uint32_t vertexStride,
+           uint32_t vertexCount, uint32_t indexCount,
+           const VertexDequantization &dequantization)
+    : m_context(context), m_vertexStride(vertexStride),
+      m_vertexCount(vertexCount), m_indexCount(indexCount),
+      m_indexType(selectIndexType(vertexCount)),
+      m_dequantization(dequantization) {
+  if (vertexCount == 0 || indexCount == 0) {
+    LOG_ERROR("mesh has no vertices or indices!");
+    throw std::runtime_error("mesh has no vertices or indices!");
+  }
+}
+
+void Mesh::upload(VkCommandPool commandPool, const RawWriter &write) {
+  VkDeviceSize vertexSize = VkDeviceSize(m_vertexCount) * m_vertexStride;
+  VkDeviceSize indexSize =
+      VkDeviceSize(m_indexCount) *
+      (m_indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t)
+                                           : sizeof(uint32_t));
+
+  // 1. 顶点与索引共用一个暂存缓冲，由 write 直接填充
+  VkBuffer stagingBuffer;
+  VkDeviceMemory stagingMemory;
+  createBuffer(m_context, vertexSize + indexSize,
+               VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+               stagingBuffer, stagingMemory);
+
+  uint8_t *mapped;
+  vkMapMemory(m_context.device, stagingMemory, 0, VK_WHOLE_SIZE, 0,
+              reinterpret_cast<void **>(&mapped));
+  try {
+    write(mapped, mapped + vertexSize, m_indexType);
+  } catch (...) {
+    vkUnmapMemory(m_context.device, stagingMemory);
+    vkDestroyBuffer(m_context.device, stagingBuffer, nullptr);
+    vkFreeMemory(m_context.device, stagingMemory, nullptr);
+    throw;
+  }
+  vkUnmapMemory(m_context.device, stagingMemory);
+
+  // 2. 一次提交复制到两个设备本地缓冲
+  createBuffer(m_context, vertexSize,
+               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                   VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_vertexBuffer,
+               m_vertexMemory);
+  createBuffer(m_context, indexSize,
+               VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                   VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_indexBuffer,
+               m_indexMemory);
+
+  VkCommandBuffer commandBuffer =
+      beginSingleTimeCommands(m_context, commandPool);
+  VkBufferCopy vertexRegion = {
+      .srcOffset = 0,
+      .dstOffset = 0,
+      .size = vertexSize,
+  };
+  vkCmdCopyBuffer(commandBuffer, stagingBuffer, m_vertexBuffer, 1,
+                  &vertexRegion);
+  VkBufferCopy indexRegion = {
+      .srcOffset = vertexSize,
+      .dstOffset = 0,
+      .size = indexSize,
+  };
+  vkCmdCopyBuffer(commandBuffer, stagingBuffer, m_indexBuffer, 1,
+                  &indexRegion);
+  endSingleTimeCommands(m_context, commandPool, commandBuffer);
+
+  vkDestroyBuffer(m_context.device, stagingBuffer, nullptr);
+  vkFreeMemory(m_context.device, stagingMemory, nullptr);
+}
+
+Mesh::~Mesh() {
+  vkDestroyBuffer(m_context.device, m_indexBuffer, nullptr);
+  vkFreeMemory(m_context.device, m_indexMemory, nullptr);
+  vkDestroyBuffer(m_context.device, m_vertexBuffer, nullptr);
+  vkFreeMemory(m_context.device, m_vertexMemory, nullptr);
+}
+
+void Mesh::Bind(VkCommandBuffer commandBuffer) const {
+  VkDeviceSize offset = 0;
+  vkCmdBindVertexBuffers(commandBuffer, 0, 1, &m_vertexBuffer, &offset);
+  vkCmdBindIndexBuffer(commandBuffer, m_indexBuffer, 0, m_indexType);
+}
+
+void Mesh::Draw(VkCommandBuffer commandBuffer, uint32_t instanceCount,
+                uint32_t firstInstance) const {
+  DrawLod(commandBuffer, 0, instanceCount, firstInstance);
+}
+
+void Mesh::DrawLod(VkCommandBuffer commandBuffer, uint32_t lod,
+                   uint32_t instanceCount, uint32_t firstInstance) const {
+  if (m_lods.empty()) {
+    vkCmdDrawIndexed(commandBuffer, m_indexCount, instanceCount, 0, 0,
+                     firstInstance);
+    return;
+  }
+  const MeshLod &range = m_lods[std::min<size_t>(lod, m_lods.size() - 1)];
+  vkCmdDrawIndexed(commandBuffer, range.indexCount, instanceCount,
+                   range.firstIndex, 0, firstInstance);
+}
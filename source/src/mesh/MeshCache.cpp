@@ -0,0 +1,234 @@
+#include "Mesh/MeshCache.hpp"
+
+#include "Mesh/GltfLoader.hpp"
+#include "Mesh/MeshOptimizer.hpp"
+#include "Mesh/MeshSimplifier.hpp"
+#include "Mesh/ObjLoader.hpp"
+#include "utils/log.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+constexpr uint64_t SECTION_ALIGNMENT = 16;
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+uint64_t indexSize(VkIndexType indexType) {
+  return indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t)
+                                           : sizeof(uint32_t);
+}
+
+MeshData importGltf(const std::string &sourcePath) {
+  GltfModel model(sourcePath);
+
+  MeshData mesh;
+  for (const GltfMesh &gltfMesh : model.GetMeshes()) {
+    for (const GltfPrimitive &primitive : gltfMesh.primitives) {
+      size_t baseVertex = mesh.vertices.size();
+      size_t baseIndex = mesh.indices.size();
+      mesh.vertices.resize(baseVertex + primitive.positions.count);
+      mesh.indices.resize(baseIndex + GltfModel::GetIndexCount(primitive));
+      GltfModel::WritePrimitive(primitive, mesh.vertices.data() + baseVertex,
+                                mesh.indices.data() + baseIndex,
+                                VK_INDEX_TYPE_UINT32);
+      for (size_t i = baseIndex; i < mesh.indices.size(); i++) {
+        mesh.indices[i] += static_cast<uint32_t>(baseVertex);
+      }
+    }
+  }
+  return mesh;
+}
+} // namespace
+
+uint64_t meshSourceStamp(const std::string &sourcePath) {
+  std::error_code error;
+  auto size = std::filesystem::file_size(sourcePath, error);
+  if (error) {
+    return 0;
+  }
+  auto time = std::filesystem::last_write_time(sourcePath, error);
+  if (error) {
+    return 0;
+  }
+  uint64_t ticks = static_cast<uint64_t>(time.time_since_epoch().count());
+  return ticks * 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(size);
+}
+
+MeshData importMesh(const std::string &sourcePath) {
+  MeshData mesh;
+  if (sourcePath.ends_with(".obj")) {
+    mesh = loadObj(sourcePath);
+  } else if (sourcePath.ends_with(".gltf") || sourcePath.ends_with(".glb")) {
+    mesh = importGltf(sourcePath);
+  } else {
+    LOG_ERROR("unsupported mesh format: {}", sourcePath);
+    throw std::runtime_error("unsupported mesh format: " + sourcePath);
+  }
+  generateLods(mesh);
+  optimizeMesh(mesh);
+  return mesh;
+}
+
+void writeMeshCache(const std::string &cachePath, const MeshData &mesh,
+                    uint64_t sourceStamp) {
+  VkIndexType indexType = selectIndexType(mesh.vertices.size());
+  std::vector<MeshLod> lods = mesh.lods;
+  if (lods.empty()) {
+    lods.push_back({0, static_cast<uint32_t>(mesh.indices.size()), 0.0f});
+  }
+
+  MeshCacheHeader header = {
+      .magic = MESH_CACHE_MAGIC,
+      .version = MESH_CACHE_VERSION,
+      .layoutHash = VertexLayoutOf<Vertex>::LAYOUT_HASH,
+      .sourceStamp = sourceStamp,
+      .vertexCount = static_cast<uint32_t>(mesh.vertices.size()),
+      .indexCount = static_cast<uint32_t>(mesh.indices.size()),
+      .indexType = static_cast<uint32_t>(indexType),
+      .lodCount = static_cast<uint32_t>(lods.size()),
+      .bounds = computeMeshBounds(mesh.vertices),
+  };
+  header.lodOffset = alignUp(sizeof(MeshCacheHeader), SECTION_ALIGNMENT);
+  header.vertexOffset = alignUp(
+      header.lodOffset + lods.size() * sizeof(MeshLod), SECTION_ALIGNMENT);
+  header.indexOffset =
+      alignUp(header.vertexOffset + mesh.vertices.size() * sizeof(Vertex),
+              SECTION_ALIGNMENT);
+  uint64_t fileSize =
+      header.indexOffset + mesh.indices.size() * indexSize(indexType);
+
+  // 先在内存中拼好整个文件，一次写出
+  std::vector<uint8_t> bytes(fileSize, 0);
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  std::memcpy(bytes.data() + header.lodOffset, lods.data(),
+              lods.size() * sizeof(MeshLod));
+  std::memcpy(bytes.data() + header.vertexOffset, mesh.vertices.data(),
+              mesh.vertices.size() * sizeof(Vertex));
+  if (indexType == VK_INDEX_TYPE_UINT16) {
+    uint16_t *indices =
+        reinterpret_cast<uint16_t *>(bytes.data() + header.indexOffset);
+    std::copy(mesh.indices.begin(), mesh.indices.end(), indices);
+  } else {
+    std::memcpy(bytes.data() + header.indexOffset, mesh.indices.data(),
+                mesh.indices.size() * sizeof(uint32_t));
+  }
+
+  std::string tempPath = cachePath + ".tmp";
+  {
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file.write(reinterpret_cast<const char *>(bytes.data()),
+                    static_cast<std::streamsize>(bytes.size()))) {
+      LOG_ERROR("failed to write mesh cache: {}", tempPath);
+      throw std::runtime_error("failed to write mesh cache: " + tempPath);
+    }
+  }
+  std::filesystem::rename(tempPath, cachePath);
+}
+
+std::unique_ptr<MeshCache> MeshCache::Open(const std::string &cachePath,
+                                           uint64_t sourceStamp) {
+  std::error_code error;
+  if (!std::filesystem::exists(cachePath, error)) {
+    return nullptr;
+  }
+
+  std::unique_ptr<MeshCache> cache(
+      new MeshCache(std::make_unique<MappedFile>(cachePath)));
+  const uint8_t *data = cache->m_file->GetData();
+  size_t size = cache->m_file->GetSize();
+  if (size < sizeof(MeshCacheHeader)) {
+    return nullptr;
+  }
+
+  MeshCacheHeader &header = cache->m_header;
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != MESH_CACHE_MAGIC ||
+      header.version != MESH_CACHE_VERSION ||
+      header.layoutHash != VertexLayoutOf<Vertex>::LAYOUT_HASH ||
+      header.sourceStamp != sourceStamp) {
+    LOG_INFO("mesh cache {} is stale", cachePath);
+    return nullptr;
+  }
+
+  VkIndexType indexType = static_cast<VkIndexType>(header.indexType);
+  if (indexType != selectIndexType(header.vertexCount) ||
+      header.lodOffset + uint64_t(header.lodCount) * sizeof(MeshLod) > size ||
+      header.vertexOffset + uint64_t(header.vertexCount) * sizeof(Vertex) >
+          size ||
+      header.indexOffset + header.indexCount * indexSize(indexType) > size) {
+    LOG_WARN("mesh cache {} is corrupt", cachePath);
+    return nullptr;
+  }
+
+  // 每个 LOD 的索引区间都必须落在索引数据内，否则绘制时会越界
+  cache->m_lods = reinterpret_cast<const MeshLod *>(data + header.lodOffset);
+  for (uint32_t lod = 0; lod < header.lodCount; lod++) {
+    const MeshLod &range = cache->m_lods[lod];
+    if (uint64_t(range.firstIndex) + range.indexCount > header.indexCount) {
+      LOG_WARN("mesh cache {} is corrupt: lod {} indices [{}, {}) exceed {}",
+               cachePath, lod, range.firstIndex,
+               uint64_t(range.firstIndex) + range.indexCount,
+               header.indexCount);
+      return nullptr;
+    }
+  }
+  cache->m_vertices = data + header.vertexOffset;
+  cache->m_indices = data + header.indexOffset;
+  return cache;
+}
+
+std::unique_ptr<Mesh>
+MeshCache::CreateMesh(const VkContext &context, VkCommandPool commandPool,
+                      VertexCompression compression) const {
+  uint64_t indexBytes =
+      m_header.indexCount *
+      indexSize(static_cast<VkIndexType>(m_header.indexType));
+
+  if (compression == VertexCompression::Quantized) {
+    VertexDequantization dequantization = VertexDequantization::FromBounds(
+        m_header.bounds.min, m_header.bounds.max);
+    auto mesh = std::make_unique<Mesh>(
+        context, commandPool, m_header.vertexCount, m_header.indexCount,
+        dequantization,
+        [&](QuantizedVertex *vertices, void *indices, VkIndexType) {
+          quantizeVertices(reinterpret_cast<const Vertex *>(m_vertices),
+                           m_header.vertexCount, dequantization, vertices);
+          std::memcpy(indices, m_indices, indexBytes);
+        });
+    mesh->SetLods({GetLods().begin(), GetLods().end()});
+    return mesh;
+  }
+
+  uint64_t vertexBytes = uint64_t(m_header.vertexCount) * sizeof(Vertex);
+  auto mesh = std::make_unique<Mesh>(
+      context, commandPool, m_header.vertexCount, m_header.indexCount,
+      [&](Vertex *vertices, void *indices, VkIndexType) {
+        std::memcpy(vertices, m_vertices, vertexBytes);
+        std::memcpy(indices, m_indices, indexBytes);
+      });
+  mesh->SetLods({GetLods().begin(), GetLods().end()});
+  return mesh;
+}
+
+std::unique_ptr<MeshCache> loadMeshCached(const std::string &sourcePath) {
+  std::string cachePath = sourcePath + ".meshcache";
+  uint64_t stamp = meshSourceStamp(sourcePath);
+
+  if (auto cache = MeshCache::Open(cachePath, stamp)) {
+    LOG_INFO("mesh cache hit: {}", cachePath);
+    return cache;
+  }
+
+  writeMeshCache(cachePath, importMesh(sourcePath), stamp);
+  auto cache = MeshCache::Open(cachePath, stamp);
+  if (!cache) {
+    LOG_ERROR("failed to reopen mesh cache: {}", cachePath);
+    throw std::runtime_error("failed to reopen mesh cache: " + cachePath);
+  }
+  return cache;
+}
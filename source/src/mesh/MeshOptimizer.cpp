@@ -0,0 +1,372 @@
+#include "Mesh/MeshOptimizer.hpp"
+
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+constexpr uint32_t INVALID_INDEX = ~0u;
+constexpr uint32_t FETCH_CACHE_LINE = 64;
+constexpr uint32_t FETCH_CACHE_LINES = 256; // 16 KiB
+
+// 时间戳模拟的 FIFO 缓存：timestamp - time[v] 不超过 size 时命中
+struct FifoCache {
+  std::vector<uint32_t> time;
+  uint32_t size;
+  uint32_t timestamp;
+
+  FifoCache(size_t entryCount, uint32_t cacheSize)
+      : time(entryCount, 0), size(cacheSize), timestamp(cacheSize + 1) {}
+
+  // 返回是否缺失
+  bool Access(uint32_t entry) {
+    if (timestamp - time[entry] > size) {
+      time[entry] = timestamp++;
+      return true;
+    }
+    return false;
+  }
+
+  void Flush() { timestamp += size + 1; }
+};
+
+// 每个顶点相邻的三角形，CSR 形式
+struct TriangleAdjacency {
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> triangles;
+
+  TriangleAdjacency(const uint32_t *indices, size_t indexCount,
+                    size_t vertexCount)
+      : offsets(vertexCount + 1, 0), triangles(indexCount) {
+    for (size_t i = 0; i < indexCount; i++) {
+      offsets[indices[i] + 1]++;
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < indexCount; i++) {
+      triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+  }
+
+  uint32_t GetCount(uint32_t vertex) const {
+    return offsets[vertex + 1] - offsets[vertex];
+  }
+};
+
+// Tipsify 的下一个扇心：优先选仍有未输出三角形、且输出后仍在缓存里的候选顶点，
+// 候选都不合适时从死端栈回溯，再不行按输入顺序找下一个
+uint32_t nextFanVertex(const std::vector<uint32_t> &candidates,
+                       const std::vector<uint32_t> &liveTriangles,
+                       const FifoCache &cache, std::vector<uint32_t> &deadEnd,
+                       uint32_t &cursor) {
+  uint32_t best = INVALID_INDEX;
+  int64_t bestPriority = -1;
+  for (uint32_t vertex : candidates) {
+    if (liveTriangles[vertex] == 0) {
+      continue;
+    }
+    int64_t age = cache.timestamp - cache.time[vertex];
+    int64_t priority = 0;
+    if (age + 2 * int64_t(liveTriangles[vertex]) <= cache.size) {
+      priority = age;
+    }
+    if (priority > bestPriority) {
+      bestPriority = priority;
+      best = vertex;
+    }
+  }
+  if (best != INVALID_INDEX) {
+    return best;
+  }
+
+  while (!deadEnd.empty()) {
+    uint32_t vertex = deadEnd.back();
+    deadEnd.pop_back();
+    if (liveTriangles[vertex] > 0) {
+      return vertex;
+    }
+  }
+  for (; cursor < liveTriangles.size(); cursor++) {
+    if (liveTriangles[cursor] > 0) {
+      return cursor;
+    }
+  }
+  return INVALID_INDEX;
+}
+
+// 按 FIFO 缓存把三角形序列切成簇：
+// 硬边界是三个顶点全部缺失的三角形（Tipsify 跳到了不相邻的区域），
+// 软边界是簇内累计 ACMR 已不超过所在硬簇 ACMR * threshold 的位置，
+// 在软边界重新开始计数相当于假设缓存被清空，因此只在代价不大时切分
+std::vector<uint32_t> buildClusters(const uint32_t *indices,
+                                    size_t triangleCount, size_t vertexCount,
+                                    float threshold, uint32_t cacheSize) {
+  FifoCache cache(vertexCount, cacheSize);
+  std::vector<uint32_t> hard = {0};
+  for (size_t t = 0; t < triangleCount; t++) {
+    uint32_t misses = cache.Access(indices[t * 3 + 0]) +
+                      cache.Access(indices[t * 3 + 1]) +
+                      cache.Access(indices[t * 3 + 2]);
+    if (misses == 3 && t > 0) {
+      hard.push_back(static_cast<uint32_t>(t));
+    }
+  }
+  hard.push_back(static_cast<uint32_t>(triangleCount));
+
+  std::vector<uint32_t> clusters;
+  for (size_t h = 0; h + 1 < hard.size(); h++) {
+    uint32_t begin = hard[h];
+    uint32_t end = hard[h + 1];
+
+    cache.Flush();
+    uint32_t hardMisses = 0;
+    for (uint32_t t = begin; t < end; t++) {
+      hardMisses += cache.Access(indices[t * 3 + 0]) +
+                    cache.Access(indices[t * 3 + 1]) +
+                    cache.Access(indices[t * 3 + 2]);
+    }
+    float limit = threshold * float(hardMisses) / float(end - begin);
+
+    cache.Flush();
+    clusters.push_back(begin);
+    uint32_t clusterBegin = begin;
+    uint32_t clusterMisses = 0;
+    for (uint32_t t = begin; t < end; t++) {
+      clusterMisses += cache.Access(indices[t * 3 + 0]) +
+                       cache.Access(indices[t * 3 + 1]) +
+                       cache.Access(indices[t * 3 + 2]);
+      if (t + 1 < end &&
+          float(clusterMisses) / float(t + 1 - clusterBegin) <= limit) {
+        clusters.push_back(t + 1);
+        clusterBegin = t + 1;
+        clusterMisses = 0;
+        cache.Flush();
+      }
+    }
+  }
+  clusters.push_back(static_cast<uint32_t>(triangleCount));
+  return clusters;
+}
+
+void logStats(const char *pass, const VertexCacheStats &before,
+              const VertexCacheStats &after) {
+  LOG_INFO("{}: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, overfetch "
+           "{:.3f} -> {:.3f}",
+           pass, before.acmr, after.acmr, before.atvr, after.atvr,
+           before.overfetch, after.overfetch);
+}
+} // namespace
+
+VertexCacheStats analyzeVertexCache(const uint32_t *indices,
+                                    size_t indexCount, size_t vertexCount,
+                                    uint32_t cacheSize) {
+  VertexCacheStats stats = {0.0f, 0.0f, 0.0f};
+  if (indexCount == 0) {
+    return stats;
+  }
+
+  FifoCache cache(vertexCount, cacheSize);
+  std::vector<bool> referenced(vertexCount, false);
+  size_t transformed = 0;
+  size_t uniqueVertices = 0;
+  for (size_t i = 0; i < indexCount; i++) {
+    uint32_t vertex = indices[i];
+    transformed += cache.Access(vertex);
+    if (!referenced[vertex]) {
+      referenced[vertex] = true;
+      uniqueVertices++;
+    }
+  }
+
+  // 顶点读取按缓存行统计，缺失的顶点才会触发读取
+  size_t lineCount =
+      (vertexCount * sizeof(Vertex) + FETCH_CACHE_LINE - 1) / FETCH_CACHE_LINE;
+  FifoCache lineCache(lineCount, FETCH_CACHE_LINES);
+  FifoCache vertexCache(vertexCount, cacheSize);
+  size_t fetchedBytes = 0;
+  for (size_t i = 0; i < indexCount; i++) {
+    uint32_t vertex = indices[i];
+    if (!vertexCache.Access(vertex)) {
+      continue;
+    }
+    size_t first = vertex * sizeof(Vertex) / FETCH_CACHE_LINE;
+    size_t last = ((vertex + 1) * sizeof(Vertex) - 1) / FETCH_CACHE_LINE;
+    for (size_t line = first; line <= last; line++) {
+      if (lineCache.Access(static_cast<uint32_t>(line))) {
+        fetchedBytes += FETCH_CACHE_LINE;
+      }
+    }
+  }
+
+  stats.acmr = float(transformed) / float(indexCount / 3);
+  stats.atvr = float(transformed) / float(uniqueVertices);
+  stats.overfetch = float(fetchedBytes) / float(uniqueVertices * sizeof(Vertex));
+  return stats;
+}
+
+// Sander 等人的 Tipsify：以顶点为扇心依次输出其全部未输出的三角形，
+// 线性时间，不需要逐三角形打分
+void optimizeVertexCache(uint32_t *indices, size_t indexCount,
+                         size_t vertexCount, uint32_t cacheSize) {
+  size_t triangleCount = indexCount / 3;
+  if (triangleCount == 0) {
+    return;
+  }
+
+  TriangleAdjacency adjacency(indices, indexCount, vertexCount);
+  std::vector<uint32_t> liveTriangles(vertexCount);
+  for (size_t v = 0; v < vertexCount; v++) {
+    liveTriangles[v] = adjacency.GetCount(static_cast<uint32_t>(v));
+  }
+
+  FifoCache cache(vertexCount, cacheSize);
+  std::vector<bool> emitted(triangleCount, false);
+  std::vector<uint32_t> deadEnd;
+  std::vector<uint32_t> candidates;
+  std::vector<uint32_t> output;
+  output.reserve(indexCount);
+
+  uint32_t cursor = 0;
+  uint32_t fan = nextFanVertex({}, liveTriangles, cache, deadEnd, cursor);
+  while (fan != INVALID_INDEX) {
+    candidates.clear();
+    for (uint32_t i = adjacency.offsets[fan]; i < adjacency.offsets[fan + 1];
+         i++) {
+      uint32_t triangle = adjacency.triangles[i];
+      if (emitted[triangle]) {
+        continue;
+      }
+      emitted[triangle] = true;
+      for (uint32_t corner = 0; corner < 3; corner++) {
+        uint32_t vertex = indices[triangle * 3 + corner];
+        output.push_back(vertex);
+        deadEnd.push_back(vertex);
+        candidates.push_back(vertex);
+        liveTriangles[vertex]--;
+        cache.Access(vertex);
+      }
+    }
+    fan = nextFanVertex(candidates, liveTriangles, cache, deadEnd, cursor);
+  }
+
+  std::copy(output.begin(), output.end(), indices);
+}
+
+// Sander 等人的线性时间过度绘制优化：簇按 (簇中心 - 网格中心) · 簇法线 从大到小排序，
+// 越朝外的簇越先绘制
+void optimizeOverdraw(uint32_t *indices, size_t indexCount,
+                      const std::vector<Vertex> &vertices, float threshold,
+                      uint32_t cacheSize) {
+  size_t triangleCount = indexCount / 3;
+  if (triangleCount == 0) {
+    return;
+  }
+
+  std::vector<uint32_t> clusters = buildClusters(
+      indices, triangleCount, vertices.size(), threshold, cacheSize);
+  size_t clusterCount = clusters.size() - 1;
+  if (clusterCount <= 1) {
+    return;
+  }
+
+  // 以面积加权的三角形中心作为网格中心
+  glm::vec3 meshCenter(0.0f);
+  float meshArea = 0.0f;
+  std::vector<glm::vec3> clusterCenters(clusterCount, glm::vec3(0.0f));
+  std::vector<glm::vec3> clusterNormals(clusterCount, glm::vec3(0.0f));
+  for (size_t c = 0; c < clusterCount; c++) {
+    float clusterArea = 0.0f;
+    for (uint32_t t = clusters[c]; t < clusters[c + 1]; t++) {
+      const glm::vec3 &p0 = vertices[indices[t * 3 + 0]].position;
+      const glm::vec3 &p1 = vertices[indices[t * 3 + 1]].position;
+      const glm::vec3 &p2 = vertices[indices[t * 3 + 2]].position;
+      glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+      float area = glm::length(normal);
+      glm::vec3 center = (p0 + p1 + p2) / 3.0f;
+
+      clusterCenters[c] += center * area;
+      clusterNormals[c] += normal;
+      clusterArea += area;
+    }
+    meshCenter += clusterCenters[c];
+    meshArea += clusterArea;
+    clusterCenters[c] =
+        clusterArea > 0.0f ? clusterCenters[c] / clusterArea : glm::vec3(0.0f);
+  }
+  if (meshArea > 0.0f) {
+    meshCenter /= meshArea;
+  }
+
+  std::vector<float> sortKeys(clusterCount);
+  for (size_t c = 0; c < clusterCount; c++) {
+    float length = glm::length(clusterNormals[c]);
+    glm::vec3 normal =
+        length > 0.0f ? clusterNormals[c] / length : glm::vec3(0.0f);
+    sortKeys[c] = glm::dot(clusterCenters[c] - meshCenter, normal);
+  }
+
+  std::vector<uint32_t> order(clusterCount);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return sortKeys[a] > sortKeys[b];
+  });
+
+  std::vector<uint32_t> output;
+  output.reserve(indexCount);
+  for (uint32_t c : order) {
+    output.insert(output.end(), indices + clusters[c] * 3,
+                  indices + clusters[c + 1] * 3);
+  }
+  std::copy(output.begin(), output.end(), indices);
+}
+
+void optimizeVertexFetch(std::vector<Vertex> &vertices,
+                         std::vector<uint32_t> &indices) {
+  std::vector<uint32_t> remap(vertices.size(), INVALID_INDEX);
+  std::vector<Vertex> reordered;
+  reordered.reserve(vertices.size());
+  for (uint32_t &index : indices) {
+    if (remap[index] == INVALID_INDEX) {
+      remap[index] = static_cast<uint32_t>(reordered.size());
+      reordered.push_back(vertices[index]);
+    }
+    index = remap[index];
+  }
+  vertices = std::move(reordered);
+}
+
+void optimizeMesh(MeshData &mesh) {
+  std::vector<MeshLod> lods = mesh.lods;
+  if (lods.empty()) {
+    lods.push_back({0, static_cast<uint32_t>(mesh.indices.size()), 0.0f});
+  }
+
+  auto analyze = [&mesh](const MeshLod &lod) {
+    return analyzeVertexCache(mesh.indices.data() + lod.firstIndex,
+                              lod.indexCount, mesh.vertices.size());
+  };
+
+  for (size_t level = 0; level < lods.size(); level++) {
+    uint32_t *indices = mesh.indices.data() + lods[level].firstIndex;
+    uint32_t indexCount = lods[level].indexCount;
+
+    VertexCacheStats original = analyze(lods[level]);
+    optimizeVertexCache(indices, indexCount, mesh.vertices.size());
+    VertexCacheStats cacheOptimized = analyze(lods[level]);
+    logStats("vertex cache", original, cacheOptimized);
+
+    optimizeOverdraw(indices, indexCount, mesh.vertices);
+    logStats("overdraw", cacheOptimized, analyze(lods[level]));
+  }
+
+  // 顶点重排对所有 LOD 共用；以最精细一级的统计为准
+  VertexCacheStats beforeFetch = analyze(lods[0]);
+  size_t vertexCount = mesh.vertices.size();
+  optimizeVertexFetch(mesh.vertices, mesh.indices);
+  logStats("vertex fetch", beforeFetch, analyze(lods[0]));
+  if (mesh.vertices.size() != vertexCount) {
+    LOG_INFO("vertex fetch: removed {} unreferenced vertices",
+             vertexCount - mesh.vertices.size());
+  }
+}
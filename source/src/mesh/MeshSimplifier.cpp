@@ -0,0 +1,463 @@
+#include "Mesh/MeshSimplifier.hpp"
+
+#include "utils/FlatHashMap.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace {
+constexpr uint32_t INVALID_INDEX = ~0u;
+
+// 对称 4x4 矩阵的 10 个分量，外加面积权重
+struct Quadric {
+  double a00 = 0, a11 = 0, a22 = 0, a01 = 0, a02 = 0, a12 = 0;
+  double b0 = 0, b1 = 0, b2 = 0;
+  double c = 0;
+  double weight = 0;
+
+  static Quadric FromPlane(const glm::vec3 &normal, float distance,
+                           double weight) {
+    double a = normal.x, b = normal.y, c = normal.z, d = distance;
+    Quadric q;
+    q.a00 = a * a * weight;
+    q.a11 = b * b * weight;
+    q.a22 = c * c * weight;
+    q.a01 = a * b * weight;
+    q.a02 = a * c * weight;
+    q.a12 = b * c * weight;
+    q.b0 = a * d * weight;
+    q.b1 = b * d * weight;
+    q.b2 = c * d * weight;
+    q.c = d * d * weight;
+    q.weight = weight;
+    return q;
+  }
+
+  Quadric &operator+=(const Quadric &other) {
+    a00 += other.a00;
+    a11 += other.a11;
+    a22 += other.a22;
+    a01 += other.a01;
+    a02 += other.a02;
+    a12 += other.a12;
+    b0 += other.b0;
+    b1 += other.b1;
+    b2 += other.b2;
+    c += other.c;
+    weight += other.weight;
+    return *this;
+  }
+
+  // 到所有平面距离平方的加权平均，只用于给折叠排序，不是距离上限
+  double Evaluate(const glm::vec3 &p) const {
+    double x = p.x, y = p.y, z = p.z;
+    double error = a00 * x * x + a11 * y * y + a22 * z * z +
+                   2 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                   2 * (b0 * x + b1 * y + b2 * z) + c;
+    return weight > 0 ? std::max(error, 0.0) / weight : 0.0;
+  }
+};
+
+struct PositionKey {
+  uint32_t bits[3];
+  bool operator==(const PositionKey &other) const {
+    return std::memcmp(bits, other.bits, sizeof(bits)) == 0;
+  }
+};
+
+struct PositionKeyHash {
+  size_t operator()(const PositionKey &key) const {
+    uint64_t h = key.bits[0];
+    h = h * 0x9E3779B97F4A7C15ull ^ key.bits[1];
+    h = h * 0x9E3779B97F4A7C15ull ^ key.bits[2];
+    return static_cast<size_t>(h);
+  }
+};
+
+struct EdgeKey {
+  uint32_t a, b;
+  bool operator==(const EdgeKey &other) const {
+    return a == other.a && b == other.b;
+  }
+};
+
+struct EdgeKeyHash {
+  size_t operator()(const EdgeKey &key) const {
+    return static_cast<size_t>((uint64_t(key.a) << 32 | key.b) *
+                               0x9E3779B97F4A7C15ull);
+  }
+};
+
+struct Collapse {
+  uint32_t from;
+  uint32_t to;
+  float error;
+};
+
+// 位置相同的顶点映射到同一个代表顶点（第一次出现的那个）
+std::vector<uint32_t> buildPositionRemap(const std::vector<Vertex> &vertices) {
+  std::vector<uint32_t> remap(vertices.size());
+  FlatHashMap<PositionKey, uint32_t, PositionKeyHash> positions(
+      vertices.size());
+  for (uint32_t v = 0; v < vertices.size(); v++) {
+    PositionKey key;
+    std::memcpy(key.bits, &vertices[v].position, sizeof(key.bits));
+    remap[v] = *positions.TryEmplace(key, v).first;
+  }
+  return remap;
+}
+
+// 锁定边界顶点：只出现在一个三角形中的位置边的两个端点。
+// 接缝（同一位置多个顶点）不锁定，折叠时同一位置的所有顶点一起沿接缝移动
+std::vector<bool> findLockedVertices(const std::vector<uint32_t> &remap,
+                                     const std::vector<uint32_t> &indices) {
+  std::vector<bool> locked(remap.size(), false);
+  FlatHashMap<EdgeKey, uint32_t, EdgeKeyHash> edges(indices.size());
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    for (int e = 0; e < 3; e++) {
+      uint32_t a = remap[indices[i + e]];
+      uint32_t b = remap[indices[i + (e + 1) % 3]];
+      EdgeKey key = {std::min(a, b), std::max(a, b)};
+      auto [count, inserted] = edges.TryEmplace(key, 0);
+      (*count)++;
+    }
+  }
+  edges.ForEach([&](const EdgeKey &key, uint32_t count) {
+    if (count == 1) {
+      locked[key.a] = true;
+      locked[key.b] = true;
+    }
+  });
+  // 代表顶点被锁定时，同一位置的所有顶点一起锁定
+  for (uint32_t v = 0; v < remap.size(); v++) {
+    if (locked[remap[v]]) {
+      locked[v] = true;
+    }
+  }
+  return locked;
+}
+
+// 为 position 的每个被使用的顶点在 target 位置上找到唯一相连的顶点，
+// 即折叠后它应该合并到的顶点。接缝两侧的顶点各自沿接缝边找到对应的顶点；
+// 某个顶点不与 target 相连或对应不唯一时不能折叠（会撕开属性）
+bool findCollapsePairs(const std::vector<uint32_t> &remap,
+                       const std::vector<uint32_t> &indices,
+                       const std::vector<uint32_t> &wedgeOffsets,
+                       const std::vector<uint32_t> &wedges,
+                       const std::vector<uint32_t> &adjacencyOffsets,
+                       const std::vector<uint32_t> &adjacency,
+                       uint32_t position, uint32_t target,
+                       std::vector<std::pair<uint32_t, uint32_t>> &pairs) {
+  pairs.clear();
+  for (uint32_t w = wedgeOffsets[position]; w < wedgeOffsets[position + 1];
+       w++) {
+    uint32_t from = wedges[w];
+    if (adjacencyOffsets[from] == adjacencyOffsets[from + 1]) {
+      continue; // 已不被任何三角形使用
+    }
+    uint32_t partner = INVALID_INDEX;
+    for (uint32_t i = adjacencyOffsets[from]; i < adjacencyOffsets[from + 1];
+         i++) {
+      const uint32_t *triangle = &indices[adjacency[i] * 3];
+      for (int k = 0; k < 3; k++) {
+        uint32_t other = triangle[k];
+        if (remap[other] != target) {
+          continue;
+        }
+        if (partner != INVALID_INDEX && partner != other) {
+          return false;
+        }
+        partner = other;
+      }
+    }
+    if (partner == INVALID_INDEX) {
+      return false;
+    }
+    pairs.push_back({from, partner});
+  }
+  return !pairs.empty();
+}
+
+glm::vec3 triangleNormal(const glm::vec3 &p0, const glm::vec3 &p1,
+                         const glm::vec3 &p2) {
+  return glm::cross(p1 - p0, p2 - p0);
+}
+
+// 把 from 移到 to 之后，from 周围不含 to 的三角形是否翻面
+bool collapseFlips(const std::vector<Vertex> &vertices,
+                   const std::vector<uint32_t> &indices,
+                   const std::vector<uint32_t> &adjacencyOffsets,
+                   const std::vector<uint32_t> &adjacency, uint32_t from,
+                   uint32_t to) {
+  const glm::vec3 &target = vertices[to].position;
+  for (uint32_t i = adjacencyOffsets[from]; i < adjacencyOffsets[from + 1];
+       i++) {
+    const uint32_t *triangle = &indices[adjacency[i] * 3];
+    if (triangle[0] == to || triangle[1] == to || triangle[2] == to) {
+      continue; // 折叠后退化，会被删除
+    }
+    glm::vec3 p[3];
+    glm::vec3 moved[3];
+    for (int k = 0; k < 3; k++) {
+      p[k] = vertices[triangle[k]].position;
+      moved[k] = triangle[k] == from ? target : p[k];
+    }
+    glm::vec3 before = triangleNormal(p[0], p[1], p[2]);
+    glm::vec3 after = triangleNormal(moved[0], moved[1], moved[2]);
+    if (glm::dot(before, after) <= 0.0f) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// 折叠目标到两个位置合并区域内所有原始平面的最大距离。
+// 距离在三角形上是仿射的，最大值在顶点处取到，因此这也是新三角形偏离原始平面的上限
+double regionBound(const std::vector<glm::vec4> &planes,
+                   const std::vector<uint32_t> &fromRegion,
+                   const std::vector<uint32_t> &toRegion,
+                   const glm::vec3 &target) {
+  double bound = 0.0;
+  for (const std::vector<uint32_t> *region : {&fromRegion, &toRegion}) {
+    for (uint32_t plane : *region) {
+      const glm::vec4 &p = planes[plane];
+      double distance = std::abs(glm::dot(glm::vec3(p), target) + p.w);
+      bound = std::max(bound, distance);
+    }
+  }
+  return bound;
+}
+} // namespace
+
+SimplifyResult simplifyMesh(const std::vector<Vertex> &vertices,
+                            const uint32_t *indices, size_t indexCount,
+                            size_t targetIndexCount, float maxError) {
+  SimplifyResult result = {
+      std::vector<uint32_t>(indices, indices + indexCount), 0.0f};
+  std::vector<uint32_t> &current = result.indices;
+  size_t vertexCount = vertices.size();
+
+  std::vector<uint32_t> remap = buildPositionRemap(vertices);
+  std::vector<bool> locked = findLockedVertices(remap, current);
+
+  // 同一位置的所有顶点（接缝两侧的属性副本），按代表顶点分组
+  std::vector<uint32_t> wedgeOffsets(vertexCount + 1, 0);
+  for (uint32_t v = 0; v < vertexCount; v++) {
+    wedgeOffsets[remap[v] + 1]++;
+  }
+  std::partial_sum(wedgeOffsets.begin(), wedgeOffsets.end(),
+                   wedgeOffsets.begin());
+  std::vector<uint32_t> wedges(vertexCount);
+  {
+    std::vector<uint32_t> cursor(wedgeOffsets.begin(), wedgeOffsets.end() - 1);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+      wedges[cursor[remap[v]]++] = v;
+    }
+  }
+
+  // 1. 每个位置累积相邻三角形平面的二次误差，按面积加权；
+  // 同时记录每个位置合并区域内的原始平面，用来计算误差上限
+  std::vector<Quadric> quadrics(vertexCount);
+  std::vector<glm::vec4> planes;
+  std::vector<std::vector<uint32_t>> regions(vertexCount);
+  for (size_t i = 0; i + 2 < current.size(); i += 3) {
+    const glm::vec3 &p0 = vertices[current[i + 0]].position;
+    const glm::vec3 &p1 = vertices[current[i + 1]].position;
+    const glm::vec3 &p2 = vertices[current[i + 2]].position;
+    glm::vec3 normal = triangleNormal(p0, p1, p2);
+    float area = glm::length(normal);
+    if (area == 0.0f) {
+      continue;
+    }
+    normal /= area;
+    float distance = -glm::dot(normal, p0);
+    Quadric quadric = Quadric::FromPlane(normal, distance, area * 0.5);
+    uint32_t plane = static_cast<uint32_t>(planes.size());
+    planes.push_back(glm::vec4(normal, distance));
+    for (int k = 0; k < 3; k++) {
+      quadrics[remap[current[i + k]]] += quadric;
+      regions[remap[current[i + k]]].push_back(plane);
+    }
+  }
+
+  // 平均距离平方不超过最大距离的平方，超过 maxError² 的折叠可以直接跳过
+  double maxErrorSquared = double(maxError) * maxError;
+  double resultError = 0.0;
+  std::vector<std::pair<uint32_t, uint32_t>> pairs;
+  std::vector<uint32_t> collapseTarget(vertexCount);
+  std::vector<bool> touched(vertexCount);
+  std::vector<Collapse> collapses;
+  std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+  std::vector<uint32_t> adjacency;
+
+  // 2. 多轮迭代：每轮按误差从小到大挑选互不相邻的折叠一起执行
+  while (current.size() > targetIndexCount) {
+    size_t triangleCount = current.size() / 3;
+
+    std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+    for (uint32_t index : current) {
+      adjacencyOffsets[index + 1]++;
+    }
+    std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(),
+                     adjacencyOffsets.begin());
+    adjacency.resize(current.size());
+    {
+      std::vector<uint32_t> cursor(adjacencyOffsets.begin(),
+                                   adjacencyOffsets.end() - 1);
+      for (size_t i = 0; i < current.size(); i++) {
+        adjacency[cursor[current[i]]++] = static_cast<uint32_t>(i / 3);
+      }
+    }
+
+    collapses.clear();
+    for (size_t i = 0; i < current.size(); i += 3) {
+      for (int e = 0; e < 3; e++) {
+        uint32_t from = current[i + e];
+        uint32_t to = current[i + (e + 1) % 3];
+        if (locked[from]) {
+          continue;
+        }
+        Quadric quadric = quadrics[remap[from]];
+        quadric += quadrics[remap[to]];
+        double error = quadric.Evaluate(vertices[to].position);
+        if (error <= maxErrorSquared) {
+          collapses.push_back({from, to, static_cast<float>(error)});
+        }
+      }
+    }
+    if (collapses.empty()) {
+      break;
+    }
+    std::sort(collapses.begin(), collapses.end(),
+              [](const Collapse &a, const Collapse &b) {
+                return a.error < b.error;
+              });
+
+    // 每次折叠约减少两个三角形
+    size_t wanted = (triangleCount - targetIndexCount / 3) / 2 + 1;
+    std::iota(collapseTarget.begin(), collapseTarget.end(), 0);
+    std::fill(touched.begin(), touched.end(), false);
+    size_t applied = 0;
+    for (const Collapse &collapse : collapses) {
+      if (applied >= wanted) {
+        break;
+      }
+      // 同一位置的所有顶点一起移动，各自合并到 to 位置上对应的顶点
+      uint32_t fromPosition = remap[collapse.from];
+      uint32_t toPosition = remap[collapse.to];
+      if (!findCollapsePairs(remap, current, wedgeOffsets, wedges,
+                             adjacencyOffsets, adjacency, fromPosition,
+                             toPosition, pairs)) {
+        continue;
+      }
+      bool rejected = false;
+      for (auto [from, to] : pairs) {
+        rejected = rejected || touched[from] || touched[to] ||
+                   collapseFlips(vertices, current, adjacencyOffsets,
+                                 adjacency, from, to);
+      }
+      if (rejected) {
+        continue;
+      }
+      double bound = regionBound(planes, regions[fromPosition],
+                                 regions[toPosition],
+                                 vertices[collapse.to].position);
+      if (bound > maxError) {
+        continue;
+      }
+
+      for (auto [from, to] : pairs) {
+        collapseTarget[from] = to;
+        // from 周围的三角形都会变化，本轮不再移动其中的顶点
+        for (uint32_t i = adjacencyOffsets[from];
+             i < adjacencyOffsets[from + 1]; i++) {
+          const uint32_t *triangle = &current[adjacency[i] * 3];
+          touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] =
+              true;
+        }
+      }
+      quadrics[toPosition] += quadrics[fromPosition];
+      // 区域只移动不复制，小的并入大的，总量始终是三角形数的三倍
+      std::vector<uint32_t> &fromRegion = regions[fromPosition];
+      std::vector<uint32_t> &toRegion = regions[toPosition];
+      if (fromRegion.size() > toRegion.size()) {
+        fromRegion.swap(toRegion);
+      }
+      toRegion.insert(toRegion.end(), fromRegion.begin(), fromRegion.end());
+      std::vector<uint32_t>().swap(fromRegion);
+      resultError = std::max(resultError, bound);
+      applied++;
+    }
+    if (applied == 0) {
+      break;
+    }
+
+    // 3. 重写索引并删除退化的三角形
+    size_t write = 0;
+    for (size_t i = 0; i < current.size(); i += 3) {
+      uint32_t a = collapseTarget[current[i + 0]];
+      uint32_t b = collapseTarget[current[i + 1]];
+      uint32_t c = collapseTarget[current[i + 2]];
+      if (remap[a] == remap[b] || remap[b] == remap[c] ||
+          remap[a] == remap[c]) {
+        continue;
+      }
+      current[write++] = a;
+      current[write++] = b;
+      current[write++] = c;
+    }
+    current.resize(write);
+  }
+
+  result.error = static_cast<float>(resultError);
+  return result;
+}
+
+void generateLods(MeshData &mesh, const LodConfig &config) {
+  if (!mesh.lods.empty() || mesh.indices.empty()) {
+    return;
+  }
+
+  MeshBounds bounds = computeMeshBounds(mesh.vertices);
+  float maxError = config.maxRelativeError * bounds.radius;
+
+  uint32_t originalIndexCount = static_cast<uint32_t>(mesh.indices.size());
+  mesh.lods.push_back({0, originalIndexCount, 0.0f});
+  while (mesh.lods.size() < config.maxLodCount) {
+    MeshLod previous = mesh.lods.back();
+    size_t previousTriangles = previous.indexCount / 3;
+    if (previousTriangles <= config.minTriangleCount) {
+      break;
+    }
+
+    size_t target = std::max<size_t>(
+        size_t(previousTriangles * config.reduction), config.minTriangleCount);
+    // 每级都从原始网格简化，误差上限直接相对原始三角形，不需要逐级累加
+    SimplifyResult simplified =
+        simplifyMesh(mesh.vertices, mesh.indices.data(), originalIndexCount,
+                     target * 3, maxError);
+
+    // 简化不动了（大量锁定顶点或误差到顶），后面的级别没有意义
+    if (simplified.indices.size() > previous.indexCount * 0.9f) {
+      break;
+    }
+
+    MeshLod lod = {
+        .firstIndex = static_cast<uint32_t>(mesh.indices.size()),
+        .indexCount = static_cast<uint32_t>(simplified.indices.size()),
+        .error = std::max(previous.error, simplified.error),
+    };
+    mesh.indices.insert(mesh.indices.end(), simplified.indices.begin(),
+                        simplified.indices.end());
+    mesh.lods.push_back(lod);
+    LOG_INFO("LOD {}: {} triangles, error {:.5f}", mesh.lods.size() - 1,
+             lod.indexCount / 3, lod.error);
+  }
+
+  if (mesh.lods.size() == 1) {
+    mesh.lods.clear(); // 只有原始网格时保持“空即一级”的约定
+  }
+}
@@ -0,0 +1,145 @@
+#include "Mesh/Meshlet.hpp"
+
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr uint8_t INVALID_LOCAL = 0xFF;
+static_assert(MESHLET_MAX_VERTICES < INVALID_LOCAL);
+} // namespace
+
+MeshletData buildMeshlets(const MeshData &mesh) {
+  uint32_t indexCount = mesh.lods.empty()
+                            ? static_cast<uint32_t>(mesh.indices.size())
+                            : mesh.lods[0].indexCount;
+  const uint32_t *indices =
+      mesh.indices.data() + (mesh.lods.empty() ? 0 : mesh.lods[0].firstIndex);
+
+  MeshletData result;
+  // 簇边界上的顶点会重复，按三角形数预留
+  result.meshlets.reserve(indexCount / 3 / MESHLET_MAX_TRIANGLES + 1);
+  result.vertices.reserve(indexCount / 3);
+  result.triangles.reserve(indexCount);
+
+  // 网格顶点在当前簇中的局部索引
+  std::vector<uint8_t> localIndex(mesh.vertices.size(), INVALID_LOCAL);
+  Meshlet current = {0, 0, 0, 0};
+
+  auto flush = [&] {
+    if (current.triangleCount == 0) {
+      return;
+    }
+    for (uint32_t i = 0; i < current.vertexCount; i++) {
+      localIndex[result.vertices[current.vertexOffset + i]] = INVALID_LOCAL;
+    }
+    result.meshlets.push_back(current);
+    current = {static_cast<uint32_t>(result.vertices.size()),
+               static_cast<uint32_t>(result.triangles.size()), 0, 0};
+  };
+
+  for (uint32_t i = 0; i + 2 < indexCount; i += 3) {
+    uint32_t a = indices[i + 0];
+    uint32_t b = indices[i + 1];
+    uint32_t c = indices[i + 2];
+    uint32_t newVertices = (localIndex[a] == INVALID_LOCAL) +
+                           (localIndex[b] == INVALID_LOCAL) +
+                           (localIndex[c] == INVALID_LOCAL);
+    if (current.vertexCount + newVertices > MESHLET_MAX_VERTICES ||
+        current.triangleCount + 1 > MESHLET_MAX_TRIANGLES) {
+      flush();
+    }
+
+    for (uint32_t vertex : {a, b, c}) {
+      if (localIndex[vertex] == INVALID_LOCAL) {
+        localIndex[vertex] = static_cast<uint8_t>(current.vertexCount++);
+        result.vertices.push_back(vertex);
+      }
+      result.triangles.push_back(localIndex[vertex]);
+    }
+    current.triangleCount++;
+  }
+  flush();
+
+  result.bounds.reserve(result.meshlets.size());
+  for (const Meshlet &meshlet : result.meshlets) {
+    result.bounds.push_back(
+        computeMeshletBounds(result, meshlet, mesh.vertices));
+  }
+
+  LOG_INFO("built {} meshlets: {:.1f} vertices, {:.1f} triangles on average",
+           result.meshlets.size(),
+           result.meshlets.empty()
+               ? 0.0
+               : double(result.vertices.size()) / result.meshlets.size(),
+           result.meshlets.empty()
+               ? 0.0
+               : double(result.triangles.size() / 3) / result.meshlets.size());
+  return result;
+}
+
+MeshletBounds computeMeshletBounds(const MeshletData &meshlets,
+                                   const Meshlet &meshlet,
+                                   const std::vector<Vertex> &vertices) {
+  auto position = [&](uint32_t local) -> const glm::vec3 & {
+    return vertices[meshlets.vertices[meshlet.vertexOffset + local]].position;
+  };
+
+  // 包围球：以包围盒中心为球心
+  glm::vec3 min = position(0);
+  glm::vec3 max = position(0);
+  for (uint32_t i = 1; i < meshlet.vertexCount; i++) {
+    min = glm::min(min, position(i));
+    max = glm::max(max, position(i));
+  }
+  MeshletBounds bounds = {(min + max) * 0.5f, 0.0f, glm::vec3(0.0f), 1.0f};
+  for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+    bounds.radius =
+        std::max(bounds.radius, glm::distance(bounds.center, position(i)));
+  }
+
+  // 法线锥：平均法线为轴，所有三角形法线与轴的最小夹角余弦决定开口
+  std::vector<glm::vec3> normals;
+  normals.reserve(meshlet.triangleCount);
+  glm::vec3 axis(0.0f);
+  const uint8_t *triangles = meshlets.triangles.data() + meshlet.triangleOffset;
+  for (uint32_t t = 0; t < meshlet.triangleCount; t++) {
+    const glm::vec3 &p0 = position(triangles[t * 3 + 0]);
+    const glm::vec3 &p1 = position(triangles[t * 3 + 1]);
+    const glm::vec3 &p2 = position(triangles[t * 3 + 2]);
+    glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+    float length = glm::length(normal);
+    if (length == 0.0f) {
+      continue; // 退化三角形不影响朝向
+    }
+    normals.push_back(normal / length);
+    axis += normals.back();
+  }
+
+  float axisLength = glm::length(axis);
+  if (normals.empty() || axisLength == 0.0f) {
+    return bounds;
+  }
+  axis /= axisLength;
+
+  float minDot = 1.0f;
+  for (const glm::vec3 &normal : normals) {
+    minDot = std::min(minDot, glm::dot(normal, axis));
+  }
+  bounds.coneAxis = axis;
+  bounds.coneCutoff = minDot <= 0.0f ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+  return bounds;
+}
+
+std::vector<uint32_t> meshletIndices(const MeshletData &meshlets) {
+  std::vector<uint32_t> indices(meshlets.triangles.size());
+  for (const Meshlet &meshlet : meshlets.meshlets) {
+    for (uint32_t i = 0; i < meshlet.triangleCount * 3; i++) {
+      uint8_t local = meshlets.triangles[meshlet.triangleOffset + i];
+      indices[meshlet.triangleOffset + i] =
+          meshlets.vertices[meshlet.vertexOffset + local];
+    }
+  }
+  return indices;
+}
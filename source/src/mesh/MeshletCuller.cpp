@@ -0,0 +1,133 @@
+#include "Mesh/MeshletCuller.hpp"
+
+#include "Vulkan/VkUtils.hpp"
+#include "utils/fileUtils.hpp"
+#include "utils/log.hpp"
+
+#include <stdexcept>
+
+namespace {
+constexpr uint32_t MESHLET_BINDING = 0;
+constexpr uint32_t DRAW_BINDING = 1;
+constexpr uint32_t DRAW_COUNT_BINDING = 2;
+} // namespace
+
+MeshletCuller::MeshletCuller(const VkContext &context)
+    : m_context(context),
+      m_layout(context,
+               {
+                   {MESHLET_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+                    VK_SHADER_STAGE_COMPUTE_BIT},
+                   {DRAW_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+                    VK_SHADER_STAGE_COMPUTE_BIT},
+                   {DRAW_COUNT_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+                    VK_SHADER_STAGE_COMPUTE_BIT},
+               }),
+      m_descriptorAllocator(context) {
+  VkDescriptorSetLayout setLayout = m_layout.Get();
+  VkPushConstantRange pushConstantRange = {
+      .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+      .offset = 0,
+      .size = sizeof(MeshletCullParams),
+  };
+  VkPipelineLayoutCreateInfo layoutInfo = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+      .setLayoutCount = 1,
+      .pSetLayouts = &setLayout,
+      .pushConstantRangeCount = 1,
+      .pPushConstantRanges = &pushConstantRange,
+  };
+  if (vkCreatePipelineLayout(m_context.device, &layoutInfo, nullptr,
+                             &m_pipelineLayout) != VK_SUCCESS) {
+    LOG_ERROR("failed to create meshlet cull pipeline layout!");
+    throw std::runtime_error("failed to create meshlet cull pipeline layout!");
+  }
+
+  VkShaderModule shaderModule = createShaderModule(
+      m_context, readFile(SHADER_PATH "meshlet/meshlet_cull.comp.spv"));
+  VkComputePipelineCreateInfo pipelineInfo = {
+      .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+      .stage =
+          {
+              .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+              .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+              .module = shaderModule,
+              .pName = "main",
+          },
+      .layout = m_pipelineLayout,
+  };
+  VkResult result = vkCreateComputePipelines(
+      m_context.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline);
+  vkDestroyShaderModule(m_context.device, shaderModule, nullptr);
+  if (result != VK_SUCCESS) {
+    vkDestroyPipelineLayout(m_context.device, m_pipelineLayout, nullptr);
+    LOG_ERROR("failed to create meshlet cull pipeline!");
+    throw std::runtime_error("failed to create meshlet cull pipeline!");
+  }
+}
+
+MeshletCuller::~MeshletCuller() {
+  vkDestroyPipeline(m_context.device, m_pipeline, nullptr);
+  vkDestroyPipelineLayout(m_context.device, m_pipelineLayout, nullptr);
+}
+
+VkDescriptorSet MeshletCuller::AllocateSet(const MeshletMesh &mesh) {
+  VkDescriptorSet set = m_descriptorAllocator.Allocate(m_layout);
+  DescriptorWrite writes[3];
+  writes[MESHLET_BINDING].buffer = {mesh.GetMeshletBuffer(), 0, VK_WHOLE_SIZE};
+  writes[DRAW_BINDING].buffer = {mesh.GetDrawBuffer(), 0, VK_WHOLE_SIZE};
+  writes[DRAW_COUNT_BINDING].buffer = {mesh.GetDrawCountBuffer(), 0,
+                                       VK_WHOLE_SIZE};
+  m_layout.Write(set, writes);
+  return set;
+}
+
+void MeshletCuller::Cull(VkCommandBuffer commandBuffer, VkDescriptorSet set,
+                         const MeshletMesh &mesh,
+                         const glm::mat4 &viewProjection,
+                         const glm::mat4 &model,
+                         const glm::vec3 &cameraPosition) const {
+  MeshletCullParams params;
+  extractFrustumPlanes(viewProjection * model, params.frustumPlanes);
+  params.cameraPosition =
+      glm::vec3(glm::inverse(model) * glm::vec4(cameraPosition, 1.0f));
+  params.meshletCount = mesh.GetMeshletCount();
+  params.compact = m_context.features12.drawIndirectCount ? 1 : 0;
+
+  // 1. 清零计数；上一次的间接绘制读完之后才能覆盖计数与命令缓冲
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                       nullptr, 0, nullptr);
+  vkCmdFillBuffer(commandBuffer, mesh.GetDrawCountBuffer(), 0,
+                  sizeof(uint32_t), 0);
+  VkMemoryBarrier clearBarrier = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+  };
+  vkCmdPipelineBarrier(commandBuffer,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT |
+                           VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
+                       &clearBarrier, 0, nullptr, 0, nullptr);
+
+  // 2. 每个线程一个簇
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                          m_pipelineLayout, 0, 1, &set, 0, nullptr);
+  vkCmdPushConstants(commandBuffer, m_pipelineLayout,
+                     VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+  vkCmdDispatch(commandBuffer,
+                (params.meshletCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1,
+                1);
+
+  // 3. 绘制命令与计数对间接绘制可见
+  VkMemoryBarrier drawBarrier = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+  };
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &drawBarrier,
+                       0, nullptr, 0, nullptr);
+}
@@ -0,0 +1,117 @@
+#include "Mesh/MeshletMesh.hpp"
+
+#include "Vulkan/VkUtils.hpp"
+#include "utils/log.hpp"
+
+#include <stdexcept>
+
+MeshletMesh::MeshletMesh(const VkContext &context, VkCommandPool commandPool,
+                         const MeshData &mesh, const MeshletData &meshlets)
+    : m_context(context),
+      m_meshletCount(static_cast<uint32_t>(meshlets.meshlets.size())),
+      m_indexType(selectIndexType(mesh.vertices.size())) {
+  if (m_meshletCount == 0) {
+    LOG_ERROR("mesh has no meshlets!");
+    throw std::runtime_error("mesh has no meshlets!");
+  }
+
+  std::vector<GpuMeshlet> gpuMeshlets(m_meshletCount);
+  for (uint32_t i = 0; i < m_meshletCount; i++) {
+    const Meshlet &meshlet = meshlets.meshlets[i];
+    const MeshletBounds &bounds = meshlets.bounds[i];
+    gpuMeshlets[i] = {
+        .sphere = glm::vec4(bounds.center, bounds.radius),
+        .cone = glm::vec4(bounds.coneAxis, bounds.coneCutoff),
+        .firstIndex = meshlet.triangleOffset,
+        .indexCount = meshlet.triangleCount * 3,
+        .vertexOffset = meshlet.vertexOffset,
+        .vertexCount = meshlet.vertexCount,
+    };
+  }
+
+  std::vector<uint32_t> indices = meshletIndices(meshlets);
+  uploadDeviceLocalBuffer(m_context, commandPool, mesh.vertices.data(),
+                          mesh.vertices.size() * sizeof(Vertex),
+                          VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                              VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                          m_vertexBuffer, m_vertexMemory);
+  if (m_indexType == VK_INDEX_TYPE_UINT16) {
+    std::vector<uint16_t> narrowed(indices.begin(), indices.end());
+    uploadDeviceLocalBuffer(m_context, commandPool, narrowed.data(),
+                            narrowed.size() * sizeof(uint16_t),
+                            VK_BUFFER_USAGE_INDEX_BUFFER_BIT, m_indexBuffer,
+                            m_indexMemory);
+  } else {
+    uploadDeviceLocalBuffer(m_context, commandPool, indices.data(),
+                            indices.size() * sizeof(uint32_t),
+                            VK_BUFFER_USAGE_INDEX_BUFFER_BIT, m_indexBuffer,
+                            m_indexMemory);
+  }
+  uploadDeviceLocalBuffer(m_context, commandPool, gpuMeshlets.data(),
+                          gpuMeshlets.size() * sizeof(GpuMeshlet),
+                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, m_meshletBuffer,
+                          m_meshletMemory);
+
+  // 三角形字节流补齐到 4 字节，着色器按 uint 读取再拆字节
+  std::vector<uint8_t> triangles = meshlets.triangles;
+  triangles.resize((triangles.size() + 3) & ~size_t(3), 0);
+  uploadDeviceLocalBuffer(m_context, commandPool, meshlets.vertices.data(),
+                          meshlets.vertices.size() * sizeof(uint32_t),
+                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                          m_meshletVertexBuffer, m_meshletVertexMemory);
+  uploadDeviceLocalBuffer(m_context, commandPool, triangles.data(),
+                          triangles.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                          m_meshletTriangleBuffer, m_meshletTriangleMemory);
+
+  createBuffer(m_context,
+               VkDeviceSize(m_meshletCount) *
+                   sizeof(VkDrawIndexedIndirectCommand),
+               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                   VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_drawBuffer, m_drawMemory);
+  createBuffer(m_context, sizeof(uint32_t),
+               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                   VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                   VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_drawCountBuffer,
+               m_drawCountMemory);
+}
+
+MeshletMesh::~MeshletMesh() {
+  vkDestroyBuffer(m_context.device, m_drawCountBuffer, nullptr);
+  vkFreeMemory(m_context.device, m_drawCountMemory, nullptr);
+  vkDestroyBuffer(m_context.device, m_drawBuffer, nullptr);
+  vkFreeMemory(m_context.device, m_drawMemory, nullptr);
+  vkDestroyBuffer(m_context.device, m_meshletTriangleBuffer, nullptr);
+  vkFreeMemory(m_context.device, m_meshletTriangleMemory, nullptr);
+  vkDestroyBuffer(m_context.device, m_meshletVertexBuffer, nullptr);
+  vkFreeMemory(m_context.device, m_meshletVertexMemory, nullptr);
+  vkDestroyBuffer(m_context.device, m_meshletBuffer, nullptr);
+  vkFreeMemory(m_context.device, m_meshletMemory, nullptr);
+  vkDestroyBuffer(m_context.device, m_indexBuffer, nullptr);
+  vkFreeMemory(m_context.device, m_indexMemory, nullptr);
+  vkDestroyBuffer(m_context.device, m_vertexBuffer, nullptr);
+  vkFreeMemory(m_context.device, m_vertexMemory, nullptr);
+}
+
+void MeshletMesh::DrawIndirect(VkCommandBuffer commandBuffer) const {
+  VkDeviceSize offset = 0;
+  vkCmdBindVertexBuffers(commandBuffer, 0, 1, &m_vertexBuffer, &offset);
+  vkCmdBindIndexBuffer(commandBuffer, m_indexBuffer, 0, m_indexType);
+
+  constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+  if (m_context.features12.drawIndirectCount) {
+    vkCmdDrawIndexedIndirectCount(commandBuffer, m_drawBuffer, 0,
+                                  m_drawCountBuffer, 0, m_meshletCount,
+                                  stride);
+  } else if (m_context.features.multiDrawIndirect) {
+    vkCmdDrawIndexedIndirect(commandBuffer, m_drawBuffer, 0, m_meshletCount,
+                             stride);
+  } else {
+    // 不支持多重间接绘制时 drawCount 只能为 0 或 1
+    for (uint32_t i = 0; i < m_meshletCount; i++) {
+      vkCmdDrawIndexedIndirect(commandBuffer, m_drawBuffer,
+                               VkDeviceSize(i) * stride, 1, stride);
+    }
+  }
+}
@@ -0,0 +1,284 @@
+#include "Mesh/MeshletRenderer.hpp"
+
+#include "Vulkan/VkUtils.hpp"
+#include "utils/fileUtils.hpp"
+#include "utils/log.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr uint32_t TASK_GROUP_SIZE = 32; // 与 meshlet.task 一致
+
+constexpr uint32_t MESHLET_BINDING = 0;
+constexpr uint32_t VERTEX_BINDING = 1;
+constexpr uint32_t MESHLET_VERTEX_BINDING = 2;
+constexpr uint32_t MESHLET_TRIANGLE_BINDING = 3;
+
+template <typename T>
+T loadDeviceFunction(VkDevice device, const char *name) {
+  auto function = reinterpret_cast<T>(vkGetDeviceProcAddr(device, name));
+  if (!function) {
+    LOG_ERROR("failed to load device function {}", name);
+    throw std::runtime_error(std::string("failed to load ") + name);
+  }
+  return function;
+}
+
+struct ShaderStage {
+  VkShaderStageFlagBits stage;
+  const char *path;
+};
+
+// 两条路径共用的固定功能状态；vertexInput 为空表示网格着色器管线
+VkPipeline
+createGraphicsPipeline(const VkContext &context, VkPipelineLayout layout,
+                       VkRenderPass renderPass, uint32_t subpass,
+                       const std::vector<ShaderStage> &stages,
+                       const VkPipelineVertexInputStateCreateInfo *vertexInput) {
+  std::vector<VkShaderModule> modules;
+  std::vector<VkPipelineShaderStageCreateInfo> stageInfos;
+  for (const ShaderStage &stage : stages) {
+    modules.push_back(createShaderModule(context, readFile(stage.path)));
+    stageInfos.push_back({
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+        .stage = stage.stage,
+        .module = modules.back(),
+        .pName = "main",
+    });
+  }
+
+  VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT,
+                                    VK_DYNAMIC_STATE_SCISSOR};
+  VkPipelineDynamicStateCreateInfo dynamicState = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+      .dynamicStateCount = 2,
+      .pDynamicStates = dynamicStates,
+  };
+  VkPipelineInputAssemblyStateCreateInfo inputAssembly = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+      .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+      .primitiveRestartEnable = VK_FALSE,
+  };
+  VkPipelineViewportStateCreateInfo viewportState = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+      .viewportCount = 1,
+      .scissorCount = 1,
+  };
+  VkPipelineRasterizationStateCreateInfo rasterizer = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+      .polygonMode = VK_POLYGON_MODE_FILL,
+      .cullMode = VK_CULL_MODE_BACK_BIT,
+      .frontFace = VK_FRONT_FACE_CLOCKWISE,
+      .lineWidth = 1.0f,
+  };
+  VkPipelineMultisampleStateCreateInfo multisampling = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+      .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
+      .minSampleShading = 1.0f,
+  };
+  VkPipelineDepthStencilStateCreateInfo depthStencil = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+      .depthTestEnable = VK_TRUE,
+      .depthWriteEnable = VK_TRUE,
+      .depthCompareOp = VK_COMPARE_OP_LESS,
+      .maxDepthBounds = 1.0f,
+  };
+  VkPipelineColorBlendAttachmentState colorBlendAttachment = {
+      .blendEnable = VK_FALSE,
+      .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                        VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT,
+  };
+  VkPipelineColorBlendStateCreateInfo colorBlending = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+      .attachmentCount = 1,
+      .pAttachments = &colorBlendAttachment,
+  };
+
+  VkGraphicsPipelineCreateInfo pipelineInfo = {
+      .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+      .stageCount = static_cast<uint32_t>(stageInfos.size()),
+      .pStages = stageInfos.data(),
+      .pVertexInputState = vertexInput,
+      .pInputAssemblyState = vertexInput ? &inputAssembly : nullptr,
+      .pViewportState = &viewportState,
+      .pRasterizationState = &rasterizer,
+      .pMultisampleState = &multisampling,
+      .pDepthStencilState = &depthStencil,
+      .pColorBlendState = &colorBlending,
+      .pDynamicState = &dynamicState,
+      .layout = layout,
+      .renderPass = renderPass,
+      .subpass = subpass,
+      .basePipelineIndex = -1,
+  };
+
+  VkPipeline pipeline;
+  VkResult result = vkCreateGraphicsPipelines(
+      context.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+  for (VkShaderModule module : modules) {
+    vkDestroyShaderModule(context.device, module, nullptr);
+  }
+  if (result != VK_SUCCESS) {
+    LOG_ERROR("failed to create meshlet pipeline!");
+    throw std::runtime_error("failed to create meshlet pipeline!");
+  }
+  return pipeline;
+}
+
+MeshletDrawParams makeDrawParams(const MeshletMesh &mesh,
+                                 const glm::mat4 &viewProjection,
+                                 const glm::mat4 &model,
+                                 const glm::vec3 &cameraPosition) {
+  return {
+      .clipFromObject = viewProjection * model,
+      .cameraPosition =
+          glm::vec3(glm::inverse(model) * glm::vec4(cameraPosition, 1.0f)),
+      .meshletCount = mesh.GetMeshletCount(),
+  };
+}
+} // namespace
+
+bool MeshletRenderer::IsMeshShaderSupported(const VkContext &context) {
+  // selectDeviceFeatures 只在任务与网格阶段都支持时保留该扩展
+  return context.HasExtension(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+}
+
+MeshletRenderer::MeshletRenderer(const VkContext &context,
+                                 VkRenderPass renderPass, uint32_t subpass)
+    : m_context(context), m_useMeshShaders(IsMeshShaderSupported(context)) {
+  if (m_useMeshShaders) {
+    createMeshShaderPipeline(renderPass, subpass);
+  } else {
+    createVertexPipeline(renderPass, subpass);
+  }
+  LOG_INFO("meshlet renderer: {}", m_useMeshShaders
+                                       ? "task/mesh shaders"
+                                       : "compute culling + indirect draw");
+}
+
+MeshletRenderer::~MeshletRenderer() {
+  vkDestroyPipeline(m_context.device, m_pipeline, nullptr);
+  vkDestroyPipelineLayout(m_context.device, m_pipelineLayout, nullptr);
+}
+
+void MeshletRenderer::createPipelineLayout(VkDescriptorSetLayout setLayout,
+                                           VkShaderStageFlags pushStages) {
+  m_pushStages = pushStages;
+  VkPushConstantRange pushConstantRange = {
+      .stageFlags = pushStages,
+      .offset = 0,
+      .size = sizeof(MeshletDrawParams),
+  };
+  VkPipelineLayoutCreateInfo layoutInfo = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+      .setLayoutCount = setLayout != VK_NULL_HANDLE ? 1u : 0u,
+      .pSetLayouts = &setLayout,
+      .pushConstantRangeCount = 1,
+      .pPushConstantRanges = &pushConstantRange,
+  };
+  if (vkCreatePipelineLayout(m_context.device, &layoutInfo, nullptr,
+                             &m_pipelineLayout) != VK_SUCCESS) {
+    LOG_ERROR("failed to create meshlet pipeline layout!");
+    throw std::runtime_error("failed to create meshlet pipeline layout!");
+  }
+}
+
+void MeshletRenderer::createMeshShaderPipeline(VkRenderPass renderPass,
+                                               uint32_t subpass) {
+  m_vkCmdDrawMeshTasksEXT = loadDeviceFunction<PFN_vkCmdDrawMeshTasksEXT>(
+      m_context.device, "vkCmdDrawMeshTasksEXT");
+
+  VkShaderStageFlags stages =
+      VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT;
+  m_layout = std::make_unique<DescriptorLayout>(
+      m_context,
+      std::vector<DescriptorBinding>{
+          {MESHLET_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, stages},
+          {VERTEX_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+           VK_SHADER_STAGE_MESH_BIT_EXT},
+          {MESHLET_VERTEX_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+           VK_SHADER_STAGE_MESH_BIT_EXT},
+          {MESHLET_TRIANGLE_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+           VK_SHADER_STAGE_MESH_BIT_EXT},
+      });
+  m_descriptorAllocator = std::make_unique<DescriptorAllocator>(m_context);
+  createPipelineLayout(m_layout->Get(), stages);
+
+  m_pipeline = createGraphicsPipeline(
+      m_context, m_pipelineLayout, renderPass, subpass,
+      {
+          {VK_SHADER_STAGE_TASK_BIT_EXT, SHADER_PATH "meshlet/meshlet.task.spv"},
+          {VK_SHADER_STAGE_MESH_BIT_EXT, SHADER_PATH "meshlet/meshlet.mesh.spv"},
+          {VK_SHADER_STAGE_FRAGMENT_BIT, SHADER_PATH "00/triangle.frag.spv"},
+      },
+      nullptr);
+}
+
+void MeshletRenderer::createVertexPipeline(VkRenderPass renderPass,
+                                           uint32_t subpass) {
+  m_culler = std::make_unique<MeshletCuller>(m_context);
+  createPipelineLayout(VK_NULL_HANDLE, VK_SHADER_STAGE_VERTEX_BIT);
+
+  VkPipelineVertexInputStateCreateInfo vertexInput =
+      VertexInputState<VertexLayoutOf<Vertex>>::CreateInfo();
+  m_pipeline = createGraphicsPipeline(
+      m_context, m_pipelineLayout, renderPass, subpass,
+      {
+          {VK_SHADER_STAGE_VERTEX_BIT, SHADER_PATH "meshlet/meshlet.vert.spv"},
+          {VK_SHADER_STAGE_FRAGMENT_BIT, SHADER_PATH "00/triangle.frag.spv"},
+      },
+      &vertexInput);
+}
+
+VkDescriptorSet MeshletRenderer::AllocateSet(const MeshletMesh &mesh) {
+  if (!m_useMeshShaders) {
+    return m_culler->AllocateSet(mesh);
+  }
+
+  VkDescriptorSet set = m_descriptorAllocator->Allocate(*m_layout);
+  DescriptorWrite writes[4];
+  writes[MESHLET_BINDING].buffer = {mesh.GetMeshletBuffer(), 0, VK_WHOLE_SIZE};
+  writes[VERTEX_BINDING].buffer = {mesh.GetVertexBuffer(), 0, VK_WHOLE_SIZE};
+  writes[MESHLET_VERTEX_BINDING].buffer = {mesh.GetMeshletVertexBuffer(), 0,
+                                           VK_WHOLE_SIZE};
+  writes[MESHLET_TRIANGLE_BINDING].buffer = {mesh.GetMeshletTriangleBuffer(),
+                                             0, VK_WHOLE_SIZE};
+  m_layout->Write(set, writes);
+  return set;
+}
+
+void MeshletRenderer::Cull(VkCommandBuffer commandBuffer, VkDescriptorSet set,
+                           const MeshletMesh &mesh,
+                           const glm::mat4 &viewProjection,
+                           const glm::mat4 &model,
+                           const glm::vec3 &cameraPosition) const {
+  if (!m_useMeshShaders) {
+    m_culler->Cull(commandBuffer, set, mesh, viewProjection, model,
+                   cameraPosition);
+  }
+}
+
+void MeshletRenderer::Draw(VkCommandBuffer commandBuffer, VkDescriptorSet set,
+                           const MeshletMesh &mesh,
+                           const glm::mat4 &viewProjection,
+                           const glm::mat4 &model,
+                           const glm::vec3 &cameraPosition) const {
+  MeshletDrawParams params =
+      makeDrawParams(mesh, viewProjection, model, cameraPosition);
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    m_pipeline);
+  vkCmdPushConstants(commandBuffer, m_pipelineLayout, m_pushStages, 0,
+                     sizeof(params), &params);
+
+  if (m_useMeshShaders) {
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            m_pipelineLayout, 0, 1, &set, 0, nullptr);
+    uint32_t groupCount =
+        (params.meshletCount + TASK_GROUP_SIZE - 1) / TASK_GROUP_SIZE;
+    m_vkCmdDrawMeshTasksEXT(commandBuffer, groupCount, 1, 1);
+  } else {
+    mesh.DrawIndirect(commandBuffer);
+  }
+}
@@ -0,0 +1,343 @@
+#include "Mesh/ObjLoader.hpp"
+
+#include "utils/FlatHashMap.hpp"
+#include "utils/MappedFile.hpp"
+#include "utils/ThreadPool.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+// 每块至少 1 MiB，块太小时合并开销会超过并行收益
+constexpr size_t MIN_CHUNK_SIZE = 1 << 20;
+constexpr int32_t MISSING_INDEX = INT32_MIN;
+
+// 面的一个角。OBJ 的正数索引是全局的（从 1 开始），负数索引相对于当前已出现的数量，
+// 而块内并不知道前面各块有多少顶点，所以相对索引先记为块内下标，合并时再加上块的起点
+struct ObjCorner {
+  int32_t position;
+  int32_t uv;
+  int32_t normal;
+  uint8_t relative; // 第 0/1/2 位表示对应分量是块内下标
+};
+
+struct ObjChunk {
+  std::vector<glm::vec3> positions;
+  std::vector<glm::vec2> uvs;
+  std::vector<glm::vec3> normals;
+  std::vector<ObjCorner> corners; // 三角化后每 3 个一组
+  size_t line = 0;                // 出错时报告用的块内行号
+  bool failed = false;
+};
+
+struct CornerKey {
+  uint32_t position;
+  uint32_t uv;
+  uint32_t normal;
+
+  bool operator==(const CornerKey &other) const {
+    return position == other.position && uv == other.uv &&
+           normal == other.normal;
+  }
+};
+
+struct CornerKeyHash {
+  size_t operator()(const CornerKey &key) const {
+    uint64_t hash = key.position;
+    hash = hash * 0x100000001B3ull ^ key.uv;
+    hash = hash * 0x100000001B3ull ^ key.normal;
+    return static_cast<size_t>(hash);
+  }
+};
+
+bool isSpace(char c) { return c == ' ' || c == '\t'; }
+
+const char *skipSpaces(const char *p, const char *end) {
+  while (p < end && isSpace(*p)) {
+    p++;
+  }
+  return p;
+}
+
+const char *skipLine(const char *p, const char *end) {
+  while (p < end && *p != '\n') {
+    p++;
+  }
+  return p < end ? p + 1 : end;
+}
+
+bool parseFloat(const char *&p, const char *end, float &value) {
+  p = skipSpaces(p, end);
+  if (p < end && *p == '+') {
+    p++;
+  }
+  auto [next, error] = std::from_chars(p, end, value);
+  if (error != std::errc()) {
+    return false;
+  }
+  p = next;
+  return true;
+}
+
+bool parseInt(const char *&p, const char *end, int32_t &value) {
+  auto [next, error] = std::from_chars(p, end, value);
+  if (error != std::errc()) {
+    return false;
+  }
+  p = next;
+  return true;
+}
+
+// 把一个 OBJ 索引转换为全局下标（正数）或块内下标（负数，relative 置位）
+void encodeIndex(int32_t index, size_t localCount, int32_t &out,
+                 uint8_t &relative, uint8_t bit) {
+  if (index > 0) {
+    out = index - 1;
+  } else {
+    out = static_cast<int32_t>(localCount) + index;
+    relative |= bit;
+  }
+}
+
+// 解析 "v", "v/vt", "v//vn", "v/vt/vn"
+bool parseCorner(const char *&p, const char *end, const ObjChunk &chunk,
+                 ObjCorner &corner) {
+  corner = {MISSING_INDEX, MISSING_INDEX, MISSING_INDEX, 0};
+
+  int32_t index;
+  if (!parseInt(p, end, index) || index == 0) {
+    return false;
+  }
+  encodeIndex(index, chunk.positions.size(), corner.position, corner.relative,
+              1);
+
+  if (p < end && *p == '/') {
+    p++;
+    if (p < end && *p != '/') {
+      if (!parseInt(p, end, index) || index == 0) {
+        return false;
+      }
+      encodeIndex(index, chunk.uvs.size(), corner.uv, corner.relative, 2);
+    }
+    if (p < end && *p == '/') {
+      p++;
+      if (!parseInt(p, end, index) || index == 0) {
+        return false;
+      }
+      encodeIndex(index, chunk.normals.size(), corner.normal, corner.relative,
+                  4);
+    }
+  }
+  return true;
+}
+
+void parseChunk(const char *begin, const char *end, ObjChunk &chunk) {
+  // 粗略预估：每行约 30 字节
+  size_t estimatedLines = static_cast<size_t>(end - begin) / 30;
+  chunk.positions.reserve(estimatedLines / 2);
+  chunk.corners.reserve(estimatedLines * 3 / 2);
+
+  ObjCorner polygon[64];
+  for (const char *p = begin; p < end; p = skipLine(p, end)) {
+    chunk.line++;
+    p = skipSpaces(p, end);
+    if (end - p < 2) {
+      continue;
+    }
+
+    if (p[0] == 'v' && isSpace(p[1])) {
+      p += 2;
+      glm::vec3 position;
+      if (!parseFloat(p, end, position.x) || !parseFloat(p, end, position.y) ||
+          !parseFloat(p, end, position.z)) {
+        chunk.failed = true;
+        return;
+      }
+      chunk.positions.push_back(position);
+    } else if (p[0] == 'v' && p[1] == 't') {
+      p += 2;
+      glm::vec2 uv;
+      if (!parseFloat(p, end, uv.x) || !parseFloat(p, end, uv.y)) {
+        chunk.failed = true;
+        return;
+      }
+      chunk.uvs.push_back(uv);
+    } else if (p[0] == 'v' && p[1] == 'n') {
+      p += 2;
+      glm::vec3 normal;
+      if (!parseFloat(p, end, normal.x) || !parseFloat(p, end, normal.y) ||
+          !parseFloat(p, end, normal.z)) {
+        chunk.failed = true;
+        return;
+      }
+      chunk.normals.push_back(normal);
+    } else if (p[0] == 'f' && isSpace(p[1])) {
+      p += 2;
+      uint32_t count = 0;
+      while (true) {
+        p = skipSpaces(p, end);
+        if (p >= end || *p == '\n' || *p == '\r' || *p == '#') {
+          break;
+        }
+        if (count == std::size(polygon) ||
+            !parseCorner(p, end, chunk, polygon[count])) {
+          chunk.failed = true;
+          return;
+        }
+        count++;
+      }
+      if (count < 3) {
+        chunk.failed = true;
+        return;
+      }
+      // 扇形三角化
+      for (uint32_t i = 1; i + 1 < count; i++) {
+        chunk.corners.push_back(polygon[0]);
+        chunk.corners.push_back(polygon[i]);
+        chunk.corners.push_back(polygon[i + 1]);
+      }
+    }
+  }
+}
+
+// 把块内编码的索引解析为全局下标，越界时返回 false
+bool resolveIndex(int32_t encoded, bool relative, size_t base, size_t total,
+                  uint32_t &out) {
+  if (encoded == MISSING_INDEX) {
+    out = UINT32_MAX;
+    return true;
+  }
+  int64_t index = relative ? int64_t(base) + encoded : int64_t(encoded);
+  if (index < 0 || index >= int64_t(total)) {
+    return false;
+  }
+  out = static_cast<uint32_t>(index);
+  return true;
+}
+} // namespace
+
+MeshData loadObj(const std::string &filename) {
+  auto startTime = std::chrono::steady_clock::now();
+
+  MappedFile file(filename);
+  const char *data = reinterpret_cast<const char *>(file.GetData());
+  const char *dataEnd = data + file.GetSize();
+
+  // 1. 按换行对齐切块
+  ThreadPool &pool = ThreadPool::Get();
+  size_t chunkCount = std::max<size_t>(
+      1, std::min<size_t>(file.GetSize() / MIN_CHUNK_SIZE,
+                          size_t(pool.GetThreadCount()) * 4));
+  std::vector<const char *> boundaries(chunkCount + 1, dataEnd);
+  boundaries[0] = data;
+  for (size_t i = 1; i < chunkCount; i++) {
+    const char *p = data + file.GetSize() * i / chunkCount;
+    boundaries[i] = std::max(skipLine(p, dataEnd), boundaries[i - 1]);
+  }
+
+  // 2. 并行解析
+  std::vector<ObjChunk> chunks(chunkCount);
+  pool.ParallelFor(chunkCount, 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      parseChunk(boundaries[i], boundaries[i + 1], chunks[i]);
+    }
+  });
+
+  // 3. 前缀和得到每块的全局起点
+  struct ChunkBase {
+    size_t position, uv, normal, corner;
+  };
+  std::vector<ChunkBase> bases(chunkCount + 1, ChunkBase{0, 0, 0, 0});
+  size_t line = 0;
+  for (size_t i = 0; i < chunkCount; i++) {
+    const ObjChunk &chunk = chunks[i];
+    if (chunk.failed) {
+      LOG_ERROR("failed to parse OBJ {} near line {}", filename,
+                line + chunk.line);
+      throw std::runtime_error("failed to parse OBJ: " + filename);
+    }
+    line += chunk.line;
+    bases[i + 1] = {
+        bases[i].position + chunk.positions.size(),
+        bases[i].uv + chunk.uvs.size(),
+        bases[i].normal + chunk.normals.size(),
+        bases[i].corner + chunk.corners.size(),
+    };
+  }
+  const ChunkBase &totals = bases[chunkCount];
+  if (totals.corner == 0) {
+    LOG_ERROR("OBJ {} contains no faces", filename);
+    throw std::runtime_error("OBJ contains no faces: " + filename);
+  }
+
+  // 4. 合并属性数组并解析索引（按块并行）
+  std::vector<glm::vec3> positions(totals.position);
+  std::vector<glm::vec2> uvs(totals.uv);
+  std::vector<glm::vec3> normals(totals.normal);
+  std::vector<CornerKey> keys(totals.corner);
+  std::vector<uint8_t> invalid(chunkCount, 0);
+  pool.ParallelFor(chunkCount, 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      const ObjChunk &chunk = chunks[i];
+      const ChunkBase &base = bases[i];
+      std::copy(chunk.positions.begin(), chunk.positions.end(),
+                positions.begin() + base.position);
+      std::copy(chunk.uvs.begin(), chunk.uvs.end(), uvs.begin() + base.uv);
+      std::copy(chunk.normals.begin(), chunk.normals.end(),
+                normals.begin() + base.normal);
+
+      for (size_t c = 0; c < chunk.corners.size(); c++) {
+        const ObjCorner &corner = chunk.corners[c];
+        CornerKey &key = keys[base.corner + c];
+        if (!resolveIndex(corner.position, corner.relative & 1, base.position,
+                          totals.position, key.position) ||
+            !resolveIndex(corner.uv, corner.relative & 2, base.uv, totals.uv,
+                          key.uv) ||
+            !resolveIndex(corner.normal, corner.relative & 4, base.normal,
+                          totals.normal, key.normal) ||
+            key.position == UINT32_MAX) {
+          invalid[i] = 1;
+          break;
+        }
+      }
+    }
+  });
+  if (std::find(invalid.begin(), invalid.end(), 1) != invalid.end()) {
+    LOG_ERROR("OBJ {} has out-of-range face indices", filename);
+    throw std::runtime_error("OBJ has out-of-range face indices: " + filename);
+  }
+  chunks.clear();
+
+  // 5. 以索引三元组去重
+  MeshData mesh;
+  mesh.indices.resize(keys.size());
+  mesh.vertices.reserve(totals.position);
+  FlatHashMap<CornerKey, uint32_t, CornerKeyHash> uniqueVertices(
+      totals.position);
+  for (size_t i = 0; i < keys.size(); i++) {
+    const CornerKey &key = keys[i];
+    auto [index, inserted] = uniqueVertices.TryEmplace(
+        key, static_cast<uint32_t>(mesh.vertices.size()));
+    if (inserted) {
+      mesh.vertices.push_back({
+          .position = positions[key.position],
+          .normal = key.normal != UINT32_MAX ? normals[key.normal]
+                                             : glm::vec3(0.0f),
+          .uv = key.uv != UINT32_MAX ? uvs[key.uv] : glm::vec2(0.0f),
+      });
+    }
+    mesh.indices[i] = *index;
+  }
+
+  double elapsedMs = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - startTime)
+                         .count();
+  LOG_INFO("loaded {} in {:.1f} ms ({} chunks): {} vertices, {} triangles",
+           filename, elapsedMs, chunkCount, mesh.vertices.size(),
+           mesh.indices.size() / 3);
+  return mesh;
+}
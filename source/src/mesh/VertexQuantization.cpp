@@ -0,0 +1,84 @@
+#include "Mesh/VertexQuantization.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+uint16_t quantizeUnorm16(float value) {
+  return static_cast<uint16_t>(
+      std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+int16_t quantizeSnorm16(float value) {
+  return static_cast<int16_t>(
+      std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+float signNotZero(float value) { return value >= 0.0f ? 1.0f : -1.0f; }
+} // namespace
+
+VertexDequantization VertexDequantization::FromBounds(const glm::vec3 &min,
+                                                      const glm::vec3 &max) {
+  VertexDequantization dequantization;
+  dequantization.offset = min;
+  for (int axis = 0; axis < 3; axis++) {
+    float extent = max[axis] - min[axis];
+    dequantization.scale[axis] = extent > 0.0f ? extent : 1.0f;
+  }
+  return dequantization;
+}
+
+glm::mat4 VertexDequantization::Matrix() const {
+  glm::mat4 matrix(1.0f);
+  matrix[0][0] = scale.x;
+  matrix[1][1] = scale.y;
+  matrix[2][2] = scale.z;
+  matrix[3] = glm::vec4(offset, 1.0f);
+  return matrix;
+}
+
+// 投影到八面体 |x| + |y| + |z| = 1 上，下半球沿对角线翻折到外侧的三角形
+Snorm16x2 encodeOctahedral(const glm::vec3 &normal) {
+  float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+  if (length == 0.0f) {
+    return {0, 0};
+  }
+  glm::vec2 p = glm::vec2(normal.x, normal.y) / length;
+  if (normal.z < 0.0f) {
+    p = glm::vec2((1.0f - std::abs(p.y)) * signNotZero(p.x),
+                  (1.0f - std::abs(p.x)) * signNotZero(p.y));
+  }
+  return {quantizeSnorm16(p.x), quantizeSnorm16(p.y)};
+}
+
+glm::vec3 decodeOctahedral(Snorm16x2 encoded) {
+  glm::vec2 p(std::max(encoded.x / 32767.0f, -1.0f),
+              std::max(encoded.y / 32767.0f, -1.0f));
+  glm::vec3 n(p.x, p.y, 1.0f - std::abs(p.x) - std::abs(p.y));
+  float t = std::max(-n.z, 0.0f);
+  n.x += n.x >= 0.0f ? -t : t;
+  n.y += n.y >= 0.0f ? -t : t;
+  return glm::normalize(n);
+}
+
+QuantizedVertex quantizeVertex(const Vertex &vertex,
+                               const VertexDequantization &dequantization) {
+  glm::vec3 local =
+      (vertex.position - dequantization.offset) / dequantization.scale;
+  return {
+      .position = {quantizeUnorm16(local.x), quantizeUnorm16(local.y),
+                   quantizeUnorm16(local.z), 0},
+      .normal = encodeOctahedral(vertex.normal),
+      .uv = {glm::packHalf1x16(vertex.uv.x), glm::packHalf1x16(vertex.uv.y)},
+  };
+}
+
+void quantizeVertices(const Vertex *src, size_t count,
+                      const VertexDequantization &dequantization,
+                      QuantizedVertex *dst) {
+  for (size_t i = 0; i < count; i++) {
+    dst[i] = quantizeVertex(src[i], dequantization);
+  }
+}
@@ -0,0 +1,237 @@
+#include "Scene/DepthPyramid.hpp"
+
+#include "Vulkan/VkUtils.hpp"
+#include "utils/fileUtils.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace {
+constexpr uint32_t DEPTH_BINDING = 0;
+constexpr uint32_t LEVEL_BINDING = 1;
+constexpr uint32_t COUNTER_BINDING = 2;
+
+// 推送常量，对应 depth_pyramid.comp 中的 PyramidPush
+struct DepthPyramidParams {
+  uint32_t depthWidth;
+  uint32_t depthHeight;
+  uint32_t width;
+  uint32_t height;
+  uint32_t levelCount;
+  uint32_t groupCount; // 工作组总数，最后一个完成的工作组负责剩余的级
+};
+
+// 不超过 value 的最大 2 的幂
+uint32_t previousPowerOfTwo(uint32_t value) {
+  return std::bit_floor(std::max(value, 1u));
+}
+} // namespace
+
+DepthPyramid::DepthPyramid(const VkContext &context, VkImageView depthView,
+                           uint32_t depthWidth, uint32_t depthHeight)
+    : m_context(context), m_depthWidth(depthWidth), m_depthHeight(depthHeight),
+      m_width(previousPowerOfTwo(depthWidth)),
+      m_height(previousPowerOfTwo(depthHeight)),
+      m_levelCount(std::bit_width(std::max(m_width, m_height))),
+      m_layout(context,
+               {
+                   {DEPTH_BINDING, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1,
+                    VK_SHADER_STAGE_COMPUTE_BIT},
+                   {LEVEL_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, MAX_LEVELS,
+                    VK_SHADER_STAGE_COMPUTE_BIT},
+                   {COUNTER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+                    VK_SHADER_STAGE_COMPUTE_BIT},
+               }),
+      m_descriptorAllocator(context, {.initialSetsPerPool = 1}) {
+  if (m_levelCount > MAX_LEVELS) {
+    LOG_ERROR("depth pyramid {}x{} exceeds {} levels", m_width, m_height,
+              MAX_LEVELS);
+    throw std::runtime_error("depth pyramid too large!");
+  }
+
+  // 1. 金字塔图像、整体视图与逐级视图（存储图像只能绑定单个 mip）
+  createImage(m_context, m_width, m_height, m_levelCount, 1,
+              VK_FORMAT_R32_SFLOAT,
+              VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, m_image,
+              m_memory);
+  m_view = createImageView(m_context, m_image, VK_FORMAT_R32_SFLOAT,
+                           VK_IMAGE_VIEW_TYPE_2D, m_levelCount, 1);
+  m_levelViews.resize(m_levelCount);
+  for (uint32_t level = 0; level < m_levelCount; level++) {
+    VkImageViewCreateInfo viewInfo = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image = m_image,
+        .viewType = VK_IMAGE_VIEW_TYPE_2D,
+        .format = VK_FORMAT_R32_SFLOAT,
+        .subresourceRange =
+            {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = level,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+    };
+    if (vkCreateImageView(m_context.device, &viewInfo, nullptr,
+                          &m_levelViews[level]) != VK_SUCCESS) {
+      LOG_ERROR("failed to create depth pyramid level view!");
+      throw std::runtime_error("failed to create depth pyramid level view!");
+    }
+  }
+
+  VkSamplerCreateInfo samplerInfo = {
+      .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+      .magFilter = VK_FILTER_NEAREST,
+      .minFilter = VK_FILTER_NEAREST,
+      .mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+      .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .maxLod = VK_LOD_CLAMP_NONE,
+  };
+  if (vkCreateSampler(m_context.device, &samplerInfo, nullptr, &m_sampler) !=
+      VK_SUCCESS) {
+    LOG_ERROR("failed to create depth pyramid sampler!");
+    throw std::runtime_error("failed to create depth pyramid sampler!");
+  }
+
+  createBuffer(m_context, sizeof(uint32_t),
+               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                   VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_counterBuffer,
+               m_counterMemory);
+
+  // 2. 描述符：未使用的级指向最后一级，保证数组中每一项都有效
+  m_set = m_descriptorAllocator.Allocate(m_layout);
+  DescriptorWrite writes[2 + MAX_LEVELS];
+  writes[0].image = {m_sampler, depthView,
+                     VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL};
+  for (uint32_t level = 0; level < MAX_LEVELS; level++) {
+    writes[1 + level].image = {
+        VK_NULL_HANDLE, m_levelViews[std::min(level, m_levelCount - 1)],
+        VK_IMAGE_LAYOUT_GENERAL};
+  }
+  writes[1 + MAX_LEVELS].buffer = {m_counterBuffer, 0, VK_WHOLE_SIZE};
+  m_layout.Write(m_set, writes);
+
+  createPipeline();
+  LOG_INFO("depth pyramid: {}x{}, {} levels", m_width, m_height, m_levelCount);
+}
+
+DepthPyramid::~DepthPyramid() {
+  vkDestroyPipeline(m_context.device, m_pipeline, nullptr);
+  vkDestroyPipelineLayout(m_context.device, m_pipelineLayout, nullptr);
+  vkDestroyBuffer(m_context.device, m_counterBuffer, nullptr);
+  vkFreeMemory(m_context.device, m_counterMemory, nullptr);
+  vkDestroySampler(m_context.device, m_sampler, nullptr);
+  for (VkImageView view : m_levelViews) {
+    vkDestroyImageView(m_context.device, view, nullptr);
+  }
+  vkDestroyImageView(m_context.device, m_view, nullptr);
+  vkDestroyImage(m_context.device, m_image, nullptr);
+  vkFreeMemory(m_context.device, m_memory, nullptr);
+}
+
+void DepthPyramid::createPipeline() {
+  VkDescriptorSetLayout setLayout = m_layout.Get();
+  VkPushConstantRange pushConstantRange = {
+      .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+      .offset = 0,
+      .size = sizeof(DepthPyramidParams),
+  };
+  VkPipelineLayoutCreateInfo layoutInfo = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+      .setLayoutCount = 1,
+      .pSetLayouts = &setLayout,
+      .pushConstantRangeCount = 1,
+      .pPushConstantRanges = &pushConstantRange,
+  };
+  if (vkCreatePipelineLayout(m_context.device, &layoutInfo, nullptr,
+                             &m_pipelineLayout) != VK_SUCCESS) {
+    LOG_ERROR("failed to create depth pyramid pipeline layout!");
+    throw std::runtime_error("failed to create depth pyramid pipeline layout!");
+  }
+
+  VkShaderModule shaderModule = createShaderModule(
+      m_context, readFile(SHADER_PATH "scene/depth_pyramid.comp.spv"));
+  VkComputePipelineCreateInfo pipelineInfo = {
+      .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+      .stage =
+          {
+              .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+              .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+              .module = shaderModule,
+              .pName = "main",
+          },
+      .layout = m_pipelineLayout,
+  };
+  VkResult result = vkCreateComputePipelines(
+      m_context.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline);
+  vkDestroyShaderModule(m_context.device, shaderModule, nullptr);
+  if (result != VK_SUCCESS) {
+    LOG_ERROR("failed to create depth pyramid pipeline!");
+    throw std::runtime_error("failed to create depth pyramid pipeline!");
+  }
+}
+
+void DepthPyramid::Build(VkCommandBuffer commandBuffer) {
+  // 1. 金字塔：首次从 UNDEFINED 转为 GENERAL，之后只需等待上一帧的采样读取
+  if (!m_initialized) {
+    cmdTransitionImageLayout(commandBuffer, m_image, VK_IMAGE_LAYOUT_UNDEFINED,
+                             VK_IMAGE_LAYOUT_GENERAL, 0, m_levelCount);
+    m_initialized = true;
+  }
+
+  // 2. 计数清零：上一次派发对计数器的原子写入需先对清零可见（WAW）
+  VkMemoryBarrier counterBarrier = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+  };
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &counterBarrier,
+                       0, nullptr, 0, nullptr);
+  vkCmdFillBuffer(commandBuffer, m_counterBuffer, 0, sizeof(uint32_t), 0);
+  VkMemoryBarrier inputBarrier = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT |
+                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+  };
+  vkCmdPipelineBarrier(commandBuffer,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT |
+                           VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
+                       &inputBarrier, 0, nullptr, 0, nullptr);
+
+  // 3. 一次派发生成全部级
+  uint32_t groupsX = (m_width + TILE_SIZE - 1) / TILE_SIZE;
+  uint32_t groupsY = (m_height + TILE_SIZE - 1) / TILE_SIZE;
+  DepthPyramidParams params = {
+      .depthWidth = m_depthWidth,
+      .depthHeight = m_depthHeight,
+      .width = m_width,
+      .height = m_height,
+      .levelCount = m_levelCount,
+      .groupCount = groupsX * groupsY,
+  };
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                          m_pipelineLayout, 0, 1, &m_set, 0, nullptr);
+  vkCmdPushConstants(commandBuffer, m_pipelineLayout,
+                     VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+  vkCmdDispatch(commandBuffer, groupsX, groupsY, 1);
+
+  // 4. 剔除着色器采样金字塔
+  VkMemoryBarrier outputBarrier = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+  };
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
+                       &outputBarrier, 0, nullptr, 0, nullptr);
+}
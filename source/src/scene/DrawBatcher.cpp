@@ -0,0 +1,229 @@
+#include "Scene/DrawBatcher.hpp"
+
+#include "Vulkan/VkUtils.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+DrawBatcher::DrawBatcher(ThreadPool &threadPool) : m_threadPool(threadPool) {}
+
+uint64_t DrawBatcher::makeKey(const DrawObject &object) {
+  if (object.pipeline >> PIPELINE_BITS || object.material >> MATERIAL_BITS ||
+      object.mesh >> MESH_BITS || object.lod >> LOD_BITS) {
+    LOG_ERROR("draw object (pipeline {}, material {}, mesh {}, lod {}) "
+              "exceeds the batch key range",
+              object.pipeline, object.material, object.mesh, object.lod);
+    throw std::runtime_error("draw object exceeds the batch key range!");
+  }
+  // 高位在前：排序后先按管线、再按材质、最后按网格与 LOD 排列
+  return uint64_t(object.pipeline) << (MATERIAL_BITS + MESH_BITS + LOD_BITS) |
+         uint64_t(object.material) << (MESH_BITS + LOD_BITS) |
+         uint64_t(object.mesh) << LOD_BITS | uint64_t(object.lod);
+}
+
+void DrawBatcher::Build(std::span<const DrawObject> objects,
+                        std::span<const glm::mat4> transforms,
+                        std::span<const uint32_t> visible,
+                        std::span<InstanceData> instances) {
+  if (objects.size() != transforms.size() ||
+      instances.size() < visible.size()) {
+    LOG_ERROR("draw batcher: {} objects, {} transforms, {} visible objects "
+              "for {} instances",
+              objects.size(), transforms.size(), visible.size(),
+              instances.size());
+    throw std::runtime_error("draw batcher input size mismatch!");
+  }
+  m_batches.clear();
+  uint32_t visibleCount = static_cast<uint32_t>(visible.size());
+  uint32_t chunkCount = (visibleCount + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  if (m_chunks.size() < chunkCount) {
+    m_chunks.resize(chunkCount);
+  }
+  m_localBatches.resize(visibleCount);
+
+  // 1. 每块局部分组。按场景顺序排列的对象常常连续共用一个批次，先和上一个键比较
+  m_threadPool.ParallelFor(chunkCount, 1, [&](size_t first, size_t last) {
+    for (size_t c = first; c < last; c++) {
+      Chunk &chunk = m_chunks[c];
+      chunk.lookup.Clear();
+      chunk.keys.clear();
+      chunk.counts.clear();
+      uint32_t begin = static_cast<uint32_t>(c) * CHUNK_SIZE;
+      uint32_t end = std::min(begin + CHUNK_SIZE, visibleCount);
+      uint64_t lastKey = UINT64_MAX;
+      uint32_t lastBatch = 0;
+      for (uint32_t i = begin; i < end; i++) {
+        uint64_t key = makeKey(objects[visible[i]]);
+        if (key != lastKey) {
+          auto [batch, inserted] = chunk.lookup.TryEmplace(
+              key, static_cast<uint32_t>(chunk.keys.size()));
+          if (inserted) {
+            chunk.keys.push_back(key);
+            chunk.counts.push_back(0);
+          }
+          lastKey = key;
+          lastBatch = *batch;
+        }
+        chunk.counts[lastBatch]++;
+        m_localBatches[i] = lastBatch;
+      }
+    }
+  });
+
+  // 2. 合并各块的批次并按键排序，再按块的顺序给每个块内批次分配实例区间
+  m_batchKeys.clear();
+  m_batchLookup.Clear();
+  for (uint32_t c = 0; c < chunkCount; c++) {
+    for (uint64_t key : m_chunks[c].keys) {
+      if (m_batchLookup.TryEmplace(key, 0).second) {
+        m_batchKeys.push_back(key);
+      }
+    }
+  }
+  std::sort(m_batchKeys.begin(), m_batchKeys.end());
+  m_batches.resize(m_batchKeys.size());
+  for (uint32_t b = 0; b < m_batchKeys.size(); b++) {
+    uint64_t key = m_batchKeys[b];
+    *m_batchLookup.Find(key) = b;
+    m_batches[b] = {
+        .pipeline = uint32_t(key >> (MATERIAL_BITS + MESH_BITS + LOD_BITS)),
+        .material = uint32_t(key >> (MESH_BITS + LOD_BITS)) &
+                    ((1u << MATERIAL_BITS) - 1),
+        .mesh = uint32_t(key >> LOD_BITS) & ((1u << MESH_BITS) - 1),
+        .lod = uint32_t(key) & ((1u << LOD_BITS) - 1),
+        .firstInstance = 0,
+        .instanceCount = 0,
+    };
+  }
+  // 查找表此后只读，各块并行地把块内批次映射到全局批次
+  m_threadPool.ParallelFor(chunkCount, 1, [&](size_t first, size_t last) {
+    for (size_t c = first; c < last; c++) {
+      Chunk &chunk = m_chunks[c];
+      chunk.batches.resize(chunk.keys.size());
+      for (size_t local = 0; local < chunk.keys.size(); local++) {
+        chunk.batches[local] = *m_batchLookup.Find(chunk.keys[local]);
+      }
+    }
+  });
+  // 块内批次的起点先记为批次内的偏移，第 3 步再加上批次的 firstInstance
+  for (uint32_t c = 0; c < chunkCount; c++) {
+    Chunk &chunk = m_chunks[c];
+    chunk.cursors.resize(chunk.keys.size());
+    for (size_t local = 0; local < chunk.keys.size(); local++) {
+      DrawBatch &batch = m_batches[chunk.batches[local]];
+      chunk.cursors[local] = batch.instanceCount;
+      batch.instanceCount += chunk.counts[local];
+    }
+  }
+  uint32_t instanceCount = 0;
+  for (DrawBatch &batch : m_batches) {
+    batch.firstInstance = instanceCount;
+    instanceCount += batch.instanceCount;
+  }
+
+  // 3. 各块并行把可见对象散布到批次顺序中，块之间的区间互不重叠
+  m_order.resize(visibleCount);
+  m_threadPool.ParallelFor(chunkCount, 1, [&](size_t first, size_t last) {
+    for (size_t c = first; c < last; c++) {
+      Chunk &chunk = m_chunks[c];
+      for (size_t local = 0; local < chunk.keys.size(); local++) {
+        chunk.cursors[local] += m_batches[chunk.batches[local]].firstInstance;
+      }
+      uint32_t begin = static_cast<uint32_t>(c) * CHUNK_SIZE;
+      uint32_t end = std::min(begin + CHUNK_SIZE, visibleCount);
+      for (uint32_t i = begin; i < end; i++) {
+        m_order[chunk.cursors[m_localBatches[i]]++] = visible[i];
+      }
+    }
+  });
+
+  // 4. 按实例顺序连续写入实例数据。实例缓冲通常是写合并的映射内存，只做顺序写
+  m_threadPool.ParallelFor(
+      visibleCount, CHUNK_SIZE, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+          uint32_t object = m_order[i];
+          InstanceData &instance = instances[i];
+          instance.model = transforms[object];
+          instance.materialIndex = objects[object].materialIndex;
+        }
+      });
+}
+
+const Mesh &DrawBindings::GetMesh(uint32_t mesh) const {
+  if (mesh >= meshes.size() || meshes[mesh] == nullptr) {
+    LOG_ERROR("draw mesh {} not bound ({} meshes)", mesh, meshes.size());
+    throw std::runtime_error("draw mesh not bound!");
+  }
+  return *meshes[mesh];
+}
+
+void DrawBatcher::Record(VkCommandBuffer commandBuffer,
+                         const DrawBindings &bindings) const {
+  uint32_t pipeline = UINT32_MAX;
+  uint32_t material = UINT32_MAX;
+  uint32_t mesh = UINT32_MAX;
+  for (const DrawBatch &batch : m_batches) {
+    if (batch.pipeline != pipeline) {
+      if (bindings.bindPipeline) {
+        bindings.bindPipeline(commandBuffer, batch.pipeline);
+      }
+      pipeline = batch.pipeline;
+      material = UINT32_MAX; // 管线布局可能不兼容，切换管线后重新绑定材质
+    }
+    if (batch.material != material) {
+      if (bindings.bindMaterial) {
+        bindings.bindMaterial(commandBuffer, batch.material);
+      }
+      material = batch.material;
+    }
+    if (batch.mesh != mesh) {
+      bindings.GetMesh(batch.mesh).Bind(commandBuffer);
+      mesh = batch.mesh;
+    }
+    bindings.GetMesh(mesh).DrawLod(commandBuffer, batch.lod,
+                                   batch.instanceCount, batch.firstInstance);
+  }
+}
+
+InstanceRing::InstanceRing(const VkContext &context,
+                           const InstanceRingConfig &config)
+    : m_context(context), m_config(config) {
+  if (m_config.framesInFlight == 0 || m_config.maxInstances == 0) {
+    LOG_ERROR("instance ring needs at least one frame and one instance!");
+    throw std::runtime_error("invalid instance ring config!");
+  }
+  VkDeviceSize size = VkDeviceSize(m_config.maxInstances) *
+                      m_config.framesInFlight * sizeof(InstanceData);
+  createBuffer(m_context, size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+               m_buffer, m_memory);
+  vkMapMemory(m_context.device, m_memory, 0, VK_WHOLE_SIZE, 0,
+              reinterpret_cast<void **>(&m_mapped));
+
+  LOG_INFO("instance ring: {} instances per frame, {} KiB total",
+           m_config.maxInstances, size >> 10);
+}
+
+InstanceRing::~InstanceRing() {
+  vkUnmapMemory(m_context.device, m_memory);
+  vkDestroyBuffer(m_context.device, m_buffer, nullptr);
+  vkFreeMemory(m_context.device, m_memory, nullptr);
+}
+
+void InstanceRing::BeginFrame(uint64_t frameIndex) {
+  m_frameSlot = static_cast<uint32_t>(frameIndex % m_config.framesInFlight);
+}
+
+std::span<InstanceData> InstanceRing::GetFrameInstances() const {
+  return {m_mapped + size_t(m_frameSlot) * m_config.maxInstances,
+          m_config.maxInstances};
+}
+
+void InstanceRing::Bind(VkCommandBuffer commandBuffer) const {
+  VkDeviceSize offset =
+      VkDeviceSize(m_frameSlot) * m_config.maxInstances * sizeof(InstanceData);
+  vkCmdBindVertexBuffers(commandBuffer, INSTANCE_BINDING, 1, &m_buffer,
+                         &offset);
+}
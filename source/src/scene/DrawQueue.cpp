@@ -0,0 +1,240 @@
+#include "Scene/DrawQueue.hpp"
+
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace {
+constexpr uint32_t PASS_SHIFT = 64 - DrawQueue::PASS_BITS;
+
+// 正浮点数的位模式随数值单调递增，去掉符号位后取高 DEPTH_BITS 位
+uint64_t quantizeDepth(float viewDepth) {
+  if (!(viewDepth > 0.0f)) {
+    return 0;
+  }
+  return std::bit_cast<uint32_t>(viewDepth) >> (31 - DrawQueue::DEPTH_BITS);
+}
+} // namespace
+
+DrawQueue::DrawQueue(ThreadPool &threadPool) : m_threadPool(threadPool) {}
+
+uint64_t DrawQueue::MakeSortKey(uint32_t pass, DepthOrder order,
+                                const DrawPacket &packet, float viewDepth) {
+  if (pass >> PASS_BITS || packet.pipeline >> PIPELINE_BITS ||
+      packet.material >> MATERIAL_BITS || packet.mesh >> MESH_BITS) {
+    LOG_ERROR("draw packet (pass {}, pipeline {}, material {}, mesh {}) "
+              "exceeds the sort key range",
+              pass, packet.pipeline, packet.material, packet.mesh);
+    throw std::runtime_error("draw packet exceeds the sort key range!");
+  }
+  uint64_t depth = quantizeDepth(viewDepth);
+  uint64_t state = uint64_t(packet.pipeline) << (MATERIAL_BITS + MESH_BITS) |
+                   uint64_t(packet.material) << MESH_BITS |
+                   uint64_t(packet.mesh);
+  uint64_t key = uint64_t(pass) << PASS_SHIFT;
+  if (order == DepthOrder::FrontToBack) {
+    return key | state << DEPTH_BITS | depth;
+  }
+  uint64_t inverted = ~depth & ((1u << DEPTH_BITS) - 1);
+  return key | inverted << (PIPELINE_BITS + MATERIAL_BITS + MESH_BITS) | state;
+}
+
+void DrawQueue::Clear() {
+  m_packets.clear();
+  m_items.clear();
+  m_commands.clear();
+  m_passRanges = {};
+  m_stats = {};
+}
+
+std::span<DrawPacket> DrawQueue::Append(size_t count) {
+  size_t first = m_packets.size();
+  m_packets.resize(first + count);
+  return std::span<DrawPacket>(m_packets).subspan(first, count);
+}
+
+void DrawQueue::Sort() {
+  radixSort();
+  buildCommands();
+}
+
+void DrawQueue::radixSort() {
+  uint32_t count = static_cast<uint32_t>(m_packets.size());
+  m_items.resize(count);
+  m_scratch.resize(count);
+  if (count == 0) {
+    return;
+  }
+  // 块数固定下来，每一轮各块处理的区间相同，块内的计数与写入位置才能对应
+  uint32_t blockCount =
+      std::min((count + RADIX_BLOCK_SIZE - 1) / RADIX_BLOCK_SIZE,
+               m_threadPool.GetThreadCount() * 4);
+  uint32_t blockSize = (count + blockCount - 1) / blockCount;
+  m_histograms.assign(size_t(blockCount) * RADIX_PASSES * RADIX_SIZE, 0);
+  auto histogramOf = [&](uint32_t block, uint32_t digit) {
+    return &m_histograms[(size_t(block) * RADIX_PASSES + digit) * RADIX_SIZE];
+  };
+
+  // 1. 取出排序键，一次读取统计所有位的直方图
+  m_threadPool.ParallelFor(blockCount, 1, [&](size_t first, size_t last) {
+    for (uint32_t block = uint32_t(first); block < last; block++) {
+      uint32_t begin = block * blockSize;
+      uint32_t end = std::min(begin + blockSize, count);
+      for (uint32_t i = begin; i < end; i++) {
+        uint64_t key = m_packets[i].sortKey;
+        m_items[i] = {key, i};
+        for (uint32_t digit = 0; digit < RADIX_PASSES; digit++) {
+          histogramOf(block, digit)[digitOf(key, digit)]++;
+        }
+      }
+    }
+  });
+
+  // 2. 从低位到高位逐位分散。各块的计数与当前顺序一致时直接使用，否则重新统计该位
+  std::vector<SortItem> *source = &m_items;
+  std::vector<SortItem> *destination = &m_scratch;
+  bool countsCurrent = true;
+  for (uint32_t digit = 0; digit < RADIX_PASSES; digit++) {
+    // 总数与顺序无关：所有键在该位都相同时跳过，pass 等高位通常只有少数几种取值
+    bool uniform = false;
+    for (uint32_t bucket = 0; bucket < RADIX_SIZE && !uniform; bucket++) {
+      uint32_t total = 0;
+      for (uint32_t block = 0; block < blockCount; block++) {
+        total += histogramOf(block, digit)[bucket];
+      }
+      uniform = total == count;
+    }
+    if (uniform) {
+      continue;
+    }
+
+    if (!countsCurrent) {
+      m_threadPool.ParallelFor(blockCount, 1, [&](size_t first, size_t last) {
+        for (uint32_t block = uint32_t(first); block < last; block++) {
+          uint32_t *histogram = histogramOf(block, digit);
+          std::fill(histogram, histogram + RADIX_SIZE, 0);
+          uint32_t begin = block * blockSize;
+          uint32_t end = std::min(begin + blockSize, count);
+          for (uint32_t i = begin; i < end; i++) {
+            histogram[digitOf((*source)[i].key, digit)]++;
+          }
+        }
+      });
+    }
+
+    // 按 (桶, 块) 的顺序前缀求和，得到每块在每个桶中的写入位置，保证排序稳定
+    uint32_t offset = 0;
+    for (uint32_t bucket = 0; bucket < RADIX_SIZE; bucket++) {
+      for (uint32_t block = 0; block < blockCount; block++) {
+        uint32_t &entry = histogramOf(block, digit)[bucket];
+        uint32_t bucketCount = entry;
+        entry = offset;
+        offset += bucketCount;
+      }
+    }
+
+    m_threadPool.ParallelFor(blockCount, 1, [&](size_t first, size_t last) {
+      for (uint32_t block = uint32_t(first); block < last; block++) {
+        uint32_t *positions = histogramOf(block, digit);
+        uint32_t begin = block * blockSize;
+        uint32_t end = std::min(begin + blockSize, count);
+        for (uint32_t i = begin; i < end; i++) {
+          const SortItem &item = (*source)[i];
+          (*destination)[positions[digitOf(item.key, digit)]++] = item;
+        }
+      }
+    });
+    std::swap(source, destination);
+    countsCurrent = false;
+  }
+  if (source != &m_items) {
+    m_items.swap(m_scratch);
+  }
+}
+
+void DrawQueue::buildCommands() {
+  m_commands.clear();
+  m_passRanges = {};
+  m_stats = {};
+
+  uint32_t pass = UINT32_MAX;
+  uint32_t pipeline = UINT32_MAX;
+  uint32_t material = UINT32_MAX;
+  uint32_t mesh = UINT32_MAX;
+  auto closePass = [&] {
+    if (pass != UINT32_MAX) {
+      m_passRanges[pass].count =
+          static_cast<uint32_t>(m_commands.size()) - m_passRanges[pass].first;
+    }
+  };
+  for (const SortItem &item : m_items) {
+    const DrawPacket &packet = m_packets[item.packet];
+    uint32_t itemPass = static_cast<uint32_t>(item.key >> PASS_SHIFT);
+    if (itemPass != pass) {
+      // 每个 pass 单独录制，开始时所有绑定都需要重新设置
+      closePass();
+      pass = itemPass;
+      m_passRanges[pass].first = static_cast<uint32_t>(m_commands.size());
+      pipeline = material = mesh = UINT32_MAX;
+    }
+    if (packet.pipeline != pipeline) {
+      m_commands.push_back({DrawCommandType::BindPipeline, packet.pipeline});
+      m_stats.pipelineBinds++;
+      pipeline = packet.pipeline;
+      material = UINT32_MAX; // 管线布局可能不兼容，切换管线后重新绑定材质
+    }
+    if (packet.material != material) {
+      m_commands.push_back({DrawCommandType::BindMaterial, packet.material});
+      m_stats.materialBinds++;
+      material = packet.material;
+    }
+    if (packet.mesh != mesh) {
+      m_commands.push_back({DrawCommandType::BindMesh, packet.mesh});
+      m_stats.meshBinds++;
+      mesh = packet.mesh;
+    }
+    m_commands.push_back({DrawCommandType::Draw, item.packet});
+    m_stats.draws++;
+  }
+  closePass();
+}
+
+std::span<const DrawCommand> DrawQueue::GetCommands(uint32_t pass) const {
+  if (pass >= MAX_PASSES) {
+    LOG_ERROR("draw queue has no pass {}", pass);
+    throw std::runtime_error("draw queue pass out of range!");
+  }
+  const PassRange &range = m_passRanges[pass];
+  return std::span<const DrawCommand>(m_commands)
+      .subspan(range.first, range.count);
+}
+
+void DrawQueue::Record(VkCommandBuffer commandBuffer, uint32_t pass,
+                       const DrawBindings &bindings) const {
+  for (const DrawCommand &command : GetCommands(pass)) {
+    switch (command.type) {
+    case DrawCommandType::BindPipeline:
+      if (bindings.bindPipeline) {
+        bindings.bindPipeline(commandBuffer, command.id);
+      }
+      break;
+    case DrawCommandType::BindMaterial:
+      if (bindings.bindMaterial) {
+        bindings.bindMaterial(commandBuffer, command.id);
+      }
+      break;
+    case DrawCommandType::BindMesh:
+      bindings.GetMesh(command.id).Bind(commandBuffer);
+      break;
+    case DrawCommandType::Draw: {
+      const DrawPacket &packet = m_packets[command.id];
+      bindings.GetMesh(packet.mesh).DrawLod(commandBuffer, packet.lod,
+                                            packet.instanceCount,
+                                            packet.firstInstance);
+      break;
+    }
+    }
+  }
+}
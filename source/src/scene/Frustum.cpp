@@ -0,0 +1,38 @@
+#include "Scene/Frustum.hpp"
+
+void extractFrustumPlanes(const glm::mat4 &clipFromObject,
+                          glm::vec4 (&planes)[6]) {
+  // Gribb-Hartmann：裁剪空间的不等式 -w <= x <= w、0 <= z <= w 变换回对象空间
+  auto row = [&](int i) {
+    return glm::vec4(clipFromObject[0][i], clipFromObject[1][i],
+                     clipFromObject[2][i], clipFromObject[3][i]);
+  };
+  planes[0] = row(3) + row(0); // 左
+  planes[1] = row(3) - row(0); // 右
+  planes[2] = row(3) + row(1); // 下
+  planes[3] = row(3) - row(1); // 上
+  planes[4] = row(2);          // 近
+  planes[5] = row(3) - row(2); // 远
+  for (glm::vec4 &plane : planes) {
+    plane /= glm::length(glm::vec3(plane));
+  }
+}
+
+FrustumTest testFrustumAabb(const glm::vec4 (&planes)[6], const glm::vec3 &min,
+                            const glm::vec3 &max) {
+  glm::vec3 center = (min + max) * 0.5f;
+  glm::vec3 extent = (max - min) * 0.5f;
+  FrustumTest result = FrustumTest::Inside;
+  for (const glm::vec4 &plane : planes) {
+    glm::vec3 normal(plane);
+    float distance = glm::dot(normal, center) + plane.w;
+    float radius = glm::dot(glm::abs(normal), extent);
+    if (distance < -radius) {
+      return FrustumTest::Outside;
+    }
+    if (distance < radius) {
+      result = FrustumTest::Intersecting;
+    }
+  }
+  return result;
+}
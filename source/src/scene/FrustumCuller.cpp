@@ -0,0 +1,516 @@
+#include "Scene/FrustumCuller.hpp"
+
+#include "Scene/Aabb.hpp"
+#include "Scene/Frustum.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||            \
+    defined(_M_IX86)
+#define CULL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define CULL_X86 0
+#endif
+
+// MSVC 不需要为内建函数指定目标指令集；GCC/Clang 按函数开启，由运行时检测决定是否调用
+#if CULL_X86 && !(defined(_MSC_VER) && !defined(__clang__))
+#define CULL_TARGET_SSE2 __attribute__((target("sse2")))
+#define CULL_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define CULL_TARGET_SSE2
+#define CULL_TARGET_AVX2
+#endif
+
+namespace {
+constexpr float PADDING_RADIUS = -std::numeric_limits<float>::infinity();
+constexpr uint32_t GROUP_SIZE = CullingBounds::LANE_PADDING;
+// 量化值的上限留出余量，保证向上取整并加一步后仍在 16 位以内
+constexpr float QUANTIZED_RANGE = 65000.0f;
+constexpr float QUANTIZED_MAX = 65535.0f;
+// 步长不小于坐标绝对值的 2^-20，float 还原时的舍入误差远小于一步
+constexpr float MIN_RELATIVE_STEP = 1.0f / (1 << 20);
+
+// 平面按分量拆开，SIMD 中逐分量广播；abs* 用于包围盒的投影半径
+struct CullPlanes {
+  float nx[6], ny[6], nz[6], d[6];
+  float ax[6], ay[6], az[6];
+};
+
+CullPlanes makeCullPlanes(const glm::mat4 &viewProjection) {
+  glm::vec4 planes[6];
+  extractFrustumPlanes(viewProjection, planes);
+  CullPlanes result;
+  for (int i = 0; i < 6; i++) {
+    result.nx[i] = planes[i].x;
+    result.ny[i] = planes[i].y;
+    result.nz[i] = planes[i].z;
+    result.d[i] = planes[i].w;
+    result.ax[i] = std::abs(planes[i].x);
+    result.ay[i] = std::abs(planes[i].y);
+    result.az[i] = std::abs(planes[i].z);
+  }
+  return result;
+}
+
+// 把一组 lane 的可见掩码展开为编号
+inline uint32_t emitVisible(uint32_t mask, uint32_t base, uint32_t *out) {
+  uint32_t count = 0;
+  while (mask != 0) {
+    out[count++] = base + static_cast<uint32_t>(std::countr_zero(mask));
+    mask &= mask - 1;
+  }
+  return count;
+}
+
+// 组内超出对象数量的 lane 不输出
+inline uint32_t groupLaneMask(uint32_t count, uint32_t group) {
+  uint32_t first = group * GROUP_SIZE;
+  return count - first >= GROUP_SIZE ? (1u << GROUP_SIZE) - 1
+                                     : (1u << (count - first)) - 1;
+}
+
+// 以下内核处理 [begin, end)，两端都是 8 的倍数，返回写入 out 的数量
+uint32_t cullScalar(const CullingBounds &bounds, const CullPlanes &planes,
+                    uint32_t begin, uint32_t end, uint32_t *out) {
+  uint32_t count = 0;
+  for (uint32_t group = begin / GROUP_SIZE; group < end / GROUP_SIZE; group++) {
+    const QuantizedGroup &g = bounds.GetGroups()[group];
+    const QuantizedSpheres &spheres = bounds.GetSpheres()[group];
+    const QuantizedExtents &extents = bounds.GetExtents()[group];
+    uint32_t lanes = groupLaneMask(bounds.GetCount(), group);
+    for (uint32_t lane = 0; lane < GROUP_SIZE; lane++) {
+      float x = g.originX + g.step * spheres.x[lane];
+      float y = g.originY + g.step * spheres.y[lane];
+      float z = g.originZ + g.step * spheres.z[lane];
+      float r = g.step * spheres.radius[lane];
+      float ex = g.step * extents.x[lane];
+      float ey = g.step * extents.y[lane];
+      float ez = g.step * extents.z[lane];
+      // 球心在所有平面内侧时包围盒测试必然通过，与 SIMD 内核一致
+      float nearest = std::numeric_limits<float>::max();
+      float farthest = std::numeric_limits<float>::max();
+      for (int p = 0; p < 6; p++) {
+        float distance = planes.nx[p] * x + planes.ny[p] * y +
+                         planes.nz[p] * z + planes.d[p];
+        float boxRadius =
+            planes.ax[p] * ex + planes.ay[p] * ey + planes.az[p] * ez;
+        nearest = std::min(nearest, distance);
+        farthest = std::min(farthest, distance + boxRadius);
+      }
+      bool visible = (lanes >> lane & 1) != 0 && nearest >= -r &&
+                     (nearest >= 0.0f || farthest >= 0.0f);
+      out[count] = group * GROUP_SIZE + lane;
+      count += visible ? 1 : 0;
+    }
+  }
+  return count;
+}
+
+#if CULL_X86
+// 取 8 个 16 位量化值中的 4 个（half 为 0 或 1），还原为 origin + step * q
+CULL_TARGET_SSE2 inline __m128 dequantizeSse2(const uint16_t *q, int half,
+                                              __m128 step, __m128 origin) {
+  __m128i packed =
+      _mm_loadl_epi64(reinterpret_cast<const __m128i *>(q + half * 4));
+  __m128 value =
+      _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed, _mm_setzero_si128()));
+  return _mm_add_ps(_mm_mul_ps(value, step), origin);
+}
+
+CULL_TARGET_SSE2 uint32_t cullSse2(const CullingBounds &bounds,
+                                   const CullPlanes &planes, uint32_t begin,
+                                   uint32_t end, uint32_t *out) {
+  const __m128 zero = _mm_setzero_ps();
+  uint32_t count = 0;
+  for (uint32_t group = begin / GROUP_SIZE; group < end / GROUP_SIZE; group++) {
+    const QuantizedGroup &g = bounds.GetGroups()[group];
+    const QuantizedSpheres &spheres = bounds.GetSpheres()[group];
+    const QuantizedExtents &extents = bounds.GetExtents()[group];
+    uint32_t lanes = groupLaneMask(bounds.GetCount(), group);
+    __m128 step = _mm_set1_ps(g.step);
+    __m128 originX = _mm_set1_ps(g.originX);
+    __m128 originY = _mm_set1_ps(g.originY);
+    __m128 originZ = _mm_set1_ps(g.originZ);
+
+    // 每组分两次，每次 4 个对象
+    for (int half = 0; half < 2; half++) {
+      __m128 x = dequantizeSse2(spheres.x, half, step, originX);
+      __m128 y = dequantizeSse2(spheres.y, half, step, originY);
+      __m128 z = dequantizeSse2(spheres.z, half, step, originZ);
+      __m128 radius = dequantizeSse2(spheres.radius, half, step, zero);
+
+      // 1. 包围球：到 6 个平面的最小距离 >= -radius
+      __m128 distances[6];
+      __m128 nearest;
+      for (int p = 0; p < 6; p++) {
+        distances[p] = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(planes.nx[p])),
+                       _mm_mul_ps(y, _mm_set1_ps(planes.ny[p]))),
+            _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(planes.nz[p])),
+                       _mm_set1_ps(planes.d[p])));
+        nearest = p == 0 ? distances[p] : _mm_min_ps(nearest, distances[p]);
+      }
+      uint32_t halfLanes = lanes >> (half * 4) & 0xF;
+      uint32_t mask =
+          static_cast<uint32_t>(_mm_movemask_ps(
+              _mm_cmpge_ps(nearest, _mm_sub_ps(zero, radius)))) &
+          halfLanes;
+      // 球心在某个平面外侧的才可能被包围盒剔除，其余直接可见
+      uint32_t outside = static_cast<uint32_t>(_mm_movemask_ps(nearest)) & mask;
+      if (outside != 0) {
+        // 2. 包围盒：distance + |n|·extent >= 0，只有这时才读取盒子尺寸
+        __m128 sx = dequantizeSse2(extents.x, half, step, zero);
+        __m128 sy = dequantizeSse2(extents.y, half, step, zero);
+        __m128 sz = dequantizeSse2(extents.z, half, step, zero);
+        __m128 farthest;
+        for (int p = 0; p < 6; p++) {
+          __m128 reach = _mm_add_ps(
+              _mm_add_ps(_mm_mul_ps(sx, _mm_set1_ps(planes.ax[p])),
+                         _mm_mul_ps(sy, _mm_set1_ps(planes.ay[p]))),
+              _mm_add_ps(_mm_mul_ps(sz, _mm_set1_ps(planes.az[p])),
+                         distances[p]));
+          farthest = p == 0 ? reach : _mm_min_ps(farthest, reach);
+        }
+        uint32_t culled = static_cast<uint32_t>(
+            _mm_movemask_ps(_mm_cmplt_ps(farthest, zero)));
+        mask &= ~(outside & culled);
+      }
+      count += emitVisible(mask, group * GROUP_SIZE + half * 4, out + count);
+    }
+  }
+  return count;
+}
+
+// 8 个 16 位量化值还原为 origin + step * q
+CULL_TARGET_AVX2 inline __m256 dequantizeAvx2(const uint16_t *q, __m256 step,
+                                              __m256 origin) {
+  __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(q));
+  return _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(packed)),
+                         step, origin);
+}
+
+// AVX2 的 CPU 都带 FMA，距离与投影半径都用乘加链计算
+CULL_TARGET_AVX2 uint32_t cullAvx2(const CullingBounds &bounds,
+                                   const CullPlanes &planes, uint32_t begin,
+                                   uint32_t end, uint32_t *out) {
+  // 平面分量在循环外广播一次，循环内直接作为内存操作数
+  __m256 nx[6], ny[6], nz[6], d[6], ax[6], ay[6], az[6];
+  for (int p = 0; p < 6; p++) {
+    nx[p] = _mm256_set1_ps(planes.nx[p]);
+    ny[p] = _mm256_set1_ps(planes.ny[p]);
+    nz[p] = _mm256_set1_ps(planes.nz[p]);
+    d[p] = _mm256_set1_ps(planes.d[p]);
+    ax[p] = _mm256_set1_ps(planes.ax[p]);
+    ay[p] = _mm256_set1_ps(planes.ay[p]);
+    az[p] = _mm256_set1_ps(planes.az[p]);
+  }
+  const __m256 zero = _mm256_setzero_ps();
+  uint32_t count = 0;
+  for (uint32_t group = begin / GROUP_SIZE; group < end / GROUP_SIZE; group++) {
+    const QuantizedGroup &g = bounds.GetGroups()[group];
+    const QuantizedSpheres &spheres = bounds.GetSpheres()[group];
+    __m256 step = _mm256_set1_ps(g.step);
+    __m256 x = dequantizeAvx2(spheres.x, step, _mm256_set1_ps(g.originX));
+    __m256 y = dequantizeAvx2(spheres.y, step, _mm256_set1_ps(g.originY));
+    __m256 z = dequantizeAvx2(spheres.z, step, _mm256_set1_ps(g.originZ));
+    __m256 negRadius =
+        _mm256_sub_ps(zero, dequantizeAvx2(spheres.radius, step, zero));
+
+    // 1. 包围球：到 6 个平面的最小距离 >= -radius
+    __m256 distances[6];
+    __m256 nearest;
+    for (int p = 0; p < 6; p++) {
+      distances[p] = _mm256_fmadd_ps(
+          x, nx[p],
+          _mm256_fmadd_ps(y, ny[p], _mm256_fmadd_ps(z, nz[p], d[p])));
+      nearest = p == 0 ? distances[p] : _mm256_min_ps(nearest, distances[p]);
+    }
+    uint32_t lanes = groupLaneMask(bounds.GetCount(), group);
+    uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(
+                        _mm256_cmp_ps(nearest, negRadius, _CMP_GE_OQ))) &
+                    lanes;
+    // 球心在某个平面外侧的才可能被包围盒剔除，其余直接可见
+    uint32_t outside = static_cast<uint32_t>(_mm256_movemask_ps(nearest)) & mask;
+    if (outside != 0) {
+      // 2. 包围盒：distance + |n|·extent >= 0，只有这时才读取盒子尺寸
+      const QuantizedExtents &extents = bounds.GetExtents()[group];
+      __m256 sx = dequantizeAvx2(extents.x, step, zero);
+      __m256 sy = dequantizeAvx2(extents.y, step, zero);
+      __m256 sz = dequantizeAvx2(extents.z, step, zero);
+      __m256 farthest;
+      for (int p = 0; p < 6; p++) {
+        __m256 reach = _mm256_fmadd_ps(
+            sx, ax[p],
+            _mm256_fmadd_ps(sy, ay[p], _mm256_fmadd_ps(sz, az[p], distances[p])));
+        farthest = p == 0 ? reach : _mm256_min_ps(farthest, reach);
+      }
+      uint32_t culled = static_cast<uint32_t>(_mm256_movemask_ps(
+          _mm256_cmp_ps(farthest, zero, _CMP_LT_OQ)));
+      mask &= ~(outside & culled);
+    }
+    count += emitVisible(mask, group * GROUP_SIZE, out + count);
+  }
+  return count;
+}
+#endif
+
+float maxAxisScale(const glm::mat4 &model) {
+  return std::sqrt(std::max({glm::dot(model[0], model[0]),
+                             glm::dot(model[1], model[1]),
+                             glm::dot(model[2], model[2])}));
+}
+} // namespace
+
+SimdLevel detectSimdLevel() {
+#if CULL_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+  __cpuid(info, 0);
+  int maxLeaf = info[0];
+  __cpuid(info, 1);
+  bool osxsave = (info[2] & (1 << 27)) != 0;
+  bool sse2 = (info[3] & (1 << 26)) != 0;
+  bool fma = (info[2] & (1 << 12)) != 0;
+  bool avx2 = false;
+  if (maxLeaf >= 7 && osxsave && (_xgetbv(0) & 0x6) == 0x6) {
+    __cpuidex(info, 7, 0);
+    avx2 = fma && (info[1] & (1 << 5)) != 0;
+  }
+#else
+  __builtin_cpu_init();
+  bool sse2 = __builtin_cpu_supports("sse2");
+  bool avx2 =
+      __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+  if (avx2) {
+    return SimdLevel::Avx2;
+  }
+  if (sse2) {
+    return SimdLevel::Sse2;
+  }
+#endif
+  return SimdLevel::Scalar;
+}
+
+const char *simdLevelName(SimdLevel level) {
+  switch (level) {
+  case SimdLevel::Avx2:
+    return "AVX2";
+  case SimdLevel::Sse2:
+    return "SSE2";
+  default:
+    return "scalar";
+  }
+}
+
+void CullingBounds::Reserve(size_t count) {
+  size_t padded = (count + LANE_PADDING - 1) / LANE_PADDING * LANE_PADDING;
+  for (std::vector<float> *array :
+       {&m_centerX, &m_centerY, &m_centerZ, &m_radius, &m_extentX, &m_extentY,
+        &m_extentZ}) {
+    array->reserve(padded);
+  }
+  m_groups.reserve(padded / GROUP_SIZE);
+  m_spheres.reserve(padded / GROUP_SIZE);
+  m_extents.reserve(padded / GROUP_SIZE);
+}
+
+void CullingBounds::Clear() {
+  m_count = 0;
+  resizePadded(0);
+}
+
+void CullingBounds::resizePadded(size_t count) {
+  size_t padded = (count + LANE_PADDING - 1) / LANE_PADDING * LANE_PADDING;
+  for (std::vector<float> *array : {&m_centerX, &m_centerY, &m_centerZ,
+                                    &m_extentX, &m_extentY, &m_extentZ}) {
+    array->resize(padded, 0.0f);
+  }
+  m_radius.resize(padded, PADDING_RADIUS);
+  // 新组的步长为 0，第一次写入时按组内对象选择量化参数
+  m_groups.resize(padded / GROUP_SIZE, QuantizedGroup{});
+  m_spheres.resize(padded / GROUP_SIZE, QuantizedSpheres{});
+  m_extents.resize(padded / GROUP_SIZE, QuantizedExtents{});
+}
+
+uint32_t CullingBounds::Add(const glm::vec3 &center, float radius,
+                            const glm::vec3 &extent) {
+  uint32_t index = m_count++;
+  if (index >= m_radius.size()) {
+    resizePadded(m_count);
+  }
+  Set(index, center, radius, extent);
+  return index;
+}
+
+uint32_t CullingBounds::Add(const MeshBounds &bounds, const glm::mat4 &model) {
+  uint32_t index = Add(glm::vec3(0.0f), 0.0f, glm::vec3(0.0f));
+  Set(index, bounds, model);
+  return index;
+}
+
+void CullingBounds::Set(uint32_t index, const glm::vec3 &center, float radius,
+                        const glm::vec3 &extent) {
+  m_centerX[index] = center.x;
+  m_centerY[index] = center.y;
+  m_centerZ[index] = center.z;
+  m_radius[index] = radius;
+  m_extentX[index] = extent.x;
+  m_extentY[index] = extent.y;
+  m_extentZ[index] = extent.z;
+  if (!quantize(index)) {
+    quantizeGroup(index / GROUP_SIZE);
+  }
+}
+
+bool CullingBounds::quantize(uint32_t index) {
+  const QuantizedGroup &group = m_groups[index / GROUP_SIZE];
+  glm::vec3 center(m_centerX[index], m_centerY[index], m_centerZ[index]);
+  glm::vec3 origin(group.originX, group.originY, group.originZ);
+  float step = group.step;
+  float largest = std::max({std::abs(center.x), std::abs(center.y),
+                            std::abs(center.z)});
+  if (!(step > 0.0f) || step < largest * MIN_RELATIVE_STEP) {
+    return false;
+  }
+  glm::vec3 q = glm::round((center - origin) / step);
+  if (std::min({q.x, q.y, q.z}) < 0.0f ||
+      std::max({q.x, q.y, q.z}) > QUANTIZED_MAX) {
+    return false;
+  }
+
+  // 半径与半尺寸计入球心的量化误差后向上取整，再多加一步覆盖还原时的舍入
+  glm::vec3 error = glm::abs(center - (origin + q * step));
+  float radius =
+      std::ceil((std::max(m_radius[index], 0.0f) + glm::length(error)) / step) +
+      1.0f;
+  glm::vec3 extent = glm::vec3(std::max(m_extentX[index], 0.0f),
+                               std::max(m_extentY[index], 0.0f),
+                               std::max(m_extentZ[index], 0.0f));
+  extent = glm::ceil((extent + error) / step) + 1.0f;
+  if (std::max({radius, extent.x, extent.y, extent.z}) > QUANTIZED_MAX) {
+    return false;
+  }
+
+  uint32_t lane = index % GROUP_SIZE;
+  QuantizedSpheres &spheres = m_spheres[index / GROUP_SIZE];
+  QuantizedExtents &extents = m_extents[index / GROUP_SIZE];
+  spheres.x[lane] = static_cast<uint16_t>(q.x);
+  spheres.y[lane] = static_cast<uint16_t>(q.y);
+  spheres.z[lane] = static_cast<uint16_t>(q.z);
+  spheres.radius[lane] = static_cast<uint16_t>(radius);
+  extents.x[lane] = static_cast<uint16_t>(extent.x);
+  extents.y[lane] = static_cast<uint16_t>(extent.y);
+  extents.z[lane] = static_cast<uint16_t>(extent.z);
+  return true;
+}
+
+void CullingBounds::quantizeGroup(uint32_t group) {
+  uint32_t first = group * GROUP_SIZE;
+  uint32_t last = std::min(first + GROUP_SIZE, m_count);
+
+  // 原点取组内球心的最小值，步长让球心跨度与最大尺寸都落在 QUANTIZED_RANGE 以内
+  glm::vec3 minimum(std::numeric_limits<float>::max());
+  glm::vec3 maximum(std::numeric_limits<float>::lowest());
+  float size = 0.0f;
+  for (uint32_t i = first; i < last; i++) {
+    glm::vec3 center(m_centerX[i], m_centerY[i], m_centerZ[i]);
+    minimum = glm::min(minimum, center);
+    maximum = glm::max(maximum, center);
+    size = std::max({size, m_radius[i], m_extentX[i], m_extentY[i],
+                     m_extentZ[i]});
+  }
+  glm::vec3 span = maximum - minimum;
+  glm::vec3 largest = glm::max(glm::abs(minimum), glm::abs(maximum));
+  float step = std::max({span.x, span.y, span.z, size}) / QUANTIZED_RANGE;
+  step = std::max({step,
+                   std::max({largest.x, largest.y, largest.z}) *
+                       MIN_RELATIVE_STEP * 2.0f,
+                   std::numeric_limits<float>::min()});
+  m_groups[group] = {minimum.x, minimum.y, minimum.z, step};
+
+  for (uint32_t i = first; i < last; i++) {
+    if (!quantize(i)) {
+      LOG_ERROR("failed to quantize culling bounds {}", i);
+      throw std::runtime_error("failed to quantize culling bounds!");
+    }
+  }
+}
+
+void CullingBounds::Set(uint32_t index, const MeshBounds &bounds,
+                        const glm::mat4 &model) {
+  // computeMeshBounds 的球心就是包围盒中心，两者变换后仍然共用
+  glm::vec3 center = glm::vec3(model * glm::vec4(bounds.center, 1.0f));
+  glm::vec3 extent = transformExtent(model, (bounds.max - bounds.min) * 0.5f);
+  Set(index, center, bounds.radius * maxAxisScale(model), extent);
+}
+
+FrustumCuller::FrustumCuller(ThreadPool &threadPool, SimdLevel level)
+    : m_threadPool(threadPool), m_level(level) {
+#if !CULL_X86
+  m_level = SimdLevel::Scalar;
+#endif
+  LOG_INFO("frustum culler: {} x {} threads", simdLevelName(m_level),
+           m_threadPool.GetThreadCount());
+}
+
+void FrustumCuller::Cull(const CullingBounds &bounds,
+                         const glm::mat4 &viewProjection,
+                         std::vector<uint32_t> &visible) {
+  uint32_t count = bounds.GetCount();
+  uint32_t paddedCount = (count + CullingBounds::LANE_PADDING - 1) /
+                         CullingBounds::LANE_PADDING *
+                         CullingBounds::LANE_PADDING;
+  uint32_t chunkCount = (paddedCount + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  CullPlanes planes = makeCullPlanes(viewProjection);
+
+  auto kernel = cullScalar;
+#if CULL_X86
+  if (m_level == SimdLevel::Avx2) {
+    kernel = cullAvx2;
+  } else if (m_level == SimdLevel::Sse2) {
+    kernel = cullSse2;
+  }
+#endif
+
+  // 1. 每块把可见编号写到 scratch 中自己的区域，互不重叠
+  m_scratch.resize(paddedCount);
+  m_chunkCounts.resize(chunkCount);
+  m_threadPool.ParallelFor(chunkCount, 1, [&](size_t first, size_t last) {
+    for (size_t chunk = first; chunk < last; chunk++) {
+      uint32_t begin = static_cast<uint32_t>(chunk) * CHUNK_SIZE;
+      uint32_t end = std::min(begin + CHUNK_SIZE, paddedCount);
+      m_chunkCounts[chunk] =
+          kernel(bounds, planes, begin, end, m_scratch.data() + begin);
+    }
+  });
+
+  // 2. 前缀和得到各块的输出偏移，再并行拷贝成紧凑数组
+  uint32_t total = 0;
+  for (uint32_t &chunkVisible : m_chunkCounts) {
+    uint32_t offset = total;
+    total += chunkVisible;
+    chunkVisible = offset;
+  }
+  visible.resize(total);
+  m_threadPool.ParallelFor(chunkCount, 1, [&](size_t first, size_t last) {
+    for (size_t chunk = first; chunk < last; chunk++) {
+      uint32_t offset = m_chunkCounts[chunk];
+      uint32_t next = chunk + 1 < m_chunkCounts.size() ? m_chunkCounts[chunk + 1]
+                                                       : total;
+      std::memcpy(visible.data() + offset,
+                  m_scratch.data() + chunk * CHUNK_SIZE,
+                  (next - offset) * sizeof(uint32_t));
+    }
+  });
+}
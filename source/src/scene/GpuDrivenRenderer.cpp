@@ -0,0 +1,359 @@
+#include "Scene/GpuDrivenRenderer.hpp"
+
+#include "Vulkan/VkUtils.hpp"
+#include "utils/fileUtils.hpp"
+#include "utils/log.hpp"
+
+#include <stdexcept>
+
+namespace {
+// scene_cull.comp 的绑定
+constexpr uint32_t CULL_OBJECT_BINDING = 0;
+constexpr uint32_t CULL_MESH_BINDING = 1;
+constexpr uint32_t CULL_DRAW_BINDING = 2;
+constexpr uint32_t CULL_DRAW_COUNT_BINDING = 3;
+constexpr uint32_t CULL_VISIBILITY_BINDING = 4; // 以下仅遮挡剔除版本
+constexpr uint32_t CULL_PYRAMID_BINDING = 5;
+
+// scene.vert 的绑定
+constexpr uint32_t DRAW_OBJECT_BINDING = 0;
+
+VkPipelineLayout createPipelineLayout(const VkContext &context,
+                                      VkDescriptorSetLayout setLayout,
+                                      VkShaderStageFlags pushStages,
+                                      uint32_t pushSize) {
+  VkPushConstantRange pushConstantRange = {
+      .stageFlags = pushStages,
+      .offset = 0,
+      .size = pushSize,
+  };
+  VkPipelineLayoutCreateInfo layoutInfo = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+      .setLayoutCount = 1,
+      .pSetLayouts = &setLayout,
+      .pushConstantRangeCount = 1,
+      .pPushConstantRanges = &pushConstantRange,
+  };
+  VkPipelineLayout layout;
+  if (vkCreatePipelineLayout(context.device, &layoutInfo, nullptr, &layout) !=
+      VK_SUCCESS) {
+    LOG_ERROR("failed to create gpu-driven pipeline layout!");
+    throw std::runtime_error("failed to create gpu-driven pipeline layout!");
+  }
+  return layout;
+}
+
+std::vector<DescriptorBinding> cullBindings(bool occlusion) {
+  std::vector<DescriptorBinding> bindings = {
+      {CULL_OBJECT_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1,
+       VK_SHADER_STAGE_COMPUTE_BIT},
+      {CULL_MESH_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+       VK_SHADER_STAGE_COMPUTE_BIT},
+      {CULL_DRAW_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+       VK_SHADER_STAGE_COMPUTE_BIT},
+      {CULL_DRAW_COUNT_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+       VK_SHADER_STAGE_COMPUTE_BIT},
+  };
+  if (occlusion) {
+    bindings.push_back({CULL_VISIBILITY_BINDING,
+                        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+                        VK_SHADER_STAGE_COMPUTE_BIT});
+    bindings.push_back({CULL_PYRAMID_BINDING,
+                        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1,
+                        VK_SHADER_STAGE_COMPUTE_BIT});
+  }
+  return bindings;
+}
+} // namespace
+
+bool GpuDrivenRenderer::IsSupported(const VkContext &context) {
+  return context.features.drawIndirectFirstInstance == VK_TRUE;
+}
+
+GpuDrivenRenderer::GpuDrivenRenderer(const VkContext &context,
+                                     const GpuScene &scene,
+                                     VkRenderPass renderPass, uint32_t subpass,
+                                     const DepthPyramid *depthPyramid)
+    : m_context(context), m_scene(scene), m_depthPyramid(depthPyramid),
+      m_cullLayout(context, cullBindings(depthPyramid != nullptr)),
+      m_drawLayout(context, {{DRAW_OBJECT_BINDING,
+                              VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1,
+                              VK_SHADER_STAGE_VERTEX_BIT}}),
+      m_descriptorAllocator(context, {.initialSetsPerPool = 2}) {
+  if (!IsSupported(m_context)) {
+    LOG_ERROR("gpu-driven rendering requires drawIndirectFirstInstance!");
+    throw std::runtime_error(
+        "gpu-driven rendering requires drawIndirectFirstInstance!");
+  }
+  if (m_depthPyramid != nullptr &&
+      m_scene.GetVisibilityBuffer() == VK_NULL_HANDLE) {
+    LOG_ERROR("occlusion culling requires GpuSceneConfig::occlusionCulling!");
+    throw std::runtime_error(
+        "occlusion culling requires GpuSceneConfig::occlusionCulling!");
+  }
+
+  m_cullSet = m_descriptorAllocator.Allocate(m_cullLayout);
+  DescriptorWrite cullWrites[6];
+  cullWrites[CULL_OBJECT_BINDING].buffer = {m_scene.GetObjectBuffer(), 0,
+                                            m_scene.GetObjectRange()};
+  cullWrites[CULL_MESH_BINDING].buffer = {m_scene.GetMeshBuffer(), 0,
+                                          VK_WHOLE_SIZE};
+  cullWrites[CULL_DRAW_BINDING].buffer = {m_scene.GetDrawBuffer(), 0,
+                                          VK_WHOLE_SIZE};
+  cullWrites[CULL_DRAW_COUNT_BINDING].buffer = {m_scene.GetDrawCountBuffer(),
+                                                0, VK_WHOLE_SIZE};
+  if (m_depthPyramid != nullptr) {
+    cullWrites[CULL_VISIBILITY_BINDING].buffer = {
+        m_scene.GetVisibilityBuffer(), 0, VK_WHOLE_SIZE};
+    cullWrites[CULL_PYRAMID_BINDING].image = {m_depthPyramid->GetSampler(),
+                                              m_depthPyramid->GetView(),
+                                              VK_IMAGE_LAYOUT_GENERAL};
+  }
+  m_cullLayout.Write(m_cullSet, cullWrites);
+
+  m_drawSet = m_descriptorAllocator.Allocate(m_drawLayout);
+  DescriptorWrite drawWrite;
+  drawWrite.buffer = {m_scene.GetObjectBuffer(), 0, m_scene.GetObjectRange()};
+  m_drawLayout.Write(m_drawSet, &drawWrite);
+
+  createCullPipeline();
+  createDrawPipeline(renderPass, subpass);
+}
+
+GpuDrivenRenderer::~GpuDrivenRenderer() {
+  vkDestroyPipeline(m_context.device, m_drawPipeline, nullptr);
+  vkDestroyPipelineLayout(m_context.device, m_drawPipelineLayout, nullptr);
+  vkDestroyPipeline(m_context.device, m_cullPipeline, nullptr);
+  vkDestroyPipelineLayout(m_context.device, m_cullPipelineLayout, nullptr);
+}
+
+void GpuDrivenRenderer::createCullPipeline() {
+  m_cullPipelineLayout =
+      createPipelineLayout(m_context, m_cullLayout.Get(),
+                           VK_SHADER_STAGE_COMPUTE_BIT, sizeof(SceneCullParams));
+
+  VkShaderModule shaderModule = createShaderModule(
+      m_context,
+      readFile(m_depthPyramid != nullptr
+                   ? SHADER_PATH "scene/scene_cull_occlusion.comp.spv"
+                   : SHADER_PATH "scene/scene_cull.comp.spv"));
+  VkComputePipelineCreateInfo pipelineInfo = {
+      .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+      .stage =
+          {
+              .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+              .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+              .module = shaderModule,
+              .pName = "main",
+          },
+      .layout = m_cullPipelineLayout,
+  };
+  VkResult result =
+      vkCreateComputePipelines(m_context.device, VK_NULL_HANDLE, 1,
+                               &pipelineInfo, nullptr, &m_cullPipeline);
+  vkDestroyShaderModule(m_context.device, shaderModule, nullptr);
+  if (result != VK_SUCCESS) {
+    LOG_ERROR("failed to create scene cull pipeline!");
+    throw std::runtime_error("failed to create scene cull pipeline!");
+  }
+}
+
+void GpuDrivenRenderer::createDrawPipeline(VkRenderPass renderPass,
+                                           uint32_t subpass) {
+  m_drawPipelineLayout =
+      createPipelineLayout(m_context, m_drawLayout.Get(),
+                           VK_SHADER_STAGE_VERTEX_BIT, sizeof(glm::mat4));
+
+  VkShaderModule vertexModule = createShaderModule(
+      m_context, readFile(SHADER_PATH "scene/scene.vert.spv"));
+  VkShaderModule fragmentModule = createShaderModule(
+      m_context, readFile(SHADER_PATH "00/triangle.frag.spv"));
+  VkPipelineShaderStageCreateInfo stages[] = {
+      {
+          .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+          .stage = VK_SHADER_STAGE_VERTEX_BIT,
+          .module = vertexModule,
+          .pName = "main",
+      },
+      {
+          .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+          .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+          .module = fragmentModule,
+          .pName = "main",
+      },
+  };
+
+  VkPipelineVertexInputStateCreateInfo vertexInput =
+      VertexInputState<VertexLayoutOf<Vertex>>::CreateInfo();
+  VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT,
+                                    VK_DYNAMIC_STATE_SCISSOR};
+  VkPipelineDynamicStateCreateInfo dynamicState = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+      .dynamicStateCount = 2,
+      .pDynamicStates = dynamicStates,
+  };
+  VkPipelineInputAssemblyStateCreateInfo inputAssembly = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+      .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+      .primitiveRestartEnable = VK_FALSE,
+  };
+  VkPipelineViewportStateCreateInfo viewportState = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+      .viewportCount = 1,
+      .scissorCount = 1,
+  };
+  VkPipelineRasterizationStateCreateInfo rasterizer = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+      .polygonMode = VK_POLYGON_MODE_FILL,
+      .cullMode = VK_CULL_MODE_BACK_BIT,
+      .frontFace = VK_FRONT_FACE_CLOCKWISE,
+      .lineWidth = 1.0f,
+  };
+  VkPipelineMultisampleStateCreateInfo multisampling = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+      .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
+      .minSampleShading = 1.0f,
+  };
+  VkPipelineDepthStencilStateCreateInfo depthStencil = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+      .depthTestEnable = VK_TRUE,
+      .depthWriteEnable = VK_TRUE,
+      .depthCompareOp = VK_COMPARE_OP_LESS,
+      .maxDepthBounds = 1.0f,
+  };
+  VkPipelineColorBlendAttachmentState colorBlendAttachment = {
+      .blendEnable = VK_FALSE,
+      .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                        VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT,
+  };
+  VkPipelineColorBlendStateCreateInfo colorBlending = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+      .attachmentCount = 1,
+      .pAttachments = &colorBlendAttachment,
+  };
+
+  VkGraphicsPipelineCreateInfo pipelineInfo = {
+      .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+      .stageCount = 2,
+      .pStages = stages,
+      .pVertexInputState = &vertexInput,
+      .pInputAssemblyState = &inputAssembly,
+      .pViewportState = &viewportState,
+      .pRasterizationState = &rasterizer,
+      .pMultisampleState = &multisampling,
+      .pDepthStencilState = &depthStencil,
+      .pColorBlendState = &colorBlending,
+      .pDynamicState = &dynamicState,
+      .layout = m_drawPipelineLayout,
+      .renderPass = renderPass,
+      .subpass = subpass,
+      .basePipelineIndex = -1,
+  };
+  VkResult result =
+      vkCreateGraphicsPipelines(m_context.device, VK_NULL_HANDLE, 1,
+                                &pipelineInfo, nullptr, &m_drawPipeline);
+  vkDestroyShaderModule(m_context.device, fragmentModule, nullptr);
+  vkDestroyShaderModule(m_context.device, vertexModule, nullptr);
+  if (result != VK_SUCCESS) {
+    LOG_ERROR("failed to create scene draw pipeline!");
+    throw std::runtime_error("failed to create scene draw pipeline!");
+  }
+}
+
+void GpuDrivenRenderer::Cull(VkCommandBuffer commandBuffer,
+                             const glm::mat4 &viewProjection,
+                             const glm::vec3 &cameraPosition,
+                             const LodSelectionParams &lodParams,
+                             CullPhase phase) const {
+  if (phase != CullPhase::All && m_depthPyramid == nullptr) {
+    LOG_ERROR("occlusion cull phase requires a depth pyramid!");
+    throw std::runtime_error("occlusion cull phase requires a depth pyramid!");
+  }
+
+  SceneCullParams params;
+  params.viewProjection = viewProjection;
+  params.cameraPosition = cameraPosition;
+  params.objectCount = m_scene.GetObjectCount();
+  params.projectionScale = lodParams.projectionScale;
+  params.pixelError = lodParams.pixelError;
+  params.compact = m_context.features12.drawIndirectCount ? 1 : 0;
+  params.phase = phase;
+
+  // 1. 清零计数；上一次的间接绘制读完之后才能覆盖计数与命令缓冲，
+  //    上一次剔除写入的可见性也要对本次可见
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                       nullptr, 0, nullptr);
+  vkCmdFillBuffer(commandBuffer, m_scene.GetDrawCountBuffer(), 0,
+                  sizeof(uint32_t), 0);
+  VkMemoryBarrier clearBarrier = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+  };
+  vkCmdPipelineBarrier(commandBuffer,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT |
+                           VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
+                       &clearBarrier, 0, nullptr, 0, nullptr);
+
+  // 2. 每个线程一个对象
+  uint32_t objectOffset = m_scene.GetObjectOffset();
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                    m_cullPipeline);
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                          m_cullPipelineLayout, 0, 1, &m_cullSet, 1,
+                          &objectOffset);
+  vkCmdPushConstants(commandBuffer, m_cullPipelineLayout,
+                     VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+  vkCmdDispatch(commandBuffer,
+                (params.objectCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1,
+                1);
+
+  // 3. 绘制命令与计数对间接绘制可见
+  VkMemoryBarrier drawBarrier = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+  };
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &drawBarrier,
+                       0, nullptr, 0, nullptr);
+}
+
+void GpuDrivenRenderer::Draw(VkCommandBuffer commandBuffer,
+                             const glm::mat4 &viewProjection) const {
+  uint32_t objectOffset = m_scene.GetObjectOffset();
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    m_drawPipeline);
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          m_drawPipelineLayout, 0, 1, &m_drawSet, 1,
+                          &objectOffset);
+  vkCmdPushConstants(commandBuffer, m_drawPipelineLayout,
+                     VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(viewProjection),
+                     &viewProjection);
+
+  VkBuffer vertexBuffer = m_scene.GetVertexBuffer();
+  VkDeviceSize offset = 0;
+  vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+  vkCmdBindIndexBuffer(commandBuffer, m_scene.GetIndexBuffer(), 0,
+                       m_scene.GetIndexType());
+
+  constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+  uint32_t objectCount = m_scene.GetObjectCount();
+  if (m_context.features12.drawIndirectCount) {
+    vkCmdDrawIndexedIndirectCount(commandBuffer, m_scene.GetDrawBuffer(), 0,
+                                  m_scene.GetDrawCountBuffer(), 0, objectCount,
+                                  stride);
+  } else if (m_context.features.multiDrawIndirect) {
+    vkCmdDrawIndexedIndirect(commandBuffer, m_scene.GetDrawBuffer(), 0,
+                             objectCount, stride);
+  } else {
+    // 不支持多重间接绘制时 drawCount 只能为 0 或 1，退化为逐对象录制
+    for (uint32_t i = 0; i < objectCount; i++) {
+      vkCmdDrawIndexedIndirect(commandBuffer, m_scene.GetDrawBuffer(),
+                               VkDeviceSize(i) * stride, 1, stride);
+    }
+  }
+}
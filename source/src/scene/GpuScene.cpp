@@ -0,0 +1,184 @@
+#include "Scene/GpuScene.hpp"
+
+#include "Vulkan/VkUtils.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+float maxAxisScale(const glm::mat4 &model) {
+  return std::sqrt(std::max({glm::dot(model[0], model[0]),
+                             glm::dot(model[1], model[1]),
+                             glm::dot(model[2], model[2])}));
+}
+} // namespace
+
+GpuScene::GpuScene(const VkContext &context, VkCommandPool commandPool,
+                   std::span<const MeshData> meshes,
+                   const GpuSceneConfig &config)
+    : m_context(context), m_config(config),
+      m_meshCount(static_cast<uint32_t>(meshes.size())),
+      m_frameVersions(config.framesInFlight, ~0ull) {
+  if (meshes.empty() || m_config.maxObjects == 0) {
+    LOG_ERROR("gpu scene has no meshes or objects!");
+    throw std::runtime_error("gpu scene has no meshes or objects!");
+  }
+
+  // 1. 合并几何：索引保持网格内的局部编号，由绘制命令的 vertexOffset 偏移，
+  // 因此只要单个网格的顶点数不超过 16 位就能使用 16 位索引
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  std::vector<GpuMeshInfo> meshInfos(m_meshCount);
+  size_t maxMeshVertices = 0;
+  for (uint32_t i = 0; i < m_meshCount; i++) {
+    const MeshData &mesh = meshes[i];
+    MeshBounds bounds = computeMeshBounds(mesh.vertices);
+    GpuMeshInfo &info = meshInfos[i];
+    info = {
+        .sphere = glm::vec4(bounds.center, bounds.radius),
+        .vertexOffset = static_cast<int32_t>(vertices.size()),
+    };
+
+    std::vector<MeshLod> lods = mesh.lods;
+    if (lods.empty()) {
+      lods.push_back({0, static_cast<uint32_t>(mesh.indices.size()), 0.0f});
+    }
+    info.lodCount = std::min<uint32_t>(static_cast<uint32_t>(lods.size()),
+                                       GPU_SCENE_MAX_LODS);
+    uint32_t baseIndex = static_cast<uint32_t>(indices.size());
+    for (uint32_t lod = 0; lod < info.lodCount; lod++) {
+      info.lods[lod] = {baseIndex + lods[lod].firstIndex, lods[lod].indexCount,
+                        lods[lod].error, 0};
+    }
+
+    vertices.insert(vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+    indices.insert(indices.end(), mesh.indices.begin(), mesh.indices.end());
+    maxMeshVertices = std::max(maxMeshVertices, mesh.vertices.size());
+  }
+
+  m_indexType = selectIndexType(maxMeshVertices);
+  uploadDeviceLocalBuffer(m_context, commandPool, vertices.data(),
+                          vertices.size() * sizeof(Vertex),
+                          VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, m_vertexBuffer,
+                          m_vertexMemory);
+  if (m_indexType == VK_INDEX_TYPE_UINT16) {
+    std::vector<uint16_t> narrowed(indices.begin(), indices.end());
+    uploadDeviceLocalBuffer(m_context, commandPool, narrowed.data(),
+                            narrowed.size() * sizeof(uint16_t),
+                            VK_BUFFER_USAGE_INDEX_BUFFER_BIT, m_indexBuffer,
+                            m_indexMemory);
+  } else {
+    uploadDeviceLocalBuffer(m_context, commandPool, indices.data(),
+                            indices.size() * sizeof(uint32_t),
+                            VK_BUFFER_USAGE_INDEX_BUFFER_BIT, m_indexBuffer,
+                            m_indexMemory);
+  }
+  uploadDeviceLocalBuffer(m_context, commandPool, meshInfos.data(),
+                          meshInfos.size() * sizeof(GpuMeshInfo),
+                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, m_meshBuffer,
+                          m_meshMemory);
+
+  // 2. 对象缓冲常驻映射，每帧一个分区，以动态偏移切换
+  VkDeviceSize alignment = std::max<VkDeviceSize>(
+      m_context.limits.minStorageBufferOffsetAlignment, 1);
+  m_objectStride = alignUp(GetObjectRange(), alignment);
+  if (m_objectStride * m_config.framesInFlight > UINT32_MAX) {
+    LOG_ERROR("gpu scene object buffer too large ({} objects)",
+              m_config.maxObjects);
+    throw std::runtime_error("gpu scene object buffer too large!");
+  }
+  createBuffer(m_context, m_objectStride * m_config.framesInFlight,
+               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+               m_objectBuffer, m_objectMemory);
+  vkMapMemory(m_context.device, m_objectMemory, 0, VK_WHOLE_SIZE, 0,
+              reinterpret_cast<void **>(&m_objectMapped));
+
+  // 3. 剔除输出：每个对象最多一条绘制命令
+  createBuffer(m_context,
+               VkDeviceSize(m_config.maxObjects) *
+                   sizeof(VkDrawIndexedIndirectCommand),
+               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                   VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_drawBuffer, m_drawMemory);
+  createBuffer(m_context, sizeof(uint32_t),
+               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                   VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                   VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_drawCountBuffer,
+               m_drawCountMemory);
+
+  // 4. 两阶段遮挡剔除记录的上一帧可见性，初始全部不可见
+  if (m_config.occlusionCulling) {
+    std::vector<uint32_t> visibility(m_config.maxObjects, 0);
+    uploadDeviceLocalBuffer(m_context, commandPool, visibility.data(),
+                            visibility.size() * sizeof(uint32_t),
+                            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                            m_visibilityBuffer, m_visibilityMemory);
+  }
+
+  m_objects.reserve(m_config.maxObjects);
+  LOG_INFO("gpu scene: {} meshes, {} vertices, {} indices, {} objects max",
+           m_meshCount, vertices.size(), indices.size(), m_config.maxObjects);
+}
+
+GpuScene::~GpuScene() {
+  vkUnmapMemory(m_context.device, m_objectMemory);
+  vkDestroyBuffer(m_context.device, m_visibilityBuffer, nullptr);
+  vkFreeMemory(m_context.device, m_visibilityMemory, nullptr);
+  vkDestroyBuffer(m_context.device, m_drawCountBuffer, nullptr);
+  vkFreeMemory(m_context.device, m_drawCountMemory, nullptr);
+  vkDestroyBuffer(m_context.device, m_drawBuffer, nullptr);
+  vkFreeMemory(m_context.device, m_drawMemory, nullptr);
+  vkDestroyBuffer(m_context.device, m_objectBuffer, nullptr);
+  vkFreeMemory(m_context.device, m_objectMemory, nullptr);
+  vkDestroyBuffer(m_context.device, m_meshBuffer, nullptr);
+  vkFreeMemory(m_context.device, m_meshMemory, nullptr);
+  vkDestroyBuffer(m_context.device, m_indexBuffer, nullptr);
+  vkFreeMemory(m_context.device, m_indexMemory, nullptr);
+  vkDestroyBuffer(m_context.device, m_vertexBuffer, nullptr);
+  vkFreeMemory(m_context.device, m_vertexMemory, nullptr);
+}
+
+uint32_t GpuScene::AddObject(uint32_t meshIndex, const glm::mat4 &model) {
+  if (meshIndex >= m_meshCount) {
+    LOG_ERROR("gpu scene mesh index {} out of range", meshIndex);
+    throw std::runtime_error("gpu scene mesh index out of range!");
+  }
+  if (m_objects.size() >= m_config.maxObjects) {
+    LOG_ERROR("gpu scene object limit {} reached", m_config.maxObjects);
+    throw std::runtime_error("gpu scene object limit reached!");
+  }
+  m_objects.push_back({model, meshIndex, maxAxisScale(model), {}});
+  m_objectVersion++;
+  return static_cast<uint32_t>(m_objects.size() - 1);
+}
+
+void GpuScene::SetTransform(uint32_t object, const glm::mat4 &model) {
+  if (object >= m_objects.size()) {
+    LOG_ERROR("gpu scene object {} out of range ({} objects)", object,
+              m_objects.size());
+    throw std::runtime_error("gpu scene object out of range!");
+  }
+  m_objects[object].model = model;
+  m_objects[object].maxScale = maxAxisScale(model);
+  m_objectVersion++;
+}
+
+void GpuScene::BeginFrame(uint64_t frameIndex) {
+  uint32_t slot = static_cast<uint32_t>(frameIndex % m_config.framesInFlight);
+  m_objectOffset = static_cast<uint32_t>(slot * m_objectStride);
+  if (m_frameVersions[slot] != m_objectVersion) {
+    std::memcpy(m_objectMapped + m_objectOffset, m_objects.data(),
+                m_objects.size() * sizeof(GpuObject));
+    m_frameVersions[slot] = m_objectVersion;
+  }
+}
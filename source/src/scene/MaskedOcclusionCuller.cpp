@@ -0,0 +1,612 @@
+#include "Scene/MaskedOcclusionCuller.hpp"
+
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||            \
+    defined(_M_IX86)
+#define OCCLUSION_X86 1
+#include <immintrin.h>
+#else
+#define OCCLUSION_X86 0
+#endif
+
+// 与 FrustumCuller.cpp 相同：GCC/Clang 按函数开启指令集，调用前已做运行时检测
+#if OCCLUSION_X86 && !(defined(_MSC_VER) && !defined(__clang__))
+#define OCCLUSION_TARGET_SSE2 __attribute__((target("sse2")))
+#define OCCLUSION_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define OCCLUSION_TARGET_SSE2
+#define OCCLUSION_TARGET_AVX2
+#endif
+
+namespace {
+using Triangle = MaskedOcclusionCuller::Triangle;
+
+constexpr uint32_t TILE_WIDTH = MaskedOcclusionCuller::TILE_WIDTH;
+constexpr uint32_t TILE_HEIGHT = MaskedOcclusionCuller::TILE_HEIGHT;
+constexpr uint32_t FULL_ROW = 0xFFFFFFFFu;
+// 缺少的左 / 右边界用一条极远的竖直线代替，避免 inf * 0
+constexpr float FAR_EDGE = 1e30f;
+constexpr float MIN_DOUBLE_AREA = 1e-6f;
+constexpr float MIN_EDGE_HEIGHT = 1e-6f;
+
+// 块内第 l ~ r 列的位掩码，l 在 [0, 32]，r 在 [-1, 31]
+inline uint32_t spanMask(int32_t l, int32_t r) {
+  if (l > r) {
+    return 0;
+  }
+  return (FULL_ROW << l) & (FULL_ROW >> (31 - r));
+}
+
+uint32_t roundUp(uint32_t value, uint32_t multiple) {
+  return std::max((value + multiple - 1) / multiple, 1u) * multiple;
+}
+
+// 以下内核求三角形在一个块内逐行的覆盖掩码，返回是否有覆盖。
+// 像素中心落在 [xl, xr] 内即视为覆盖，xl / xr 先换算到块内并钳制，
+// 这样 ceil / floor 的结果直接落在合法的移位范围内
+bool rasterizeTileScalar(const Triangle &triangle, uint32_t tileX,
+                         uint32_t tileY, uint32_t rowMasks[TILE_HEIGHT]) {
+  float tileLeft = float(tileX * TILE_WIDTH) + 0.5f;
+  float rowY = float(tileY * TILE_HEIGHT) + 0.5f;
+  uint32_t any = 0;
+  for (uint32_t row = 0; row < TILE_HEIGHT; row++, rowY += 1.0f) {
+    if (rowY < triangle.minY || rowY > triangle.maxY) {
+      rowMasks[row] = 0;
+      continue;
+    }
+    float xl = std::max(triangle.leftOffset[0] + triangle.leftSlope[0] * rowY,
+                        triangle.leftOffset[1] + triangle.leftSlope[1] * rowY);
+    float xr =
+        std::min(triangle.rightOffset[0] + triangle.rightSlope[0] * rowY,
+                 triangle.rightOffset[1] + triangle.rightSlope[1] * rowY);
+    int32_t l = int32_t(std::ceil(std::clamp(xl - tileLeft, 0.0f, 32.0f)));
+    int32_t r = int32_t(std::floor(std::clamp(xr - tileLeft, -1.0f, 31.0f)));
+    rowMasks[row] = spanMask(l, r);
+    any |= rowMasks[row];
+  }
+  return any != 0;
+}
+
+#if OCCLUSION_X86
+// SSE2 没有 ceil / floor 与逐 lane 移位：钳制后的值加上偏移再截断得到 floor，
+// 掩码在标量中拼出。一次处理 4 行
+OCCLUSION_TARGET_SSE2
+bool rasterizeTileSse2(const Triangle &triangle, uint32_t tileX,
+                       uint32_t tileY, uint32_t rowMasks[TILE_HEIGHT]) {
+  const __m128 bias = _mm_set1_ps(64.0f);
+  const __m128i biasInt = _mm_set1_epi32(64);
+  __m128 tileLeft = _mm_set1_ps(float(tileX * TILE_WIDTH) + 0.5f);
+  uint32_t any = 0;
+  for (uint32_t half = 0; half < TILE_HEIGHT; half += 4) {
+    float firstY = float(tileY * TILE_HEIGHT + half) + 0.5f;
+    __m128 y = _mm_add_ps(_mm_set1_ps(firstY), _mm_setr_ps(0, 1, 2, 3));
+
+    __m128 xl = _mm_max_ps(
+        _mm_add_ps(_mm_set1_ps(triangle.leftOffset[0]),
+                   _mm_mul_ps(_mm_set1_ps(triangle.leftSlope[0]), y)),
+        _mm_add_ps(_mm_set1_ps(triangle.leftOffset[1]),
+                   _mm_mul_ps(_mm_set1_ps(triangle.leftSlope[1]), y)));
+    __m128 xr = _mm_min_ps(
+        _mm_add_ps(_mm_set1_ps(triangle.rightOffset[0]),
+                   _mm_mul_ps(_mm_set1_ps(triangle.rightSlope[0]), y)),
+        _mm_add_ps(_mm_set1_ps(triangle.rightOffset[1]),
+                   _mm_mul_ps(_mm_set1_ps(triangle.rightSlope[1]), y)));
+    xl = _mm_min_ps(_mm_max_ps(_mm_sub_ps(xl, tileLeft), _mm_setzero_ps()),
+                    _mm_set1_ps(32.0f));
+    xr = _mm_min_ps(_mm_max_ps(_mm_sub_ps(xr, tileLeft), _mm_set1_ps(-1.0f)),
+                    _mm_set1_ps(31.0f));
+
+    // ceil(v) = 64 - floor(64 - v)，floor(v) = trunc(v + 64) - 64
+    alignas(16) int32_t l[4], r[4];
+    _mm_store_si128(reinterpret_cast<__m128i *>(l),
+                    _mm_sub_epi32(biasInt, _mm_cvttps_epi32(
+                                               _mm_sub_ps(bias, xl))));
+    _mm_store_si128(
+        reinterpret_cast<__m128i *>(r),
+        _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(xr, bias)), biasInt));
+    int rowValid = _mm_movemask_ps(
+        _mm_and_ps(_mm_cmpge_ps(y, _mm_set1_ps(triangle.minY)),
+                   _mm_cmple_ps(y, _mm_set1_ps(triangle.maxY))));
+
+    for (uint32_t lane = 0; lane < 4; lane++) {
+      uint32_t mask = (rowValid >> lane) & 1 ? spanMask(l[lane], r[lane]) : 0;
+      rowMasks[half + lane] = mask;
+      any |= mask;
+    }
+  }
+  return any != 0;
+}
+
+// AVX2：8 行正好是一个块，变长移位直接得到掩码（移位量 >= 32 时结果为 0）
+OCCLUSION_TARGET_AVX2
+bool rasterizeTileAvx2(const Triangle &triangle, uint32_t tileX,
+                       uint32_t tileY, uint32_t rowMasks[TILE_HEIGHT]) {
+  float firstY = float(tileY * TILE_HEIGHT) + 0.5f;
+  __m256 y = _mm256_add_ps(_mm256_set1_ps(firstY),
+                           _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7));
+  __m256 tileLeft = _mm256_set1_ps(float(tileX * TILE_WIDTH) + 0.5f);
+
+  __m256 xl = _mm256_max_ps(
+      _mm256_fmadd_ps(_mm256_set1_ps(triangle.leftSlope[0]), y,
+                      _mm256_set1_ps(triangle.leftOffset[0])),
+      _mm256_fmadd_ps(_mm256_set1_ps(triangle.leftSlope[1]), y,
+                      _mm256_set1_ps(triangle.leftOffset[1])));
+  __m256 xr = _mm256_min_ps(
+      _mm256_fmadd_ps(_mm256_set1_ps(triangle.rightSlope[0]), y,
+                      _mm256_set1_ps(triangle.rightOffset[0])),
+      _mm256_fmadd_ps(_mm256_set1_ps(triangle.rightSlope[1]), y,
+                      _mm256_set1_ps(triangle.rightOffset[1])));
+  xl = _mm256_min_ps(
+      _mm256_max_ps(_mm256_sub_ps(xl, tileLeft), _mm256_setzero_ps()),
+      _mm256_set1_ps(32.0f));
+  xr = _mm256_min_ps(
+      _mm256_max_ps(_mm256_sub_ps(xr, tileLeft), _mm256_set1_ps(-1.0f)),
+      _mm256_set1_ps(31.0f));
+  __m256i l = _mm256_cvttps_epi32(_mm256_ceil_ps(xl));
+  __m256i r = _mm256_cvttps_epi32(_mm256_floor_ps(xr));
+
+  const __m256i ones = _mm256_set1_epi32(-1);
+  __m256i leftMask = _mm256_sllv_epi32(ones, l);
+  __m256i rightMask =
+      _mm256_srlv_epi32(ones, _mm256_sub_epi32(_mm256_set1_epi32(31), r));
+  __m256 rowValid =
+      _mm256_and_ps(_mm256_cmp_ps(y, _mm256_set1_ps(triangle.minY), _CMP_GE_OQ),
+                    _mm256_cmp_ps(y, _mm256_set1_ps(triangle.maxY), _CMP_LE_OQ));
+  __m256i masks = _mm256_and_si256(_mm256_and_si256(leftMask, rightMask),
+                                   _mm256_castps_si256(rowValid));
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(rowMasks), masks);
+  return !_mm256_testz_si256(masks, masks);
+}
+#endif
+
+// 三角形在块内（与其包围盒的交集）的最大深度：平面的最大值在矩形角点处取得，
+// 外插的平面可能超过顶点深度，再与顶点最大深度取较小者
+float tileDepth(const Triangle &triangle, uint32_t tileX, uint32_t tileY) {
+  float x0 = std::max(float(tileX * TILE_WIDTH), triangle.minX);
+  float x1 = std::min(float((tileX + 1) * TILE_WIDTH), triangle.maxX);
+  float y0 = std::max(float(tileY * TILE_HEIGHT), triangle.minY);
+  float y1 = std::min(float((tileY + 1) * TILE_HEIGHT), triangle.maxY);
+  float x = triangle.zA > 0.0f ? x1 : x0;
+  float y = triangle.zB > 0.0f ? y1 : y0;
+  return std::min(triangle.zA * x + triangle.zB * y + triangle.zC,
+                  triangle.zMax);
+}
+
+// 近平面（深度范围 [0, 1]，z >= 0）裁剪，返回顶点数（0、3 或 4）
+uint32_t clipNearPlane(const glm::vec4 in[3], glm::vec4 out[4]) {
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < 3; i++) {
+    const glm::vec4 &a = in[i];
+    const glm::vec4 &b = in[(i + 1) % 3];
+    if (a.z >= 0.0f) {
+      out[count++] = a;
+    }
+    if ((a.z >= 0.0f) != (b.z >= 0.0f)) {
+      float t = a.z / (a.z - b.z);
+      out[count++] = a + (b - a) * t;
+    }
+  }
+  return count;
+}
+} // namespace
+
+MaskedOcclusionCuller::MaskedOcclusionCuller(
+    const MaskedOcclusionConfig &config, ThreadPool &threadPool,
+    SimdLevel level)
+    : m_threadPool(threadPool), m_level(level),
+      m_width(roundUp(config.width, TILE_WIDTH)),
+      m_height(roundUp(config.height, TILE_HEIGHT)),
+      m_tilesX(m_width / TILE_WIDTH), m_tilesY(m_height / TILE_HEIGHT) {
+  uint32_t tileCount = m_tilesX * m_tilesY;
+  m_zMax0.resize(tileCount);
+  m_zMax1.resize(tileCount);
+  m_masks.resize(size_t(tileCount) * TILE_HEIGHT);
+  BeginFrame(glm::mat4(1.0f));
+  LOG_INFO("masked occlusion culler: {}x{} ({} tiles), {}", m_width, m_height,
+           tileCount, simdLevelName(m_level));
+}
+
+void MaskedOcclusionCuller::BeginFrame(const glm::mat4 &viewProjection) {
+  m_viewProjection = viewProjection;
+  std::fill(m_zMax0.begin(), m_zMax0.end(), 1.0f);
+  std::fill(m_zMax1.begin(), m_zMax1.end(), 0.0f);
+  std::fill(m_masks.begin(), m_masks.end(), 0u);
+  m_triangleCount = 0;
+}
+
+void MaskedOcclusionCuller::RenderOccluders(
+    std::span<const OccluderMesh> occluders) {
+  // 1. 所有遮挡体的顶点变换到裁剪空间
+  transformVertices(occluders);
+
+  // 2. 按三角形分批：裁剪、建立边方程并分箱
+  m_jobCount = 0;
+  for (uint32_t occluder = 0; occluder < occluders.size(); occluder++) {
+    uint32_t triangleCount =
+        static_cast<uint32_t>(occluders[occluder].indices.size() / 3);
+    for (uint32_t first = 0; first < triangleCount; first += JOB_TRIANGLES) {
+      if (m_jobCount == m_jobs.size()) {
+        m_jobs.emplace_back();
+      }
+      TriangleJob &job = m_jobs[m_jobCount++];
+      job.occluder = occluder;
+      job.firstTriangle = first;
+      job.triangleCount = std::min(JOB_TRIANGLES, triangleCount - first);
+    }
+  }
+  m_threadPool.ParallelFor(m_jobCount, 1, [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; i++) {
+      setupTriangles(occluders[m_jobs[i].occluder], m_jobs[i]);
+    }
+  });
+  for (uint32_t i = 0; i < m_jobCount; i++) {
+    m_triangleCount += static_cast<uint32_t>(m_jobs[i].triangles.size());
+  }
+
+  // 3. 每个箱独占自己的块，按批次顺序光栅化
+  m_threadPool.ParallelFor(BIN_COLUMNS * BIN_ROWS, 1,
+                           [&](size_t first, size_t last) {
+                             for (size_t bin = first; bin < last; bin++) {
+                               rasterizeBin(static_cast<uint32_t>(bin));
+                             }
+                           });
+}
+
+void MaskedOcclusionCuller::transformVertices(
+    std::span<const OccluderMesh> occluders) {
+  m_vertexOffsets.resize(occluders.size() + 1);
+  uint32_t total = 0;
+  for (size_t i = 0; i < occluders.size(); i++) {
+    m_vertexOffsets[i] = total;
+    total += static_cast<uint32_t>(occluders[i].vertices.size());
+  }
+  m_vertexOffsets.back() = total;
+  m_clipVertices.resize(total);
+
+  m_threadPool.ParallelFor(total, 4096, [&](size_t first, size_t last) {
+    // 批次起点所在的遮挡体，之后顺序前进
+    size_t occluder = std::upper_bound(m_vertexOffsets.begin(),
+                                       m_vertexOffsets.end() - 1, first) -
+                      m_vertexOffsets.begin() - 1;
+    glm::mat4 clipFromObject =
+        m_viewProjection * occluders[occluder].model;
+    for (size_t i = first; i < last; i++) {
+      while (i >= m_vertexOffsets[occluder + 1]) {
+        occluder++;
+        clipFromObject = m_viewProjection * occluders[occluder].model;
+      }
+      const Vertex &vertex =
+          occluders[occluder].vertices[i - m_vertexOffsets[occluder]];
+      m_clipVertices[i] = clipFromObject * glm::vec4(vertex.position, 1.0f);
+    }
+  });
+}
+
+void MaskedOcclusionCuller::setupTriangles(const OccluderMesh &occluder,
+                                           TriangleJob &job) const {
+  job.triangles.clear();
+  for (std::vector<uint32_t> &bin : job.binned) {
+    bin.clear();
+  }
+
+  const glm::vec4 *vertices =
+      m_clipVertices.data() + m_vertexOffsets[job.occluder];
+  uint32_t vertexCount = static_cast<uint32_t>(occluder.vertices.size());
+  const uint32_t *indices = occluder.indices.data() + job.firstTriangle * 3;
+  for (uint32_t i = 0; i < job.triangleCount; i++, indices += 3) {
+    if (indices[0] >= vertexCount || indices[1] >= vertexCount ||
+        indices[2] >= vertexCount) {
+      continue;
+    }
+    glm::vec4 clip[3] = {vertices[indices[0]], vertices[indices[1]],
+                         vertices[indices[2]]};
+
+    // 三个顶点都在同一个视锥平面之外时整体丢弃
+    auto allOutside = [&](auto &&outside) {
+      return outside(clip[0]) && outside(clip[1]) && outside(clip[2]);
+    };
+    if (allOutside([](const glm::vec4 &v) { return v.x > v.w; }) ||
+        allOutside([](const glm::vec4 &v) { return v.x < -v.w; }) ||
+        allOutside([](const glm::vec4 &v) { return v.y > v.w; }) ||
+        allOutside([](const glm::vec4 &v) { return v.y < -v.w; }) ||
+        allOutside([](const glm::vec4 &v) { return v.z > v.w; }) ||
+        allOutside([](const glm::vec4 &v) { return v.z < 0.0f; })) {
+      continue;
+    }
+
+    if (clip[0].z >= 0.0f && clip[1].z >= 0.0f && clip[2].z >= 0.0f) {
+      emitTriangle(clip, job);
+      continue;
+    }
+    glm::vec4 polygon[4];
+    uint32_t count = clipNearPlane(clip, polygon);
+    for (uint32_t k = 2; k < count; k++) {
+      glm::vec4 fan[3] = {polygon[0], polygon[k - 1], polygon[k]};
+      emitTriangle(fan, job);
+    }
+  }
+}
+
+void MaskedOcclusionCuller::emitTriangle(const glm::vec4 clip[3],
+                                         TriangleJob &job) const {
+  // 1. 投影到像素坐标（y 与 NDC 同向，和查询时一致）
+  glm::vec3 v[3];
+  for (int i = 0; i < 3; i++) {
+    float invW = 1.0f / clip[i].w;
+    v[i] = glm::vec3((clip[i].x * invW * 0.5f + 0.5f) * float(m_width),
+                     (clip[i].y * invW * 0.5f + 0.5f) * float(m_height),
+                     clip[i].z * invW);
+  }
+  float doubleArea = (v[1].x - v[0].x) * (v[2].y - v[0].y) -
+                     (v[1].y - v[0].y) * (v[2].x - v[0].x);
+  if (std::abs(doubleArea) < MIN_DOUBLE_AREA) {
+    return;
+  }
+  // 两种绕序都光栅化，统一为正面积
+  if (doubleArea < 0.0f) {
+    std::swap(v[1], v[2]);
+    doubleArea = -doubleArea;
+  }
+
+  Triangle triangle;
+  triangle.minX = std::min({v[0].x, v[1].x, v[2].x});
+  triangle.maxX = std::max({v[0].x, v[1].x, v[2].x});
+  triangle.minY = std::min({v[0].y, v[1].y, v[2].y});
+  triangle.maxY = std::max({v[0].y, v[1].y, v[2].y});
+
+  // 2. 覆盖的像素中心范围，完全落在像素中心之间的三角形不产生覆盖
+  float pixelX0 = std::max(std::ceil(triangle.minX - 0.5f), 0.0f);
+  float pixelX1 = std::min(std::floor(triangle.maxX - 0.5f), float(m_width - 1));
+  float pixelY0 = std::max(std::ceil(triangle.minY - 0.5f), 0.0f);
+  float pixelY1 =
+      std::min(std::floor(triangle.maxY - 0.5f), float(m_height - 1));
+  if (pixelX0 > pixelX1 || pixelY0 > pixelY1) {
+    return;
+  }
+  triangle.tileX0 = static_cast<uint16_t>(uint32_t(pixelX0) / TILE_WIDTH);
+  triangle.tileX1 = static_cast<uint16_t>(uint32_t(pixelX1) / TILE_WIDTH);
+  triangle.tileY0 = static_cast<uint16_t>(uint32_t(pixelY0) / TILE_HEIGHT);
+  triangle.tileY1 = static_cast<uint16_t>(uint32_t(pixelY1) / TILE_HEIGHT);
+
+  // 3. 边 a -> b 的内侧满足 A * x + B * y + C >= 0；A > 0 为左边界，A < 0 为右边界，
+  //    水平边已由 minY / maxY 限定
+  uint32_t leftCount = 0, rightCount = 0;
+  for (int i = 0; i < 3; i++) {
+    const glm::vec3 &a = v[i];
+    const glm::vec3 &b = v[(i + 1) % 3];
+    float edgeA = a.y - b.y;
+    if (std::abs(edgeA) < MIN_EDGE_HEIGHT) {
+      continue;
+    }
+    float slope = (b.x - a.x) / (b.y - a.y);
+    float offset = a.x - a.y * slope;
+    if (edgeA > 0.0f) {
+      triangle.leftOffset[leftCount] = offset;
+      triangle.leftSlope[leftCount++] = slope;
+    } else {
+      triangle.rightOffset[rightCount] = offset;
+      triangle.rightSlope[rightCount++] = slope;
+    }
+  }
+  for (; leftCount < 2; leftCount++) {
+    triangle.leftOffset[leftCount] = -FAR_EDGE;
+    triangle.leftSlope[leftCount] = 0.0f;
+  }
+  for (; rightCount < 2; rightCount++) {
+    triangle.rightOffset[rightCount] = FAR_EDGE;
+    triangle.rightSlope[rightCount] = 0.0f;
+  }
+
+  // 4. 深度平面
+  glm::vec3 d1 = v[1] - v[0];
+  glm::vec3 d2 = v[2] - v[0];
+  triangle.zA = (d1.z * d2.y - d1.y * d2.z) / doubleArea;
+  triangle.zB = (d1.x * d2.z - d1.z * d2.x) / doubleArea;
+  triangle.zC = v[0].z - triangle.zA * v[0].x - triangle.zB * v[0].y;
+  triangle.zMax = std::max({v[0].z, v[1].z, v[2].z});
+
+  // 5. 分箱
+  uint32_t binTilesX = (m_tilesX + BIN_COLUMNS - 1) / BIN_COLUMNS;
+  uint32_t binTilesY = (m_tilesY + BIN_ROWS - 1) / BIN_ROWS;
+  uint32_t index = static_cast<uint32_t>(job.triangles.size());
+  job.triangles.push_back(triangle);
+  for (uint32_t binY = triangle.tileY0 / binTilesY;
+       binY <= triangle.tileY1 / binTilesY; binY++) {
+    for (uint32_t binX = triangle.tileX0 / binTilesX;
+         binX <= triangle.tileX1 / binTilesX; binX++) {
+      job.binned[binY * BIN_COLUMNS + binX].push_back(index);
+    }
+  }
+}
+
+void MaskedOcclusionCuller::rasterizeBin(uint32_t bin) {
+  uint32_t binTilesX = (m_tilesX + BIN_COLUMNS - 1) / BIN_COLUMNS;
+  uint32_t binTilesY = (m_tilesY + BIN_ROWS - 1) / BIN_ROWS;
+  uint32_t binX0 = (bin % BIN_COLUMNS) * binTilesX;
+  uint32_t binY0 = (bin / BIN_COLUMNS) * binTilesY;
+  uint32_t binX1 = std::min(binX0 + binTilesX, m_tilesX);
+  uint32_t binY1 = std::min(binY0 + binTilesY, m_tilesY);
+  if (binX0 >= binX1 || binY0 >= binY1) {
+    return;
+  }
+
+  auto kernel = rasterizeTileScalar;
+#if OCCLUSION_X86
+  if (m_level == SimdLevel::Avx2) {
+    kernel = rasterizeTileAvx2;
+  } else if (m_level == SimdLevel::Sse2) {
+    kernel = rasterizeTileSse2;
+  }
+#endif
+
+  alignas(32) uint32_t rowMasks[TILE_HEIGHT];
+  for (uint32_t j = 0; j < m_jobCount; j++) {
+    const TriangleJob &job = m_jobs[j];
+    for (uint32_t index : job.binned[bin]) {
+      const Triangle &triangle = job.triangles[index];
+      uint32_t tileX0 = std::max<uint32_t>(triangle.tileX0, binX0);
+      uint32_t tileX1 = std::min<uint32_t>(triangle.tileX1 + 1u, binX1);
+      uint32_t tileY0 = std::max<uint32_t>(triangle.tileY0, binY0);
+      uint32_t tileY1 = std::min<uint32_t>(triangle.tileY1 + 1u, binY1);
+      for (uint32_t tileY = tileY0; tileY < tileY1; tileY++) {
+        for (uint32_t tileX = tileX0; tileX < tileX1; tileX++) {
+          uint32_t tile = tileY * m_tilesX + tileX;
+          float depth = tileDepth(triangle, tileX, tileY);
+          // 整块已被更近的几何覆盖，不会带来新的遮挡信息
+          if (depth >= m_zMax0[tile]) {
+            continue;
+          }
+          if (kernel(triangle, tileX, tileY, rowMasks)) {
+            updateTile(tile, rowMasks, depth);
+          }
+        }
+      }
+    }
+  }
+}
+
+void MaskedOcclusionCuller::updateTile(uint32_t tile,
+                                       const uint32_t rowMasks[TILE_HEIGHT],
+                                       float depth) {
+  uint32_t *masks = m_masks.data() + size_t(tile) * TILE_HEIGHT;
+  float &zMax0 = m_zMax0[tile];
+  float &zMax1 = m_zMax1[tile];
+
+  // 新三角形比工作层更接近 zMax0 时，丢弃工作层，避免它的上界被拉得过远
+  if (depth - zMax1 > zMax0 - depth) {
+    zMax1 = 0.0f;
+    std::memset(masks, 0, TILE_HEIGHT * sizeof(uint32_t));
+  }
+
+  zMax1 = std::max(zMax1, depth);
+  uint32_t full = FULL_ROW;
+  for (uint32_t row = 0; row < TILE_HEIGHT; row++) {
+    masks[row] |= rowMasks[row];
+    full &= masks[row];
+  }
+
+  // 工作层覆盖满整块，成为新的 zMax0
+  if (full == FULL_ROW) {
+    zMax0 = zMax1;
+    zMax1 = 0.0f;
+    std::memset(masks, 0, TILE_HEIGHT * sizeof(uint32_t));
+  }
+}
+
+bool MaskedOcclusionCuller::IsVisible(const glm::vec3 &center,
+                                      const glm::vec3 &extent) const {
+  // 1. 8 个角点投影，求屏幕矩形与最近深度
+  glm::vec4 clipCenter = m_viewProjection * glm::vec4(center, 1.0f);
+  glm::vec4 axisX = m_viewProjection[0] * extent.x;
+  glm::vec4 axisY = m_viewProjection[1] * extent.y;
+  glm::vec4 axisZ = m_viewProjection[2] * extent.z;
+  glm::vec2 rectMin(1.0f), rectMax(-1.0f);
+  float closest = 1.0f;
+  for (int i = 0; i < 8; i++) {
+    glm::vec4 corner = clipCenter + (i & 1 ? axisX : -axisX) +
+                       (i & 2 ? axisY : -axisY) + (i & 4 ? axisZ : -axisZ);
+    if (corner.z < 0.0f || corner.w <= 0.0f) {
+      return true;
+    }
+    glm::vec3 ndc = glm::vec3(corner) / corner.w;
+    rectMin = glm::min(rectMin, glm::vec2(ndc.x, ndc.y));
+    rectMax = glm::max(rectMax, glm::vec2(ndc.x, ndc.y));
+    closest = std::min(closest, ndc.z);
+  }
+
+  // 2. 与矩形有交集的像素（不只是像素中心），钳制到缓冲内
+  float scaleX = 0.5f * float(m_width), scaleY = 0.5f * float(m_height);
+  int32_t pixelX0 = std::max(int32_t(std::floor((rectMin.x + 1.0f) * scaleX)), 0);
+  int32_t pixelX1 = std::min(int32_t(std::ceil((rectMax.x + 1.0f) * scaleX)) - 1,
+                             int32_t(m_width) - 1);
+  int32_t pixelY0 = std::max(int32_t(std::floor((rectMin.y + 1.0f) * scaleY)), 0);
+  int32_t pixelY1 = std::min(
+      int32_t(std::ceil((rectMax.y + 1.0f) * scaleY)) - 1, int32_t(m_height) - 1);
+  if (pixelX0 > pixelX1 || pixelY0 > pixelY1) {
+    // 完全在屏幕外由视锥剔除负责，这里不做判断
+    return true;
+  }
+
+  // 3. 逐块比较：先用 zMax0 整块判断，再逐行区分工作层内外的像素
+  for (int32_t tileY = pixelY0 / int32_t(TILE_HEIGHT);
+       tileY <= pixelY1 / int32_t(TILE_HEIGHT); tileY++) {
+    int32_t rowBegin = std::max(pixelY0 - tileY * int32_t(TILE_HEIGHT), 0);
+    int32_t rowEnd =
+        std::min(pixelY1 - tileY * int32_t(TILE_HEIGHT), int32_t(TILE_HEIGHT) - 1);
+    for (int32_t tileX = pixelX0 / int32_t(TILE_WIDTH);
+         tileX <= pixelX1 / int32_t(TILE_WIDTH); tileX++) {
+      uint32_t tile = uint32_t(tileY) * m_tilesX + uint32_t(tileX);
+      if (closest >= m_zMax0[tile]) {
+        continue;
+      }
+      uint32_t columns = spanMask(
+          std::max(pixelX0 - tileX * int32_t(TILE_WIDTH), 0),
+          std::min(pixelX1 - tileX * int32_t(TILE_WIDTH), int32_t(TILE_WIDTH) - 1));
+      bool beforeWorkingLayer = closest < m_zMax1[tile];
+      const uint32_t *masks = m_masks.data() + size_t(tile) * TILE_HEIGHT;
+      for (int32_t row = rowBegin; row <= rowEnd; row++) {
+        uint32_t covered = masks[row] & columns;
+        if ((columns & ~covered) != 0 || (covered != 0 && beforeWorkingLayer)) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+void MaskedOcclusionCuller::FilterVisible(const CullingBounds &bounds,
+                                          std::vector<uint32_t> &visible) {
+  uint32_t count = static_cast<uint32_t>(visible.size());
+  uint32_t chunkCount = (count + TEST_CHUNK_SIZE - 1) / TEST_CHUNK_SIZE;
+  const float *cx = bounds.GetCenterX(), *cy = bounds.GetCenterY(),
+              *cz = bounds.GetCenterZ();
+  const float *ex = bounds.GetExtentX(), *ey = bounds.GetExtentY(),
+              *ez = bounds.GetExtentZ();
+
+  // 1. 每块在自己的区间内就地压缩
+  m_chunkCounts.resize(chunkCount);
+  m_threadPool.ParallelFor(chunkCount, 1, [&](size_t first, size_t last) {
+    for (size_t chunk = first; chunk < last; chunk++) {
+      uint32_t begin = static_cast<uint32_t>(chunk) * TEST_CHUNK_SIZE;
+      uint32_t end = std::min(begin + TEST_CHUNK_SIZE, count);
+      uint32_t kept = begin;
+      for (uint32_t i = begin; i < end; i++) {
+        uint32_t object = visible[i];
+        if (IsVisible(glm::vec3(cx[object], cy[object], cz[object]),
+                      glm::vec3(ex[object], ey[object], ez[object]))) {
+          visible[kept++] = object;
+        }
+      }
+      m_chunkCounts[chunk] = kept - begin;
+    }
+  });
+
+  // 2. 各块的结果依次前移
+  uint32_t total = 0;
+  for (uint32_t chunk = 0; chunk < chunkCount; chunk++) {
+    std::memmove(visible.data() + total,
+                 visible.data() + size_t(chunk) * TEST_CHUNK_SIZE,
+                 m_chunkCounts[chunk] * sizeof(uint32_t));
+    total += m_chunkCounts[chunk];
+  }
+  visible.resize(total);
+}
+
+void MaskedOcclusionCuller::ResolveDepth(std::vector<float> &depth) const {
+  depth.resize(size_t(m_width) * m_height);
+  for (uint32_t y = 0; y < m_height; y++) {
+    for (uint32_t x = 0; x < m_width; x++) {
+      uint32_t tile = (y / TILE_HEIGHT) * m_tilesX + x / TILE_WIDTH;
+      uint32_t mask = m_masks[size_t(tile) * TILE_HEIGHT + y % TILE_HEIGHT];
+      bool inWorkingLayer = (mask >> (x % TILE_WIDTH)) & 1;
+      depth[size_t(y) * m_width + x] =
+          inWorkingLayer ? m_zMax1[tile] : m_zMax0[tile];
+    }
+  }
+}
@@ -0,0 +1,626 @@
+#include "Scene/SceneBvh.hpp"
+
+#include "Scene/Frustum.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+using Node = SceneBvh::Node;
+
+constexpr uint32_t WIDTH = SceneBvh::WIDTH;
+constexpr uint32_t BIN_COUNT = SceneBvh::BIN_COUNT;
+// SAH 代价中遍历一个节点与测试一个对象的相对开销
+constexpr float TRAVERSAL_COST = 1.0f;
+constexpr float INTERSECT_COST = 1.0f;
+// 分箱并行统计时每个批次的最小对象数
+constexpr size_t BIN_BATCH_SIZE = 8192;
+
+struct Bin {
+  Aabb bounds;
+  Aabb centroids;
+  uint32_t count = 0;
+};
+
+Node makeEmptyNode() {
+  Node node;
+  for (uint32_t slot = 0; slot < WIDTH; slot++) {
+    node.minX[slot] = node.minY[slot] = node.minZ[slot] =
+        std::numeric_limits<float>::max();
+    node.maxX[slot] = node.maxY[slot] = node.maxZ[slot] =
+        -std::numeric_limits<float>::max();
+    node.index[slot] = SceneBvh::EMPTY_CHILD;
+    node.count[slot] = 0;
+  }
+  return node;
+}
+
+void setSlotBounds(Node &node, uint32_t slot, const Aabb &bounds) {
+  node.minX[slot] = bounds.min.x;
+  node.minY[slot] = bounds.min.y;
+  node.minZ[slot] = bounds.min.z;
+  node.maxX[slot] = bounds.max.x;
+  node.maxY[slot] = bounds.max.y;
+  node.maxZ[slot] = bounds.max.z;
+}
+
+Aabb slotBounds(const Node &node, uint32_t slot) {
+  return {{node.minX[slot], node.minY[slot], node.minZ[slot]},
+          {node.maxX[slot], node.maxY[slot], node.maxZ[slot]}};
+}
+
+Aabb nodeBounds(const Node &node) {
+  Aabb bounds;
+  for (uint32_t slot = 0; slot < WIDTH; slot++) {
+    if (node.index[slot] != SceneBvh::EMPTY_CHILD) {
+      bounds.Expand(slotBounds(node, slot));
+    }
+  }
+  return bounds;
+}
+
+// 射线进入包围盒的距离，未命中或超过 maxDistance 时返回负数
+float rayBoxEntry(const glm::vec3 &origin, const glm::vec3 &inverseDirection,
+                  const glm::vec3 &min, const glm::vec3 &max,
+                  float maxDistance) {
+  glm::vec3 t0 = (min - origin) * inverseDirection;
+  glm::vec3 t1 = (max - origin) * inverseDirection;
+  glm::vec3 near = glm::min(t0, t1);
+  glm::vec3 far = glm::max(t0, t1);
+  float entry = std::max({near.x, near.y, near.z, 0.0f});
+  float exit = std::min({far.x, far.y, far.z, maxDistance});
+  return entry <= exit ? entry : -1.0f;
+}
+} // namespace
+
+SceneBvh::SceneBvh(ThreadPool &threadPool) : m_threadPool(threadPool) {}
+
+SceneBvh::Range SceneBvh::makeRange(uint32_t begin, uint32_t end,
+                                    bool parallel) const {
+  Range range = {begin, end, {}, {}};
+  auto accumulate = [&](size_t first, size_t last, Range &result) {
+    for (size_t i = first; i < last; i++) {
+      const Aabb &bounds = m_primitives[i].bounds;
+      result.bounds.Expand(bounds);
+      result.centroidBounds.Expand(bounds.Center());
+    }
+  };
+  if (!parallel || end - begin <= BIN_BATCH_SIZE) {
+    accumulate(begin, end, range);
+    return range;
+  }
+  std::mutex mutex;
+  m_threadPool.ParallelFor(
+      end - begin, BIN_BATCH_SIZE, [&](size_t first, size_t last) {
+        Range local = {};
+        accumulate(begin + first, begin + last, local);
+        std::lock_guard lock(mutex);
+        range.bounds.Expand(local.bounds);
+        range.centroidBounds.Expand(local.centroidBounds);
+      });
+  return range;
+}
+
+bool SceneBvh::splitRange(const Range &range, Range &left, Range &right,
+                          bool parallel) {
+  uint32_t count = range.end - range.begin;
+  if (count < 2) {
+    return false;
+  }
+  glm::vec3 origin = range.centroidBounds.min;
+  glm::vec3 extent = range.centroidBounds.max - range.centroidBounds.min;
+  glm::vec3 scale(0.0f);
+  for (int axis = 0; axis < 3; axis++) {
+    if (extent[axis] > 0.0f) {
+      scale[axis] = float(BIN_COUNT) / extent[axis];
+    }
+  }
+  auto binOf = [&](const glm::vec3 &centroid, int axis) {
+    return std::min(uint32_t((centroid[axis] - origin[axis]) * scale[axis]),
+                    BIN_COUNT - 1);
+  };
+
+  // 1. 三个轴同时分箱，大区间按批次并行统计再合并
+  Bin bins[3][BIN_COUNT];
+  auto binObjects = [&](size_t first, size_t last, Bin (&result)[3][BIN_COUNT]) {
+    for (size_t i = first; i < last; i++) {
+      const Aabb &bounds = m_primitives[i].bounds;
+      glm::vec3 centroid = bounds.Center();
+      for (int axis = 0; axis < 3; axis++) {
+        Bin &bin = result[axis][binOf(centroid, axis)];
+        bin.bounds.Expand(bounds);
+        bin.centroids.Expand(centroid);
+        bin.count++;
+      }
+    }
+  };
+  if (!parallel || count <= BIN_BATCH_SIZE) {
+    binObjects(range.begin, range.end, bins);
+  } else {
+    std::mutex mutex;
+    m_threadPool.ParallelFor(
+        count, BIN_BATCH_SIZE, [&](size_t first, size_t last) {
+          Bin local[3][BIN_COUNT];
+          binObjects(range.begin + first, range.begin + last, local);
+          std::lock_guard lock(mutex);
+          for (int axis = 0; axis < 3; axis++) {
+            for (uint32_t b = 0; b < BIN_COUNT; b++) {
+              bins[axis][b].bounds.Expand(local[axis][b].bounds);
+              bins[axis][b].centroids.Expand(local[axis][b].centroids);
+              bins[axis][b].count += local[axis][b].count;
+            }
+          }
+        });
+  }
+
+  // 2. 扫描各分割面：代价 = 左表面积 * 左数量 + 右表面积 * 右数量
+  int bestAxis = -1;
+  uint32_t bestSplit = 0;
+  float bestCost = std::numeric_limits<float>::max();
+  for (int axis = 0; axis < 3; axis++) {
+    if (scale[axis] == 0.0f) {
+      continue;
+    }
+    float rightCost[BIN_COUNT] = {};
+    Aabb accumulated;
+    uint32_t accumulatedCount = 0;
+    for (uint32_t b = BIN_COUNT - 1; b > 0; b--) {
+      accumulated.Expand(bins[axis][b].bounds);
+      accumulatedCount += bins[axis][b].count;
+      rightCost[b] = accumulated.SurfaceArea() * float(accumulatedCount);
+    }
+    accumulated = {};
+    accumulatedCount = 0;
+    for (uint32_t b = 1; b < BIN_COUNT; b++) {
+      accumulated.Expand(bins[axis][b - 1].bounds);
+      accumulatedCount += bins[axis][b - 1].count;
+      if (accumulatedCount == 0 || accumulatedCount == count) {
+        continue;
+      }
+      float cost = accumulated.SurfaceArea() * float(accumulatedCount) +
+                   rightCost[b];
+      if (cost < bestCost) {
+        bestCost = cost;
+        bestAxis = axis;
+        bestSplit = b;
+      }
+    }
+  }
+
+  // 3. 按分割面划分；质心全部重合或划分失败时退化为按中位数划分
+  BuildPrimitive *primitives = m_primitives.data();
+  if (bestAxis >= 0) {
+    BuildPrimitive *middle =
+        std::partition(primitives + range.begin, primitives + range.end,
+                       [&](const BuildPrimitive &primitive) {
+                         return binOf(primitive.bounds.Center(), bestAxis) <
+                                bestSplit;
+                       });
+    uint32_t mid = static_cast<uint32_t>(middle - primitives);
+    left = {range.begin, mid, {}, {}};
+    right = {mid, range.end, {}, {}};
+    for (uint32_t b = 0; b < BIN_COUNT; b++) {
+      Range &side = b < bestSplit ? left : right;
+      side.bounds.Expand(bins[bestAxis][b].bounds);
+      side.centroidBounds.Expand(bins[bestAxis][b].centroids);
+    }
+    return true;
+  }
+
+  uint32_t mid = range.begin + count / 2;
+  int axis = extent.x >= extent.y && extent.x >= extent.z ? 0
+             : extent.y >= extent.z                       ? 1
+                                                          : 2;
+  std::nth_element(primitives + range.begin, primitives + mid,
+                   primitives + range.end,
+                   [&](const BuildPrimitive &a, const BuildPrimitive &b) {
+                     return a.bounds.min[axis] + a.bounds.max[axis] <
+                            b.bounds.min[axis] + b.bounds.max[axis];
+                   });
+  left = makeRange(range.begin, mid, parallel);
+  right = makeRange(mid, range.end, parallel);
+  return true;
+}
+
+uint32_t SceneBvh::gatherChildren(const Range &range, Range children[WIDTH],
+                                  bool parallel) {
+  // 二分展开：每次拆开表面积最大、仍超过叶子容量的子区间，直到 4 个
+  children[0] = range;
+  uint32_t childCount = 1;
+  while (childCount < WIDTH) {
+    int best = -1;
+    float bestArea = -1.0f;
+    for (uint32_t i = 0; i < childCount; i++) {
+      float area = children[i].bounds.SurfaceArea();
+      if (children[i].end - children[i].begin > MAX_LEAF_SIZE &&
+          area > bestArea) {
+        best = int(i);
+        bestArea = area;
+      }
+    }
+    Range left, right;
+    if (best < 0 || !splitRange(children[best], left, right, parallel)) {
+      break;
+    }
+    children[best] = left;
+    children[childCount++] = right;
+  }
+  return childCount;
+}
+
+void SceneBvh::setChild(Node &node, uint32_t slot, const Range &range) const {
+  uint32_t count = range.end - range.begin;
+  if (count <= MAX_LEAF_SIZE) {
+    node.index[slot] = range.begin;
+    node.count[slot] = count;
+  } else {
+    node.count[slot] = 0; // 内部节点编号由调用方填写
+  }
+  setSlotBounds(node, slot, range.bounds);
+}
+
+void SceneBvh::buildSubtree(const Range &range, uint32_t baseNode,
+                            std::vector<Node> &nodes) {
+  uint32_t nodeIndex = static_cast<uint32_t>(nodes.size());
+  nodes.push_back(makeEmptyNode());
+
+  Range children[WIDTH];
+  uint32_t childCount = gatherChildren(range, children, false);
+  Node node = makeEmptyNode();
+  for (uint32_t slot = 0; slot < childCount; slot++) {
+    setChild(node, slot, children[slot]);
+    if (node.count[slot] == 0) {
+      node.index[slot] = baseNode + static_cast<uint32_t>(nodes.size());
+      buildSubtree(children[slot], baseNode, nodes);
+    }
+  }
+  nodes[nodeIndex] = node;
+}
+
+void SceneBvh::Build(std::span<const Aabb> bounds) {
+  uint32_t objectCount = static_cast<uint32_t>(bounds.size());
+  m_nodes.clear();
+  m_subtrees.clear();
+  m_topNodeCount = 0;
+  m_objectIndices.resize(objectCount);
+  if (objectCount == 0) {
+    m_leafBounds.clear();
+    m_rootBounds = {};
+    m_cost = m_buildCost = 0.0f;
+    return;
+  }
+  m_primitives.resize(objectCount);
+  m_threadPool.ParallelFor(objectCount, BIN_BATCH_SIZE,
+                           [&](size_t first, size_t last) {
+                             for (size_t i = first; i < last; i++) {
+                               m_primitives[i] = {bounds[i],
+                                                  static_cast<uint32_t>(i)};
+                             }
+                           });
+
+  // 1. 顶层：超过 SUBTREE_SIZE 的区间逐个展开，分箱在线程池上并行；
+  //    较小的区间留作独立子树
+  std::vector<PendingChild> deferred;
+  std::vector<std::pair<uint32_t, Range>> open;
+  m_nodes.push_back(makeEmptyNode());
+  open.push_back({0, makeRange(0, objectCount, true)});
+  while (!open.empty()) {
+    auto [nodeIndex, range] = open.back();
+    open.pop_back();
+
+    Range children[WIDTH];
+    uint32_t childCount = gatherChildren(range, children, true);
+    Node node = makeEmptyNode();
+    for (uint32_t slot = 0; slot < childCount; slot++) {
+      setChild(node, slot, children[slot]);
+      if (node.count[slot] != 0) {
+        continue;
+      }
+      if (children[slot].end - children[slot].begin > SUBTREE_SIZE) {
+        node.index[slot] = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.push_back(makeEmptyNode());
+        open.push_back({node.index[slot], children[slot]});
+      } else {
+        deferred.push_back({nodeIndex, slot, children[slot]});
+      }
+    }
+    m_nodes[nodeIndex] = node;
+  }
+  m_topNodeCount = static_cast<uint32_t>(m_nodes.size());
+
+  // 2. 各子树在自己的对象区间内并行构建，节点编号相对子树起点
+  m_subtrees.resize(deferred.size());
+  m_threadPool.ParallelFor(deferred.size(), 1, [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; i++) {
+      buildSubtree(deferred[i].range, 0, m_subtrees[i].nodes);
+    }
+  });
+
+  // 3. 子树依次接在顶层节点之后，内部节点编号加上子树起点
+  uint32_t nodeCount = m_topNodeCount;
+  for (size_t i = 0; i < m_subtrees.size(); i++) {
+    Subtree &subtree = m_subtrees[i];
+    subtree.firstNode = nodeCount;
+    subtree.nodeCount = static_cast<uint32_t>(subtree.nodes.size());
+    nodeCount += subtree.nodeCount;
+    m_nodes[deferred[i].parent].index[deferred[i].slot] = subtree.firstNode;
+  }
+  m_nodes.resize(nodeCount);
+  m_threadPool.ParallelFor(m_subtrees.size(), 1, [&](size_t first,
+                                                     size_t last) {
+    for (size_t i = first; i < last; i++) {
+      Subtree &subtree = m_subtrees[i];
+      for (uint32_t n = 0; n < subtree.nodeCount; n++) {
+        Node node = subtree.nodes[n];
+        for (uint32_t slot = 0; slot < WIDTH; slot++) {
+          if (node.index[slot] != EMPTY_CHILD && node.count[slot] == 0) {
+            node.index[slot] += subtree.firstNode;
+          }
+        }
+        m_nodes[subtree.firstNode + n] = node;
+      }
+      subtree.nodes = {};
+    }
+  });
+  m_threadPool.ParallelFor(objectCount, BIN_BATCH_SIZE,
+                           [&](size_t first, size_t last) {
+                             for (size_t i = first; i < last; i++) {
+                               m_objectIndices[i] = m_primitives[i].object;
+                             }
+                           });
+
+  // 4. 叶子包围盒与代价统一由 Refit 计算
+  Refit(bounds);
+  m_buildCost = m_cost;
+}
+
+float SceneBvh::refitNodes(uint32_t firstNode, uint32_t nodeCount) {
+  // 子节点编号总是大于父节点，逆序遍历即自底向上
+  float cost = 0.0f;
+  for (uint32_t i = firstNode + nodeCount; i-- > firstNode;) {
+    Node &node = m_nodes[i];
+    for (uint32_t slot = 0; slot < WIDTH; slot++) {
+      if (node.index[slot] == EMPTY_CHILD) {
+        continue;
+      }
+      Aabb bounds;
+      if (node.count[slot] != 0) {
+        for (uint32_t k = 0; k < node.count[slot]; k++) {
+          bounds.Expand(m_leafBounds[node.index[slot] + k]);
+        }
+        cost += bounds.SurfaceArea() * INTERSECT_COST * float(node.count[slot]);
+      } else {
+        bounds = nodeBounds(m_nodes[node.index[slot]]);
+        cost += bounds.SurfaceArea() * TRAVERSAL_COST;
+      }
+      setSlotBounds(node, slot, bounds);
+    }
+  }
+  return cost;
+}
+
+void SceneBvh::Refit(std::span<const Aabb> bounds) {
+  if (bounds.size() != m_objectIndices.size()) {
+    LOG_ERROR("bvh refit with {} objects, built with {}", bounds.size(),
+              m_objectIndices.size());
+    throw std::runtime_error("bvh refit object count mismatch!");
+  }
+  if (m_nodes.empty()) {
+    return;
+  }
+
+  // 1. 对象包围盒按叶子顺序拷贝，查询时连续访问
+  m_leafBounds.resize(bounds.size());
+  m_threadPool.ParallelFor(bounds.size(), BIN_BATCH_SIZE,
+                           [&](size_t first, size_t last) {
+                             for (size_t i = first; i < last; i++) {
+                               m_leafBounds[i] = bounds[m_objectIndices[i]];
+                             }
+                           });
+
+  // 2. 各子树并行，最后是顶层节点
+  std::vector<float> subtreeCosts(m_subtrees.size());
+  m_threadPool.ParallelFor(m_subtrees.size(), 1, [&](size_t first,
+                                                     size_t last) {
+    for (size_t i = first; i < last; i++) {
+      subtreeCosts[i] =
+          refitNodes(m_subtrees[i].firstNode, m_subtrees[i].nodeCount);
+    }
+  });
+  float cost = refitNodes(0, m_topNodeCount);
+  for (float subtreeCost : subtreeCosts) {
+    cost += subtreeCost;
+  }
+
+  m_rootBounds = nodeBounds(m_nodes[0]);
+  float rootArea = m_rootBounds.SurfaceArea();
+  m_cost = rootArea > 0.0f ? TRAVERSAL_COST + cost / rootArea : 0.0f;
+}
+
+bool SceneBvh::Update(std::span<const Aabb> bounds, float rebuildThreshold) {
+  if (bounds.size() == m_objectIndices.size()) {
+    Refit(bounds);
+    if (m_cost <= m_buildCost * rebuildThreshold) {
+      return false;
+    }
+  }
+  LOG_DEBUG("bvh rebuild: cost {:.2f} -> build cost {:.2f}", m_cost,
+            m_buildCost);
+  Build(bounds);
+  return true;
+}
+
+template <typename Visit>
+void SceneBvh::forEachLeafObject(uint32_t nodeIndex, Visit &&visit) const {
+  std::vector<uint32_t> stack = {nodeIndex};
+  while (!stack.empty()) {
+    const Node &node = m_nodes[stack.back()];
+    stack.pop_back();
+    for (uint32_t slot = 0; slot < WIDTH; slot++) {
+      if (node.index[slot] == EMPTY_CHILD) {
+        continue;
+      }
+      if (node.count[slot] == 0) {
+        stack.push_back(node.index[slot]);
+        continue;
+      }
+      for (uint32_t k = 0; k < node.count[slot]; k++) {
+        visit(node.index[slot] + k);
+      }
+    }
+  }
+}
+
+void SceneBvh::QueryFrustum(const glm::mat4 &viewProjection,
+                            std::vector<uint32_t> &objects) const {
+  objects.clear();
+  if (m_nodes.empty()) {
+    return;
+  }
+  glm::vec4 planes[6];
+  extractFrustumPlanes(viewProjection, planes);
+  auto emit = [&](uint32_t leaf) {
+    objects.push_back(m_objectIndices[leaf]);
+  };
+
+  std::vector<uint32_t> stack = {0};
+  while (!stack.empty()) {
+    const Node &node = m_nodes[stack.back()];
+    stack.pop_back();
+    for (uint32_t slot = 0; slot < WIDTH; slot++) {
+      if (node.index[slot] == EMPTY_CHILD) {
+        continue;
+      }
+      Aabb bounds = slotBounds(node, slot);
+      FrustumTest result = testFrustumAabb(planes, bounds.min, bounds.max);
+      if (result == FrustumTest::Outside) {
+        continue;
+      }
+      uint32_t child = node.index[slot];
+      if (node.count[slot] == 0) {
+        // 整棵子树都在视锥内时直接输出，不再逐个测试
+        if (result == FrustumTest::Inside) {
+          forEachLeafObject(child, emit);
+        } else {
+          stack.push_back(child);
+        }
+        continue;
+      }
+      for (uint32_t k = 0; k < node.count[slot]; k++) {
+        const Aabb &object = m_leafBounds[child + k];
+        if (result == FrustumTest::Inside ||
+            testFrustumAabb(planes, object.min, object.max) !=
+                FrustumTest::Outside) {
+          emit(child + k);
+        }
+      }
+    }
+  }
+}
+
+void SceneBvh::QuerySphere(const glm::vec3 &center, float radius,
+                           std::vector<uint32_t> &objects) const {
+  objects.clear();
+  if (m_nodes.empty()) {
+    return;
+  }
+  float radiusSquared = radius * radius;
+  std::vector<uint32_t> stack = {0};
+  while (!stack.empty()) {
+    const Node &node = m_nodes[stack.back()];
+    stack.pop_back();
+    for (uint32_t slot = 0; slot < WIDTH; slot++) {
+      if (node.index[slot] == EMPTY_CHILD) {
+        continue;
+      }
+      Aabb bounds = slotBounds(node, slot);
+      if (bounds.SquaredDistance(center) > radiusSquared) {
+        continue;
+      }
+      uint32_t child = node.index[slot];
+      if (node.count[slot] == 0) {
+        stack.push_back(child);
+        continue;
+      }
+      for (uint32_t k = 0; k < node.count[slot]; k++) {
+        const Aabb &object = m_leafBounds[child + k];
+        if (object.SquaredDistance(center) <= radiusSquared) {
+          objects.push_back(m_objectIndices[child + k]);
+        }
+      }
+    }
+  }
+}
+
+bool SceneBvh::Raycast(const glm::vec3 &origin, const glm::vec3 &direction,
+                       float maxDistance, RayHit &hit,
+                       const RayIntersector &intersector) const {
+  if (m_nodes.empty()) {
+    return false;
+  }
+  glm::vec3 inverseDirection = 1.0f / direction;
+  float closest = maxDistance;
+  bool found = false;
+
+  // 栈中保存进入距离，弹出时已不可能更近的节点直接跳过
+  struct Entry {
+    uint32_t node;
+    float distance;
+  };
+  std::vector<Entry> stack = {{0, 0.0f}};
+  while (!stack.empty()) {
+    Entry entry = stack.back();
+    stack.pop_back();
+    if (entry.distance >= closest) {
+      continue;
+    }
+    const Node &node = m_nodes[entry.node];
+
+    Entry children[WIDTH];
+    uint32_t childCount = 0;
+    for (uint32_t slot = 0; slot < WIDTH; slot++) {
+      if (node.index[slot] == EMPTY_CHILD) {
+        continue;
+      }
+      Aabb bounds = slotBounds(node, slot);
+      float distance = rayBoxEntry(origin, inverseDirection, bounds.min,
+                                   bounds.max, closest);
+      if (distance < 0.0f) {
+        continue;
+      }
+      uint32_t child = node.index[slot];
+      if (node.count[slot] == 0) {
+        children[childCount++] = {child, distance};
+        continue;
+      }
+      for (uint32_t k = 0; k < node.count[slot]; k++) {
+        const Aabb &object = m_leafBounds[child + k];
+        float objectDistance = rayBoxEntry(origin, inverseDirection,
+                                           object.min, object.max, closest);
+        if (objectDistance < 0.0f) {
+          continue;
+        }
+        uint32_t objectIndex = m_objectIndices[child + k];
+        if (intersector) {
+          objectDistance = intersector(objectIndex, closest);
+        }
+        if (objectDistance >= 0.0f && objectDistance < closest) {
+          closest = objectDistance;
+          hit = {objectIndex, objectDistance};
+          found = true;
+        }
+      }
+    }
+
+    // 远的先入栈，近的先弹出
+    std::sort(children, children + childCount,
+              [](const Entry &a, const Entry &b) {
+                return a.distance > b.distance;
+              });
+    stack.insert(stack.end(), children, children + childCount);
+  }
+  return found;
+}
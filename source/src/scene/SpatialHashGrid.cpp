@@ -0,0 +1,317 @@
+#include "Scene/SpatialHashGrid.hpp"
+
+#include "Scene/Frustum.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+// 批量操作第一步每个批次的最小对象数
+constexpr size_t PLACE_BATCH_SIZE = 1024;
+} // namespace
+
+SpatialHashGrid::SpatialHashGrid(const SpatialHashGridConfig &config,
+                                 ThreadPool &threadPool)
+    : m_threadPool(threadPool), m_cellSize(config.cellSize),
+      m_inverseCellSize(1.0f / config.cellSize),
+      m_bucketCount(std::bit_ceil(std::max(config.bucketCount, 1u))) {
+  if (!(config.cellSize > 0.0f)) {
+    LOG_ERROR("spatial hash grid cell size must be positive, got {}",
+              config.cellSize);
+    throw std::runtime_error("invalid spatial hash grid cell size!");
+  }
+  m_buckets.resize(m_bucketCount + 1);
+}
+
+glm::ivec3 SpatialHashGrid::cellOf(const glm::vec3 &point) const {
+  return glm::ivec3(glm::floor(point * m_inverseCellSize));
+}
+
+uint32_t SpatialHashGrid::bucketOf(const glm::ivec3 &cell) const {
+  // Teschner 等人的空间哈希
+  uint32_t hash = (static_cast<uint32_t>(cell.x) * 73856093u) ^
+                  (static_cast<uint32_t>(cell.y) * 19349663u) ^
+                  (static_cast<uint32_t>(cell.z) * 83492791u);
+  return hash & (m_bucketCount - 1);
+}
+
+uint32_t SpatialHashGrid::placeEntry(Entry &entry, const Aabb &bounds,
+                                     glm::ivec3 &cell) const {
+  entry.bounds = bounds;
+  glm::vec3 extent = bounds.Extent();
+  if (std::max({extent.x, extent.y, extent.z}) > m_cellSize * 0.5f) {
+    cell = glm::ivec3(0);
+    return m_bucketCount;
+  }
+  cell = cellOf(bounds.Center());
+  return bucketOf(cell);
+}
+
+void SpatialHashGrid::addToBucket(uint32_t object, uint32_t bucket,
+                                  const glm::ivec3 &cell) {
+  std::vector<BucketItem> &items = m_buckets[bucket];
+  Entry &entry = m_entries[object];
+  entry.bucket = bucket;
+  entry.slot = static_cast<uint32_t>(items.size());
+  items.push_back({cell, object});
+}
+
+void SpatialHashGrid::removeFromBucket(uint32_t object) {
+  Entry &entry = m_entries[object];
+  std::vector<BucketItem> &items = m_buckets[entry.bucket];
+  BucketItem last = items.back();
+  items[entry.slot] = last;
+  m_entries[last.object].slot = entry.slot;
+  items.pop_back();
+  entry.bucket = INVALID_BUCKET;
+}
+
+void SpatialHashGrid::Insert(uint32_t object, const Aabb &bounds) {
+  if (Contains(object)) {
+    LOG_ERROR("object {} is already in the spatial hash grid", object);
+    throw std::runtime_error("duplicate spatial hash grid object!");
+  }
+  if (object >= m_entries.size()) {
+    m_entries.resize(object + 1);
+  }
+  glm::ivec3 cell;
+  uint32_t bucket = placeEntry(m_entries[object], bounds, cell);
+  addToBucket(object, bucket, cell);
+  m_objectCount++;
+}
+
+void SpatialHashGrid::Update(uint32_t object, const Aabb &bounds) {
+  if (!Contains(object)) {
+    LOG_ERROR("object {} is not in the spatial hash grid", object);
+    throw std::runtime_error("unknown spatial hash grid object!");
+  }
+  Entry &entry = m_entries[object];
+  glm::ivec3 cell;
+  uint32_t bucket = placeEntry(entry, bounds, cell);
+  if (bucket == entry.bucket) {
+    m_buckets[bucket][entry.slot].cell = cell;
+  } else {
+    removeFromBucket(object);
+    addToBucket(object, bucket, cell);
+  }
+}
+
+void SpatialHashGrid::Remove(uint32_t object) {
+  if (!Contains(object)) {
+    LOG_ERROR("object {} is not in the spatial hash grid", object);
+    throw std::runtime_error("unknown spatial hash grid object!");
+  }
+  removeFromBucket(object);
+  m_objectCount--;
+}
+
+void SpatialHashGrid::InsertBatch(std::span<const uint32_t> objects,
+                                  std::span<const Aabb> bounds) {
+  applyBatch(objects, bounds, BatchMode::Insert);
+}
+
+void SpatialHashGrid::UpdateBatch(std::span<const uint32_t> objects,
+                                  std::span<const Aabb> bounds) {
+  applyBatch(objects, bounds, BatchMode::Update);
+}
+
+void SpatialHashGrid::RemoveBatch(std::span<const uint32_t> objects) {
+  applyBatch(objects, {}, BatchMode::Remove);
+}
+
+void SpatialHashGrid::groupByShard(bool byDestination,
+                                   std::vector<uint32_t> &offsets,
+                                   std::vector<uint32_t> &order) const {
+  // 计数排序，分片内保持批次中的顺序
+  offsets.assign(SHARD_COUNT + 1, 0);
+  for (const Move &move : m_moves) {
+    uint32_t bucket = byDestination ? move.to : move.from;
+    if (move.from != move.to && bucket != INVALID_BUCKET) {
+      offsets[shardOf(bucket) + 1]++;
+    }
+  }
+  for (uint32_t shard = 0; shard < SHARD_COUNT; shard++) {
+    offsets[shard + 1] += offsets[shard];
+  }
+  order.resize(offsets[SHARD_COUNT]);
+  uint32_t cursor[SHARD_COUNT];
+  std::copy(offsets.begin(), offsets.begin() + SHARD_COUNT, cursor);
+  for (uint32_t i = 0; i < m_moves.size(); i++) {
+    const Move &move = m_moves[i];
+    uint32_t bucket = byDestination ? move.to : move.from;
+    if (move.from != move.to && bucket != INVALID_BUCKET) {
+      order[cursor[shardOf(bucket)]++] = i;
+    }
+  }
+}
+
+void SpatialHashGrid::applyBatch(std::span<const uint32_t> objects,
+                                 std::span<const Aabb> bounds, BatchMode mode) {
+  if (mode != BatchMode::Remove && bounds.size() != objects.size()) {
+    LOG_ERROR("spatial hash grid batch has {} objects but {} bounds",
+              objects.size(), bounds.size());
+    throw std::runtime_error("spatial hash grid batch size mismatch!");
+  }
+
+  // 1. 先检查编号，出错时网格保持不变
+  for (uint32_t object : objects) {
+    if (Contains(object) != (mode != BatchMode::Insert)) {
+      LOG_ERROR("spatial hash grid batch: object {} is {}in the grid", object,
+                Contains(object) ? "already " : "not ");
+      throw std::runtime_error("invalid spatial hash grid batch object!");
+    }
+  }
+  if (mode == BatchMode::Insert && !objects.empty()) {
+    uint32_t maxObject = *std::max_element(objects.begin(), objects.end());
+    if (maxObject >= m_entries.size()) {
+      m_entries.resize(maxObject + 1);
+    }
+  }
+
+  // 2. 并行计算目标桶。仍在原桶内的对象直接改写自己那一项的格子坐标，
+  //    此时只写各对象自己的数据
+  m_moves.resize(objects.size());
+  m_threadPool.ParallelFor(
+      objects.size(), PLACE_BATCH_SIZE, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+          Move &move = m_moves[i];
+          move.object = objects[i];
+          Entry &entry = m_entries[move.object];
+          move.from = entry.bucket;
+          move.to = mode == BatchMode::Remove
+                        ? INVALID_BUCKET
+                        : placeEntry(entry, bounds[i], move.cell);
+          if (move.from == move.to) {
+            m_buckets[move.from][entry.slot].cell = move.cell;
+          }
+        }
+      });
+
+  // 3. 按分片并行换桶：先从旧桶删除，再插入新桶。
+  //    交换删除只会改动同一个桶内对象的位置，分片之间互不干扰
+  groupByShard(false, m_removeOffsets, m_removeOrder);
+  groupByShard(true, m_insertOffsets, m_insertOrder);
+  m_threadPool.ParallelFor(SHARD_COUNT, 1, [&](size_t first, size_t last) {
+    for (size_t shard = first; shard < last; shard++) {
+      for (uint32_t k = m_removeOffsets[shard]; k < m_removeOffsets[shard + 1];
+           k++) {
+        removeFromBucket(m_moves[m_removeOrder[k]].object);
+      }
+    }
+  });
+  m_threadPool.ParallelFor(SHARD_COUNT, 1, [&](size_t first, size_t last) {
+    for (size_t shard = first; shard < last; shard++) {
+      for (uint32_t k = m_insertOffsets[shard]; k < m_insertOffsets[shard + 1];
+           k++) {
+        const Move &move = m_moves[m_insertOrder[k]];
+        addToBucket(move.object, move.to, move.cell);
+      }
+    }
+  });
+
+  uint32_t count = static_cast<uint32_t>(objects.size());
+  if (mode == BatchMode::Insert) {
+    m_objectCount += count;
+  } else if (mode == BatchMode::Remove) {
+    m_objectCount -= count;
+  }
+}
+
+void SpatialHashGrid::Clear() {
+  for (std::vector<BucketItem> &bucket : m_buckets) {
+    bucket.clear();
+  }
+  m_entries.clear();
+  m_objectCount = 0;
+}
+
+void SpatialHashGrid::QuerySphere(const glm::vec3 &center, float radius,
+                                  std::vector<uint32_t> &objects) const {
+  objects.clear();
+  float radiusSquared = radius * radius;
+  auto testBucket = [&](uint32_t bucket, const glm::ivec3 *cell) {
+    for (const BucketItem &item : m_buckets[bucket]) {
+      if ((!cell || item.cell == *cell) &&
+          m_entries[item.object].bounds.SquaredDistance(center) <=
+              radiusSquared) {
+        objects.push_back(item.object);
+      }
+    }
+  };
+
+  // 对象最多超出所在格子半个格子，格子范围按此外扩；
+  // 范围内的格子比桶还多时直接遍历所有桶
+  glm::vec3 reach(radius + m_cellSize * 0.5f);
+  glm::ivec3 low = cellOf(center - reach);
+  glm::ivec3 high = cellOf(center + reach);
+  uint64_t cellCount = uint64_t(high.x - low.x + 1) *
+                       uint64_t(high.y - low.y + 1) *
+                       uint64_t(high.z - low.z + 1);
+  if (cellCount <= m_bucketCount) {
+    for (int z = low.z; z <= high.z; z++) {
+      for (int y = low.y; y <= high.y; y++) {
+        for (int x = low.x; x <= high.x; x++) {
+          glm::ivec3 cell(x, y, z);
+          testBucket(bucketOf(cell), &cell);
+        }
+      }
+    }
+  } else {
+    for (uint32_t bucket = 0; bucket < m_bucketCount; bucket++) {
+      testBucket(bucket, nullptr);
+    }
+  }
+  testBucket(m_bucketCount, nullptr);
+}
+
+void SpatialHashGrid::QueryFrustum(const glm::mat4 &viewProjection,
+                                   std::vector<uint32_t> &objects) {
+  glm::vec4 planes[6];
+  extractFrustumPlanes(viewProjection, planes);
+  float margin = m_cellSize * 0.5f;
+  glm::vec3 looseSize(m_cellSize + 2.0f * margin);
+
+  uint32_t bucketCount = m_bucketCount + 1;
+  uint32_t chunkCount = (bucketCount + QUERY_CHUNK_SIZE - 1) / QUERY_CHUNK_SIZE;
+  m_chunkResults.resize(chunkCount);
+  m_threadPool.ParallelFor(chunkCount, 1, [&](size_t first, size_t last) {
+    for (size_t chunk = first; chunk < last; chunk++) {
+      std::vector<uint32_t> &result = m_chunkResults[chunk];
+      result.clear();
+      uint32_t begin = static_cast<uint32_t>(chunk) * QUERY_CHUNK_SIZE;
+      uint32_t end = std::min(begin + QUERY_CHUNK_SIZE, bucketCount);
+      for (uint32_t bucket = begin; bucket < end; bucket++) {
+        // 桶内的对象大多来自同一个格子，格子的松散边界只在格子变化时重新测试
+        bool oversized = bucket == m_bucketCount;
+        bool cellTested = false;
+        glm::ivec3 testedCell(0);
+        FrustumTest cellResult = FrustumTest::Intersecting;
+        for (const BucketItem &item : m_buckets[bucket]) {
+          if (!oversized && (!cellTested || item.cell != testedCell)) {
+            glm::vec3 cellMin = glm::vec3(item.cell) * m_cellSize - margin;
+            cellResult = testFrustumAabb(planes, cellMin, cellMin + looseSize);
+            testedCell = item.cell;
+            cellTested = true;
+          }
+          if (cellResult == FrustumTest::Outside) {
+            continue;
+          }
+          const Aabb &bounds = m_entries[item.object].bounds;
+          if (cellResult == FrustumTest::Inside ||
+              testFrustumAabb(planes, bounds.min, bounds.max) !=
+                  FrustumTest::Outside) {
+            result.push_back(item.object);
+          }
+        }
+      }
+    }
+  });
+
+  objects.clear();
+  for (const std::vector<uint32_t> &result : m_chunkResults) {
+    objects.insert(objects.end(), result.begin(), result.end());
+  }
+}
@@ -0,0 +1,154 @@
+#include "Texture/AtlasPacker.hpp"
+
+#include <algorithm>
+#include <limits>
+
+AtlasPacker::AtlasPacker(uint32_t width, uint32_t height,
+                         AtlasPackMethod method)
+    : m_width(width), m_height(height), m_method(method) {
+  Reset();
+}
+
+void AtlasPacker::Reset() {
+  m_usedArea = 0;
+  m_skyline.assign(1, {0, 0, m_width});
+  m_freeRects.assign(1, {0, 0, m_width, m_height});
+}
+
+float AtlasPacker::GetOccupancy() const {
+  return static_cast<float>(static_cast<double>(m_usedArea) /
+                            (static_cast<double>(m_width) * m_height));
+}
+
+bool AtlasPacker::Insert(uint32_t width, uint32_t height, AtlasRect &rect) {
+  if (width == 0 || height == 0 || width > m_width || height > m_height) {
+    return false;
+  }
+
+  bool placed = m_method == AtlasPackMethod::Skyline
+                    ? insertSkyline(width, height, rect)
+                    : insertGuillotine(width, height, rect);
+  if (placed) {
+    m_usedArea += uint64_t(width) * height;
+  }
+  return placed;
+}
+
+bool AtlasPacker::skylineFit(size_t index, uint32_t width, uint32_t height,
+                             uint32_t &y) const {
+  uint32_t x = m_skyline[index].x;
+  if (x + width > m_width) {
+    return false;
+  }
+
+  // 矩形跨越的所有节点中最高的那个决定放置高度
+  y = 0;
+  uint32_t remaining = width;
+  for (size_t i = index; remaining > 0; i++) {
+    y = std::max(y, m_skyline[i].y);
+    if (y + height > m_height) {
+      return false;
+    }
+    remaining -= std::min(remaining, m_skyline[i].width);
+  }
+  return true;
+}
+
+bool AtlasPacker::insertSkyline(uint32_t width, uint32_t height,
+                                AtlasRect &rect) {
+  // 1. 选择顶边最低的位置，相同时选择最窄的节点以减少浪费
+  size_t bestIndex = m_skyline.size();
+  uint32_t bestY = std::numeric_limits<uint32_t>::max();
+  uint32_t bestWidth = std::numeric_limits<uint32_t>::max();
+  for (size_t i = 0; i < m_skyline.size(); i++) {
+    uint32_t y;
+    if (!skylineFit(i, width, height, y)) {
+      continue;
+    }
+    uint32_t top = y + height;
+    if (top < bestY || (top == bestY && m_skyline[i].width < bestWidth)) {
+      bestIndex = i;
+      bestY = top;
+      bestWidth = m_skyline[i].width;
+    }
+  }
+  if (bestIndex == m_skyline.size()) {
+    return false;
+  }
+
+  rect = {m_skyline[bestIndex].x, bestY - height, width, height};
+
+  // 2. 插入新节点，并裁掉被它覆盖的节点
+  m_skyline.insert(m_skyline.begin() + bestIndex, {rect.x, bestY, width});
+  uint32_t right = rect.x + width;
+  for (size_t i = bestIndex + 1; i < m_skyline.size();) {
+    SkylineNode &node = m_skyline[i];
+    if (node.x >= right) {
+      break;
+    }
+    uint32_t shrink = std::min(right - node.x, node.width);
+    node.x += shrink;
+    node.width -= shrink;
+    if (node.width == 0) {
+      m_skyline.erase(m_skyline.begin() + i);
+    } else {
+      break;
+    }
+  }
+
+  // 3. 合并高度相同的相邻节点
+  for (size_t i = 0; i + 1 < m_skyline.size();) {
+    if (m_skyline[i].y == m_skyline[i + 1].y) {
+      m_skyline[i].width += m_skyline[i + 1].width;
+      m_skyline.erase(m_skyline.begin() + i + 1);
+    } else {
+      i++;
+    }
+  }
+  return true;
+}
+
+bool AtlasPacker::insertGuillotine(uint32_t width, uint32_t height,
+                                   AtlasRect &rect) {
+  // 1. 最佳面积匹配：选择剩余面积最小的空闲矩形
+  size_t bestIndex = m_freeRects.size();
+  uint64_t bestArea = std::numeric_limits<uint64_t>::max();
+  for (size_t i = 0; i < m_freeRects.size(); i++) {
+    const AtlasRect &free = m_freeRects[i];
+    if (free.width < width || free.height < height) {
+      continue;
+    }
+    uint64_t area = uint64_t(free.width) * free.height;
+    if (area < bestArea) {
+      bestIndex = i;
+      bestArea = area;
+    }
+  }
+  if (bestIndex == m_freeRects.size()) {
+    return false;
+  }
+
+  AtlasRect free = m_freeRects[bestIndex];
+  m_freeRects[bestIndex] = m_freeRects.back();
+  m_freeRects.pop_back();
+  rect = {free.x, free.y, width, height};
+
+  // 2. 沿较短的剩余边切分，让剩下的大块尽量完整
+  uint32_t restW = free.width - width;
+  uint32_t restH = free.height - height;
+  AtlasRect right, bottom;
+  if (restW < restH) {
+    right = {free.x + width, free.y, restW, height};
+    bottom = {free.x, free.y + height, free.width, restH};
+  } else {
+    right = {free.x + width, free.y, restW, free.height};
+    bottom = {free.x, free.y + height, width, restH};
+  }
+  if (right.width > 0 && right.height > 0) {
+    m_freeRects.push_back(right);
+  }
+  if (bottom.width > 0 && bottom.height > 0) {
+    m_freeRects.push_back(bottom);
+  }
+  return true;
+}
@@ -0,0 +1,76 @@
+#include "Texture/ImageData.hpp"
+
+#include "utils/log.hpp"
+#include "utils/stb_image.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+ImageData loadImageRGBA8(const std::string &filename) {
+  int width = 0, height = 0, channels = 0;
+  stbi_uc *data =
+      stbi_load(filename.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+  if (!data) {
+    LOG_ERROR("failed to load image: {} ({})", filename, stbi_failure_reason());
+    throw std::runtime_error("failed to load image: " + filename);
+  }
+
+  ImageData image;
+  image.width = static_cast<uint32_t>(width);
+  image.height = static_cast<uint32_t>(height);
+  image.pixels.assign(data, data + static_cast<size_t>(width) * height * 4);
+  stbi_image_free(data);
+
+  return image;
+}
+
+uint32_t mipLevelCount(uint32_t width, uint32_t height) {
+  uint32_t levels = 1;
+  uint32_t size = std::max(width, height);
+  while (size > 1) {
+    size >>= 1;
+    levels++;
+  }
+  return levels;
+}
+
+ImageData downsampleImage(const ImageData &source) {
+  ImageData result;
+  result.width = std::max(source.width / 2, 1u);
+  result.height = std::max(source.height / 2, 1u);
+  result.pixels.resize(static_cast<size_t>(result.width) * result.height * 4);
+
+  for (uint32_t y = 0; y < result.height; y++) {
+    uint32_t y0 = std::min(y * 2, source.height - 1);
+    uint32_t y1 = std::min(y * 2 + 1, source.height - 1);
+    for (uint32_t x = 0; x < result.width; x++) {
+      uint32_t x0 = std::min(x * 2, source.width - 1);
+      uint32_t x1 = std::min(x * 2 + 1, source.width - 1);
+
+      const uint8_t *p00 = &source.pixels[(size_t(y0) * source.width + x0) * 4];
+      const uint8_t *p01 = &source.pixels[(size_t(y0) * source.width + x1) * 4];
+      const uint8_t *p10 = &source.pixels[(size_t(y1) * source.width + x0) * 4];
+      const uint8_t *p11 = &source.pixels[(size_t(y1) * source.width + x1) * 4];
+      uint8_t *dst = &result.pixels[(size_t(y) * result.width + x) * 4];
+
+      for (int c = 0; c < 4; c++) {
+        dst[c] = static_cast<uint8_t>((p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+      }
+    }
+  }
+
+  return result;
+}
+
+std::vector<ImageData> generateMipChain(ImageData base) {
+  uint32_t levels = mipLevelCount(base.width, base.height);
+
+  std::vector<ImageData> chain;
+  chain.reserve(levels);
+  chain.push_back(std::move(base));
+  for (uint32_t i = 1; i < levels; i++) {
+    chain.push_back(downsampleImage(chain.back()));
+  }
+
+  return chain;
+}
@@ -0,0 +1,316 @@
+#include "Texture/TextureAtlas.hpp"
+
+#include "Vulkan/VkUtils.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+constexpr VkFormat PACKED_TEXTURE_FORMAT = VK_FORMAT_R8G8B8A8_SRGB;
+
+uint32_t alignUp(uint32_t value, uint32_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+} // namespace
+
+TextureAtlasBuilder::TextureAtlasBuilder(const VkContext &context,
+                                         const TextureAtlasConfig &config)
+    : m_context(context), m_config(config) {
+  VkCommandPoolCreateInfo poolInfo = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+      .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+      .queueFamilyIndex = m_context.graphicsQueueFamily,
+  };
+  if (vkCreateCommandPool(m_context.device, &poolInfo, nullptr,
+                          &m_commandPool) != VK_SUCCESS) {
+    LOG_ERROR("failed to create texture atlas command pool!");
+    throw std::runtime_error("failed to create texture atlas command pool!");
+  }
+
+  // 图集依赖 padding 防止越界，寻址模式只影响数组纹理的边缘
+  VkSamplerCreateInfo samplerInfo = {
+      .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+      .magFilter = VK_FILTER_LINEAR,
+      .minFilter = VK_FILTER_LINEAR,
+      .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+      .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .minLod = 0.0f,
+      .maxLod = VK_LOD_CLAMP_NONE,
+  };
+  if (vkCreateSampler(m_context.device, &samplerInfo, nullptr, &m_sampler) !=
+      VK_SUCCESS) {
+    LOG_ERROR("failed to create texture atlas sampler!");
+    throw std::runtime_error("failed to create texture atlas sampler!");
+  }
+}
+
+TextureAtlasBuilder::~TextureAtlasBuilder() {
+  for (auto &image : m_images) {
+    vkDestroyImageView(m_context.device, image.view, nullptr);
+    vkDestroyImage(m_context.device, image.image, nullptr);
+    vkFreeMemory(m_context.device, image.memory, nullptr);
+  }
+  vkDestroySampler(m_context.device, m_sampler, nullptr);
+  vkDestroyCommandPool(m_context.device, m_commandPool, nullptr);
+}
+
+PackedTextureHandle TextureAtlasBuilder::Add(const std::string &filename) {
+  return Add(loadImageRGBA8(filename));
+}
+
+PackedTextureHandle TextureAtlasBuilder::Add(ImageData image) {
+  m_entries.push_back({std::move(image), {}});
+  return static_cast<PackedTextureHandle>(m_entries.size() - 1);
+}
+
+void TextureAtlasBuilder::Build() {
+  if (m_config.atlasExtent <= 2 * m_config.padding) {
+    LOG_ERROR("atlas extent {} leaves no room inside padding {}",
+              m_config.atlasExtent, m_config.padding);
+    throw std::runtime_error("atlas extent too small for padding!");
+  }
+
+  // 1. 按尺寸分组：数量足够或尺寸过大的组走纹理数组，其余进图集
+  std::map<std::pair<uint32_t, uint32_t>, std::vector<PackedTextureHandle>>
+      groups;
+  for (PackedTextureHandle i = 0; i < m_entries.size(); i++) {
+    const ImageData &image = m_entries[i].image;
+    groups[{image.width, image.height}].push_back(i);
+  }
+
+  uint32_t atlasLimit =
+      std::min(m_config.maxSpriteExtent,
+               m_config.atlasExtent - 2 * m_config.padding);
+  std::vector<PackedTextureHandle> atlasHandles;
+  for (auto &[size, handles] : groups) {
+    bool fitsAtlas = size.first <= atlasLimit && size.second <= atlasLimit;
+    if (handles.size() >= m_config.minArrayLayers || !fitsAtlas) {
+      buildArrays(handles);
+    } else {
+      atlasHandles.insert(atlasHandles.end(), handles.begin(), handles.end());
+    }
+  }
+
+  // 2. 剩余小图打包进图集
+  if (!atlasHandles.empty()) {
+    buildAtlas(std::move(atlasHandles));
+  }
+
+  for (auto &entry : m_entries) {
+    entry.image = {};
+  }
+
+  LOG_INFO("texture atlas: {} textures packed into {} images",
+           m_entries.size(), m_images.size());
+}
+
+void TextureAtlasBuilder::buildArrays(
+    const std::vector<PackedTextureHandle> &handles) {
+  const ImageData &first = m_entries[handles.front()].image;
+  uint32_t maxLayers = m_context.limits.maxImageArrayLayers;
+
+  // 超出设备数组层数上限时拆成多张数组图像
+  for (size_t begin = 0; begin < handles.size(); begin += maxLayers) {
+    size_t end = std::min(handles.size(), begin + maxLayers);
+
+    PackedImage target;
+    target.width = first.width;
+    target.height = first.height;
+    target.layers = static_cast<uint32_t>(end - begin);
+    target.mipLevels = mipLevelCount(first.width, first.height);
+
+    std::vector<std::vector<ImageData>> layerMips;
+    layerMips.reserve(target.layers);
+    for (size_t i = begin; i < end; i++) {
+      Entry &entry = m_entries[handles[i]];
+      entry.packed.imageIndex = static_cast<uint32_t>(m_images.size());
+      entry.packed.uvTransform.layer = static_cast<uint32_t>(i - begin);
+      layerMips.push_back(generateMipChain(std::move(entry.image)));
+    }
+
+    uploadImage(target, layerMips);
+    m_images.push_back(target);
+  }
+}
+
+void TextureAtlasBuilder::buildAtlas(std::vector<PackedTextureHandle> handles) {
+  const uint32_t extent = m_config.atlasExtent;
+  const uint32_t padding = m_config.padding;
+
+  // 对齐到 2^(mips-1)，并保证每级 mip 至少还有一个纹素的外扩边缘
+  uint32_t mipLevels = 1;
+  while ((2u << (mipLevels - 1)) <= padding) {
+    mipLevels++;
+  }
+  mipLevels = std::min(mipLevels, mipLevelCount(extent, extent));
+  const uint32_t alignment = 1u << (mipLevels - 1);
+
+  // 高度优先的降序插入让天际线更平整，面积优先对断头台切分更有利
+  std::sort(handles.begin(), handles.end(),
+            [&](PackedTextureHandle a, PackedTextureHandle b) {
+              const ImageData &ia = m_entries[a].image;
+              const ImageData &ib = m_entries[b].image;
+              if (m_config.method == AtlasPackMethod::Skyline) {
+                return ia.height != ib.height ? ia.height > ib.height
+                                              : ia.width > ib.width;
+              }
+              return uint64_t(ia.width) * ia.height >
+                     uint64_t(ib.width) * ib.height;
+            });
+
+  std::vector<AtlasPacker> packers;
+  std::vector<ImageData> pages;
+  const float invExtent = 1.0f / static_cast<float>(extent);
+
+  for (PackedTextureHandle handle : handles) {
+    Entry &entry = m_entries[handle];
+    const ImageData &image = entry.image;
+    uint32_t paddedW = alignUp(image.width + 2 * padding, alignment);
+    uint32_t paddedH = alignUp(image.height + 2 * padding, alignment);
+
+    AtlasRect rect;
+    size_t page = 0;
+    while (page < packers.size() && !packers[page].Insert(paddedW, paddedH, rect)) {
+      page++;
+    }
+    if (page == packers.size()) {
+      packers.emplace_back(extent, extent, m_config.method);
+      // 对齐后的尺寸可能超过 atlasLimit 的估计，空白页也放不下时报错
+      if (!packers.back().Insert(paddedW, paddedH, rect)) {
+        LOG_ERROR("texture {} ({}x{}, padded {}x{}) does not fit an empty "
+                  "{}x{} atlas page",
+                  handle, image.width, image.height, paddedW, paddedH, extent,
+                  extent);
+        throw std::runtime_error("texture does not fit an empty atlas page!");
+      }
+
+      ImageData blank;
+      blank.width = extent;
+      blank.height = extent;
+      blank.pixels.assign(size_t(extent) * extent * 4, 0);
+      pages.push_back(std::move(blank));
+    }
+
+    // 写入子图并把边缘像素外扩到整个对齐后的矩形
+    ImageData &target = pages[page];
+    for (uint32_t y = 0; y < rect.height; y++) {
+      uint32_t sy = static_cast<uint32_t>(std::clamp<int64_t>(
+          int64_t(y) - padding, 0, int64_t(image.height) - 1));
+      for (uint32_t x = 0; x < rect.width; x++) {
+        uint32_t sx = static_cast<uint32_t>(std::clamp<int64_t>(
+            int64_t(x) - padding, 0, int64_t(image.width) - 1));
+        std::memcpy(
+            &target.pixels[(size_t(rect.y + y) * extent + rect.x + x) * 4],
+            &image.pixels[(size_t(sy) * image.width + sx) * 4], 4);
+      }
+    }
+
+    entry.packed.imageIndex = static_cast<uint32_t>(m_images.size());
+    entry.packed.uvTransform = {
+        .offset = {(rect.x + padding) * invExtent,
+                   (rect.y + padding) * invExtent},
+        .scale = {image.width * invExtent, image.height * invExtent},
+        .layer = static_cast<uint32_t>(page),
+    };
+  }
+
+  for (size_t i = 0; i < packers.size(); i++) {
+    LOG_DEBUG("atlas page {}: {:.1f}% occupied", i,
+              packers[i].GetOccupancy() * 100.0f);
+  }
+
+  PackedImage target;
+  target.width = extent;
+  target.height = extent;
+  target.layers = static_cast<uint32_t>(pages.size());
+  target.mipLevels = mipLevels;
+  target.isAtlas = true;
+
+  std::vector<std::vector<ImageData>> layerMips;
+  layerMips.reserve(pages.size());
+  for (auto &page : pages) {
+    std::vector<ImageData> mips = generateMipChain(std::move(page));
+    mips.resize(mipLevels);
+    layerMips.push_back(std::move(mips));
+  }
+
+  uploadImage(target, layerMips);
+  m_images.push_back(target);
+}
+
+void TextureAtlasBuilder::uploadImage(
+    PackedImage &target, const std::vector<std::vector<ImageData>> &layerMips) {
+  createImage(m_context, target.width, target.height, target.mipLevels,
+              target.layers, PACKED_TEXTURE_FORMAT,
+              VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+              target.image, target.memory);
+  target.view = createImageView(m_context, target.image, PACKED_TEXTURE_FORMAT,
+                                VK_IMAGE_VIEW_TYPE_2D_ARRAY, target.mipLevels,
+                                target.layers);
+
+  VkDeviceSize stagingSize = 0;
+  for (const auto &mips : layerMips) {
+    for (uint32_t level = 0; level < target.mipLevels; level++) {
+      stagingSize += mips[level].ByteSize();
+    }
+  }
+
+  VkBuffer stagingBuffer;
+  VkDeviceMemory stagingMemory;
+  createBuffer(m_context, stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+               stagingBuffer, stagingMemory);
+
+  std::vector<VkBufferImageCopy> regions;
+  regions.reserve(layerMips.size() * target.mipLevels);
+
+  void *mapped;
+  vkMapMemory(m_context.device, stagingMemory, 0, stagingSize, 0, &mapped);
+  VkDeviceSize offset = 0;
+  for (uint32_t layer = 0; layer < layerMips.size(); layer++) {
+    for (uint32_t level = 0; level < target.mipLevels; level++) {
+      const ImageData &mip = layerMips[layer][level];
+      std::memcpy(static_cast<uint8_t *>(mapped) + offset, mip.pixels.data(),
+                  mip.ByteSize());
+
+      regions.push_back({
+          .bufferOffset = offset,
+          .imageSubresource =
+              {
+                  .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                  .mipLevel = level,
+                  .baseArrayLayer = layer,
+                  .layerCount = 1,
+              },
+          .imageExtent = {mip.width, mip.height, 1},
+      });
+      offset += mip.ByteSize();
+    }
+  }
+  vkUnmapMemory(m_context.device, stagingMemory);
+
+  VkCommandBuffer commandBuffer =
+      beginSingleTimeCommands(m_context, m_commandPool);
+  cmdTransitionImageLayout(commandBuffer, target.image,
+                           VK_IMAGE_LAYOUT_UNDEFINED,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0,
+                           target.mipLevels, target.layers);
+  vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, target.image,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         static_cast<uint32_t>(regions.size()), regions.data());
+  cmdTransitionImageLayout(commandBuffer, target.image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 0,
+                           target.mipLevels, target.layers);
+  endSingleTimeCommands(m_context, m_commandPool, commandBuffer);
+
+  vkDestroyBuffer(m_context.device, stagingBuffer, nullptr);
+  vkFreeMemory(m_context.device, stagingMemory, nullptr);
+}
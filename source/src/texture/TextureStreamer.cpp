@@ -0,0 +1,637 @@
+#include "Texture/TextureStreamer.hpp"
+
+#include "Vulkan/VkUtils.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+constexpr VkFormat STREAMED_TEXTURE_FORMAT = VK_FORMAT_R8G8B8A8_SRGB;
+constexpr VkDeviceSize STREAMED_TEXEL_SIZE = 4;
+
+VkDeviceSize levelBytes(const ImageData &mip) {
+  return VkDeviceSize(mip.width) * mip.height * STREAMED_TEXEL_SIZE;
+}
+} // namespace
+
+TextureStreamer::TextureStreamer(const VkContext &context,
+                                 const TextureStreamerConfig &config)
+    : m_context(context), m_config(config),
+      m_budgetBytes(config.budgetBytes) {
+  VkCommandPoolCreateInfo poolInfo = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+      .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT |
+               VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+      .queueFamilyIndex = m_context.graphicsQueueFamily,
+  };
+
+  if (vkCreateCommandPool(m_context.device, &poolInfo, nullptr,
+                          &m_commandPool) != VK_SUCCESS) {
+    LOG_ERROR("failed to create texture streaming command pool!");
+    throw std::runtime_error(
+        "failed to create texture streaming command pool!");
+  }
+
+  if (!m_context.HasExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+    LOG_WARN("VK_EXT_memory_budget not available, texture budget fixed at {} "
+             "MiB",
+             m_config.budgetBytes >> 20);
+  }
+
+  m_worker = std::thread(&TextureStreamer::workerLoop, this);
+}
+
+TextureStreamer::~TextureStreamer() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopWorker = true;
+  }
+  m_condition.notify_all();
+  m_worker.join();
+
+  vkQueueWaitIdle(m_context.graphicsQueue);
+  destroyRetiredImages(true);
+
+  for (auto &texture : m_textures) {
+    if (texture.uploading) {
+      PendingUpload &upload = texture.upload;
+      vkDestroyFence(m_context.device, upload.fence, nullptr);
+      vkDestroyBuffer(m_context.device, upload.stagingBuffer, nullptr);
+      vkFreeMemory(m_context.device, upload.stagingMemory, nullptr);
+      vkDestroyImageView(m_context.device, upload.view, nullptr);
+      vkDestroyImage(m_context.device, upload.image, nullptr);
+      vkFreeMemory(m_context.device, upload.memory, nullptr);
+    }
+    if (texture.image != VK_NULL_HANDLE) {
+      vkDestroyImageView(m_context.device, texture.view, nullptr);
+      vkDestroyImage(m_context.device, texture.image, nullptr);
+      vkFreeMemory(m_context.device, texture.memory, nullptr);
+    }
+  }
+
+  // 销毁命令池会一并释放其中的命令缓冲
+  vkDestroyCommandPool(m_context.device, m_commandPool, nullptr);
+}
+
+StreamedTextureHandle TextureStreamer::Load(const std::string &filename) {
+  StreamedTextureHandle handle =
+      static_cast<StreamedTextureHandle>(m_textures.size());
+
+  StreamedTexture texture;
+  texture.filename = filename;
+  texture.lastUsedFrame = m_frameIndex;
+  m_textures.push_back(std::move(texture));
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_decodeQueue.push_back({handle, filename, 0, UINT32_MAX});
+  }
+  m_condition.notify_one();
+
+  return handle;
+}
+
+void TextureStreamer::RequestMip(StreamedTextureHandle handle,
+                                 uint32_t mipLevel) {
+  StreamedTexture &texture = m_textures[handle];
+  if (!texture.requested) {
+    texture.requested = true;
+    texture.requestedMip = mipLevel;
+  } else {
+    texture.requestedMip = std::min(texture.requestedMip, mipLevel);
+  }
+  texture.lastUsedFrame = m_frameIndex;
+}
+
+void TextureStreamer::Update(uint64_t frameIndex) {
+  m_frameIndex = frameIndex;
+  m_uploadsThisFrame = 0;
+
+  // 1. 回收完成的上传并替换图像
+  pollUploads();
+  destroyRetiredImages(false);
+
+  // 2. 接收后台解码结果，尾部 mip 不受预算限制立即上传
+  collectDecodedTextures();
+  uploadTails();
+
+  // 3. 先按预算淘汰，再按需求提升精度
+  queryBudget();
+  evictToBudget();
+  streamIn();
+
+  // 不再需要的纹理丢弃暂存的像素；尾部尚未上传的纹理要保留像素重试
+  for (auto &texture : m_textures) {
+    if (!texture.requested && texture.image != VK_NULL_HANDLE) {
+      releasePixels(texture, 0);
+    }
+    texture.requested = false;
+  }
+}
+
+VkImageView TextureStreamer::GetImageView(StreamedTextureHandle handle) const {
+  return m_textures[handle].view;
+}
+
+uint32_t
+TextureStreamer::GetResidentMip(StreamedTextureHandle handle) const {
+  return m_textures[handle].residentMip;
+}
+
+uint32_t TextureStreamer::ComputeDesiredMip(uint32_t width, uint32_t height,
+                                            float screenExtentPixels) {
+  float texels = static_cast<float>(std::max(width, height));
+  float ratio = texels / std::max(screenExtentPixels, 1.0f);
+  if (ratio <= 1.0f) {
+    return 0;
+  }
+
+  uint32_t mip = static_cast<uint32_t>(std::floor(std::log2(ratio)));
+  return std::min(mip, mipLevelCount(width, height) - 1);
+}
+
+void TextureStreamer::workerLoop() {
+  while (true) {
+    DecodeRequest request;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(
+          lock, [this] { return m_stopWorker || !m_decodeQueue.empty(); });
+      if (m_stopWorker) {
+        return;
+      }
+      request = std::move(m_decodeQueue.front());
+      m_decodeQueue.pop_front();
+    }
+
+    DecodeResult result{request.handle, {}};
+    try {
+      result.mips = generateMipChain(loadImageRGBA8(request.filename));
+    } catch (const std::exception &e) {
+      LOG_ERROR("texture streaming decode failed: {}", e.what());
+    }
+    // 只把请求的级别交给主线程，其余级别的像素立即释放
+    for (uint32_t i = 0; i < result.mips.size(); i++) {
+      if (i < request.firstMip || i >= request.lastMip) {
+        std::vector<uint8_t>().swap(result.mips[i].pixels);
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_decodedResults.push_back(std::move(result));
+  }
+}
+
+void TextureStreamer::queryBudget() {
+  m_budgetBytes = m_config.budgetBytes;
+  if (!m_context.HasExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+    return;
+  }
+
+  VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT,
+  };
+  VkPhysicalDeviceMemoryProperties2 memProperties = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+      .pNext = &budgetProperties,
+  };
+  vkGetPhysicalDeviceMemoryProperties2(m_context.physicalDevice,
+                                       &memProperties);
+
+  // 汇总所有设备本地堆的预算和用量，用量中已包含本模块的分配
+  VkDeviceSize heapBudget = 0;
+  VkDeviceSize heapUsage = 0;
+  const auto &heaps = memProperties.memoryProperties;
+  for (uint32_t i = 0; i < heaps.memoryHeapCount; i++) {
+    if (heaps.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+      heapBudget += budgetProperties.heapBudget[i];
+      heapUsage += budgetProperties.heapUsage[i];
+    }
+  }
+
+  VkDeviceSize ownUsage = m_residentBytes + m_retiredBytes;
+  VkDeviceSize otherUsage = heapUsage > ownUsage ? heapUsage - ownUsage : 0;
+  VkDeviceSize usable =
+      static_cast<VkDeviceSize>(heapBudget * m_config.budgetUsageRatio);
+  VkDeviceSize available = usable > otherUsage ? usable - otherUsage : 0;
+
+  m_budgetBytes = std::min(m_budgetBytes, available);
+}
+
+void TextureStreamer::collectDecodedTextures() {
+  std::vector<DecodeResult> results;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    results.swap(m_decodedResults);
+  }
+
+  for (auto &result : results) {
+    StreamedTexture &texture = m_textures[result.handle];
+
+    // 重新解码：把请求的级别暂存起来，等待 streamIn 上传
+    if (texture.mipCount != 0) {
+      texture.decoding = false;
+      if (result.mips.size() != texture.mipCount) {
+        LOG_WARN("texture {} changed or failed to decode, stop streaming it",
+                 texture.filename);
+        texture.decodeFailed = true;
+        continue;
+      }
+      for (uint32_t i = 0; i < texture.mipCount; i++) {
+        if (!result.mips[i].pixels.empty()) {
+          texture.mips[i].pixels = std::move(result.mips[i].pixels);
+        }
+      }
+      continue;
+    }
+
+    if (result.mips.empty()) {
+      continue;
+    }
+
+    texture.mips = std::move(result.mips);
+    texture.mipCount = static_cast<uint32_t>(texture.mips.size());
+    texture.residentMip = texture.mipCount;
+
+    // 尾部：第一个最大边长不超过 tailMaxExtent 的 mip
+    texture.tailMip = texture.mipCount - 1;
+    for (uint32_t i = 0; i < texture.mipCount; i++) {
+      const ImageData &mip = texture.mips[i];
+      if (std::max(mip.width, mip.height) <= m_config.tailMaxExtent) {
+        texture.tailMip = i;
+        break;
+      }
+    }
+    texture.requestedMip = texture.tailMip;
+  }
+}
+
+void TextureStreamer::uploadTails() {
+  for (StreamedTextureHandle i = 0; i < m_textures.size(); i++) {
+    StreamedTexture &texture = m_textures[i];
+    if (texture.mipCount == 0 || texture.image != VK_NULL_HANDLE ||
+        texture.uploading || texture.decodeFailed) {
+      continue;
+    }
+    // 缺少像素时重试也无济于事，停止流送
+    if (!hasPixels(texture, texture.tailMip, texture.mipCount)) {
+      LOG_WARN("texture {} has no pixels for its tail, stop streaming it",
+               texture.filename);
+      texture.decodeFailed = true;
+      continue;
+    }
+
+    // 上传时像素已复制到暂存缓冲，之后的级别变化都从旧图像复制，不再需要 CPU 端数据
+    if (beginUpload(i, texture.tailMip)) {
+      releasePixels(texture, 0);
+    }
+  }
+}
+
+void TextureStreamer::pollUploads() {
+  for (auto &texture : m_textures) {
+    if (!texture.uploading ||
+        vkGetFenceStatus(m_context.device, texture.upload.fence) !=
+            VK_SUCCESS) {
+      continue;
+    }
+
+    PendingUpload &upload = texture.upload;
+    vkDestroyFence(m_context.device, upload.fence, nullptr);
+    vkFreeCommandBuffers(m_context.device, m_commandPool, 1,
+                         &upload.commandBuffer);
+    vkDestroyBuffer(m_context.device, upload.stagingBuffer, nullptr);
+    vkFreeMemory(m_context.device, upload.stagingMemory, nullptr);
+
+    // 旧图像可能仍被在途帧采样，延迟销毁
+    if (texture.image != VK_NULL_HANDLE) {
+      m_retiredImages.push_back({m_frameIndex, texture.image, texture.memory,
+                                 texture.view, texture.bytes});
+      m_residentBytes -= texture.bytes;
+      m_retiredBytes += texture.bytes;
+    }
+
+    texture.image = upload.image;
+    texture.memory = upload.memory;
+    texture.view = upload.view;
+    texture.bytes = upload.bytes;
+    texture.residentMip = upload.targetMip;
+    texture.uploading = false;
+    texture.upload = {};
+  }
+}
+
+void TextureStreamer::destroyRetiredImages(bool force) {
+  while (!m_retiredImages.empty()) {
+    const RetiredImage &retired = m_retiredImages.front();
+    if (!force &&
+        retired.retireFrame + m_config.framesInFlight > m_frameIndex) {
+      break;
+    }
+
+    vkDestroyImageView(m_context.device, retired.view, nullptr);
+    vkDestroyImage(m_context.device, retired.image, nullptr);
+    vkFreeMemory(m_context.device, retired.memory, nullptr);
+    m_retiredBytes -= retired.bytes;
+    m_retiredImages.pop_front();
+  }
+}
+
+void TextureStreamer::evictToBudget() {
+  // 等待释放的旧图像几帧内就会释放，不计入降级的目标，否则会多降级
+  VkDeviceSize projected = m_residentBytes;
+  if (projected <= m_budgetBytes) {
+    return;
+  }
+
+  // 最近最少使用的纹理优先降级
+  std::vector<StreamedTextureHandle> candidates;
+  for (StreamedTextureHandle i = 0; i < m_textures.size(); i++) {
+    const StreamedTexture &texture = m_textures[i];
+    if (!texture.uploading && texture.image != VK_NULL_HANDLE &&
+        texture.residentMip < texture.tailMip) {
+      candidates.push_back(i);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [this](StreamedTextureHandle a, StreamedTextureHandle b) {
+              return m_textures[a].lastUsedFrame < m_textures[b].lastUsedFrame;
+            });
+
+  for (StreamedTextureHandle handle : candidates) {
+    if (projected <= m_budgetBytes ||
+        m_uploadsThisFrame >= m_config.maxUploadsPerFrame) {
+      break;
+    }
+
+    StreamedTexture &texture = m_textures[handle];
+    // 未被请求的纹理直接退回尾部，被请求的纹理每次只降一级
+    uint32_t targetMip = texture.requested
+                             ? texture.residentMip + 1
+                             : texture.tailMip;
+    VkDeviceSize newBytes = estimateBytes(texture, targetMip);
+    if (beginUpload(handle, targetMip)) {
+      projected -= texture.bytes - newBytes;
+    }
+  }
+
+  if (projected > m_budgetBytes) {
+    LOG_DEBUG("texture streaming over budget: {} / {} bytes", projected,
+              m_budgetBytes);
+  }
+}
+
+void TextureStreamer::streamIn() {
+  std::vector<StreamedTextureHandle> candidates;
+  for (StreamedTextureHandle i = 0; i < m_textures.size(); i++) {
+    const StreamedTexture &texture = m_textures[i];
+    if (texture.requested && !texture.uploading && !texture.decoding &&
+        !texture.decodeFailed && texture.image != VK_NULL_HANDLE &&
+        texture.requestedMip < texture.residentMip) {
+      candidates.push_back(i);
+    }
+  }
+
+  // 缺口最大的纹理优先
+  std::sort(candidates.begin(), candidates.end(),
+            [this](StreamedTextureHandle a, StreamedTextureHandle b) {
+              const StreamedTexture &ta = m_textures[a];
+              const StreamedTexture &tb = m_textures[b];
+              return ta.residentMip - ta.requestedMip >
+                     tb.residentMip - tb.requestedMip;
+            });
+
+  // 新图像上传期间和上传后的 framesInFlight 帧内旧图像仍占着显存，
+  // 因此按新旧图像同时存在、以及等待释放的旧图像一并计入预算，不会短时超出
+  VkDeviceSize projected = m_residentBytes + m_retiredBytes;
+  for (StreamedTextureHandle handle : candidates) {
+    if (m_uploadsThisFrame >= m_config.maxUploadsPerFrame) {
+      break;
+    }
+
+    StreamedTexture &texture = m_textures[handle];
+    uint32_t targetMip = texture.residentMip - 1;
+    VkDeviceSize newBytes = estimateBytes(texture, targetMip);
+    if (projected + newBytes > m_budgetBytes) {
+      continue;
+    }
+
+    // 新级别的像素尚未暂存时交给后台解码，一次取回直到请求级别的所有级别
+    if (!hasPixels(texture, targetMip, texture.residentMip)) {
+      requestDecode(handle, texture.requestedMip, texture.residentMip);
+      continue;
+    }
+
+    if (beginUpload(handle, targetMip)) {
+      projected += newBytes;
+      releasePixels(texture, targetMip);
+    }
+  }
+}
+
+void TextureStreamer::requestDecode(StreamedTextureHandle handle,
+                                    uint32_t firstMip, uint32_t lastMip) {
+  StreamedTexture &texture = m_textures[handle];
+  texture.decoding = true;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_decodeQueue.push_back({handle, texture.filename, firstMip, lastMip});
+  }
+  m_condition.notify_one();
+}
+
+bool TextureStreamer::beginUpload(StreamedTextureHandle handle,
+                                  uint32_t targetMip) {
+  StreamedTexture &texture = m_textures[handle];
+  const ImageData &top = texture.mips[targetMip];
+  uint32_t levelCount = texture.mipCount - targetMip;
+
+  // 已常驻的级别 [copyMip, mipCount) 从旧图像复制，其余级别从暂存的像素上传
+  bool hasOldImage = texture.image != VK_NULL_HANDLE;
+  uint32_t copyMip = hasOldImage ? std::max(targetMip, texture.residentMip)
+                                 : texture.mipCount;
+  if (!hasPixels(texture, targetMip, copyMip)) {
+    LOG_ERROR("texture {} has no pixels for mips [{}, {})", texture.filename,
+              targetMip, copyMip);
+    return false;
+  }
+
+  PendingUpload upload;
+  upload.targetMip = targetMip;
+  upload.bytes = createImage(
+      m_context, top.width, top.height, levelCount, 1, STREAMED_TEXTURE_FORMAT,
+      VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+          VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+      upload.image, upload.memory);
+  upload.view =
+      createImageView(m_context, upload.image, STREAMED_TEXTURE_FORMAT,
+                      VK_IMAGE_VIEW_TYPE_2D, levelCount, 1);
+
+  // 将新级别按顺序写入暂存缓冲
+  VkDeviceSize stagingSize = 0;
+  for (uint32_t i = targetMip; i < copyMip; i++) {
+    stagingSize += texture.mips[i].ByteSize();
+  }
+
+  std::vector<VkBufferImageCopy> regions;
+  if (stagingSize > 0) {
+    createBuffer(m_context, stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                     VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                 upload.stagingBuffer, upload.stagingMemory);
+
+    void *mapped;
+    vkMapMemory(m_context.device, upload.stagingMemory, 0, stagingSize, 0,
+                &mapped);
+    VkDeviceSize offset = 0;
+    for (uint32_t i = targetMip; i < copyMip; i++) {
+      const ImageData &mip = texture.mips[i];
+      std::memcpy(static_cast<uint8_t *>(mapped) + offset, mip.pixels.data(),
+                  mip.ByteSize());
+
+      regions.push_back({
+          .bufferOffset = offset,
+          .imageSubresource =
+              {
+                  .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                  .mipLevel = i - targetMip,
+                  .baseArrayLayer = 0,
+                  .layerCount = 1,
+              },
+          .imageExtent = {mip.width, mip.height, 1},
+      });
+      offset += mip.ByteSize();
+    }
+    vkUnmapMemory(m_context.device, upload.stagingMemory);
+  }
+
+  std::vector<VkImageCopy> copies;
+  for (uint32_t i = copyMip; i < texture.mipCount; i++) {
+    const ImageData &mip = texture.mips[i];
+    copies.push_back({
+        .srcSubresource =
+            {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = i - texture.residentMip,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+        .dstSubresource =
+            {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = i - targetMip,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+        .extent = {mip.width, mip.height, 1},
+    });
+  }
+
+  VkCommandBufferAllocateInfo allocInfo = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+      .commandPool = m_commandPool,
+      .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+      .commandBufferCount = 1,
+  };
+  vkAllocateCommandBuffers(m_context.device, &allocInfo, &upload.commandBuffer);
+
+  VkCommandBufferBeginInfo beginInfo = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+  };
+  vkBeginCommandBuffer(upload.commandBuffer, &beginInfo);
+
+  cmdTransitionImageLayout(upload.commandBuffer, upload.image,
+                           VK_IMAGE_LAYOUT_UNDEFINED,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0,
+                           levelCount);
+  if (!regions.empty()) {
+    vkCmdCopyBufferToImage(upload.commandBuffer, upload.stagingBuffer,
+                           upload.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(regions.size()),
+                           regions.data());
+  }
+  if (!copies.empty()) {
+    // 旧图像仍可能被在途帧采样，复制前后在同一队列上切换布局
+    uint32_t srcMip = copyMip - texture.residentMip;
+    uint32_t srcCount = static_cast<uint32_t>(copies.size());
+    cmdTransitionImageLayout(upload.commandBuffer, texture.image,
+                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, srcMip,
+                             srcCount);
+    vkCmdCopyImage(upload.commandBuffer, texture.image,
+                   VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, upload.image,
+                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, srcCount,
+                   copies.data());
+    cmdTransitionImageLayout(upload.commandBuffer, texture.image,
+                             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, srcMip,
+                             srcCount);
+  }
+  cmdTransitionImageLayout(upload.commandBuffer, upload.image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 0,
+                           levelCount);
+
+  vkEndCommandBuffer(upload.commandBuffer);
+
+  VkFenceCreateInfo fenceInfo = {
+      .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+  };
+  vkCreateFence(m_context.device, &fenceInfo, nullptr, &upload.fence);
+
+  VkSubmitInfo submitInfo = {
+      .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+      .commandBufferCount = 1,
+      .pCommandBuffers = &upload.commandBuffer,
+  };
+
+  if (vkQueueSubmit(m_context.graphicsQueue, 1, &submitInfo, upload.fence) !=
+      VK_SUCCESS) {
+    LOG_ERROR("failed to submit texture upload for {}", texture.filename);
+    vkDestroyFence(m_context.device, upload.fence, nullptr);
+    vkFreeCommandBuffers(m_context.device, m_commandPool, 1,
+                         &upload.commandBuffer);
+    vkDestroyBuffer(m_context.device, upload.stagingBuffer, nullptr);
+    vkFreeMemory(m_context.device, upload.stagingMemory, nullptr);
+    vkDestroyImageView(m_context.device, upload.view, nullptr);
+    vkDestroyImage(m_context.device, upload.image, nullptr);
+    vkFreeMemory(m_context.device, upload.memory, nullptr);
+    return false;
+  }
+
+  m_residentBytes += upload.bytes;
+  m_uploadsThisFrame++;
+  texture.upload = upload;
+  texture.uploading = true;
+  return true;
+}
+
+VkDeviceSize TextureStreamer::estimateBytes(const StreamedTexture &texture,
+                                            uint32_t firstMip) const {
+  VkDeviceSize bytes = 0;
+  for (uint32_t i = firstMip; i < texture.mipCount; i++) {
+    bytes += levelBytes(texture.mips[i]);
+  }
+  return bytes;
+}
+
+bool TextureStreamer::hasPixels(const StreamedTexture &texture,
+                                uint32_t firstMip, uint32_t lastMip) {
+  for (uint32_t i = firstMip; i < lastMip; i++) {
+    if (texture.mips[i].ByteSize() != levelBytes(texture.mips[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TextureStreamer::releasePixels(StreamedTexture &texture,
+                                    uint32_t firstMip) {
+  for (uint32_t i = firstMip; i < texture.mips.size(); i++) {
+    std::vector<uint8_t>().swap(texture.mips[i].pixels);
+  }
+}
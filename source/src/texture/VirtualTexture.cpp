@@ -0,0 +1,798 @@
+#include "Texture/VirtualTexture.hpp"
+
+#include "Vulkan/VkUtils.hpp"
+#include "utils/log.hpp"
+#include "utils/stb_image.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+constexpr VkFormat CACHE_FORMAT = VK_FORMAT_R8G8B8A8_SRGB;
+constexpr VkFormat PAGE_TABLE_FORMAT = VK_FORMAT_R8G8B8A8_UINT;
+constexpr VkFormat FEEDBACK_FORMAT = VK_FORMAT_R32_UINT;
+constexpr VkFormat FEEDBACK_DEPTH_FORMAT = VK_FORMAT_D32_SFLOAT;
+constexpr uint32_t MAX_CACHED_SOURCES = 8; // 后台线程缓存的已解码源图像数
+
+// 页表项：r/g 为物理页坐标，b 为映射页面所在级别，a 非零表示有效
+uint32_t packEntry(uint32_t slotX, uint32_t slotY, uint32_t level) {
+  return slotX | (slotY << 8) | (level << 16) | (1u << 24);
+}
+} // namespace
+
+VirtualTexture::VirtualTexture(const VkContext &context,
+                               VkExtent2D screenExtent,
+                               const VirtualTextureConfig &config)
+    : m_context(context), m_config(config) {
+  if (m_config.cachePagesPerSide > 256) {
+    throw std::runtime_error("virtual texture cache exceeds 256 pages per side");
+  }
+
+  m_levelCount = 1;
+  while ((m_config.virtualPagesPerSide >> (m_levelCount - 1)) > 1) {
+    m_levelCount++;
+  }
+
+  createResources(screenExtent);
+  createFeedbackResources();
+
+  m_worker = std::thread(&VirtualTexture::workerLoop, this);
+}
+
+VirtualTexture::~VirtualTexture() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopWorker = true;
+  }
+  m_condition.notify_all();
+  m_worker.join();
+
+  VkDevice device = m_context.device;
+  for (size_t i = 0; i < m_readbackBuffers.size(); i++) {
+    vkUnmapMemory(device, m_readbackMemories[i]);
+    vkDestroyBuffer(device, m_readbackBuffers[i], nullptr);
+    vkFreeMemory(device, m_readbackMemories[i], nullptr);
+  }
+  vkDestroyFramebuffer(device, m_feedbackFramebuffer, nullptr);
+  vkDestroyRenderPass(device, m_feedbackRenderPass, nullptr);
+  vkDestroyImageView(device, m_feedbackDepthView, nullptr);
+  vkDestroyImage(device, m_feedbackDepthImage, nullptr);
+  vkFreeMemory(device, m_feedbackDepthMemory, nullptr);
+  vkDestroyImageView(device, m_feedbackView, nullptr);
+  vkDestroyImage(device, m_feedbackImage, nullptr);
+  vkFreeMemory(device, m_feedbackMemory, nullptr);
+
+  vkUnmapMemory(device, m_stagingMemory);
+  vkDestroyBuffer(device, m_stagingBuffer, nullptr);
+  vkFreeMemory(device, m_stagingMemory, nullptr);
+
+  vkDestroySampler(device, m_pageTableSampler, nullptr);
+  vkDestroyImageView(device, m_pageTableView, nullptr);
+  vkDestroyImage(device, m_pageTableImage, nullptr);
+  vkFreeMemory(device, m_pageTableMemory, nullptr);
+  vkDestroySampler(device, m_cacheSampler, nullptr);
+  vkDestroyImageView(device, m_cacheView, nullptr);
+  vkDestroyImage(device, m_cacheImage, nullptr);
+  vkFreeMemory(device, m_cacheMemory, nullptr);
+}
+
+void VirtualTexture::createResources(VkExtent2D screenExtent) {
+  uint32_t cacheExtent = m_config.cachePagesPerSide * paddedPageSize();
+
+  // 1. 物理页缓存：单级 mip，页面之间靠边框避免过滤串色
+  createImage(m_context, cacheExtent, cacheExtent, 1, 1, CACHE_FORMAT,
+              VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+              m_cacheImage, m_cacheMemory);
+  m_cacheView = createImageView(m_context, m_cacheImage, CACHE_FORMAT,
+                                VK_IMAGE_VIEW_TYPE_2D, 1, 1);
+
+  VkSamplerCreateInfo cacheSamplerInfo = {
+      .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+      .magFilter = VK_FILTER_LINEAR,
+      .minFilter = VK_FILTER_LINEAR,
+      .mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+      .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .minLod = 0.0f,
+      .maxLod = 0.0f,
+  };
+  if (vkCreateSampler(m_context.device, &cacheSamplerInfo, nullptr,
+                      &m_cacheSampler) != VK_SUCCESS) {
+    LOG_ERROR("failed to create virtual texture cache sampler!");
+    throw std::runtime_error("failed to create virtual texture cache sampler!");
+  }
+
+  // 2. 页表：每个虚拟页一个texel，每级 mip 对应一个虚拟级别
+  createImage(m_context, m_config.virtualPagesPerSide,
+              m_config.virtualPagesPerSide, m_levelCount, 1, PAGE_TABLE_FORMAT,
+              VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+              m_pageTableImage, m_pageTableMemory);
+  m_pageTableView =
+      createImageView(m_context, m_pageTableImage, PAGE_TABLE_FORMAT,
+                      VK_IMAGE_VIEW_TYPE_2D, m_levelCount, 1);
+
+  VkSamplerCreateInfo pageTableSamplerInfo = {
+      .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+      .magFilter = VK_FILTER_NEAREST,
+      .minFilter = VK_FILTER_NEAREST,
+      .mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+      .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .minLod = 0.0f,
+      .maxLod = static_cast<float>(m_levelCount - 1),
+  };
+  if (vkCreateSampler(m_context.device, &pageTableSamplerInfo, nullptr,
+                      &m_pageTableSampler) != VK_SUCCESS) {
+    LOG_ERROR("failed to create virtual texture page table sampler!");
+    throw std::runtime_error(
+        "failed to create virtual texture page table sampler!");
+  }
+
+  m_pageEntries.resize(m_levelCount);
+  m_resolvedEntries.resize(m_levelCount);
+  VkDeviceSize pageTableBytes = 0;
+  for (uint32_t level = 0; level < m_levelCount; level++) {
+    size_t count = size_t(levelPages(level)) * levelPages(level);
+    m_pageEntries[level].assign(count, 0);
+    m_resolvedEntries[level].assign(count, 0);
+    pageTableBytes += count * sizeof(uint32_t);
+  }
+
+  // 3. 暂存缓冲：每帧一段，容纳本帧上传的页面和完整页表
+  VkDeviceSize pageBytes = VkDeviceSize(paddedPageSize()) * paddedPageSize() * 4;
+  m_stagingFrameSize = pageBytes * m_config.maxUploadsPerFrame + pageTableBytes;
+  createBuffer(m_context, m_stagingFrameSize * m_config.framesInFlight,
+               VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+               m_stagingBuffer, m_stagingMemory);
+  vkMapMemory(m_context.device, m_stagingMemory, 0, VK_WHOLE_SIZE, 0,
+              reinterpret_cast<void **>(&m_stagingMapped));
+
+  // 4. 物理槽位
+  uint32_t slotCount = m_config.cachePagesPerSide * m_config.cachePagesPerSide;
+  m_slots.resize(slotCount);
+  m_freeSlots.reserve(slotCount);
+  for (uint32_t i = slotCount; i > 0; i--) {
+    m_freeSlots.push_back(i - 1);
+  }
+
+  m_feedbackExtent = {
+      std::max(screenExtent.width / m_config.feedbackDivisor, 1u),
+      std::max(screenExtent.height / m_config.feedbackDivisor, 1u),
+  };
+
+  LOG_INFO("virtual texture: {} pages cache ({}x{} px), {} virtual levels",
+           slotCount, cacheExtent, cacheExtent, m_levelCount);
+}
+
+void VirtualTexture::createFeedbackResources() {
+  createImage(m_context, m_feedbackExtent.width, m_feedbackExtent.height, 1, 1,
+              FEEDBACK_FORMAT,
+              VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                  VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+              m_feedbackImage, m_feedbackMemory);
+  m_feedbackView = createImageView(m_context, m_feedbackImage, FEEDBACK_FORMAT,
+                                   VK_IMAGE_VIEW_TYPE_2D, 1, 1);
+
+  createImage(m_context, m_feedbackExtent.width, m_feedbackExtent.height, 1, 1,
+              FEEDBACK_DEPTH_FORMAT,
+              VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+              m_feedbackDepthImage, m_feedbackDepthMemory);
+  m_feedbackDepthView = createImageView(
+      m_context, m_feedbackDepthImage, FEEDBACK_DEPTH_FORMAT,
+      VK_IMAGE_VIEW_TYPE_2D, 1, 1, VK_IMAGE_ASPECT_DEPTH_BIT);
+
+  VkAttachmentDescription attachments[2] = {
+      {
+          .format = FEEDBACK_FORMAT,
+          .samples = VK_SAMPLE_COUNT_1_BIT,
+          .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+          .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+          .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+          .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+          .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+          .finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+      },
+      {
+          .format = FEEDBACK_DEPTH_FORMAT,
+          .samples = VK_SAMPLE_COUNT_1_BIT,
+          .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+          .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+          .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+          .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+          .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+          .finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+      },
+  };
+
+  VkAttachmentReference colorRef = {
+      .attachment = 0,
+      .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+  };
+  VkAttachmentReference depthRef = {
+      .attachment = 1,
+      .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+  };
+
+  VkSubpassDescription subpass = {
+      .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+      .colorAttachmentCount = 1,
+      .pColorAttachments = &colorRef,
+      .pDepthStencilAttachment = &depthRef,
+  };
+
+  // 结束后反馈图像会被复制到回读缓冲
+  VkSubpassDependency dependencies[2] = {
+      {
+          .srcSubpass = VK_SUBPASS_EXTERNAL,
+          .dstSubpass = 0,
+          .srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT,
+          .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                          VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+          .srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+          .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                           VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+      },
+      {
+          .srcSubpass = 0,
+          .dstSubpass = VK_SUBPASS_EXTERNAL,
+          .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+          .dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT,
+          .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+          .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+      },
+  };
+
+  VkRenderPassCreateInfo renderPassInfo = {
+      .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+      .attachmentCount = 2,
+      .pAttachments = attachments,
+      .subpassCount = 1,
+      .pSubpasses = &subpass,
+      .dependencyCount = 2,
+      .pDependencies = dependencies,
+  };
+  if (vkCreateRenderPass(m_context.device, &renderPassInfo, nullptr,
+                         &m_feedbackRenderPass) != VK_SUCCESS) {
+    LOG_ERROR("failed to create virtual texture feedback render pass!");
+    throw std::runtime_error(
+        "failed to create virtual texture feedback render pass!");
+  }
+
+  VkImageView framebufferAttachments[2] = {m_feedbackView,
+                                           m_feedbackDepthView};
+  VkFramebufferCreateInfo framebufferInfo = {
+      .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+      .renderPass = m_feedbackRenderPass,
+      .attachmentCount = 2,
+      .pAttachments = framebufferAttachments,
+      .width = m_feedbackExtent.width,
+      .height = m_feedbackExtent.height,
+      .layers = 1,
+  };
+  if (vkCreateFramebuffer(m_context.device, &framebufferInfo, nullptr,
+                          &m_feedbackFramebuffer) != VK_SUCCESS) {
+    LOG_ERROR("failed to create virtual texture feedback framebuffer!");
+    throw std::runtime_error(
+        "failed to create virtual texture feedback framebuffer!");
+  }
+
+  // 每个在途帧一个常驻映射的回读缓冲
+  VkDeviceSize readbackSize =
+      VkDeviceSize(m_feedbackExtent.width) * m_feedbackExtent.height * 4;
+  uint32_t frames = m_config.framesInFlight;
+  m_readbackBuffers.resize(frames);
+  m_readbackMemories.resize(frames);
+  m_readbackMapped.resize(frames);
+  m_readbackValid.assign(frames, false);
+  for (uint32_t i = 0; i < frames; i++) {
+    createBuffer(m_context, readbackSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                     VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                 m_readbackBuffers[i], m_readbackMemories[i]);
+    void *mapped;
+    vkMapMemory(m_context.device, m_readbackMemories[i], 0, VK_WHOLE_SIZE, 0,
+                &mapped);
+    m_readbackMapped[i] = static_cast<const uint32_t *>(mapped);
+  }
+}
+
+VirtualTextureRegion VirtualTexture::AddTexture(const std::string &filename) {
+  int width = 0, height = 0, channels = 0;
+  if (!stbi_info(filename.c_str(), &width, &height, &channels)) {
+    LOG_ERROR("failed to read image info: {}", filename);
+    throw std::runtime_error("failed to read image info: " + filename);
+  }
+
+  VirtualSource source;
+  source.filename = filename;
+  source.width = static_cast<uint32_t>(width);
+  source.height = static_cast<uint32_t>(height);
+  source.pagesW = (source.width + m_config.pageSize - 1) / m_config.pageSize;
+  source.pagesH = (source.height + m_config.pageSize - 1) / m_config.pageSize;
+
+  // 货架分配：当前行放不下时换到下一行
+  uint32_t pages = m_config.virtualPagesPerSide;
+  if (m_shelfX + source.pagesW > pages) {
+    m_shelfY += m_shelfHeight;
+    m_shelfX = 0;
+    m_shelfHeight = 0;
+  }
+  if (source.pagesW > pages || m_shelfY + source.pagesH > pages) {
+    LOG_ERROR("virtual texture address space exhausted by {}", filename);
+    throw std::runtime_error("virtual texture address space exhausted");
+  }
+
+  source.pageX = m_shelfX;
+  source.pageY = m_shelfY;
+  m_shelfX += source.pagesW;
+  m_shelfHeight = std::max(m_shelfHeight, source.pagesH);
+
+  float virtualSize = static_cast<float>(pages * m_config.pageSize);
+  VirtualTextureRegion region = {
+      .uvOffset = {source.pageX * m_config.pageSize / virtualSize,
+                   source.pageY * m_config.pageSize / virtualSize},
+      .uvScale = {source.width / virtualSize, source.height / virtualSize},
+  };
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sources.push_back(std::move(source));
+  }
+
+  return region;
+}
+
+void VirtualTexture::Update(VkCommandBuffer commandBuffer,
+                            uint64_t frameIndex) {
+  uint32_t frameSlot =
+      static_cast<uint32_t>(frameIndex % m_config.framesInFlight);
+
+  // 1. 读取本帧槽位上一次写入的反馈（该帧已完成）并发出加载请求
+  if (m_readbackValid[frameSlot]) {
+    processFeedback(frameIndex);
+    m_readbackValid[frameSlot] = false;
+  }
+
+  // 2. 领取后台线程切好的页面
+  std::vector<LoadedPage> loaded;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = std::min<size_t>(m_loadedPages.size(),
+                                    m_config.maxUploadsPerFrame);
+    loaded.assign(std::make_move_iterator(m_loadedPages.begin()),
+                  std::make_move_iterator(m_loadedPages.begin() + count));
+    m_loadedPages.erase(m_loadedPages.begin(), m_loadedPages.begin() + count);
+  }
+
+  VkImageLayout oldLayout = m_imagesInitialized
+                                ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+                                : VK_IMAGE_LAYOUT_UNDEFINED;
+  if (loaded.empty() && !m_pageTableDirty && m_imagesInitialized) {
+    return;
+  }
+
+  cmdTransitionImageLayout(commandBuffer, m_cacheImage, oldLayout,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0, 1);
+  cmdTransitionImageLayout(commandBuffer, m_pageTableImage, oldLayout,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0,
+                           m_levelCount);
+
+  // 3. 把页面写入物理缓存槽位
+  uint8_t *staging = m_stagingMapped + m_stagingFrameSize * frameSlot;
+  VkDeviceSize stagingBase = m_stagingFrameSize * frameSlot;
+  VkDeviceSize offset = 0;
+  uint32_t padded = paddedPageSize();
+
+  std::vector<VkBufferImageCopy> cacheRegions;
+  for (auto &page : loaded) {
+    m_pendingPages.erase(page.pageKey);
+    if (m_residentPages.count(page.pageKey)) {
+      continue;
+    }
+
+    uint32_t slot = allocateSlot(frameIndex);
+    if (slot == INVALID_PAGE) {
+      continue; // 缓存中全是本帧在用的页面，等反馈再次请求
+    }
+
+    uint32_t slotX = slot % m_config.cachePagesPerSide;
+    uint32_t slotY = slot / m_config.cachePagesPerSide;
+    std::memcpy(staging + offset, page.pixels.data(), page.pixels.size());
+    cacheRegions.push_back({
+        .bufferOffset = stagingBase + offset,
+        .imageSubresource =
+            {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = 0,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+        .imageOffset = {static_cast<int32_t>(slotX * padded),
+                        static_cast<int32_t>(slotY * padded), 0},
+        .imageExtent = {padded, padded, 1},
+    });
+    offset += page.pixels.size();
+
+    uint32_t level = pageLevel(page.pageKey);
+    m_slots[slot] = {page.pageKey, frameIndex, level == m_levelCount - 1};
+    m_residentPages[page.pageKey] = slot;
+    m_pageEntries[level][pageY(page.pageKey) * levelPages(level) +
+                         pageX(page.pageKey)] = packEntry(slotX, slotY, level);
+    m_pageTableDirty = true;
+  }
+
+  if (!cacheRegions.empty()) {
+    vkCmdCopyBufferToImage(commandBuffer, m_stagingBuffer, m_cacheImage,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(cacheRegions.size()),
+                           cacheRegions.data());
+  }
+
+  // 4. 解析回退并整表上传页表（页表很小，整表上传比追踪脏区域简单）
+  if (m_pageTableDirty || !m_imagesInitialized) {
+    rebuildPageTable();
+
+    std::vector<VkBufferImageCopy> tableRegions;
+    for (uint32_t level = 0; level < m_levelCount; level++) {
+      const auto &entries = m_resolvedEntries[level];
+      size_t bytes = entries.size() * sizeof(uint32_t);
+      std::memcpy(staging + offset, entries.data(), bytes);
+      tableRegions.push_back({
+          .bufferOffset = stagingBase + offset,
+          .imageSubresource =
+              {
+                  .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                  .mipLevel = level,
+                  .baseArrayLayer = 0,
+                  .layerCount = 1,
+              },
+          .imageExtent = {levelPages(level), levelPages(level), 1},
+      });
+      offset += bytes;
+    }
+
+    vkCmdCopyBufferToImage(commandBuffer, m_stagingBuffer, m_pageTableImage,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(tableRegions.size()),
+                           tableRegions.data());
+    m_pageTableDirty = false;
+  }
+
+  cmdTransitionImageLayout(commandBuffer, m_cacheImage,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 0, 1);
+  cmdTransitionImageLayout(commandBuffer, m_pageTableImage,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 0,
+                           m_levelCount);
+  m_imagesInitialized = true;
+}
+
+void VirtualTexture::BeginFeedbackPass(VkCommandBuffer commandBuffer,
+                                       uint64_t frameIndex) {
+  VkClearValue clearValues[2] = {};
+  clearValues[0].color.uint32[0] = INVALID_PAGE;
+  clearValues[1].depthStencil = {1.0f, 0};
+
+  VkRenderPassBeginInfo beginInfo = {
+      .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+      .renderPass = m_feedbackRenderPass,
+      .framebuffer = m_feedbackFramebuffer,
+      .renderArea = {{0, 0}, m_feedbackExtent},
+      .clearValueCount = 2,
+      .pClearValues = clearValues,
+  };
+  vkCmdBeginRenderPass(commandBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+}
+
+void VirtualTexture::EndFeedbackPass(VkCommandBuffer commandBuffer,
+                                     uint64_t frameIndex) {
+  vkCmdEndRenderPass(commandBuffer);
+
+  uint32_t frameSlot =
+      static_cast<uint32_t>(frameIndex % m_config.framesInFlight);
+  VkBufferImageCopy region = {
+      .bufferOffset = 0,
+      .imageSubresource =
+          {
+              .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+              .mipLevel = 0,
+              .baseArrayLayer = 0,
+              .layerCount = 1,
+          },
+      .imageExtent = {m_feedbackExtent.width, m_feedbackExtent.height, 1},
+  };
+  vkCmdCopyImageToBuffer(commandBuffer, m_feedbackImage,
+                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                         m_readbackBuffers[frameSlot], 1, &region);
+
+  VkBufferMemoryBarrier barrier = {
+      .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .buffer = m_readbackBuffers[frameSlot],
+      .offset = 0,
+      .size = VK_WHOLE_SIZE,
+  };
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &barrier,
+                       0, nullptr);
+
+  m_readbackValid[frameSlot] = true;
+}
+
+VirtualTextureShaderConstants VirtualTexture::GetShaderConstants() const {
+  return {
+      .pageSize = m_config.pageSize,
+      .pageBorder = m_config.pageBorder,
+      .cachePagesPerSide = m_config.cachePagesPerSide,
+      .virtualPagesPerSide = m_config.virtualPagesPerSide,
+      .maxMipLevel = m_levelCount - 1,
+      .feedbackScale = 1.0f / static_cast<float>(m_config.feedbackDivisor),
+  };
+}
+
+void VirtualTexture::FillSpecializationInfo(
+    const VirtualTextureShaderConstants &constants,
+    VkSpecializationMapEntry (&entries)[6], VkSpecializationInfo &info) {
+  const uint32_t offsets[6] = {
+      offsetof(VirtualTextureShaderConstants, pageSize),
+      offsetof(VirtualTextureShaderConstants, pageBorder),
+      offsetof(VirtualTextureShaderConstants, cachePagesPerSide),
+      offsetof(VirtualTextureShaderConstants, virtualPagesPerSide),
+      offsetof(VirtualTextureShaderConstants, maxMipLevel),
+      offsetof(VirtualTextureShaderConstants, feedbackScale),
+  };
+  for (uint32_t i = 0; i < 6; i++) {
+    entries[i] = {i, offsets[i], 4};
+  }
+
+  info = {
+      .mapEntryCount = 6,
+      .pMapEntries = entries,
+      .dataSize = sizeof(VirtualTextureShaderConstants),
+      .pData = &constants,
+  };
+}
+
+void VirtualTexture::workerLoop() {
+  // 已解码的源图像 mip 链，只在后台线程内访问
+  std::unordered_map<uint32_t, std::vector<ImageData>> sourceCache;
+  std::deque<uint32_t> cacheOrder;
+
+  while (true) {
+    uint32_t pageKey;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock,
+                       [this] { return m_stopWorker || !m_loadQueue.empty(); });
+      if (m_stopWorker) {
+        return;
+      }
+      pageKey = m_loadQueue.front();
+      m_loadQueue.pop_front();
+    }
+
+    LoadedPage page{pageKey, {}};
+    buildPage(pageKey, page.pixels, sourceCache, cacheOrder);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_loadedPages.push_back(std::move(page));
+  }
+}
+
+void VirtualTexture::buildPage(
+    uint32_t pageKey, std::vector<uint8_t> &pixels,
+    std::unordered_map<uint32_t, std::vector<ImageData>> &cache,
+    std::deque<uint32_t> &cacheOrder) {
+  const uint32_t level = pageLevel(pageKey);
+  const uint32_t pageSize = m_config.pageSize;
+  const uint32_t padded = paddedPageSize();
+  pixels.assign(size_t(padded) * padded * 4, 0);
+
+  // 页面（含边框）在本级虚拟像素空间中的范围，超出虚拟空间的部分钳制到边缘
+  const int64_t levelExtent = int64_t(levelPages(level)) * pageSize;
+  const int64_t tileX = int64_t(pageX(pageKey)) * pageSize - m_config.pageBorder;
+  const int64_t tileY = int64_t(pageY(pageKey)) * pageSize - m_config.pageBorder;
+
+  // 找出与页面相交的源图像（第 0 级像素空间）
+  std::vector<std::pair<uint32_t, VirtualSource>> overlapping;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int64_t x0 = std::max<int64_t>(tileX, 0) << level;
+    int64_t y0 = std::max<int64_t>(tileY, 0) << level;
+    int64_t x1 = std::min<int64_t>(tileX + padded, levelExtent) << level;
+    int64_t y1 = std::min<int64_t>(tileY + padded, levelExtent) << level;
+    for (uint32_t i = 0; i < m_sources.size(); i++) {
+      const VirtualSource &source = m_sources[i];
+      int64_t sx0 = int64_t(source.pageX) * pageSize;
+      int64_t sy0 = int64_t(source.pageY) * pageSize;
+      int64_t sx1 = sx0 + int64_t(source.pagesW) * pageSize;
+      int64_t sy1 = sy0 + int64_t(source.pagesH) * pageSize;
+      if (sx0 < x1 && sx1 > x0 && sy0 < y1 && sy1 > y0) {
+        overlapping.emplace_back(i, source);
+      }
+    }
+  }
+
+  for (const auto &[index, source] : overlapping) {
+    auto it = cache.find(index);
+    if (it == cache.end()) {
+      try {
+        it = cache.emplace(index,
+                           generateMipChain(loadImageRGBA8(source.filename)))
+                 .first;
+      } catch (const std::exception &e) {
+        LOG_ERROR("virtual texture page load failed: {}", e.what());
+        continue;
+      }
+      cacheOrder.push_back(index);
+      if (cacheOrder.size() > MAX_CACHED_SOURCES) {
+        cache.erase(cacheOrder.front());
+        cacheOrder.pop_front();
+      }
+    }
+
+    // 级别超过源图像 mip 数时使用最粗的 mip
+    const auto &mips = it->second;
+    const uint32_t mip = std::min<uint32_t>(level, uint32_t(mips.size()) - 1);
+    const ImageData &image = mips[mip];
+
+    const int64_t originX = int64_t(source.pageX) * pageSize;
+    const int64_t originY = int64_t(source.pageY) * pageSize;
+    const int64_t endX = originX + int64_t(source.pagesW) * pageSize;
+    const int64_t endY = originY + int64_t(source.pagesH) * pageSize;
+
+    for (uint32_t py = 0; py < padded; py++) {
+      int64_t vy = std::clamp<int64_t>(tileY + py, 0, levelExtent - 1) << level;
+      if (vy < originY || vy >= endY) {
+        continue;
+      }
+      int64_t sy = std::min<int64_t>((vy - originY) >> mip, image.height - 1);
+
+      for (uint32_t px = 0; px < padded; px++) {
+        int64_t vx =
+            std::clamp<int64_t>(tileX + px, 0, levelExtent - 1) << level;
+        if (vx < originX || vx >= endX) {
+          continue;
+        }
+        // 源图像按页对齐后的空白区域重复边缘像素
+        int64_t sx = std::min<int64_t>((vx - originX) >> mip, image.width - 1);
+        std::memcpy(&pixels[(size_t(py) * padded + px) * 4],
+                    &image.pixels[(size_t(sy) * image.width + sx) * 4], 4);
+      }
+    }
+  }
+}
+
+void VirtualTexture::processFeedback(uint64_t frameIndex) {
+  uint32_t frameSlot =
+      static_cast<uint32_t>(frameIndex % m_config.framesInFlight);
+  const uint32_t *feedback = m_readbackMapped[frameSlot];
+  size_t count =
+      size_t(m_feedbackExtent.width) * m_feedbackExtent.height;
+
+  // 反馈中相邻像素大多请求同一页，先去重
+  std::unordered_set<uint32_t> unique;
+  uint32_t previous = INVALID_PAGE;
+  for (size_t i = 0; i < count; i++) {
+    uint32_t key = feedback[i];
+    if (key == INVALID_PAGE || key == previous) {
+      continue;
+    }
+    previous = key;
+
+    uint32_t level = pageLevel(key);
+    if (level >= m_levelCount || pageX(key) >= levelPages(level) ||
+        pageY(key) >= levelPages(level)) {
+      continue;
+    }
+    unique.insert(key);
+  }
+
+  std::vector<uint32_t> requests;
+  for (uint32_t key : unique) {
+    requestPage(key, frameIndex, requests);
+  }
+  if (requests.empty()) {
+    return;
+  }
+
+  // 粗级别优先加载，尽快提供可回退的数据
+  std::sort(requests.begin(), requests.end(), [](uint32_t a, uint32_t b) {
+    return pageLevel(a) > pageLevel(b);
+  });
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (uint32_t key : requests) {
+      if (m_loadQueue.size() >= m_config.maxPendingRequests) {
+        m_pendingPages.erase(key); // 超出队列上限，下次反馈再请求
+        continue;
+      }
+      m_loadQueue.push_back(key);
+    }
+  }
+  m_condition.notify_one();
+}
+
+void VirtualTexture::requestPage(uint32_t pageKey, uint64_t frameIndex,
+                                 std::vector<uint32_t> &requests) {
+  uint32_t level = pageLevel(pageKey);
+  uint32_t x = pageX(pageKey);
+  uint32_t y = pageY(pageKey);
+
+  // 沿父级向上，直到遇到已常驻的页面；途中缺失的页面全部请求
+  for (; level < m_levelCount; level++, x >>= 1, y >>= 1) {
+    uint32_t key = makePageKey(level, x, y);
+    auto it = m_residentPages.find(key);
+    if (it != m_residentPages.end()) {
+      m_slots[it->second].lastUsedFrame = frameIndex;
+      return;
+    }
+    if (m_pendingPages.insert(key).second) {
+      requests.push_back(key);
+    }
+  }
+}
+
+uint32_t VirtualTexture::allocateSlot(uint64_t frameIndex) {
+  if (!m_freeSlots.empty()) {
+    uint32_t slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+    return slot;
+  }
+
+  // 淘汰最近最少使用且本帧未被引用的页面
+  uint32_t victim = INVALID_PAGE;
+  uint64_t oldest = frameIndex;
+  for (uint32_t i = 0; i < m_slots.size(); i++) {
+    const CacheSlot &slot = m_slots[i];
+    if (!slot.pinned && slot.lastUsedFrame < oldest) {
+      oldest = slot.lastUsedFrame;
+      victim = i;
+    }
+  }
+  if (victim == INVALID_PAGE) {
+    return INVALID_PAGE;
+  }
+
+  uint32_t key = m_slots[victim].pageKey;
+  uint32_t level = pageLevel(key);
+  m_residentPages.erase(key);
+  m_pageEntries[level][pageY(key) * levelPages(level) + pageX(key)] = 0;
+  m_slots[victim] = {};
+  m_pageTableDirty = true;
+
+  return victim;
+}
+
+void VirtualTexture::rebuildPageTable() {
+  // 自粗到细：没有自身映射的页面继承父页面的映射
+  for (uint32_t level = m_levelCount; level-- > 0;) {
+    uint32_t pages = levelPages(level);
+    const auto &own = m_pageEntries[level];
+    auto &resolved = m_resolvedEntries[level];
+
+    for (uint32_t y = 0; y < pages; y++) {
+      for (uint32_t x = 0; x < pages; x++) {
+        uint32_t index = y * pages + x;
+        if (own[index] != 0 || level == m_levelCount - 1) {
+          resolved[index] = own[index];
+        } else {
+          uint32_t parentPages = levelPages(level + 1);
+          resolved[index] =
+              m_resolvedEntries[level + 1][(y >> 1) * parentPages + (x >> 1)];
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,222 @@
+#include "utils/JsonReader.hpp"
+
+#include "utils/log.hpp"
+
+#include <charconv>
+#include <stdexcept>
+
+JsonType JsonReader::Peek() {
+  switch (peekChar()) {
+  case '{':
+    return JsonType::Object;
+  case '[':
+    return JsonType::Array;
+  case '"':
+    return JsonType::String;
+  case 't':
+  case 'f':
+    return JsonType::Bool;
+  case 'n':
+    return JsonType::Null;
+  default:
+    return JsonType::Number;
+  }
+}
+
+void JsonReader::BeginObject() { expect('{'); }
+
+bool JsonReader::NextKey(std::string_view &key) {
+  skipCommaBefore('}');
+  if (peekChar() == '}') {
+    m_pos++;
+    return false;
+  }
+  key = ReadRawString();
+  expect(':');
+  return true;
+}
+
+void JsonReader::BeginArray() { expect('['); }
+
+bool JsonReader::NextElement() {
+  skipCommaBefore(']');
+  if (peekChar() == ']') {
+    m_pos++;
+    return false;
+  }
+  return true;
+}
+
+double JsonReader::ReadNumber() {
+  skipWhitespace();
+  double value;
+  auto [next, error] = std::from_chars(m_text.data() + m_pos,
+                                       m_text.data() + m_text.size(), value);
+  if (error != std::errc()) {
+    fail("expected a number");
+  }
+  m_pos = next - m_text.data();
+  return value;
+}
+
+uint32_t JsonReader::ReadUint() {
+  double value = ReadNumber();
+  if (value < 0.0 || value > double(UINT32_MAX) ||
+      value != static_cast<double>(static_cast<uint32_t>(value))) {
+    fail("expected an unsigned integer");
+  }
+  return static_cast<uint32_t>(value);
+}
+
+bool JsonReader::ReadBool() {
+  skipWhitespace();
+  std::string_view rest = m_text.substr(m_pos);
+  if (rest.starts_with("true")) {
+    m_pos += 4;
+    return true;
+  }
+  if (rest.starts_with("false")) {
+    m_pos += 5;
+    return false;
+  }
+  fail("expected a boolean");
+}
+
+std::string_view JsonReader::ReadRawString() {
+  expect('"');
+  size_t begin = m_pos;
+  while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+    m_pos += m_text[m_pos] == '\\' ? 2 : 1;
+  }
+  if (m_pos >= m_text.size()) {
+    fail("unterminated string");
+  }
+  return m_text.substr(begin, m_pos++ - begin);
+}
+
+std::string JsonReader::ReadString() {
+  std::string_view raw = ReadRawString();
+  std::string result;
+  result.reserve(raw.size());
+  for (size_t i = 0; i < raw.size(); i++) {
+    if (raw[i] != '\\') {
+      result.push_back(raw[i]);
+      continue;
+    }
+    char c = raw[++i];
+    switch (c) {
+    case 'n':
+      result.push_back('\n');
+      break;
+    case 't':
+      result.push_back('\t');
+      break;
+    case 'r':
+      result.push_back('\r');
+      break;
+    case 'b':
+      result.push_back('\b');
+      break;
+    case 'f':
+      result.push_back('\f');
+      break;
+    case 'u': {
+      // 只处理基本多文种平面，按 UTF-8 编码
+      uint32_t code = 0;
+      if (i + 4 >= raw.size() ||
+          std::from_chars(raw.data() + i + 1, raw.data() + i + 5, code, 16)
+                  .ec != std::errc()) {
+        fail("invalid unicode escape");
+      }
+      i += 4;
+      if (code < 0x80) {
+        result.push_back(static_cast<char>(code));
+      } else if (code < 0x800) {
+        result.push_back(static_cast<char>(0xC0 | (code >> 6)));
+        result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+      } else {
+        result.push_back(static_cast<char>(0xE0 | (code >> 12)));
+        result.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+      }
+      break;
+    }
+    default: // '"' '\\' '/'
+      result.push_back(c);
+      break;
+    }
+  }
+  return result;
+}
+
+void JsonReader::Skip() {
+  switch (Peek()) {
+  case JsonType::Object: {
+    BeginObject();
+    std::string_view key;
+    while (NextKey(key)) {
+      Skip();
+    }
+    break;
+  }
+  case JsonType::Array:
+    BeginArray();
+    while (NextElement()) {
+      Skip();
+    }
+    break;
+  case JsonType::String:
+    ReadRawString();
+    break;
+  case JsonType::Bool:
+    ReadBool();
+    break;
+  case JsonType::Null:
+    if (!m_text.substr(m_pos).starts_with("null")) {
+      fail("expected null");
+    }
+    m_pos += 4;
+    break;
+  case JsonType::Number:
+    ReadNumber();
+    break;
+  }
+}
+
+void JsonReader::skipWhitespace() {
+  while (m_pos < m_text.size() &&
+         (m_text[m_pos] == ' ' || m_text[m_pos] == '\n' ||
+          m_text[m_pos] == '\r' || m_text[m_pos] == '\t')) {
+    m_pos++;
+  }
+}
+
+char JsonReader::peekChar() {
+  skipWhitespace();
+  if (m_pos >= m_text.size()) {
+    fail("unexpected end of input");
+  }
+  return m_text[m_pos];
+}
+
+void JsonReader::expect(char c) {
+  if (peekChar() != c) {
+    fail("unexpected character");
+  }
+  m_pos++;
+}
+
+// 消耗元素之间的逗号。读取器不记录嵌套状态，因此不检查缺少逗号的情况
+void JsonReader::skipCommaBefore(char closing) {
+  if (peekChar() == ',') {
+    m_pos++;
+    if (peekChar() == closing) {
+      fail("trailing comma");
+    }
+  }
+}
+
+void JsonReader::fail(const char *message) const {
+  LOG_ERROR("json parse error at offset {}: {}", m_pos, message);
+  throw std::runtime_error(std::string("json parse error: ") + message);
+}
@@ -0,0 +1,107 @@
+#include "utils/MappedFile.hpp"
+
+#include "utils/log.hpp"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+[[noreturn]] void throwMapError(const std::string &filename) {
+  LOG_ERROR("failed to map file: {}", filename);
+  throw std::runtime_error("failed to map file: " + filename);
+}
+} // namespace
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string &filename) {
+  m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                       OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (m_file == INVALID_HANDLE_VALUE) {
+    m_file = nullptr;
+    throwMapError(filename);
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(m_file, &size)) {
+    CloseHandle(m_file);
+    throwMapError(filename);
+  }
+  m_size = static_cast<size_t>(size.QuadPart);
+  if (m_size == 0) {
+    return;
+  }
+
+  m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!m_mapping) {
+    CloseHandle(m_file);
+    throwMapError(filename);
+  }
+  m_data = static_cast<const uint8_t *>(
+      MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+  if (!m_data) {
+    CloseHandle(m_mapping);
+    CloseHandle(m_file);
+    throwMapError(filename);
+  }
+}
+
+MappedFile::~MappedFile() {
+  if (m_data) {
+    UnmapViewOfFile(m_data);
+  }
+  if (m_mapping) {
+    CloseHandle(m_mapping);
+  }
+  if (m_file) {
+    CloseHandle(m_file);
+  }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &filename) {
+  m_file = open(filename.c_str(), O_RDONLY);
+  if (m_file < 0) {
+    throwMapError(filename);
+  }
+
+  struct stat status;
+  if (fstat(m_file, &status) != 0) {
+    close(m_file);
+    throwMapError(filename);
+  }
+  m_size = static_cast<size_t>(status.st_size);
+  if (m_size == 0) {
+    return;
+  }
+
+  void *data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+  if (data == MAP_FAILED) {
+    close(m_file);
+    throwMapError(filename);
+  }
+  // 解析器按顺序扫描，提示内核提前预读
+  madvise(data, m_size, MADV_SEQUENTIAL);
+  m_data = static_cast<const uint8_t *>(data);
+}
+
+MappedFile::~MappedFile() {
+  if (m_data) {
+    munmap(const_cast<uint8_t *>(m_data), m_size);
+  }
+  if (m_file >= 0) {
+    close(m_file);
+  }
+}
+
+#endif
@@ -0,0 +1,102 @@
+#include "utils/ThreadPool.hpp"
+
+thread_local bool ThreadPool::s_insideTask = false;
+
+ThreadPool::ThreadPool(uint32_t workerCount) {
+  if (workerCount == DEFAULT_WORKER_COUNT) {
+    workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+  }
+  m_workers.reserve(workerCount);
+  for (uint32_t i = 0; i < workerCount; i++) {
+    m_workers.emplace_back(&ThreadPool::workerLoop, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_wakeCondition.notify_all();
+  for (auto &worker : m_workers) {
+    worker.join();
+  }
+}
+
+ThreadPool &ThreadPool::Get() {
+  static ThreadPool pool;
+  return pool;
+}
+
+void ThreadPool::run(size_t batchCount,
+                     const std::function<void(size_t)> &task) {
+  std::lock_guard<std::mutex> runLock(m_runMutex);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_batchCount = batchCount;
+    m_nextBatch.store(0, std::memory_order_relaxed);
+    m_pendingWorkers = m_workers.size();
+    m_exception = nullptr;
+    m_generation++;
+  }
+  m_wakeCondition.notify_all();
+
+  s_insideTask = true;
+  drainBatches();
+  s_insideTask = false;
+
+  std::exception_ptr exception;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this] { return m_pendingWorkers == 0; });
+    m_task = nullptr;
+    exception = m_exception;
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+void ThreadPool::drainBatches() {
+  for (size_t batch = m_nextBatch.fetch_add(1, std::memory_order_relaxed);
+       batch < m_batchCount;
+       batch = m_nextBatch.fetch_add(1, std::memory_order_relaxed)) {
+    try {
+      (*m_task)(batch);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!m_exception) {
+        m_exception = std::current_exception();
+      }
+      // 跳过剩余批次，尽快返回调用线程
+      m_nextBatch.store(m_batchCount, std::memory_order_relaxed);
+    }
+  }
+}
+
+void ThreadPool::workerLoop() {
+  s_insideTask = true; // 工作线程只会执行任务
+  uint64_t seenGeneration = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_wakeCondition.wait(lock, [&] {
+        return m_stop || m_generation != seenGeneration;
+      });
+      if (m_stop) {
+        return;
+      }
+      seenGeneration = m_generation;
+    }
+
+    drainBatches();
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (--m_pendingWorkers == 0) {
+        m_doneCondition.notify_one();
+      }
+    }
+  }
+}
@@ -0,0 +1,3 @@
+// stb_image 的实现单元，其余文件只包含声明
+#define STB_IMAGE_IMPLEMENTATION
+#include "utils/stb_image.h"
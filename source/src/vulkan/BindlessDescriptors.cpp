@@ -0,0 +1,271 @@
+#include "Vulkan/BindlessDescriptors.hpp"
+
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+BindlessHandle DescriptorSlotAllocator::Allocate() {
+  if (!m_freeList.empty()) {
+    BindlessHandle slot = m_freeList.back();
+    m_freeList.pop_back();
+    return slot;
+  }
+  if (m_next < m_capacity) {
+    return m_next++;
+  }
+  return INVALID_BINDLESS_HANDLE;
+}
+
+void DescriptorSlotAllocator::Free(BindlessHandle slot) {
+  m_freeList.push_back(slot);
+}
+
+bool BindlessDescriptors::IsSupported(const VkContext &context) {
+  const VkPhysicalDeviceVulkan12Features &features = context.features12;
+  return features.descriptorIndexing && features.runtimeDescriptorArray &&
+         features.descriptorBindingPartiallyBound &&
+         features.descriptorBindingUpdateUnusedWhilePending &&
+         features.descriptorBindingSampledImageUpdateAfterBind &&
+         features.descriptorBindingStorageBufferUpdateAfterBind;
+}
+
+BindlessDescriptors::BindlessDescriptors(const VkContext &context,
+                                         const BindlessConfig &config)
+    : m_context(context), m_config(config) {
+  if (!IsSupported(m_context)) {
+    LOG_ERROR("descriptor indexing features are not enabled!");
+    throw std::runtime_error("descriptor indexing features are not enabled!");
+  }
+
+  // 1. 按设备的绑定后更新限制裁剪数组容量
+  VkPhysicalDeviceDescriptorIndexingProperties indexingProperties = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES,
+  };
+  VkPhysicalDeviceProperties2 properties = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+      .pNext = &indexingProperties,
+  };
+  vkGetPhysicalDeviceProperties2(m_context.physicalDevice, &properties);
+
+  uint32_t maxTextures = std::min(
+      {m_config.maxTextures,
+       indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+       indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers,
+       indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+       indexingProperties.maxDescriptorSetUpdateAfterBindSamplers});
+  uint32_t maxBuffers = std::min(
+      {m_config.maxStorageBuffers,
+       indexingProperties.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+       indexingProperties.maxDescriptorSetUpdateAfterBindStorageBuffers});
+  m_textureSlots = DescriptorSlotAllocator(maxTextures);
+  m_bufferSlots = DescriptorSlotAllocator(maxBuffers);
+
+  // 2. 描述符集布局：两个部分绑定、绑定后可更新的数组
+  VkShaderStageFlags stages = VK_SHADER_STAGE_VERTEX_BIT |
+                              VK_SHADER_STAGE_FRAGMENT_BIT |
+                              VK_SHADER_STAGE_COMPUTE_BIT;
+  VkDescriptorSetLayoutBinding bindings[2] = {
+      {
+          .binding = TEXTURE_BINDING,
+          .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          .descriptorCount = maxTextures,
+          .stageFlags = stages,
+      },
+      {
+          .binding = STORAGE_BUFFER_BINDING,
+          .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+          .descriptorCount = maxBuffers,
+          .stageFlags = stages,
+      },
+  };
+
+  VkDescriptorBindingFlags bindingFlag =
+      VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+      VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+      VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+  VkDescriptorBindingFlags bindingFlags[2] = {bindingFlag, bindingFlag};
+
+  VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+      .bindingCount = 2,
+      .pBindingFlags = bindingFlags,
+  };
+
+  VkDescriptorSetLayoutCreateInfo layoutInfo = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .pNext = &bindingFlagsInfo,
+      .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+      .bindingCount = 2,
+      .pBindings = bindings,
+  };
+
+  if (vkCreateDescriptorSetLayout(m_context.device, &layoutInfo, nullptr,
+                                  &m_setLayout) != VK_SUCCESS) {
+    LOG_ERROR("failed to create bindless descriptor set layout!");
+    throw std::runtime_error(
+        "failed to create bindless descriptor set layout!");
+  }
+
+  // 3. 描述符池与唯一的描述符集
+  VkDescriptorPoolSize poolSizes[2] = {
+      {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, maxTextures},
+      {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, maxBuffers},
+  };
+
+  VkDescriptorPoolCreateInfo poolInfo = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+      .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+      .maxSets = 1,
+      .poolSizeCount = 2,
+      .pPoolSizes = poolSizes,
+  };
+
+  if (vkCreateDescriptorPool(m_context.device, &poolInfo, nullptr,
+                             &m_descriptorPool) != VK_SUCCESS) {
+    LOG_ERROR("failed to create bindless descriptor pool!");
+    throw std::runtime_error("failed to create bindless descriptor pool!");
+  }
+
+  VkDescriptorSetAllocateInfo allocInfo = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+      .descriptorPool = m_descriptorPool,
+      .descriptorSetCount = 1,
+      .pSetLayouts = &m_setLayout,
+  };
+
+  if (vkAllocateDescriptorSets(m_context.device, &allocInfo,
+                               &m_descriptorSet) != VK_SUCCESS) {
+    LOG_ERROR("failed to allocate bindless descriptor set!");
+    throw std::runtime_error("failed to allocate bindless descriptor set!");
+  }
+
+  LOG_INFO("bindless descriptors: {} textures, {} storage buffers",
+           maxTextures, maxBuffers);
+}
+
+BindlessDescriptors::~BindlessDescriptors() {
+  // 销毁描述符池会一并释放其中的描述符集
+  vkDestroyDescriptorPool(m_context.device, m_descriptorPool, nullptr);
+  vkDestroyDescriptorSetLayout(m_context.device, m_setLayout, nullptr);
+}
+
+BindlessHandle BindlessDescriptors::RegisterTexture(VkImageView view,
+                                                    VkSampler sampler) {
+  BindlessHandle handle = m_textureSlots.Allocate();
+  if (handle == INVALID_BINDLESS_HANDLE) {
+    LOG_ERROR("bindless texture slots exhausted ({})",
+              m_textureSlots.GetCapacity());
+    throw std::runtime_error("bindless texture slots exhausted!");
+  }
+
+  writeTexture(handle, view, sampler);
+  return handle;
+}
+
+BindlessHandle BindlessDescriptors::RegisterStorageBuffer(VkBuffer buffer,
+                                                          VkDeviceSize offset,
+                                                          VkDeviceSize range) {
+  BindlessHandle handle = m_bufferSlots.Allocate();
+  if (handle == INVALID_BINDLESS_HANDLE) {
+    LOG_ERROR("bindless storage buffer slots exhausted ({})",
+              m_bufferSlots.GetCapacity());
+    throw std::runtime_error("bindless storage buffer slots exhausted!");
+  }
+
+  writeStorageBuffer(handle, buffer, offset, range);
+  return handle;
+}
+
+BindlessHandle BindlessDescriptors::UpdateTexture(BindlessHandle handle,
+                                                  VkImageView view,
+                                                  VkSampler sampler,
+                                                  uint64_t frameIndex) {
+  BindlessHandle newHandle = RegisterTexture(view, sampler);
+  ReleaseTexture(handle, frameIndex);
+  return newHandle;
+}
+
+BindlessHandle BindlessDescriptors::UpdateStorageBuffer(BindlessHandle handle,
+                                                        VkBuffer buffer,
+                                                        uint64_t frameIndex,
+                                                        VkDeviceSize offset,
+                                                        VkDeviceSize range) {
+  BindlessHandle newHandle = RegisterStorageBuffer(buffer, offset, range);
+  ReleaseStorageBuffer(handle, frameIndex);
+  return newHandle;
+}
+
+void BindlessDescriptors::ReleaseTexture(BindlessHandle handle,
+                                         uint64_t frameIndex) {
+  m_retiredSlots.push_back({frameIndex, TEXTURE_BINDING, handle});
+}
+
+void BindlessDescriptors::ReleaseStorageBuffer(BindlessHandle handle,
+                                               uint64_t frameIndex) {
+  m_retiredSlots.push_back({frameIndex, STORAGE_BUFFER_BINDING, handle});
+}
+
+void BindlessDescriptors::Update(uint64_t frameIndex) {
+  while (!m_retiredSlots.empty() &&
+         m_retiredSlots.front().releaseFrame + m_config.framesInFlight <=
+             frameIndex) {
+    const RetiredSlot &retired = m_retiredSlots.front();
+    if (retired.binding == TEXTURE_BINDING) {
+      m_textureSlots.Free(retired.slot);
+    } else {
+      m_bufferSlots.Free(retired.slot);
+    }
+    m_retiredSlots.pop_front();
+  }
+}
+
+void BindlessDescriptors::Bind(VkCommandBuffer commandBuffer,
+                               VkPipelineBindPoint bindPoint,
+                               VkPipelineLayout layout,
+                               uint32_t setIndex) const {
+  vkCmdBindDescriptorSets(commandBuffer, bindPoint, layout, setIndex, 1,
+                          &m_descriptorSet, 0, nullptr);
+}
+
+void BindlessDescriptors::writeTexture(BindlessHandle handle, VkImageView view,
+                                       VkSampler sampler) {
+  VkDescriptorImageInfo imageInfo = {
+      .sampler = sampler,
+      .imageView = view,
+      .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+  };
+
+  VkWriteDescriptorSet write = {
+      .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+      .dstSet = m_descriptorSet,
+      .dstBinding = TEXTURE_BINDING,
+      .dstArrayElement = handle,
+      .descriptorCount = 1,
+      .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+      .pImageInfo = &imageInfo,
+  };
+  vkUpdateDescriptorSets(m_context.device, 1, &write, 0, nullptr);
+}
+
+void BindlessDescriptors::writeStorageBuffer(BindlessHandle handle,
+                                             VkBuffer buffer,
+                                             VkDeviceSize offset,
+                                             VkDeviceSize range) {
+  VkDescriptorBufferInfo bufferInfo = {
+      .buffer = buffer,
+      .offset = offset,
+      .range = range,
+  };
+
+  VkWriteDescriptorSet write = {
+      .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+      .dstSet = m_descriptorSet,
+      .dstBinding = STORAGE_BUFFER_BINDING,
+      .dstArrayElement = handle,
+      .descriptorCount = 1,
+      .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+      .pBufferInfo = &bufferInfo,
+  };
+  vkUpdateDescriptorSets(m_context.device, 1, &write, 0, nullptr);
+}
@@ -0,0 +1,277 @@
+#include "Vulkan/DescriptorAllocator.hpp"
+
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+namespace {
+// 比例按每 64 个集合计，避免整数比例过早截断为 0
+constexpr uint32_t RATIO_SETS = 64;
+
+// 尚未观测到用量时新池的默认比例
+const DescriptorTypeCounts DEFAULT_TYPE_RATIO = [] {
+  DescriptorTypeCounts ratio{};
+  ratio[VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER] = 4 * RATIO_SETS;
+  ratio[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER] = 2 * RATIO_SETS;
+  ratio[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC] = RATIO_SETS;
+  ratio[VK_DESCRIPTOR_TYPE_STORAGE_BUFFER] = 2 * RATIO_SETS;
+  ratio[VK_DESCRIPTOR_TYPE_STORAGE_IMAGE] = RATIO_SETS / 2;
+  return ratio;
+}();
+} // namespace
+
+DescriptorLayout::DescriptorLayout(
+    const VkContext &context, const std::vector<DescriptorBinding> &bindings,
+    VkDescriptorSetLayoutCreateFlags flags)
+    : m_context(context), m_flags(flags), m_bindings(bindings) {
+  std::vector<VkDescriptorSetLayoutBinding> layoutBindings;
+  std::vector<VkDescriptorUpdateTemplateEntry> entries;
+  layoutBindings.reserve(bindings.size());
+  entries.reserve(bindings.size());
+
+  for (const auto &binding : bindings) {
+    if (static_cast<uint32_t>(binding.type) >= CORE_DESCRIPTOR_TYPE_COUNT) {
+      LOG_ERROR("unsupported descriptor type {}",
+                static_cast<uint32_t>(binding.type));
+      throw std::runtime_error("unsupported descriptor type!");
+    }
+
+    layoutBindings.push_back({
+        .binding = binding.binding,
+        .descriptorType = binding.type,
+        .descriptorCount = binding.count,
+        .stageFlags = binding.stages,
+    });
+
+    entries.push_back({
+        .dstBinding = binding.binding,
+        .dstArrayElement = 0,
+        .descriptorCount = binding.count,
+        .descriptorType = binding.type,
+        .offset = m_writeCount * sizeof(DescriptorWrite),
+        .stride = sizeof(DescriptorWrite),
+    });
+
+    m_writeCount += binding.count;
+    m_typeCounts[binding.type] += binding.count;
+  }
+
+  VkDescriptorSetLayoutCreateInfo layoutInfo = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .flags = m_flags,
+      .bindingCount = static_cast<uint32_t>(layoutBindings.size()),
+      .pBindings = layoutBindings.data(),
+  };
+
+  if (vkCreateDescriptorSetLayout(m_context.device, &layoutInfo, nullptr,
+                                  &m_layout) != VK_SUCCESS) {
+    LOG_ERROR("failed to create descriptor set layout!");
+    throw std::runtime_error("failed to create descriptor set layout!");
+  }
+
+  // 描述符缓冲布局不分配描述符集，也就不需要更新模板
+  if (m_flags & VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT) {
+    return;
+  }
+
+  VkDescriptorUpdateTemplateCreateInfo templateInfo = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+      .descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size()),
+      .pDescriptorUpdateEntries = entries.data(),
+      .templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET,
+      .descriptorSetLayout = m_layout,
+  };
+
+  if (vkCreateDescriptorUpdateTemplate(m_context.device, &templateInfo,
+                                       nullptr,
+                                       &m_updateTemplate) != VK_SUCCESS) {
+    LOG_ERROR("failed to create descriptor update template!");
+    throw std::runtime_error("failed to create descriptor update template!");
+  }
+}
+
+DescriptorLayout::~DescriptorLayout() {
+  if (m_updateTemplate != VK_NULL_HANDLE) {
+    vkDestroyDescriptorUpdateTemplate(m_context.device, m_updateTemplate,
+                                      nullptr);
+  }
+  vkDestroyDescriptorSetLayout(m_context.device, m_layout, nullptr);
+}
+
+void DescriptorLayout::Write(VkDescriptorSet set,
+                             const DescriptorWrite *writes) const {
+  vkUpdateDescriptorSetWithTemplate(m_context.device, set, m_updateTemplate,
+                                    writes);
+}
+
+DescriptorAllocator::DescriptorAllocator(
+    const VkContext &context, const DescriptorAllocatorConfig &config)
+    : m_context(context), m_config(config),
+      m_setsPerPool(config.initialSetsPerPool),
+      m_typeRatio(DEFAULT_TYPE_RATIO) {}
+
+DescriptorAllocator::~DescriptorAllocator() {
+  for (const Pool &pool : m_usedPools) {
+    vkDestroyDescriptorPool(m_context.device, pool.pool, nullptr);
+  }
+  for (const Pool &pool : m_readyPools) {
+    vkDestroyDescriptorPool(m_context.device, pool.pool, nullptr);
+  }
+}
+
+VkDescriptorSet DescriptorAllocator::Allocate(const DescriptorLayout &layout) {
+  // 1. 当前池剩余空间不足时先换池，不让驱动在热路径上分配失败
+  const DescriptorTypeCounts &counts = layout.GetTypeCounts();
+  if (m_currentPool == VK_NULL_HANDLE ||
+      !fits(m_remainingSets, m_remainingTypes, counts)) {
+    acquirePool(layout, false);
+  }
+
+  VkDescriptorSetLayout setLayout = layout.Get();
+  VkDescriptorSetAllocateInfo allocInfo = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+      .descriptorPool = m_currentPool,
+      .descriptorSetCount = 1,
+      .pSetLayouts = &setLayout,
+  };
+
+  VkDescriptorSet set = VK_NULL_HANDLE;
+  VkResult result = vkAllocateDescriptorSets(m_context.device, &allocInfo, &set);
+
+  // 2. 防御：驱动仍然报告池空间不足时，换一个新建的池重试一次
+  if (result == VK_ERROR_OUT_OF_POOL_MEMORY ||
+      result == VK_ERROR_FRAGMENTED_POOL) {
+    LOG_WARN("descriptor pool ran out of memory despite the tracked budget");
+    acquirePool(layout, true);
+    allocInfo.descriptorPool = m_currentPool;
+    result = vkAllocateDescriptorSets(m_context.device, &allocInfo, &set);
+  }
+
+  if (result != VK_SUCCESS) {
+    LOG_ERROR("failed to allocate descriptor set!");
+    throw std::runtime_error("failed to allocate descriptor set!");
+  }
+
+  m_remainingSets--;
+  m_allocatedSets++;
+  for (uint32_t type = 0; type < CORE_DESCRIPTOR_TYPE_COUNT; type++) {
+    m_remainingTypes[type] -= counts[type];
+    m_allocatedTypes[type] += counts[type];
+  }
+  return set;
+}
+
+void DescriptorAllocator::Reset() {
+  // 1. 根据本轮实际用量调整后续新池的大小与类型比例
+  if (m_allocatedSets > 0) {
+    for (uint32_t type = 0; type < CORE_DESCRIPTOR_TYPE_COUNT; type++) {
+      m_typeRatio[type] = static_cast<uint32_t>(
+          (uint64_t(m_allocatedTypes[type]) * RATIO_SETS + m_allocatedSets -
+           1) /
+          m_allocatedSets);
+    }
+    m_setsPerPool = std::clamp(m_allocatedSets, m_config.initialSetsPerPool,
+                               m_config.maxSetsPerPool);
+  }
+  m_allocatedSets = 0;
+  m_allocatedTypes = {};
+
+  // 2. 整体重置所有池，不逐个释放集合
+  for (const Pool &pool : m_usedPools) {
+    vkResetDescriptorPool(m_context.device, pool.pool, 0);
+    m_readyPools.push_back(pool);
+  }
+  m_usedPools.clear();
+  m_currentPool = VK_NULL_HANDLE;
+  m_remainingSets = 0;
+  m_remainingTypes = {};
+}
+
+bool DescriptorAllocator::fits(uint32_t sets,
+                               const DescriptorTypeCounts &available,
+                               const DescriptorTypeCounts &required) {
+  if (sets == 0) {
+    return false;
+  }
+  for (uint32_t type = 0; type < CORE_DESCRIPTOR_TYPE_COUNT; type++) {
+    if (required[type] > available[type]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void DescriptorAllocator::acquirePool(const DescriptorLayout &layout,
+                                      bool forceNew) {
+  const DescriptorTypeCounts &counts = layout.GetTypeCounts();
+  auto ready = forceNew ? m_readyPools.end()
+                        : std::find_if(m_readyPools.begin(), m_readyPools.end(),
+                                       [&](const Pool &pool) {
+                                         return fits(pool.maxSets,
+                                                     pool.capacity, counts);
+                                       });
+  Pool pool;
+  if (ready != m_readyPools.end()) {
+    pool = *ready;
+    *ready = m_readyPools.back();
+    m_readyPools.pop_back();
+  } else {
+    pool = createPool(m_setsPerPool, counts);
+    m_setsPerPool = std::min(
+        static_cast<uint32_t>(m_setsPerPool * m_config.growthFactor),
+        m_config.maxSetsPerPool);
+  }
+
+  m_usedPools.push_back(pool);
+  m_currentPool = pool.pool;
+  m_remainingSets = pool.maxSets;
+  m_remainingTypes = pool.capacity;
+}
+
+DescriptorAllocator::Pool
+DescriptorAllocator::createPool(uint32_t maxSets,
+                                const DescriptorTypeCounts &minCounts) {
+  Pool pool = {.maxSets = maxSets};
+  std::vector<VkDescriptorPoolSize> poolSizes;
+  for (uint32_t type = 0; type < CORE_DESCRIPTOR_TYPE_COUNT; type++) {
+    uint32_t count = static_cast<uint32_t>(
+        (uint64_t(m_typeRatio[type]) * maxSets + RATIO_SETS - 1) / RATIO_SETS);
+    count = std::max(count, minCounts[type]);
+    if (count > 0) {
+      poolSizes.push_back({static_cast<VkDescriptorType>(type), count});
+    }
+    pool.capacity[type] = count;
+  }
+
+  VkDescriptorPoolCreateInfo poolInfo = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+      .maxSets = maxSets,
+      .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+      .pPoolSizes = poolSizes.data(),
+  };
+
+  if (vkCreateDescriptorPool(m_context.device, &poolInfo, nullptr,
+                             &pool.pool) != VK_SUCCESS) {
+    LOG_ERROR("failed to create descriptor pool!");
+    throw std::runtime_error("failed to create descriptor pool!");
+  }
+
+  LOG_DEBUG("descriptor allocator: new pool with {} sets", maxSets);
+  return pool;
+}
+
+FrameDescriptorAllocator::FrameDescriptorAllocator(
+    const VkContext &context, uint32_t framesInFlight,
+    const DescriptorAllocatorConfig &config) {
+  for (uint32_t i = 0; i < framesInFlight; i++) {
+    m_allocators.push_back(
+        std::make_unique<DescriptorAllocator>(context, config));
+  }
+}
+
+void FrameDescriptorAllocator::BeginFrame(uint64_t frameIndex) {
+  m_current = static_cast<uint32_t>(frameIndex % m_allocators.size());
+  m_allocators[m_current]->Reset();
+}
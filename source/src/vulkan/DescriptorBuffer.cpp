@@ -0,0 +1,270 @@
+#include "Vulkan/DescriptorBuffer.hpp"
+
+#include "Vulkan/VkUtils.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace {
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+template <typename T>
+T loadDeviceFunction(VkDevice device, const char *name) {
+  auto function = reinterpret_cast<T>(vkGetDeviceProcAddr(device, name));
+  if (!function) {
+    LOG_ERROR("failed to load device function {}", name);
+    throw std::runtime_error(std::string("failed to load ") + name);
+  }
+  return function;
+}
+} // namespace
+
+bool DescriptorBuffer::IsSupported(const VkContext &context) {
+  return context.HasExtension(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) &&
+         context.features12.bufferDeviceAddress;
+}
+
+DescriptorBuffer::DescriptorBuffer(const VkContext &context,
+                                   uint32_t framesInFlight,
+                                   VkDeviceSize bytesPerFrame)
+    : m_context(context), m_framesInFlight(framesInFlight) {
+  if (!IsSupported(m_context)) {
+    LOG_ERROR("VK_EXT_descriptor_buffer is not enabled!");
+    throw std::runtime_error("VK_EXT_descriptor_buffer is not enabled!");
+  }
+
+  // 1. 扩展函数与描述符尺寸
+  VkDevice device = m_context.device;
+  m_vkGetDescriptorSetLayoutSizeEXT =
+      loadDeviceFunction<PFN_vkGetDescriptorSetLayoutSizeEXT>(
+          device, "vkGetDescriptorSetLayoutSizeEXT");
+  m_vkGetDescriptorSetLayoutBindingOffsetEXT =
+      loadDeviceFunction<PFN_vkGetDescriptorSetLayoutBindingOffsetEXT>(
+          device, "vkGetDescriptorSetLayoutBindingOffsetEXT");
+  m_vkGetDescriptorEXT =
+      loadDeviceFunction<PFN_vkGetDescriptorEXT>(device, "vkGetDescriptorEXT");
+  m_vkCmdBindDescriptorBuffersEXT =
+      loadDeviceFunction<PFN_vkCmdBindDescriptorBuffersEXT>(
+          device, "vkCmdBindDescriptorBuffersEXT");
+  m_vkCmdSetDescriptorBufferOffsetsEXT =
+      loadDeviceFunction<PFN_vkCmdSetDescriptorBufferOffsetsEXT>(
+          device, "vkCmdSetDescriptorBufferOffsetsEXT");
+
+  m_properties.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
+  VkPhysicalDeviceProperties2 properties = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+      .pNext = &m_properties,
+  };
+  vkGetPhysicalDeviceProperties2(m_context.physicalDevice, &properties);
+
+  // 2. 整个缓冲同时存放资源与采样器描述符，受两者中较小的可寻址范围限制
+  VkDeviceSize alignment = m_properties.descriptorBufferOffsetAlignment;
+  m_bytesPerFrame = alignUp(bytesPerFrame, alignment);
+  VkDeviceSize maxRange = std::min(m_properties.maxResourceDescriptorBufferRange,
+                                   m_properties.maxSamplerDescriptorBufferRange);
+  if (m_bytesPerFrame * m_framesInFlight > maxRange) {
+    m_bytesPerFrame = maxRange / m_framesInFlight / alignment * alignment;
+    LOG_WARN("descriptor buffer clamped to {} bytes per frame",
+             m_bytesPerFrame);
+  }
+
+  createBuffer(m_context, m_bytesPerFrame * m_framesInFlight,
+               VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+                   VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT |
+                   VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+               m_buffer, m_memory);
+  vkMapMemory(device, m_memory, 0, VK_WHOLE_SIZE, 0,
+              reinterpret_cast<void **>(&m_mapped));
+
+  VkBufferDeviceAddressInfo addressInfo = {
+      .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+      .buffer = m_buffer,
+  };
+  m_address = vkGetBufferDeviceAddress(device, &addressInfo);
+
+  LOG_INFO("descriptor buffer: {} KiB per frame, offset alignment {}",
+           m_bytesPerFrame >> 10, alignment);
+}
+
+DescriptorBuffer::~DescriptorBuffer() {
+  vkUnmapMemory(m_context.device, m_memory);
+  vkDestroyBuffer(m_context.device, m_buffer, nullptr);
+  vkFreeMemory(m_context.device, m_memory, nullptr);
+}
+
+void DescriptorBuffer::BeginFrame(uint64_t frameIndex) {
+  m_frameBegin = (frameIndex % m_framesInFlight) * m_bytesPerFrame;
+  m_head = 0;
+}
+
+DescriptorBufferSet DescriptorBuffer::Allocate(const DescriptorLayout &layout) {
+  const LayoutInfo &info = getLayoutInfo(layout);
+
+  VkDeviceSize offset =
+      alignUp(m_head, m_properties.descriptorBufferOffsetAlignment);
+  if (offset + info.size > m_bytesPerFrame) {
+    LOG_ERROR("descriptor buffer frame region exhausted ({} bytes)",
+              m_bytesPerFrame);
+    throw std::runtime_error("descriptor buffer frame region exhausted!");
+  }
+  m_head = offset + info.size;
+
+  offset += m_frameBegin;
+  return {offset, m_mapped + offset};
+}
+
+void DescriptorBuffer::RegisterBuffer(VkBuffer buffer) {
+  VkBufferDeviceAddressInfo bufferInfo = {
+      .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+      .buffer = buffer,
+  };
+  m_bufferAddresses[buffer] =
+      vkGetBufferDeviceAddress(m_context.device, &bufferInfo);
+}
+
+void DescriptorBuffer::UnregisterBuffer(VkBuffer buffer) {
+  m_bufferAddresses.erase(buffer);
+}
+
+void DescriptorBuffer::Write(const DescriptorBufferSet &set,
+                             const DescriptorLayout &layout,
+                             const DescriptorWrite *writes) {
+  const LayoutInfo &info = getLayoutInfo(layout);
+  const auto &bindings = layout.GetBindings();
+
+  uint32_t writeIndex = 0;
+  for (size_t b = 0; b < bindings.size(); b++) {
+    const DescriptorBinding &binding = bindings[b];
+    size_t size = descriptorSize(binding.type);
+
+    for (uint32_t i = 0; i < binding.count; i++, writeIndex++) {
+      const DescriptorWrite &write = writes[writeIndex];
+      VkDescriptorGetInfoEXT getInfo = {
+          .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+          .type = binding.type,
+      };
+
+      // 缓冲类描述符使用设备地址而不是 VkBuffer 句柄
+      VkDescriptorAddressInfoEXT addressInfo = {
+          .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT,
+      };
+      switch (binding.type) {
+      case VK_DESCRIPTOR_TYPE_SAMPLER:
+        getInfo.data.pSampler = &write.image.sampler;
+        break;
+      case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+        getInfo.data.pCombinedImageSampler = &write.image;
+        break;
+      case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+        getInfo.data.pSampledImage = &write.image;
+        break;
+      case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+        getInfo.data.pStorageImage = &write.image;
+        break;
+      case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+        getInfo.data.pInputAttachmentImage = &write.image;
+        break;
+      case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+      case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER: {
+        auto address = m_bufferAddresses.find(write.buffer.buffer);
+        if (address == m_bufferAddresses.end()) {
+          LOG_ERROR("buffer written to descriptor buffer was not registered");
+          throw std::runtime_error("descriptor buffer write of unregistered "
+                                   "buffer!");
+        }
+        addressInfo.address = address->second + write.buffer.offset;
+        addressInfo.range = write.buffer.range;
+        if (binding.type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) {
+          getInfo.data.pUniformBuffer = &addressInfo;
+        } else {
+          getInfo.data.pStorageBuffer = &addressInfo;
+        }
+        break;
+      }
+      default:
+        LOG_ERROR("descriptor type {} not supported by descriptor buffer",
+                  static_cast<uint32_t>(binding.type));
+        throw std::runtime_error("unsupported descriptor buffer type!");
+      }
+
+      m_vkGetDescriptorEXT(m_context.device, &getInfo, size,
+                           set.mapped + info.bindingOffsets[b] + i * size);
+    }
+  }
+}
+
+void DescriptorBuffer::BindBuffer(VkCommandBuffer commandBuffer) const {
+  VkDescriptorBufferBindingInfoEXT bindingInfo = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+      .address = m_address,
+      .usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+               VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT,
+  };
+  m_vkCmdBindDescriptorBuffersEXT(commandBuffer, 1, &bindingInfo);
+}
+
+void DescriptorBuffer::BindSet(VkCommandBuffer commandBuffer,
+                               VkPipelineBindPoint bindPoint,
+                               VkPipelineLayout pipelineLayout,
+                               uint32_t setIndex,
+                               const DescriptorBufferSet &set) const {
+  uint32_t bufferIndex = 0;
+  m_vkCmdSetDescriptorBufferOffsetsEXT(commandBuffer, bindPoint,
+                                       pipelineLayout, setIndex, 1,
+                                       &bufferIndex, &set.offset);
+}
+
+const DescriptorBuffer::LayoutInfo &
+DescriptorBuffer::getLayoutInfo(const DescriptorLayout &layout) {
+  auto it = m_layoutInfos.find(layout.Get());
+  if (it != m_layoutInfos.end()) {
+    return it->second;
+  }
+
+  if (!(layout.GetFlags() &
+        VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)) {
+    LOG_ERROR("descriptor layout was not created for descriptor buffers!");
+    throw std::runtime_error(
+        "descriptor layout was not created for descriptor buffers!");
+  }
+
+  LayoutInfo info;
+  m_vkGetDescriptorSetLayoutSizeEXT(m_context.device, layout.Get(),
+                                    &info.size);
+  for (const auto &binding : layout.GetBindings()) {
+    VkDeviceSize offset;
+    m_vkGetDescriptorSetLayoutBindingOffsetEXT(m_context.device, layout.Get(),
+                                               binding.binding, &offset);
+    info.bindingOffsets.push_back(offset);
+  }
+
+  return m_layoutInfos.emplace(layout.Get(), std::move(info)).first->second;
+}
+
+size_t DescriptorBuffer::descriptorSize(VkDescriptorType type) const {
+  switch (type) {
+  case VK_DESCRIPTOR_TYPE_SAMPLER:
+    return m_properties.samplerDescriptorSize;
+  case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+    return m_properties.combinedImageSamplerDescriptorSize;
+  case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+    return m_properties.sampledImageDescriptorSize;
+  case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+    return m_properties.storageImageDescriptorSize;
+  case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+    return m_properties.inputAttachmentDescriptorSize;
+  case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+    return m_properties.uniformBufferDescriptorSize;
+  case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+    return m_properties.storageBufferDescriptorSize;
+  default:
+    return 0;
+  }
+}
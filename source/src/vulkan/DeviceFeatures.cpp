@@ -0,0 +1,172 @@
+#include "Vulkan/DeviceFeatures.hpp"
+
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+bool hasExtension(const std::vector<const char *> &extensions,
+                  const char *name) {
+  return std::any_of(extensions.begin(), extensions.end(),
+                     [name](const char *e) { return std::strcmp(e, name) == 0; });
+}
+
+void removeExtension(std::vector<const char *> &extensions, const char *name) {
+  extensions.erase(std::remove_if(extensions.begin(), extensions.end(),
+                                  [name](const char *e) {
+                                    return std::strcmp(e, name) == 0;
+                                  }),
+                   extensions.end());
+}
+// synchronization2 在 1.3 中是核心功能，低于 1.3 时需要启用扩展
+bool hasSynchronization2(uint32_t apiVersion,
+                         const std::vector<const char *> &extensions) {
+  return apiVersion >= VK_API_VERSION_1_3 ||
+         hasExtension(extensions, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+}
+} // namespace
+
+const void *DeviceFeatureChain::Link(uint32_t apiVersion,
+                                     const std::vector<const char *> &extensions) {
+  features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+  descriptorBuffer.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
+  meshShader.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+  synchronization2.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+  features12.pNext = nullptr;
+  descriptorBuffer.pNext = nullptr;
+  meshShader.pNext = nullptr;
+  synchronization2.pNext = nullptr;
+
+  if (apiVersion < VK_API_VERSION_1_2) {
+    return nullptr;
+  }
+
+  void **next = &features12.pNext;
+  if (hasExtension(extensions, VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)) {
+    *next = &descriptorBuffer;
+    next = &descriptorBuffer.pNext;
+  }
+  if (hasSynchronization2(apiVersion, extensions)) {
+    *next = &synchronization2;
+    next = &synchronization2.pNext;
+  }
+  if (hasExtension(extensions, VK_EXT_MESH_SHADER_EXTENSION_NAME)) {
+    *next = &meshShader;
+  }
+  return &features12;
+}
+
+void selectDeviceFeatures(VkPhysicalDevice physicalDevice, uint32_t apiVersion,
+                          std::vector<const char *> &extensions,
+                          DeviceFeatureChain &chain) {
+  chain = {};
+  chain.features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+  // 0. 核心特性：GPU 剔除后的间接绘制一次提交多条命令，
+  // firstInstance 由剔除着色器写入对象编号
+  VkPhysicalDeviceFeatures supportedCore;
+  vkGetPhysicalDeviceFeatures(physicalDevice, &supportedCore);
+  chain.features.multiDrawIndirect = supportedCore.multiDrawIndirect;
+  chain.features.drawIndirectFirstInstance =
+      supportedCore.drawIndirectFirstInstance;
+
+  // 特性链依赖 vkGetPhysicalDeviceFeatures2 与 Vulkan12Features，低于 1.2 时全部关闭
+  if (apiVersion < VK_API_VERSION_1_2) {
+    removeExtension(extensions, VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+    removeExtension(extensions, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+    removeExtension(extensions, VK_EXT_MESH_SHADER_EXTENSION_NAME);
+    return;
+  }
+
+  // 只串入已请求扩展的特性结构
+  VkPhysicalDeviceDescriptorBufferFeaturesEXT supportedDescriptorBuffer = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT,
+  };
+  VkPhysicalDeviceMeshShaderFeaturesEXT supportedMeshShader = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT,
+  };
+  VkPhysicalDeviceSynchronization2FeaturesKHR supportedSynchronization2 = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR,
+  };
+  VkPhysicalDeviceVulkan12Features supported12 = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+  };
+  void **next = &supported12.pNext;
+  if (hasExtension(extensions, VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)) {
+    *next = &supportedDescriptorBuffer;
+    next = &supportedDescriptorBuffer.pNext;
+  }
+  if (hasSynchronization2(apiVersion, extensions)) {
+    *next = &supportedSynchronization2;
+    next = &supportedSynchronization2.pNext;
+  }
+  if (hasExtension(extensions, VK_EXT_MESH_SHADER_EXTENSION_NAME)) {
+    *next = &supportedMeshShader;
+  }
+  VkPhysicalDeviceFeatures2 supportedFeatures = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+      .pNext = &supported12,
+  };
+  vkGetPhysicalDeviceFeatures2(physicalDevice, &supportedFeatures);
+
+  VkPhysicalDeviceVulkan12Features &features12 = chain.features12;
+
+  // 1. 无绑定描述符：部分绑定、绑定后更新的运行时数组
+  if (supported12.descriptorIndexing && supported12.runtimeDescriptorArray &&
+      supported12.descriptorBindingPartiallyBound &&
+      supported12.descriptorBindingUpdateUnusedWhilePending &&
+      supported12.descriptorBindingSampledImageUpdateAfterBind &&
+      supported12.descriptorBindingStorageBufferUpdateAfterBind &&
+      supported12.shaderSampledImageArrayNonUniformIndexing &&
+      supported12.shaderStorageBufferArrayNonUniformIndexing) {
+    features12.descriptorIndexing = VK_TRUE;
+    features12.runtimeDescriptorArray = VK_TRUE;
+    features12.descriptorBindingPartiallyBound = VK_TRUE;
+    features12.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+    features12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    features12.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+    features12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    features12.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+  }
+
+  // 2. synchronization2：描述符缓冲扩展的依赖
+  bool synchronization2 = hasSynchronization2(apiVersion, extensions) &&
+                          supportedSynchronization2.synchronization2;
+  if (synchronization2) {
+    chain.synchronization2.synchronization2 = VK_TRUE;
+  } else if (hasExtension(extensions,
+                          VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME)) {
+    removeExtension(extensions, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+  }
+
+  // 3. 描述符缓冲：需要缓冲设备地址与 synchronization2
+  if (supportedDescriptorBuffer.descriptorBuffer &&
+      supported12.bufferDeviceAddress && synchronization2) {
+    chain.descriptorBuffer.descriptorBuffer = VK_TRUE;
+    features12.bufferDeviceAddress = VK_TRUE;
+  } else if (hasExtension(extensions,
+                          VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)) {
+    LOG_INFO("descriptorBuffer or synchronization2 not supported, "
+             "disabling {}",
+             VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+    removeExtension(extensions, VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+  }
+
+  // 4. 间接绘制计数：绘制数量由 GPU 剔除结果决定
+  if (supported12.drawIndirectCount) {
+    features12.drawIndirectCount = VK_TRUE;
+  }
+
+  // 5. 网格着色器：任务与网格阶段都要支持，否则回退到顶点管线
+  if (supportedMeshShader.taskShader && supportedMeshShader.meshShader) {
+    chain.meshShader.taskShader = VK_TRUE;
+    chain.meshShader.meshShader = VK_TRUE;
+  } else if (hasExtension(extensions, VK_EXT_MESH_SHADER_EXTENSION_NAME)) {
+    LOG_INFO("task/mesh shader features not supported, disabling {}",
+             VK_EXT_MESH_SHADER_EXTENSION_NAME);
+    removeExtension(extensions, VK_EXT_MESH_SHADER_EXTENSION_NAME);
+  }
+}
@@ -0,0 +1,94 @@
+#include "Vulkan/PerDrawData.hpp"
+
+#include "Vulkan/VkUtils.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+uint32_t clampDrawSize(const VkContext &context, uint32_t maxDrawSize) {
+  return std::min(maxDrawSize, context.limits.maxUniformBufferRange);
+}
+} // namespace
+
+PerDrawUniformRing::PerDrawUniformRing(const VkContext &context,
+                                       const PerDrawConfig &config)
+    : m_context(context), m_config(config),
+      m_layout(context, {{UNIFORM_BINDING,
+                          VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1,
+                          PER_DRAW_STAGES}}),
+      m_descriptorAllocator(context, {.initialSetsPerPool = 1}) {
+  m_config.maxDrawSize = clampDrawSize(m_context, m_config.maxDrawSize);
+
+  // 1. 每帧区域按对齐取整；动态偏移是 32 位，整个缓冲不能超过 4 GiB。
+  // 末尾额外留出一个 maxDrawSize，保证任意偏移加上描述符 range 都不越界
+  m_alignment = std::max<VkDeviceSize>(
+      m_context.limits.minUniformBufferOffsetAlignment, 1);
+  m_config.bytesPerFrame = alignUp(m_config.bytesPerFrame, m_alignment);
+  VkDeviceSize totalSize =
+      m_config.bytesPerFrame * m_config.framesInFlight + m_config.maxDrawSize;
+  if (totalSize > UINT32_MAX) {
+    LOG_ERROR("per-draw uniform ring too large ({} bytes)", totalSize);
+    throw std::runtime_error("per-draw uniform ring too large!");
+  }
+
+  createBuffer(m_context, totalSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+               m_buffer, m_memory);
+  vkMapMemory(m_context.device, m_memory, 0, VK_WHOLE_SIZE, 0,
+              reinterpret_cast<void **>(&m_mapped));
+
+  // 2. 唯一的描述符集，range 固定为 maxDrawSize
+  m_set = m_descriptorAllocator.Allocate(m_layout);
+  DescriptorWrite write;
+  write.buffer = {m_buffer, 0, m_config.maxDrawSize};
+  m_layout.Write(m_set, &write);
+
+  LOG_INFO("per-draw uniform ring: {} KiB per frame, offset alignment {}",
+           m_config.bytesPerFrame >> 10, m_alignment);
+}
+
+PerDrawUniformRing::~PerDrawUniformRing() {
+  vkUnmapMemory(m_context.device, m_memory);
+  vkDestroyBuffer(m_context.device, m_buffer, nullptr);
+  vkFreeMemory(m_context.device, m_memory, nullptr);
+}
+
+void PerDrawUniformRing::BeginFrame(uint64_t frameIndex) {
+  m_frameBegin = (frameIndex % m_config.framesInFlight) * m_config.bytesPerFrame;
+  m_head = 0;
+}
+
+PerDrawAllocation PerDrawUniformRing::Allocate(uint32_t size) {
+  if (size > m_config.maxDrawSize) {
+    LOG_ERROR("per-draw data of {} bytes exceeds the ring limit of {}", size,
+              m_config.maxDrawSize);
+    throw std::runtime_error("per-draw data too large!");
+  }
+
+  VkDeviceSize offset = alignUp(m_head, m_alignment);
+  if (offset + size > m_config.bytesPerFrame) {
+    LOG_ERROR("per-draw uniform ring frame region exhausted ({} bytes)",
+              m_config.bytesPerFrame);
+    throw std::runtime_error("per-draw uniform ring frame region exhausted!");
+  }
+  m_head = offset + size;
+
+  offset += m_frameBegin;
+  return {static_cast<uint32_t>(offset), m_mapped + offset};
+}
+
+void PerDrawUniformRing::Bind(VkCommandBuffer commandBuffer,
+                              VkPipelineBindPoint bindPoint,
+                              VkPipelineLayout pipelineLayout,
+                              uint32_t setIndex,
+                              uint32_t dynamicOffset) const {
+  vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, setIndex, 1,
+                          &m_set, 1, &dynamicOffset);
+}
@@ -0,0 +1,307 @@
+#include "Vulkan/VkUtils.hpp"
+
+#include "utils/log.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+uint32_t findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter,
+                        VkMemoryPropertyFlags properties) {
+  VkPhysicalDeviceMemoryProperties memProperties;
+  vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+
+  for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+    if ((typeFilter & (1u << i)) &&
+        (memProperties.memoryTypes[i].propertyFlags & properties) ==
+            properties) {
+      return i;
+    }
+  }
+
+  LOG_ERROR("failed to find suitable memory type!");
+  throw std::runtime_error("failed to find suitable memory type!");
+}
+
+void createBuffer(const VkContext &context, VkDeviceSize size,
+                  VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                  VkBuffer &buffer, VkDeviceMemory &memory) {
+  VkBufferCreateInfo bufferInfo = {
+      .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+      .size = size,
+      .usage = usage,
+      .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+  };
+
+  if (vkCreateBuffer(context.device, &bufferInfo, nullptr, &buffer) !=
+      VK_SUCCESS) {
+    LOG_ERROR("failed to create buffer!");
+    throw std::runtime_error("failed to create buffer!");
+  }
+
+  VkMemoryRequirements memRequirements;
+  vkGetBufferMemoryRequirements(context.device, buffer, &memRequirements);
+
+  // 带设备地址用途的缓冲需要在分配时声明
+  VkMemoryAllocateFlagsInfo allocFlagsInfo = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO,
+      .flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT,
+  };
+
+  VkMemoryAllocateInfo allocInfo = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+      .pNext = (usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT)
+                   ? &allocFlagsInfo
+                   : nullptr,
+      .allocationSize = memRequirements.size,
+      .memoryTypeIndex = findMemoryType(
+          context.physicalDevice, memRequirements.memoryTypeBits, properties),
+  };
+
+  if (vkAllocateMemory(context.device, &allocInfo, nullptr, &memory) !=
+      VK_SUCCESS) {
+    LOG_ERROR("failed to allocate buffer memory!");
+    throw std::runtime_error("failed to allocate buffer memory!");
+  }
+
+  vkBindBufferMemory(context.device, buffer, memory, 0);
+}
+
+VkDeviceSize createImage(const VkContext &context, uint32_t width,
+                         uint32_t height, uint32_t mipLevels,
+                         uint32_t arrayLayers, VkFormat format,
+                         VkImageUsageFlags usage, VkImage &image,
+                         VkDeviceMemory &memory) {
+  VkImageCreateInfo imageInfo = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+      .imageType = VK_IMAGE_TYPE_2D,
+      .format = format,
+      .extent = {width, height, 1},
+      .mipLevels = mipLevels,
+      .arrayLayers = arrayLayers,
+      .samples = VK_SAMPLE_COUNT_1_BIT,
+      .tiling = VK_IMAGE_TILING_OPTIMAL,
+      .usage = usage,
+      .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+      .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+  };
+
+  if (vkCreateImage(context.device, &imageInfo, nullptr, &image) !=
+      VK_SUCCESS) {
+    LOG_ERROR("failed to create image!");
+    throw std::runtime_error("failed to create image!");
+  }
+
+  VkMemoryRequirements memRequirements;
+  vkGetImageMemoryRequirements(context.device, image, &memRequirements);
+
+  VkMemoryAllocateInfo allocInfo = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+      .allocationSize = memRequirements.size,
+      .memoryTypeIndex = findMemoryType(context.physicalDevice,
+                                        memRequirements.memoryTypeBits,
+                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+  };
+
+  if (vkAllocateMemory(context.device, &allocInfo, nullptr, &memory) !=
+      VK_SUCCESS) {
+    LOG_ERROR("failed to allocate image memory!");
+    throw std::runtime_error("failed to allocate image memory!");
+  }
+
+  vkBindImageMemory(context.device, image, memory, 0);
+  return memRequirements.size;
+}
+
+VkImageView createImageView(const VkContext &context, VkImage image,
+                            VkFormat format, VkImageViewType viewType,
+                            uint32_t mipLevels, uint32_t arrayLayers,
+                            VkImageAspectFlags aspectMask) {
+  VkImageViewCreateInfo viewInfo = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+      .image = image,
+      .viewType = viewType,
+      .format = format,
+      .subresourceRange =
+          {
+              .aspectMask = aspectMask,
+              .baseMipLevel = 0,
+              .levelCount = mipLevels,
+              .baseArrayLayer = 0,
+              .layerCount = arrayLayers,
+          },
+  };
+
+  VkImageView imageView;
+  if (vkCreateImageView(context.device, &viewInfo, nullptr, &imageView) !=
+      VK_SUCCESS) {
+    LOG_ERROR("failed to create image view!");
+    throw std::runtime_error("failed to create image view!");
+  }
+
+  return imageView;
+}
+
+VkShaderModule createShaderModule(const VkContext &context,
+                                  const std::vector<char> &code) {
+  VkShaderModuleCreateInfo createInfo = {
+      .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+      .codeSize = code.size(),
+      .pCode = reinterpret_cast<const uint32_t *>(code.data()),
+  };
+
+  VkShaderModule shaderModule;
+  if (vkCreateShaderModule(context.device, &createInfo, nullptr,
+                           &shaderModule) != VK_SUCCESS) {
+    LOG_ERROR("failed to create shader module!");
+    throw std::runtime_error("failed to create shader module!");
+  }
+  return shaderModule;
+}
+
+VkCommandBuffer beginSingleTimeCommands(const VkContext &context,
+                                        VkCommandPool commandPool) {
+  VkCommandBufferAllocateInfo allocInfo = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+      .commandPool = commandPool,
+      .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+      .commandBufferCount = 1,
+  };
+
+  VkCommandBuffer commandBuffer;
+  vkAllocateCommandBuffers(context.device, &allocInfo, &commandBuffer);
+
+  VkCommandBufferBeginInfo beginInfo = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+  };
+  vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+  return commandBuffer;
+}
+
+void endSingleTimeCommands(const VkContext &context, VkCommandPool commandPool,
+                           VkCommandBuffer commandBuffer) {
+  vkEndCommandBuffer(commandBuffer);
+
+  VkSubmitInfo submitInfo = {
+      .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+      .commandBufferCount = 1,
+      .pCommandBuffers = &commandBuffer,
+  };
+
+  vkQueueSubmit(context.graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
+  vkQueueWaitIdle(context.graphicsQueue);
+
+  vkFreeCommandBuffers(context.device, commandPool, 1, &commandBuffer);
+}
+
+void uploadDeviceLocalBuffer(const VkContext &context,
+                             VkCommandPool commandPool, const void *data,
+                             VkDeviceSize size, VkBufferUsageFlags usage,
+                             VkBuffer &buffer, VkDeviceMemory &memory) {
+  // 1. 数据先拷进主机可见的暂存缓冲
+  VkBuffer stagingBuffer;
+  VkDeviceMemory stagingMemory;
+  createBuffer(context, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+               stagingBuffer, stagingMemory);
+
+  void *mapped;
+  vkMapMemory(context.device, stagingMemory, 0, size, 0, &mapped);
+  std::memcpy(mapped, data, static_cast<size_t>(size));
+  vkUnmapMemory(context.device, stagingMemory);
+
+  // 2. 再由传输命令复制到设备本地缓冲
+  createBuffer(context, size, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, memory);
+
+  VkCommandBuffer commandBuffer = beginSingleTimeCommands(context, commandPool);
+  VkBufferCopy region = {
+      .srcOffset = 0,
+      .dstOffset = 0,
+      .size = size,
+  };
+  vkCmdCopyBuffer(commandBuffer, stagingBuffer, buffer, 1, &region);
+  endSingleTimeCommands(context, commandPool, commandBuffer);
+
+  vkDestroyBuffer(context.device, stagingBuffer, nullptr);
+  vkFreeMemory(context.device, stagingMemory, nullptr);
+}
+
+void cmdTransitionImageLayout(VkCommandBuffer commandBuffer, VkImage image,
+                              VkImageLayout oldLayout, VkImageLayout newLayout,
+                              uint32_t baseMipLevel, uint32_t levelCount,
+                              uint32_t layerCount) {
+  VkImageMemoryBarrier barrier = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+      .oldLayout = oldLayout,
+      .newLayout = newLayout,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .image = image,
+      .subresourceRange =
+          {
+              .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+              .baseMipLevel = baseMipLevel,
+              .levelCount = levelCount,
+              .baseArrayLayer = 0,
+              .layerCount = layerCount,
+          },
+  };
+
+  VkPipelineStageFlags srcStage;
+  VkPipelineStageFlags dstStage;
+
+  if (newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
+    // 上传前：新图像无需等待，已被采样的图像需等待先前的着色器读取
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    srcStage = oldLayout == VK_IMAGE_LAYOUT_UNDEFINED
+                   ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT
+                   : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+  } else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL &&
+             newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
+    // 上传后：着色器读取需要等待传输写入
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+               VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+  } else if (oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL &&
+             newLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+    // 作为复制源：先前的着色器读取结束后才能转换布局
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    srcStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+               VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+  } else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL &&
+             newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
+    // 复制结束后恢复采样布局，读后读无需可见性
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+               VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+  } else if (newLayout == VK_IMAGE_LAYOUT_GENERAL) {
+    // 计算着色器读写
+    barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT |
+                            VK_ACCESS_SHADER_WRITE_BIT |
+                            VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask =
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    srcStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    dstStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+  } else {
+    barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+    srcStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    dstStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+  }
+
+  vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0,
+                       nullptr, 1, &barrier);
+}